@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <assert.h>
 #include <stdlib.h>
 #include <sys/cdefs.h>
 #include "sdkconfig.h"
@@ -27,6 +28,10 @@
 
 static const char *TAG = "lcd_panel.st7789t";
 
+// 显存为 240 列 x 320 行
+#define ST7789T_MEM_COLS    240
+#define ST7789T_MEM_ROWS    320
+
 static esp_err_t panel_st7789t_del(esp_lcd_panel_t *panel);
 static esp_err_t panel_st7789t_reset(esp_lcd_panel_t *panel);
 static esp_err_t panel_st7789t_init(esp_lcd_panel_t *panel);
@@ -47,6 +52,12 @@ typedef struct {
     uint8_t fb_bits_per_pixel;
     uint8_t madctl_val; // save current value of LCD_CMD_MADCTL register
     uint8_t colmod_cal; // save surrent value of LCD_CMD_COLMOD register
+    int mem_rows;       // 当前方向下显存的行数（MV 置位时行列互换）
+    // 上次 draw_bitmap 之后写指针停在哪里：列范围相同、从 next_y 行开始的区域可以不发命令直接续写；
+    // next_y 为 -1 表示不能续写（还没写过，或之后发过其他命令结束了显存写入）
+    int next_x_start;
+    int next_x_end;
+    int next_y;
 } st7789t_panel_t;
 
 esp_err_t esp_lcd_new_panel_st7789t(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_st7789t_config_t *panel_dev_config, esp_lcd_panel_handle_t *ret_panel)
@@ -97,6 +108,8 @@ esp_err_t esp_lcd_new_panel_st7789t(const esp_lcd_panel_io_handle_t io, const es
     }
 
     st7789t->io = io;
+    st7789t->mem_rows = ST7789T_MEM_ROWS;
+    st7789t->next_y = -1;
     st7789t->fb_bits_per_pixel = fb_bits_per_pixel;
     st7789t->reset_gpio_num = panel_dev_config->reset_gpio_num;
     st7789t->reset_level = panel_dev_config->flags.reset_active_high;
@@ -140,6 +153,7 @@ static esp_err_t panel_st7789t_reset(esp_lcd_panel_t *panel)
 {
     st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
     esp_lcd_panel_io_handle_t io = st7789t->io;
+    st7789t->next_y = -1;
 
     // perform hardware reset
     if (st7789t->reset_gpio_num >= 0) {
@@ -159,6 +173,7 @@ static esp_err_t panel_st7789t_init(esp_lcd_panel_t *panel)
 {
     st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
     esp_lcd_panel_io_handle_t io = st7789t->io;
+    st7789t->next_y = -1;
     // LCD goes into sleep mode and display will be turned off after power on reset, exit sleep mode first
     esp_lcd_panel_io_tx_param(io, LCD_CMD_SLPOUT, NULL, 0);
     vTaskDelay(pdMS_TO_TICKS(100));
@@ -213,22 +228,36 @@ static esp_err_t panel_st7789t_draw_bitmap(esp_lcd_panel_t *panel, int x_start,
     y_start += st7789t->y_gap;
     y_end += st7789t->y_gap;
 
-    // define an area of frame memory where MCU can access
-    esp_lcd_panel_io_tx_param(io, LCD_CMD_CASET, (uint8_t[]) {
-        (x_start >> 8) & 0xFF,
-        x_start & 0xFF,
-        ((x_end - 1) >> 8) & 0xFF,
-        (x_end - 1) & 0xFF,
-    }, 4);
-    esp_lcd_panel_io_tx_param(io, LCD_CMD_RASET, (uint8_t[]) {
-        (y_start >> 8) & 0xFF,
-        y_start & 0xFF,
-        ((y_end - 1) >> 8) & 0xFF,
-        (y_end - 1) & 0xFF,
-    }, 4);
-    // transfer frame buffer
     size_t len = (x_end - x_start) * (y_end - y_start) * st7789t->fb_bits_per_pixel / 8;
-    esp_lcd_panel_io_tx_color(io, LCD_CMD_RAMWR, color_data, len);
+
+    if (y_start == st7789t->next_y && x_start == st7789t->next_x_start && x_end == st7789t->next_x_end) {
+        // 紧接上一块的下方、列范围相同（LVGL 逐条刷新的同一区域）：窗口已开到显存底部，
+        // 写指针正停在这一行开头，不发命令直接续写像素。esp_lcd 发命令前要等已排队的颜色传输
+        // 全部发完再轮询发送，续写则只把这块排进队列
+        esp_lcd_panel_io_tx_color(io, -1, color_data, len);
+    } else {
+        // define an area of frame memory where MCU can access
+        esp_lcd_panel_io_tx_param(io, LCD_CMD_CASET, (uint8_t[]) {
+            (x_start >> 8) & 0xFF,
+            x_start & 0xFF,
+            ((x_end - 1) >> 8) & 0xFF,
+            (x_end - 1) & 0xFF,
+        }, 4);
+        // 行范围开到显存底部，下面紧接的一块可以续写；写满本块后写指针停在 y_end 行开头
+        int row_end = y_end > st7789t->mem_rows ? y_end : st7789t->mem_rows;
+        esp_lcd_panel_io_tx_param(io, LCD_CMD_RASET, (uint8_t[]) {
+            (y_start >> 8) & 0xFF,
+            y_start & 0xFF,
+            ((row_end - 1) >> 8) & 0xFF,
+            (row_end - 1) & 0xFF,
+        }, 4);
+        // transfer frame buffer
+        esp_lcd_panel_io_tx_color(io, LCD_CMD_RAMWR, color_data, len);
+    }
+
+    st7789t->next_x_start = x_start;
+    st7789t->next_x_end = x_end;
+    st7789t->next_y = y_end;
 
     return ESP_OK;
 }
@@ -244,6 +273,7 @@ static esp_err_t panel_st7789t_invert_color(esp_lcd_panel_t *panel, bool invert_
         command = LCD_CMD_INVOFF;
     }
     esp_lcd_panel_io_tx_param(io, command, NULL, 0);
+    st7789t->next_y = -1;
     return ESP_OK;
 }
 
@@ -264,6 +294,7 @@ static esp_err_t panel_st7789t_mirror(esp_lcd_panel_t *panel, bool mirror_x, boo
     esp_lcd_panel_io_tx_param(io, LCD_CMD_MADCTL, (uint8_t[]) {
         st7789t->madctl_val
     }, 1);
+    st7789t->next_y = -1;
     return ESP_OK;
 }
 
@@ -279,6 +310,8 @@ static esp_err_t panel_st7789t_swap_xy(esp_lcd_panel_t *panel, bool swap_axes)
     esp_lcd_panel_io_tx_param(io, LCD_CMD_MADCTL, (uint8_t[]) {
         st7789t->madctl_val
     }, 1);
+    st7789t->mem_rows = swap_axes ? ST7789T_MEM_COLS : ST7789T_MEM_ROWS;
+    st7789t->next_y = -1;
     return ESP_OK;
 }
 
@@ -287,6 +320,7 @@ static esp_err_t panel_st7789t_set_gap(esp_lcd_panel_t *panel, int x_gap, int y_
     st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
     st7789t->x_gap = x_gap;
     st7789t->y_gap = y_gap;
+    st7789t->next_y = -1;
     return ESP_OK;
 }
 
@@ -301,5 +335,6 @@ static esp_err_t panel_st7789t_disp_on_off(esp_lcd_panel_t *panel, bool on_off)
         command = LCD_CMD_DISPOFF;
     }
     esp_lcd_panel_io_tx_param(io, command, NULL, 0);
+    st7789t->next_y = -1;
     return ESP_OK;
 }
@@ -0,0 +1,159 @@
+/**
+ * @file app_tasks.c
+ * @brief 任务拓扑与任务统计实现
+ *
+ * CPU占用取 FreeRTOS 运行时计数器（以 esp_timer 微秒计）在两次统计之间的增量，
+ * 除以同一时间段的墙钟时间；核负载 = 100 - 该核空闲任务的占用。
+ */
+
+#include "app_tasks.h"
+#include <stdio.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+
+static const char *TAG = "app_tasks";
+
+#define CORE_COUNT 2
+
+typedef struct {
+    TaskHandle_t handle;
+    const char *name;
+    int core;
+    uint32_t stack_size;
+    uint32_t last_runtime;
+    uint8_t cpu_percent;
+} task_entry_t;
+
+static portMUX_TYPE tasks_lock = portMUX_INITIALIZER_UNLOCKED;
+static task_entry_t tasks[APP_TASKS_MAX];
+static int task_count = 0;
+
+static int64_t last_log_us = 0;
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+static int64_t last_sample_us = 0;
+static uint32_t last_idle_runtime[CORE_COUNT];
+#endif
+static uint8_t core_load[CORE_COUNT];
+
+esp_err_t app_tasks_create(TaskFunction_t fn, const char *name, uint32_t stack_size,
+                           UBaseType_t priority, int core, TaskHandle_t *handle)
+{
+    TaskHandle_t created = NULL;
+    if (xTaskCreatePinnedToCore(fn, name, stack_size, NULL, priority, &created, core) != pdPASS) {
+        ESP_LOGE(TAG, "任务 %s 创建失败", name);
+        return ESP_ERR_NO_MEM;
+    }
+    if (handle != NULL) {
+        *handle = created;
+    }
+
+    taskENTER_CRITICAL(&tasks_lock);
+    if (task_count < APP_TASKS_MAX) {
+        tasks[task_count++] = (task_entry_t) {
+            .handle = created,
+            .name = name,
+            .core = core,
+            .stack_size = stack_size,
+        };
+    }
+    taskEXIT_CRITICAL(&tasks_lock);
+
+    ESP_LOGI(TAG, "任务 %s 运行在核%d（栈 %lu 字节，优先级 %u）", name, core, stack_size, priority);
+    return ESP_OK;
+}
+
+/**
+ * @brief 按运行时计数器的增量更新各任务和各核的占用
+ */
+static void sample_cpu(int64_t now)
+{
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    uint32_t elapsed = (uint32_t)(now - last_sample_us);
+    bool first = last_sample_us == 0;
+    last_sample_us = now;
+
+    taskENTER_CRITICAL(&tasks_lock);
+    int n = task_count;
+    taskEXIT_CRITICAL(&tasks_lock);
+
+    for (int i = 0; i < n; i++) {
+        uint32_t runtime = ulTaskGetRunTimeCounter(tasks[i].handle);
+        if (!first && elapsed > 0) {
+            tasks[i].cpu_percent = (uint8_t)((uint64_t)(runtime - tasks[i].last_runtime) * 100 / elapsed);
+        }
+        tasks[i].last_runtime = runtime;
+    }
+
+    for (int core = 0; core < CORE_COUNT; core++) {
+        uint32_t idle = ulTaskGetRunTimeCounter(xTaskGetIdleTaskHandleForCore(core));
+        if (!first && elapsed > 0) {
+            uint32_t idle_pct = (uint32_t)((uint64_t)(idle - last_idle_runtime[core]) * 100 / elapsed);
+            core_load[core] = idle_pct >= 100 ? 0 : 100 - idle_pct;
+        }
+        last_idle_runtime[core] = idle;
+    }
+#else
+    (void)now;
+#endif
+}
+
+void app_tasks_log_periodic(void)
+{
+    int64_t now = esp_timer_get_time();
+    if (last_log_us == 0) {
+        // 从第一次调用开始计时，第一次只记下计数器
+        last_log_us = now;
+        sample_cpu(now);
+        return;
+    }
+    if (now - last_log_us < (int64_t)APP_TASKS_LOG_INTERVAL_MS * 1000) {
+        return;
+    }
+    last_log_us = now;
+    sample_cpu(now);
+
+    app_task_stats_t stats[APP_TASKS_MAX];
+    int n = app_tasks_get_stats(stats, APP_TASKS_MAX);
+
+    // 每个任务 "名称@核 CPU% 栈余量"，一行打完
+    char line[384] = {0};
+    int len = 0;
+    for (int i = 0; i < n && len < (int)sizeof(line); i++) {
+        len += snprintf(line + len, sizeof(line) - len, " %s@%d %u%% %lu/%lu",
+                        stats[i].name, stats[i].core, stats[i].cpu_percent,
+                        stats[i].stack_free_min, stats[i].stack_size);
+    }
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    ESP_LOGI(TAG, "核负载 %u%%/%u%%，任务 CPU 栈余量/栈:%s", core_load[0], core_load[1], line);
+#else
+    ESP_LOGI(TAG, "任务 CPU(未开启运行时统计) 栈余量/栈:%s", line);
+#endif
+}
+
+int app_tasks_get_stats(app_task_stats_t *out, int max)
+{
+    if (out == NULL) {
+        return 0;
+    }
+
+    taskENTER_CRITICAL(&tasks_lock);
+    int n = task_count < max ? task_count : max;
+    taskEXIT_CRITICAL(&tasks_lock);
+
+    for (int i = 0; i < n; i++) {
+        out[i] = (app_task_stats_t) {
+            .name = tasks[i].name,
+            .core = tasks[i].core,
+            .stack_size = tasks[i].stack_size,
+            .stack_free_min = uxTaskGetStackHighWaterMark(tasks[i].handle),
+            .cpu_percent = tasks[i].cpu_percent,
+        };
+    }
+    return n;
+}
+
+uint8_t app_tasks_get_core_load(int core)
+{
+    return core >= 0 && core < CORE_COUNT ? core_load[core] : 0;
+}
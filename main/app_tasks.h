@@ -0,0 +1,76 @@
+/**
+ * @file app_tasks.h
+ * @brief 任务拓扑与任务统计
+ *
+ * 界面任务（LVGL渲染、触摸、界面逻辑）固定在核1，网络任务（HTTP请求、解析）、
+ * 推送任务和后端探测任务固定在核0，与 WiFi/lwIP 任务同核。
+ * 两边通过 todo_net 的无锁队列交换请求和结果，界面不会被网络请求阻塞。
+ *
+ * 通过 app_tasks_create 创建的任务登记在这里，定期打印各任务的栈余量水位线和CPU占用
+ * （CPU占用需要开启 CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS）。
+ */
+
+#ifndef APP_TASKS_H
+#define APP_TASKS_H
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define APP_UI_CORE                 1
+#define APP_NET_CORE                0       // WiFi/lwIP 默认在核0
+
+#define APP_UI_TASK_STACK_SIZE      8192
+#define APP_UI_TASK_PRIORITY        4
+#define APP_NET_TASK_STACK_SIZE     8192    // mbedTLS 握手 + cJSON
+#define APP_NET_TASK_PRIORITY       3
+
+#define APP_TASKS_MAX               8
+#define APP_TASKS_LOG_INTERVAL_MS   60000
+
+/**
+ * @brief 单个任务的统计
+ */
+typedef struct {
+    const char *name;
+    int core;
+    uint32_t stack_size;
+    uint32_t stack_free_min;    // 栈余量水位线（字节）
+    uint8_t cpu_percent;        // 上一个统计周期内占单核的百分比
+} app_task_stats_t;
+
+/**
+ * @brief 创建固定在指定核上的任务并登记统计
+ * @return ESP_OK 成功, ESP_ERR_NO_MEM 创建失败
+ */
+esp_err_t app_tasks_create(TaskFunction_t fn, const char *name, uint32_t stack_size,
+                           UBaseType_t priority, int core, TaskHandle_t *handle);
+
+/**
+ * @brief 定期打印统计（在网络任务中调用，未到周期时直接返回）
+ */
+void app_tasks_log_periodic(void);
+
+/**
+ * @brief 获取已登记任务的统计（CPU占用为上一个统计周期的值）
+ * @param out 输出数组
+ * @param max 数组长度
+ * @return 写入的任务数
+ */
+int app_tasks_get_stats(app_task_stats_t *out, int max);
+
+/**
+ * @brief 上一个统计周期各核的负载百分比（未开启运行时统计时为0）
+ */
+uint8_t app_tasks_get_core_load(int core);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,243 @@
+/**
+ * @file cbor_reader.c
+ * @brief 精简 CBOR 读取器实现
+ */
+
+#include "cbor_reader.h"
+#include <string.h>
+
+#define CBOR_MAJOR(b)       ((b) >> 5)
+#define CBOR_INFO(b)        ((b) & 0x1F)
+#define CBOR_INFO_INDEF     31
+#define CBOR_BREAK          0xFF
+
+#define CBOR_SIMPLE_FALSE   20
+#define CBOR_SIMPLE_TRUE    21
+#define CBOR_SIMPLE_NULL    22
+
+#define CBOR_MAX_DEPTH      8    // 跳过嵌套内容时的最大深度
+
+#define HEAD_INDEF          UINT64_MAX   // read_head 中表示不定长
+
+void cbor_reader_init(cbor_reader_t *r, const void *data, size_t len)
+{
+    r->p = data;
+    r->end = r->p + len;
+    r->error = false;
+}
+
+static bool fail(cbor_reader_t *r)
+{
+    r->error = true;
+    return false;
+}
+
+/**
+ * @brief 读取数据项头：主类型 + 参数（长度/数值），不定长时 arg 为 HEAD_INDEF
+ */
+static bool read_head(cbor_reader_t *r, uint8_t *major, uint64_t *arg)
+{
+    if (r->error || r->p >= r->end) {
+        return fail(r);
+    }
+
+    uint8_t initial = *r->p++;
+    uint8_t info = CBOR_INFO(initial);
+    *major = CBOR_MAJOR(initial);
+
+    if (info < 24) {
+        *arg = info;
+        return true;
+    }
+    if (info == CBOR_INFO_INDEF) {
+        *arg = HEAD_INDEF;
+        return true;
+    }
+    if (info > 27) {
+        return fail(r);
+    }
+
+    size_t n = (size_t)1 << (info - 24);
+    if ((size_t)(r->end - r->p) < n) {
+        return fail(r);
+    }
+    uint64_t value = 0;
+    for (size_t i = 0; i < n; i++) {
+        value = (value << 8) | *r->p++;
+    }
+    *arg = value;
+    return true;
+}
+
+cbor_type_t cbor_peek_type(const cbor_reader_t *r)
+{
+    if (r->error || r->p >= r->end) {
+        return CBOR_TYPE_END;
+    }
+    if (*r->p == CBOR_BREAK) {
+        return CBOR_TYPE_BREAK;
+    }
+    return (cbor_type_t)CBOR_MAJOR(*r->p);
+}
+
+static bool read_container(cbor_reader_t *r, uint8_t expect, uint32_t *count)
+{
+    uint8_t major;
+    uint64_t arg;
+    if (!read_head(r, &major, &arg) || major != expect) {
+        return fail(r);
+    }
+    if (arg == HEAD_INDEF) {
+        *count = CBOR_INDEFINITE;
+        return true;
+    }
+    if (arg >= CBOR_INDEFINITE) {
+        return fail(r);
+    }
+    *count = (uint32_t)arg;
+    return true;
+}
+
+bool cbor_read_array(cbor_reader_t *r, uint32_t *count)
+{
+    return read_container(r, CBOR_TYPE_ARRAY, count);
+}
+
+bool cbor_read_map(cbor_reader_t *r, uint32_t *count)
+{
+    return read_container(r, CBOR_TYPE_MAP, count);
+}
+
+bool cbor_read_break(cbor_reader_t *r)
+{
+    if (cbor_peek_type(r) == CBOR_TYPE_BREAK) {
+        r->p++;
+        return true;
+    }
+    return false;
+}
+
+bool cbor_container_next(cbor_reader_t *r, uint32_t *remaining)
+{
+    if (r->error) {
+        return false;
+    }
+    if (*remaining == CBOR_INDEFINITE) {
+        if (cbor_read_break(r)) {
+            return false;
+        }
+        // 缺少结束标记说明数据被截断
+        return cbor_peek_type(r) != CBOR_TYPE_END || fail(r);
+    }
+    if (*remaining == 0) {
+        return false;
+    }
+    (*remaining)--;
+    return true;
+}
+
+bool cbor_read_text(cbor_reader_t *r, const char **text, size_t *len)
+{
+    uint8_t major;
+    uint64_t arg;
+    // 不定长（分段）文本串不支持
+    if (!read_head(r, &major, &arg) || major != CBOR_TYPE_TEXT || arg == HEAD_INDEF) {
+        return fail(r);
+    }
+    if ((uint64_t)(r->end - r->p) < arg) {
+        return fail(r);
+    }
+    *text = (const char *)r->p;
+    *len = (size_t)arg;
+    r->p += arg;
+    return true;
+}
+
+bool cbor_read_bool(cbor_reader_t *r, bool *value)
+{
+    uint8_t major;
+    uint64_t arg;
+    if (!read_head(r, &major, &arg) || major != CBOR_TYPE_SIMPLE) {
+        return fail(r);
+    }
+    if (arg == CBOR_SIMPLE_TRUE || arg == CBOR_SIMPLE_FALSE) {
+        *value = arg == CBOR_SIMPLE_TRUE;
+        return true;
+    }
+    return fail(r);
+}
+
+bool cbor_read_uint(cbor_reader_t *r, uint64_t *value)
+{
+    uint8_t major;
+    if (!read_head(r, &major, value) || major != CBOR_TYPE_UINT || *value == HEAD_INDEF) {
+        return fail(r);
+    }
+    return true;
+}
+
+static bool skip_item(cbor_reader_t *r, int depth)
+{
+    if (depth > CBOR_MAX_DEPTH) {
+        return fail(r);
+    }
+
+    uint8_t major;
+    uint64_t arg;
+    if (!read_head(r, &major, &arg)) {
+        return false;
+    }
+
+    switch (major) {
+        case CBOR_TYPE_UINT:
+        case CBOR_TYPE_NEGINT:
+        case CBOR_TYPE_SIMPLE:
+            // 简单值和浮点的参数已在 read_head 中读完
+            return true;
+        case CBOR_TYPE_BYTES:
+        case CBOR_TYPE_TEXT:
+            if (arg == HEAD_INDEF) {
+                while (!cbor_read_break(r)) {
+                    if (cbor_peek_type(r) != (cbor_type_t)major || !skip_item(r, depth + 1)) {
+                        return fail(r);
+                    }
+                }
+                return true;
+            }
+            if ((uint64_t)(r->end - r->p) < arg) {
+                return fail(r);
+            }
+            r->p += arg;
+            return true;
+        case CBOR_TYPE_ARRAY:
+        case CBOR_TYPE_MAP: {
+            if (arg != HEAD_INDEF && arg >= CBOR_INDEFINITE) {
+                return fail(r);
+            }
+            uint32_t remaining = arg == HEAD_INDEF ? CBOR_INDEFINITE : (uint32_t)arg;
+            int per_entry = major == CBOR_TYPE_MAP ? 2 : 1;
+            while (cbor_container_next(r, &remaining)) {
+                for (int i = 0; i < per_entry; i++) {
+                    if (!skip_item(r, depth + 1)) {
+                        return false;
+                    }
+                }
+            }
+            return !r->error;
+        }
+        case CBOR_TYPE_TAG:
+            return skip_item(r, depth + 1);
+        default:
+            return fail(r);
+    }
+}
+
+bool cbor_skip(cbor_reader_t *r)
+{
+    return skip_item(r, 0);
+}
+
+bool cbor_text_equals(const char *text, size_t len, const char *str)
+{
+    return strlen(str) == len && memcmp(text, str, len) == 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file cbor_reader.h
+ * @brief 精简 CBOR (RFC 8949) 读取器
+ *
+ * 按顺序拉取数据项，不建树、不分配内存，文本串直接返回指向输入缓冲区的指针，
+ * 由调用者按键名把值拷进自己的结构。只支持本项目用到的类型：
+ * 无符号/负整数、文本串、字节串（只能跳过）、数组、映射、true/false/null。
+ * 数组和映射支持定长与不定长两种编码。
+ */
+
+#ifndef CBOR_READER_H
+#define CBOR_READER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 不定长数组/映射的元素数
+#define CBOR_INDEFINITE UINT32_MAX
+
+typedef enum {
+    CBOR_TYPE_UINT = 0,
+    CBOR_TYPE_NEGINT,
+    CBOR_TYPE_BYTES,
+    CBOR_TYPE_TEXT,
+    CBOR_TYPE_ARRAY,
+    CBOR_TYPE_MAP,
+    CBOR_TYPE_TAG,
+    CBOR_TYPE_SIMPLE,    // true/false/null/undefined/浮点
+    CBOR_TYPE_BREAK,     // 不定长容器结束
+    CBOR_TYPE_END,       // 输入结束或出错
+} cbor_type_t;
+
+typedef struct {
+    const uint8_t *p;
+    const uint8_t *end;
+    bool error;
+} cbor_reader_t;
+
+void cbor_reader_init(cbor_reader_t *r, const void *data, size_t len);
+
+/**
+ * @brief 查看下一个数据项的类型（不消耗）
+ */
+cbor_type_t cbor_peek_type(const cbor_reader_t *r);
+
+/**
+ * @brief 读取数组/映射头
+ * @param count 元素数（映射为键值对数），不定长时为 CBOR_INDEFINITE
+ */
+bool cbor_read_array(cbor_reader_t *r, uint32_t *count);
+bool cbor_read_map(cbor_reader_t *r, uint32_t *count);
+
+/**
+ * @brief 不定长容器：下一个是结束标记时消耗它并返回true
+ */
+bool cbor_read_break(cbor_reader_t *r);
+
+/**
+ * @brief 读取定长文本串（零拷贝，不以'\0'结尾）
+ */
+bool cbor_read_text(cbor_reader_t *r, const char **text, size_t *len);
+
+bool cbor_read_bool(cbor_reader_t *r, bool *value);
+bool cbor_read_uint(cbor_reader_t *r, uint64_t *value);
+
+/**
+ * @brief 跳过一个完整数据项（含嵌套内容）
+ */
+bool cbor_skip(cbor_reader_t *r);
+
+/**
+ * @brief 容器还有下一个元素吗（定长时递减 remaining）
+ *
+ * 用法：for (uint32_t n = count; cbor_container_next(r, &n); ) { ... }
+ */
+bool cbor_container_next(cbor_reader_t *r, uint32_t *remaining);
+
+/**
+ * @brief 文本串与C字符串比较
+ */
+bool cbor_text_equals(const char *text, size_t len, const char *str);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
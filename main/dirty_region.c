@@ -0,0 +1,238 @@
+/**
+ * @file dirty_region.c
+ * @brief 脏区合并与重绘热力图实现
+ */
+
+#include "dirty_region.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+
+static const char *TAG = "dirty_region";
+
+#define HEAT_CELL_SHIFT     3        // 热力图按 8x8 像素分格
+#define HEAT_MAX_COLS       (320 >> HEAT_CELL_SHIFT)
+#define HEAT_MAX_ROWS       (320 >> HEAT_CELL_SHIFT)
+#define HEAT_DECAY_MS       100
+#define HEAT_DECAY_STEP     26       // 约 1 秒从最热褪到无
+#define HEAT_LEVEL_SHIFT    5        // 8 级深浅，级别变化时才重绘该格
+#define HEAT_OPA_PER_LEVEL  16
+
+static dirty_region_stats_t stats;
+static int64_t last_log_us = 0;
+
+#if CONFIG_TODO_DIRTY_HEATMAP
+static uint8_t heat[HEAT_MAX_ROWS][HEAT_MAX_COLS];
+static int heat_cols = 0;
+static int heat_rows = 0;
+static int64_t last_decay_us = 0;
+#endif
+
+static int32_t area_cost(const lv_area_t *a)
+{
+    return (int32_t)lv_area_get_size(a) + DIRTY_AREA_OVERHEAD_PX;
+}
+
+/**
+ * @brief 按屏幕裁剪后，反复合并节省最多的一对区域，直到任何一对合并都不再划算；
+ *        剩下的区域总代价不低于整屏时改为整屏重绘
+ */
+static void coalesce(lv_disp_t *disp)
+{
+    lv_area_t *areas = disp->inv_areas;
+    lv_area_t screen = {0, 0, lv_disp_get_hor_res(disp) - 1, lv_disp_get_ver_res(disp) - 1};
+    int n = 0;
+
+    // 代价只算屏幕内的像素，完全在屏幕外的区域丢掉
+    for (int i = 0; i < disp->inv_p; i++) {
+        if (_lv_area_intersect(&areas[n], &areas[i], &screen)) {
+            n++;
+        }
+    }
+
+    while (n > 1) {
+        int32_t best_saving = 0;
+        int best_i = -1;
+        int best_j = -1;
+        lv_area_t best_union;
+
+        for (int i = 0; i < n; i++) {
+            int32_t cost_i = area_cost(&areas[i]);
+            for (int j = i + 1; j < n; j++) {
+                lv_area_t u;
+                _lv_area_join(&u, &areas[i], &areas[j]);
+                int32_t saving = cost_i + area_cost(&areas[j]) - area_cost(&u);
+                if (saving > best_saving) {
+                    best_saving = saving;
+                    best_i = i;
+                    best_j = j;
+                    best_union = u;
+                }
+            }
+        }
+
+        if (best_i < 0) {
+            break;
+        }
+        areas[best_i] = best_union;
+        areas[best_j] = areas[--n];
+        stats.merges++;
+        stats.saved_cost_px += best_saving;
+    }
+
+    // 几块区域拼起来铺满大半屏时（如翻页），任何两块的外接矩形都不划算，但加上每块的固定开销
+    // 和相互重叠，总代价可能超过整屏一次重绘
+    int32_t total = 0;
+    for (int i = 0; i < n; i++) {
+        total += area_cost(&areas[i]);
+    }
+    if (n > 1 && total >= area_cost(&screen)) {
+        areas[0] = screen;
+        n = 1;
+        stats.full_screen++;
+        stats.saved_cost_px += total - area_cost(&screen);
+    }
+
+    disp->inv_p = n;
+}
+
+#if CONFIG_TODO_DIRTY_HEATMAP
+static void heat_mark(const lv_area_t *a)
+{
+    int c1 = LV_MAX(a->x1, 0) >> HEAT_CELL_SHIFT;
+    int c2 = LV_MIN(a->x2 >> HEAT_CELL_SHIFT, heat_cols - 1);
+    int r1 = LV_MAX(a->y1, 0) >> HEAT_CELL_SHIFT;
+    int r2 = LV_MIN(a->y2 >> HEAT_CELL_SHIFT, heat_rows - 1);
+
+    for (int r = r1; r <= r2; r++) {
+        for (int c = c1; c <= c2; c++) {
+            heat[r][c] = 255;
+        }
+    }
+}
+
+/**
+ * @brief 热度衰减，深浅级别变化的格子按行合并后重新失效，让覆盖层褪色
+ */
+static void heat_decay(lv_disp_t *disp, int64_t now)
+{
+    if (now - last_decay_us < HEAT_DECAY_MS * 1000) {
+        return;
+    }
+    last_decay_us = now;
+
+    for (int r = 0; r < heat_rows; r++) {
+        int run_start = -1;
+        for (int c = 0; c <= heat_cols; c++) {
+            bool changed = false;
+            if (c < heat_cols && heat[r][c] > 0) {
+                uint8_t before = heat[r][c];
+                heat[r][c] = before > HEAT_DECAY_STEP ? before - HEAT_DECAY_STEP : 0;
+                changed = (before >> HEAT_LEVEL_SHIFT) != (heat[r][c] >> HEAT_LEVEL_SHIFT);
+            }
+            if (changed && run_start < 0) {
+                run_start = c;
+            } else if (!changed && run_start >= 0) {
+                lv_area_t a = {
+                    .x1 = run_start << HEAT_CELL_SHIFT,
+                    .y1 = r << HEAT_CELL_SHIFT,
+                    .x2 = (c << HEAT_CELL_SHIFT) - 1,
+                    .y2 = ((r + 1) << HEAT_CELL_SHIFT) - 1,
+                };
+                _lv_inv_area(disp, &a);
+                run_start = -1;
+            }
+        }
+    }
+}
+
+static void heat_tint(const lv_area_t *area, lv_color_t *color_map)
+{
+    lv_color_t red = lv_palette_main(LV_PALETTE_RED);
+    int w = lv_area_get_width(area);
+
+    for (int y = area->y1; y <= area->y2; y++) {
+        const uint8_t *row = heat[y >> HEAT_CELL_SHIFT];
+        lv_color_t *px = color_map + (y - area->y1) * w;
+        for (int x = area->x1; x <= area->x2; x++, px++) {
+            uint8_t level = row[x >> HEAT_CELL_SHIFT] >> HEAT_LEVEL_SHIFT;
+            if (level > 0) {
+                *px = lv_color_mix(red, *px, level * HEAT_OPA_PER_LEVEL);
+            }
+        }
+    }
+}
+#endif
+
+static void log_periodic(int64_t now)
+{
+    if (now - last_log_us < (int64_t)DIRTY_REGION_LOG_INTERVAL_MS * 1000 || stats.frames == 0) {
+        return;
+    }
+    last_log_us = now;
+
+    uint32_t areas_x10 = stats.flushed_areas * 10 / stats.frames;
+    ESP_LOGI(TAG, "每帧 %lu 像素 / %lu.%lu 块, 失效区域 %lu -> %lu, 合并 %lu 次, 整屏 %lu 次, 节省 %llu 像素当量",
+             (uint32_t)(stats.flushed_px / stats.frames), areas_x10 / 10, areas_x10 % 10,
+             stats.inv_areas, stats.coalesced_areas, stats.merges, stats.full_screen, stats.saved_cost_px);
+}
+
+static void refr_timer_cb(lv_timer_t *timer)
+{
+    lv_disp_t *disp = (lv_disp_t *)timer->user_data;
+    int64_t now = esp_timer_get_time();
+
+    stats.inv_areas += disp->inv_p;
+#if CONFIG_TODO_DIRTY_HEATMAP
+    // 先用本次的失效区域（不含上次褪色产生的，那些已在上次刷新中处理）加热，再衰减
+    for (int i = 0; i < disp->inv_p; i++) {
+        heat_mark(&disp->inv_areas[i]);
+    }
+    heat_decay(disp, now);
+#endif
+#if CONFIG_TODO_DIRTY_COALESCE
+    coalesce(disp);
+#endif
+    stats.coalesced_areas += disp->inv_p;
+
+    _lv_disp_refr_timer(timer);
+    stats.refr_us += esp_timer_get_time() - now;
+    log_periodic(now);
+}
+
+void dirty_region_init(lv_disp_t *disp)
+{
+    lv_timer_set_cb(disp->refr_timer, refr_timer_cb);
+    last_log_us = esp_timer_get_time();
+
+#if CONFIG_TODO_DIRTY_HEATMAP
+    heat_cols = LV_MIN((lv_disp_get_hor_res(disp) + (1 << HEAT_CELL_SHIFT) - 1) >> HEAT_CELL_SHIFT, HEAT_MAX_COLS);
+    heat_rows = LV_MIN((lv_disp_get_ver_res(disp) + (1 << HEAT_CELL_SHIFT) - 1) >> HEAT_CELL_SHIFT, HEAT_MAX_ROWS);
+    ESP_LOGW(TAG, "重绘热力图已开启");
+#endif
+}
+
+void dirty_region_on_flush(const lv_area_t *area, lv_color_t *color_map, bool frame_end)
+{
+    stats.flushed_px += lv_area_get_size(area);
+    stats.flushed_areas++;
+    if (frame_end) {
+        stats.frames++;
+    }
+
+#if CONFIG_TODO_DIRTY_HEATMAP
+    if (color_map != NULL) {
+        heat_tint(area, color_map);
+    }
+#else
+    (void)color_map;
+#endif
+}
+
+void dirty_region_get_stats(dirty_region_stats_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+    *out = stats;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file dirty_region.h
+ * @brief 脏区合并与重绘热力图
+ *
+ * 每次刷新前按代价合并LVGL记录的失效区域：每块区域除了像素本身，还有一份固定开销
+ * （遍历对象树、设置窗口、一次DMA传输和回调），两块合并后的外接矩形代价更低就合并；
+ * 合并完剩下的区域总代价不低于整屏时，改为整屏重绘一次。
+ * 送屏时累计每帧的像素数和区域数，可以看出每个界面操作实际重绘了多少。
+ *
+ * 开启 CONFIG_TODO_DIRTY_HEATMAP 后，重绘过的区域叠加一层红色，并在约一秒内逐渐褪去，
+ * 用于排查不必要的重绘（仅分块渲染模式）。
+ *
+ * 所有函数在LVGL任务中调用，不加锁。
+ */
+
+#ifndef DIRTY_REGION_H
+#define DIRTY_REGION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DIRTY_AREA_OVERHEAD_PX     512     // 每块区域的固定开销，折算成像素
+#define DIRTY_REGION_LOG_INTERVAL_MS 60000
+
+/**
+ * @brief 统计（自启动以来的累计值）
+ */
+typedef struct {
+    uint32_t frames;            // 送屏的帧数
+    uint64_t flushed_px;        // 送屏的像素
+    uint32_t flushed_areas;     // 送屏的区域（分块渲染时一块区域可能分几次送）
+    uint32_t inv_areas;         // 合并前的失效区域
+    uint32_t coalesced_areas;   // 合并后的失效区域
+    uint32_t merges;            // 合并次数
+    uint32_t full_screen;       // 改为整屏重绘的次数
+    uint64_t saved_cost_px;     // 合并节省的代价（像素当量，含固定开销）
+    uint64_t refr_us;           // 刷新定时器中的累计耗时（渲染和等待送屏）
+} dirty_region_stats_t;
+
+/**
+ * @brief 接管显示刷新定时器，在每次刷新前合并失效区域（在显示注册之后调用）
+ */
+void dirty_region_init(lv_disp_t *disp);
+
+/**
+ * @brief 在 flush 回调中送屏前调用
+ * @param area 本次送屏的区域
+ * @param color_map 区域像素，开启热力图时在其上叠加颜色；为 NULL 时只统计
+ * @param frame_end 是否为本帧最后一次送屏
+ */
+void dirty_region_on_flush(const lv_area_t *area, lv_color_t *color_map, bool frame_end);
+
+/**
+ * @brief 获取统计
+ */
+void dirty_region_get_stats(dirty_region_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,236 @@
+/**
+ * @file display_power.c
+ * @brief 显示电源管理实现
+ */
+
+#include "display_power.h"
+#include "dirty_region.h"
+#include "driver/ledc.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lvgl.h"
+#include "sdkconfig.h"
+
+static const char *TAG = "display_power";
+
+#define BL_SPEED_MODE       LEDC_LOW_SPEED_MODE
+#define BL_TIMER            LEDC_TIMER_0
+#define BL_CHANNEL          LEDC_CHANNEL_0
+#define BL_DUTY_FULL        255
+#define BL_DUTY_DIM         40
+
+#define FADE_ON_MS          150     // 唤醒要快
+#define FADE_DIM_MS         1000
+#define FADE_OFF_MS         1000
+
+#define DIM_AFTER_MS        (CONFIG_TODO_DISPLAY_DIM_SEC * 1000U)
+#define OFF_AFTER_MS        (CONFIG_TODO_DISPLAY_OFF_SEC * 1000U)
+
+static display_power_state_t state = DISPLAY_POWER_OFF;
+static bool started = false;
+static bool wake_requested = false;
+static bool swallowing = false;
+
+static display_power_stats_t stats;
+static int64_t state_since_us = 0;
+static int64_t last_skip_check_us = 0;
+
+static void fade_to(uint32_t duty, int ms)
+{
+    esp_err_t err = ledc_set_fade_time_and_start(BL_SPEED_MODE, BL_CHANNEL, duty, ms, LEDC_FADE_NO_WAIT);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "背光渐变失败: %s", esp_err_to_name(err));
+    }
+}
+
+static void account_state_time(int64_t now)
+{
+    if (!started) {
+        return;
+    }
+    uint32_t s = (uint32_t)((now - state_since_us) / 1000000);
+    state_since_us += (int64_t)s * 1000000;
+    switch (state) {
+        case DISPLAY_POWER_ON:
+            stats.on_s += s;
+            break;
+        case DISPLAY_POWER_DIM:
+            stats.dim_s += s;
+            break;
+        default:
+            stats.off_s += s;
+            break;
+    }
+}
+
+static void set_state(display_power_state_t next)
+{
+    account_state_time(esp_timer_get_time());
+    state = next;
+}
+
+esp_err_t display_power_init(int backlight_gpio)
+{
+    ledc_timer_config_t ledc_timer = {
+        .speed_mode       = BL_SPEED_MODE,
+        .timer_num        = BL_TIMER,
+        .duty_resolution  = LEDC_TIMER_8_BIT,
+        .freq_hz          = 5000,
+        .clk_cfg          = LEDC_AUTO_CLK
+    };
+    ESP_ERROR_CHECK(ledc_timer_config(&ledc_timer));
+
+    ledc_channel_config_t ledc_channel = {
+        .speed_mode     = BL_SPEED_MODE,
+        .channel        = BL_CHANNEL,
+        .timer_sel      = BL_TIMER,
+        .intr_type      = LEDC_INTR_DISABLE,
+        .gpio_num       = backlight_gpio,
+        .duty           = 0,
+        .hpoint         = 0
+    };
+    ESP_ERROR_CHECK(ledc_channel_config(&ledc_channel));
+
+    return ledc_fade_func_install(0);
+}
+
+void display_power_on(void)
+{
+    state_since_us = esp_timer_get_time();
+    state = DISPLAY_POWER_ON;
+    started = true;
+    lv_disp_trig_activity(NULL);
+    fade_to(BL_DUTY_FULL, FADE_ON_MS);
+}
+
+static void go_dark(lv_disp_t *disp)
+{
+    set_state(DISPLAY_POWER_OFF);
+    fade_to(0, FADE_OFF_MS);
+    // 渐灭期间画面不再变化，无需刷新
+    lv_timer_pause(disp->refr_timer);
+    last_skip_check_us = esp_timer_get_time();
+    ESP_LOGI(TAG, "关闭背光，暂停刷新");
+}
+
+/**
+ * @brief 黑屏期间每个刷新周期检查一次：有失效区域时 LVGL 本会刷新，记为跳过一次，
+ *        区域丢掉（唤醒时整屏重绘），下个周期只看新的变化
+ */
+static void skip_refresh(lv_disp_t *disp)
+{
+    int64_t now = esp_timer_get_time();
+    if (now - last_skip_check_us < (int64_t)disp->refr_timer->period * 1000) {
+        return;
+    }
+    last_skip_check_us = now;
+    if (disp->inv_p == 0) {
+        return;
+    }
+    for (int i = 0; i < disp->inv_p; i++) {
+        stats.skipped_px += lv_area_get_size(&disp->inv_areas[i]);
+    }
+    stats.flushes_avoided++;
+    disp->inv_p = 0;
+}
+
+static void wake(lv_disp_t *disp)
+{
+    set_state(DISPLAY_POWER_ON);
+    stats.wakeups++;
+    lv_timer_resume(disp->refr_timer);
+
+    // 黑屏期间积累的失效区域不完整（可能已溢出），整屏刷一次再亮屏
+    lv_area_t full = {
+        .x1 = 0,
+        .y1 = 0,
+        .x2 = lv_disp_get_hor_res(disp) - 1,
+        .y2 = lv_disp_get_ver_res(disp) - 1,
+    };
+    _lv_inv_area(disp, &full);
+    // 交给刷新定时器在下一次 lv_timer_handler 中执行，照常经过脏区合并和统计；
+    // 背光从0渐亮，晚一个循环送屏看不出来
+    lv_timer_ready(disp->refr_timer);
+
+    fade_to(BL_DUTY_FULL, FADE_ON_MS);
+    ESP_LOGI(TAG, "唤醒，黑屏期间共跳过 %lu 次刷新", stats.flushes_avoided);
+}
+
+void display_power_process(void)
+{
+    if (!started) {
+        return;
+    }
+
+    lv_disp_t *disp = lv_disp_get_default();
+    if (wake_requested) {
+        wake_requested = false;
+        if (state == DISPLAY_POWER_OFF) {
+            wake(disp);
+            return;
+        }
+    }
+
+    uint32_t inactive_ms = lv_disp_get_inactive_time(disp);
+    switch (state) {
+        case DISPLAY_POWER_ON:
+            if (CONFIG_TODO_DISPLAY_DIM_SEC > 0 && inactive_ms >= DIM_AFTER_MS) {
+                set_state(DISPLAY_POWER_DIM);
+                fade_to(BL_DUTY_DIM, FADE_DIM_MS);
+            } else if (CONFIG_TODO_DISPLAY_OFF_SEC > 0 && inactive_ms >= OFF_AFTER_MS) {
+                go_dark(disp);
+            }
+            break;
+        case DISPLAY_POWER_DIM:
+            if (inactive_ms < DIM_AFTER_MS) {
+                // 暗屏时的触摸照常交给LVGL，同时恢复亮度
+                set_state(DISPLAY_POWER_ON);
+                fade_to(BL_DUTY_FULL, FADE_ON_MS);
+            } else if (CONFIG_TODO_DISPLAY_OFF_SEC > 0 && inactive_ms >= OFF_AFTER_MS) {
+                go_dark(disp);
+            }
+            break;
+        default:
+            skip_refresh(disp);
+            break;
+    }
+}
+
+bool display_power_filter_touch(bool pressed)
+{
+    if (!pressed) {
+        swallowing = false;
+        return false;
+    }
+    if (state == DISPLAY_POWER_OFF && started) {
+        if (!swallowing) {
+            wake_requested = true;
+            lv_disp_trig_activity(NULL);
+        }
+        swallowing = true;
+    }
+    return !swallowing;
+}
+
+display_power_state_t display_power_get_state(void)
+{
+    return state;
+}
+
+void display_power_get_stats(display_power_stats_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+    account_state_time(esp_timer_get_time());
+    *out = stats;
+    out->state = state;
+
+    // 亮屏时每像素的平均刷新耗时（皮秒，避免整数精度不够）乘以跳过的像素
+    dirty_region_stats_t refr;
+    dirty_region_get_stats(&refr);
+    if (refr.flushed_px > 0) {
+        uint64_t ps_per_px = refr.refr_us * 1000000 / refr.flushed_px;
+        out->cpu_saved_ms = (uint32_t)(stats.skipped_px * ps_per_px / 1000000000);
+    }
+}
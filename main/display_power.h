@@ -0,0 +1,85 @@
+/**
+ * @file display_power.h
+ * @brief 显示电源管理
+ *
+ * 无操作一段时间后背光渐暗，再过一段时间背光渐灭并暂停LVGL显示刷新，
+ * 黑屏期间时钟和列表的变化不渲染也不送屏：每个刷新周期检查一次，有失效区域就记为跳过一次刷新，
+ * 区域直接丢掉（唤醒时整屏重绘）。节省的CPU时间按亮屏时每像素的平均刷新耗时（dirty_region 统计）估算。
+ * 触摸中断唤醒后先整屏刷新一次，让面板显存与当前界面一致，再渐亮背光；
+ * 唤醒的那次按压被吞掉，不会误触发点击。背光渐变使用原有的 LEDC 通道。
+ *
+ * 所有函数都在主循环（LVGL）任务中调用，不加锁。
+ */
+
+#ifndef DISPLAY_POWER_H
+#define DISPLAY_POWER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 显示电源状态
+ */
+typedef enum {
+    DISPLAY_POWER_ON = 0,
+    DISPLAY_POWER_DIM,
+    DISPLAY_POWER_OFF,      // 背光关闭，显示刷新暂停
+} display_power_state_t;
+
+/**
+ * @brief 统计（自启动以来）
+ */
+typedef struct {
+    display_power_state_t state;
+    uint32_t on_s;          // 各状态累计时间
+    uint32_t dim_s;
+    uint32_t off_s;
+    uint32_t wakeups;       // 从黑屏唤醒的次数
+    uint32_t flushes_avoided;   // 黑屏期间跳过的刷新（有失效区域的刷新周期）
+    uint64_t skipped_px;        // 跳过的刷新中的失效像素
+    uint32_t cpu_saved_ms;      // 估算节省的刷新耗时
+} display_power_stats_t;
+
+/**
+ * @brief 配置背光 LEDC 通道（背光保持关闭）
+ * @param backlight_gpio 背光引脚
+ */
+esp_err_t display_power_init(int backlight_gpio);
+
+/**
+ * @brief 第一帧渲染完成后调用，渐亮背光并开始计时
+ */
+void display_power_on(void);
+
+/**
+ * @brief 在主循环中调用：按无操作时间调暗/关闭，处理唤醒
+ */
+void display_power_process(void);
+
+/**
+ * @brief 触摸读取回调中调用：黑屏时的按压用于唤醒并被吞掉，直到松手
+ * @param pressed 触摸是否按下
+ * @return 是否把按压交给LVGL
+ */
+bool display_power_filter_touch(bool pressed);
+
+/**
+ * @brief 当前状态
+ */
+display_power_state_t display_power_get_state(void);
+
+/**
+ * @brief 获取统计
+ */
+void display_power_get_stats(display_power_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,204 @@
+/**
+ * @file draw_blend.c
+ * @brief RGB565 纯色填充/混合内核实现
+ *
+ * 要求 LV_COLOR_DEPTH 16、LV_COLOR_16_SWAP 0、LV_COLOR_MIX_ROUND_OFS 0（在 sdkconfig.defaults 中固定，
+ * LVGL 由 Kconfig 配置，lv_conf.h 不参与编译），
+ * 逐位一致是相对于这组配置下 LVGL 8.3 的 fill_normal 而言的。
+ */
+
+#include "draw_blend.h"
+#include <stdint.h>
+
+#if LV_COLOR_DEPTH != 16 || LV_COLOR_16_SWAP != 0 || LV_COLOR_MIX_ROUND_OFS != 0
+#error "draw_blend 只支持 RGB565（不交换字节、向下取整混合）"
+#endif
+
+/**
+ * @brief 两个 16 位字段同时除以 255（向下取整），每个字段须小于 65535
+ *
+ * floor(x / 255) == (x + 1 + (x >> 8)) >> 8 在 x < 65535 时成立，与 LV_UDIV255 结果相同。
+ */
+static inline uint32_t div255_x2(uint32_t x)
+{
+    return ((x + 0x00010001 + ((x >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+}
+
+static inline uint32_t div255(uint32_t x)
+{
+    return (x + 1 + (x >> 8)) >> 8;
+}
+
+// R 放在高 16 位、B 放在低 16 位，乘 8 位系数后互不进位
+static inline uint32_t unpack_rb(uint16_t c)
+{
+    return ((uint32_t)(c >> 11) << 16) | (c & 0x1F);
+}
+
+static inline uint16_t pack_rbg(uint32_t rb, uint32_t g)
+{
+    return (uint16_t)(((rb >> 5) & 0xF800) | (g << 5) | (rb & 0x1F));
+}
+
+static void LV_ATTRIBUTE_FAST_MEM fill_cover(lv_color_t *dest, lv_coord_t stride, int w, int h, lv_color_t color)
+{
+    uint32_t c32 = (uint32_t)color.full | ((uint32_t)color.full << 16);
+
+    for (int y = 0; y < h; y++) {
+        uint16_t *d = (uint16_t *)dest;
+        int n = w;
+        if (((uintptr_t)d & 3) && n > 0) {
+            *d++ = color.full;
+            n--;
+        }
+        uint32_t *d32 = (uint32_t *)d;
+        for (; n >= 8; n -= 8) {
+            d32[0] = c32;
+            d32[1] = c32;
+            d32[2] = c32;
+            d32[3] = c32;
+            d32 += 4;
+        }
+        for (; n >= 2; n -= 2) {
+            *d32++ = c32;
+        }
+        if (n > 0) {
+            *(uint16_t *)d32 = color.full;
+        }
+        dest += stride;
+    }
+}
+
+static void LV_ATTRIBUTE_FAST_MEM fill_opa(lv_color_t *dest, lv_coord_t stride, int w, int h,
+                                           lv_color_t color, lv_opa_t opa)
+{
+    uint32_t opa_inv = 255 - opa;
+    uint32_t pre_rb = unpack_rb(color.full) * opa;
+    uint32_t pre_g = ((color.full >> 5) & 0x3F) * opa;
+
+    // 背景多为大片同色，只在背景色变化时重新计算。
+    // 缓存初值与 LVGL 相同：纯黑背景取 lv_color_mix 的结果
+    uint16_t last_dest = 0;
+    uint16_t last_res = lv_color_mix(color, lv_color_black(), opa).full;
+
+    for (int y = 0; y < h; y++) {
+        uint16_t *d = (uint16_t *)dest;
+        for (int x = 0; x < w; x++) {
+            uint16_t c = d[x];
+            if (c != last_dest) {
+                last_dest = c;
+                uint32_t rb = div255_x2(pre_rb + unpack_rb(c) * opa_inv);
+                uint32_t g = div255(pre_g + ((c >> 5) & 0x3F) * opa_inv);
+                last_res = pack_rbg(rb, g);
+            }
+            d[x] = last_res;
+        }
+        dest += stride;
+    }
+}
+
+static inline void mask_px(lv_color_t *d, lv_color_t color, lv_opa_t m)
+{
+    if (m == LV_OPA_COVER) {
+        *d = color;
+    } else if (m != LV_OPA_TRANSP) {
+        *d = lv_color_mix(color, *d, m);
+    }
+}
+
+static void LV_ATTRIBUTE_FAST_MEM fill_mask(lv_color_t *dest, lv_coord_t stride, int w, int h,
+                                            lv_color_t color, lv_opa_t opa,
+                                            const lv_opa_t *mask, lv_coord_t mask_stride)
+{
+    for (int y = 0; y < h; y++) {
+        int x = 0;
+        if (opa >= LV_OPA_MAX) {
+            for (; x < w && ((uintptr_t)(mask + x) & 3); x++) {
+                mask_px(&dest[x], color, mask[x]);
+            }
+            // 文字和圆角遮罩大部分是整段全透明或全覆盖
+            for (; x + 4 <= w; x += 4) {
+                uint32_t m32 = *(const uint32_t *)(mask + x);
+                if (m32 == 0) {
+                    continue;
+                }
+                if (m32 == 0xFFFFFFFF) {
+                    dest[x] = color;
+                    dest[x + 1] = color;
+                    dest[x + 2] = color;
+                    dest[x + 3] = color;
+                    continue;
+                }
+                mask_px(&dest[x], color, mask[x]);
+                mask_px(&dest[x + 1], color, mask[x + 1]);
+                mask_px(&dest[x + 2], color, mask[x + 2]);
+                mask_px(&dest[x + 3], color, mask[x + 3]);
+            }
+            for (; x < w; x++) {
+                mask_px(&dest[x], color, mask[x]);
+            }
+        } else {
+            for (; x < w; x++) {
+                lv_opa_t m = mask[x];
+                if (m != LV_OPA_TRANSP) {
+                    lv_opa_t mix = m == LV_OPA_COVER ? opa : (lv_opa_t)(((uint32_t)m * opa) >> 8);
+                    dest[x] = lv_color_mix(color, dest[x], mix);
+                }
+            }
+        }
+        dest += stride;
+        mask += mask_stride;
+    }
+}
+
+static void LV_ATTRIBUTE_FAST_MEM blend_cb(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc)
+{
+    lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+    if (dsc->src_buf != NULL || dsc->blend_mode != LV_BLEND_MODE_NORMAL ||
+        disp->driver->set_px_cb != NULL || disp->driver->screen_transp) {
+        lv_draw_sw_blend_basic(draw_ctx, dsc);
+        return;
+    }
+
+    const lv_opa_t *mask = dsc->mask_buf;
+    if (mask != NULL && dsc->mask_res == LV_DRAW_MASK_RES_TRANSP) {
+        return;
+    }
+    if (dsc->mask_res == LV_DRAW_MASK_RES_FULL_COVER) {
+        mask = NULL;
+    }
+
+    lv_area_t area;
+    if (!_lv_area_intersect(&area, dsc->blend_area, draw_ctx->clip_area)) {
+        return;
+    }
+
+    lv_coord_t dest_stride = lv_area_get_width(draw_ctx->buf_area);
+    lv_color_t *dest = (lv_color_t *)draw_ctx->buf + dest_stride * (area.y1 - draw_ctx->buf_area->y1) +
+                       (area.x1 - draw_ctx->buf_area->x1);
+    int w = lv_area_get_width(&area);
+    int h = lv_area_get_height(&area);
+
+    if (mask != NULL) {
+        lv_coord_t mask_stride = lv_area_get_width(dsc->mask_area);
+        mask += mask_stride * (area.y1 - dsc->mask_area->y1) + (area.x1 - dsc->mask_area->x1);
+        fill_mask(dest, dest_stride, w, h, dsc->color, dsc->opa, mask, mask_stride);
+    } else if (dsc->opa >= LV_OPA_MAX) {
+        fill_cover(dest, dest_stride, w, h, dsc->color);
+    } else {
+        fill_opa(dest, dest_stride, w, h, dsc->color, dsc->opa);
+    }
+}
+
+static void draw_ctx_init(lv_disp_drv_t *drv, lv_draw_ctx_t *draw_ctx)
+{
+    lv_draw_sw_init_ctx(drv, draw_ctx);
+    ((lv_draw_sw_ctx_t *)draw_ctx)->blend = blend_cb;
+}
+
+void draw_blend_attach(lv_disp_drv_t *drv)
+{
+    drv->draw_ctx_init = draw_ctx_init;
+    drv->draw_ctx_deinit = lv_draw_sw_deinit_ctx;
+    drv->draw_ctx_size = sizeof(lv_draw_sw_ctx_t);
+}
@@ -0,0 +1,31 @@
+/**
+ * @file draw_blend.h
+ * @brief RGB565 纯色填充/混合内核
+ *
+ * LVGL 的纯色绘制（卡片背景、边框、详情弹窗的半透明遮罩、圆角抗锯齿边缘、文字）
+ * 最后都落到软件渲染的 blend 回调里做填充。这里替换该回调，按三种情况处理：
+ * - 不透明填充：按 32 位一次写两个像素；
+ * - 半透明填充：R/B 两个通道放进同一个 32 位字一起乘，除以 255 用移位加法代替乘法；
+ * - 带遮罩（文字、抗锯齿边缘）：每次读 4 个遮罩字节，全透明整组跳过、全不透明整组写入。
+ * 结果与 LVGL 自带实现逐位一致；贴图和非普通混合模式仍交给 lv_draw_sw_blend_basic。
+ */
+
+#ifndef DRAW_BLEND_H
+#define DRAW_BLEND_H
+
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 让显示驱动使用本模块的 blend 回调（在 lv_disp_drv_init 之后、注册之前调用）
+ */
+void draw_blend_attach(lv_disp_drv_t *drv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,240 @@
+/**
+ * @file gzip_stream.c
+ * @brief gzip 流式解压实现
+ *
+ * gzip 头和尾可能被拆在任意两块数据之间，用一个小状态机逐字节处理；
+ * 中间的 deflate 数据交给 tinfl，靠 TINFL_FLAG_HAS_MORE_INPUT 跨块续解。
+ */
+
+#include "gzip_stream.h"
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "mem_tag.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "rom/miniz.h"
+
+static const char *TAG = "gzip_stream";
+
+#define GZIP_ID1        0x1F
+#define GZIP_ID2        0x8B
+#define GZIP_CM_DEFLATE 8
+
+#define GZIP_FHCRC      0x02
+#define GZIP_FEXTRA     0x04
+#define GZIP_FNAME      0x08
+#define GZIP_FCOMMENT   0x10
+
+#define GZIP_HEADER_LEN  10
+#define GZIP_TRAILER_LEN 8
+
+typedef enum {
+    GZ_STATE_HEADER = 0,    // 固定10字节头
+    GZ_STATE_EXTRA_LEN,     // FEXTRA 长度（2字节）
+    GZ_STATE_EXTRA,         // FEXTRA 数据
+    GZ_STATE_NAME,          // 以'\0'结尾的文件名
+    GZ_STATE_COMMENT,       // 以'\0'结尾的注释
+    GZ_STATE_HCRC,          // 头部CRC16（2字节）
+    GZ_STATE_DEFLATE,
+    GZ_STATE_TRAILER,       // CRC32 + ISIZE
+    GZ_STATE_DONE,
+    GZ_STATE_ERROR,
+} gz_state_t;
+
+struct gzip_stream {
+    tinfl_decompressor inflator;
+    gz_state_t state;
+    uint8_t flags;
+    uint8_t hdr[GZIP_HEADER_LEN];   // 固定头 / 尾部暂存
+    size_t hdr_pos;
+    size_t skip;                    // FEXTRA 剩余字节
+    char *out;
+    size_t out_size;
+    size_t out_pos;
+    size_t compressed_len;
+};
+
+/**
+ * @brief 固定头之后，进入下一个可选字段或 deflate 数据
+ */
+static void next_header_state(gzip_stream_t *gz)
+{
+    if (gz->state < GZ_STATE_EXTRA_LEN && (gz->flags & GZIP_FEXTRA)) {
+        gz->state = GZ_STATE_EXTRA_LEN;
+    } else if (gz->state < GZ_STATE_NAME && (gz->flags & GZIP_FNAME)) {
+        gz->state = GZ_STATE_NAME;
+    } else if (gz->state < GZ_STATE_COMMENT && (gz->flags & GZIP_FCOMMENT)) {
+        gz->state = GZ_STATE_COMMENT;
+    } else if (gz->state < GZ_STATE_HCRC && (gz->flags & GZIP_FHCRC)) {
+        gz->state = GZ_STATE_HCRC;
+    } else {
+        gz->state = GZ_STATE_DEFLATE;
+    }
+    gz->hdr_pos = 0;
+}
+
+/**
+ * @brief 处理头部字节，返回消耗的字节数
+ */
+static size_t parse_header(gzip_stream_t *gz, const uint8_t *data, size_t len)
+{
+    size_t used = 0;
+    while (used < len && gz->state < GZ_STATE_DEFLATE && gz->state != GZ_STATE_ERROR) {
+        uint8_t c = data[used++];
+        switch (gz->state) {
+            case GZ_STATE_HEADER:
+                gz->hdr[gz->hdr_pos++] = c;
+                if (gz->hdr_pos == GZIP_HEADER_LEN) {
+                    if (gz->hdr[0] != GZIP_ID1 || gz->hdr[1] != GZIP_ID2 || gz->hdr[2] != GZIP_CM_DEFLATE) {
+                        ESP_LOGE(TAG, "不是 gzip 数据");
+                        gz->state = GZ_STATE_ERROR;
+                        break;
+                    }
+                    gz->flags = gz->hdr[3];
+                    next_header_state(gz);
+                }
+                break;
+            case GZ_STATE_EXTRA_LEN:
+                gz->hdr[gz->hdr_pos++] = c;
+                if (gz->hdr_pos == 2) {
+                    gz->skip = gz->hdr[0] | (gz->hdr[1] << 8);
+                    gz->state = GZ_STATE_EXTRA;
+                    if (gz->skip == 0) {
+                        next_header_state(gz);
+                    }
+                }
+                break;
+            case GZ_STATE_EXTRA:
+                if (--gz->skip == 0) {
+                    next_header_state(gz);
+                }
+                break;
+            case GZ_STATE_NAME:
+            case GZ_STATE_COMMENT:
+                if (c == '\0') {
+                    next_header_state(gz);
+                }
+                break;
+            case GZ_STATE_HCRC:
+                if (++gz->hdr_pos == 2) {
+                    next_header_state(gz);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return used;
+}
+
+gzip_stream_t *gzip_stream_create(void)
+{
+    gzip_stream_t *gz = mem_tag_calloc(MEM_TAG_CLIENT, 1, sizeof(gzip_stream_t), MALLOC_CAP_SPIRAM);
+    if (gz == NULL) {
+        ESP_LOGE(TAG, "解压器分配失败");
+    }
+    return gz;
+}
+
+void gzip_stream_begin(gzip_stream_t *gz, char *out, size_t out_size)
+{
+    tinfl_init(&gz->inflator);
+    gz->state = GZ_STATE_HEADER;
+    gz->flags = 0;
+    gz->hdr_pos = 0;
+    gz->skip = 0;
+    gz->out = out;
+    gz->out_size = out_size;
+    gz->out_pos = 0;
+    gz->compressed_len = 0;
+}
+
+esp_err_t gzip_stream_feed(gzip_stream_t *gz, const void *data, size_t len)
+{
+    const uint8_t *in = data;
+    gz->compressed_len += len;
+
+    while (len > 0) {
+        if (gz->state == GZ_STATE_ERROR) {
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+
+        if (gz->state < GZ_STATE_DEFLATE) {
+            size_t used = parse_header(gz, in, len);
+            in += used;
+            len -= used;
+            continue;
+        }
+
+        if (gz->state == GZ_STATE_DEFLATE) {
+            // 输出缓冲区本身就是回溯窗口，预留1字节给结尾'\0'
+            size_t in_bytes = len;
+            size_t out_bytes = gz->out_size - 1 - gz->out_pos;
+            tinfl_status status = tinfl_decompress(&gz->inflator, in, &in_bytes,
+                                                   (mz_uint8 *)gz->out, (mz_uint8 *)gz->out + gz->out_pos, &out_bytes,
+                                                   TINFL_FLAG_HAS_MORE_INPUT | TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF);
+            gz->out_pos += out_bytes;
+            in += in_bytes;
+            len -= in_bytes;
+
+            if (status == TINFL_STATUS_DONE) {
+                gz->state = GZ_STATE_TRAILER;
+                gz->hdr_pos = 0;
+            } else if (status == TINFL_STATUS_HAS_MORE_OUTPUT) {
+                ESP_LOGE(TAG, "解压结果超过 %u 字节", (unsigned)(gz->out_size - 1));
+                gz->state = GZ_STATE_ERROR;
+                return ESP_ERR_INVALID_SIZE;
+            } else if (status < 0) {
+                ESP_LOGE(TAG, "deflate 数据损坏 (%d)", status);
+                gz->state = GZ_STATE_ERROR;
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+            continue;
+        }
+
+        if (gz->state == GZ_STATE_TRAILER) {
+            size_t n = GZIP_TRAILER_LEN - gz->hdr_pos;
+            if (n > len) {
+                n = len;
+            }
+            memcpy(gz->hdr + gz->hdr_pos, in, n);
+            gz->hdr_pos += n;
+            in += n;
+            len -= n;
+            if (gz->hdr_pos == GZIP_TRAILER_LEN) {
+                gz->state = GZ_STATE_DONE;
+            }
+            continue;
+        }
+
+        // 尾部之后的多余数据（多成员 gzip）不支持，直接忽略
+        break;
+    }
+    return ESP_OK;
+}
+
+esp_err_t gzip_stream_finish(gzip_stream_t *gz, size_t *out_len)
+{
+    if (gz->state != GZ_STATE_DONE) {
+        ESP_LOGE(TAG, "gzip 数据不完整");
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    uint32_t crc = gz->hdr[0] | (gz->hdr[1] << 8) | (gz->hdr[2] << 16) | ((uint32_t)gz->hdr[3] << 24);
+    uint32_t isize = gz->hdr[4] | (gz->hdr[5] << 8) | (gz->hdr[6] << 16) | ((uint32_t)gz->hdr[7] << 24);
+    if (isize != (uint32_t)gz->out_pos || crc != esp_rom_crc32_le(0, (const uint8_t *)gz->out, gz->out_pos)) {
+        ESP_LOGE(TAG, "gzip 校验失败");
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    gz->out[gz->out_pos] = '\0';
+    if (out_len != NULL) {
+        *out_len = gz->out_pos;
+    }
+    return ESP_OK;
+}
+
+size_t gzip_stream_get_compressed_len(const gzip_stream_t *gz)
+{
+    return gz->compressed_len;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file gzip_stream.h
+ * @brief gzip 流式解压
+ *
+ * HTTP 响应分块到达时逐块解压，压缩数据不整体缓存。
+ * 解压输出直接写入调用者的缓冲区，该缓冲区同时作为 deflate 的回溯窗口，
+ * 所以窗口大小就是输出缓冲区大小，不再额外分配 32KB 字典。
+ * 使用芯片 ROM 中的 miniz（tinfl）实现。
+ */
+
+#ifndef GZIP_STREAM_H
+#define GZIP_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct gzip_stream gzip_stream_t;
+
+/**
+ * @brief 创建解压器（解压状态约 11KB，放在PSRAM）
+ * @return 解压器，内存不足时返回NULL
+ */
+gzip_stream_t *gzip_stream_create(void);
+
+/**
+ * @brief 开始解压一个新的 gzip 流
+ * @param gz 解压器
+ * @param out 输出缓冲区，解压完成后以'\0'结尾
+ * @param out_size 输出缓冲区大小（含结尾'\0'）
+ */
+void gzip_stream_begin(gzip_stream_t *gz, char *out, size_t out_size);
+
+/**
+ * @brief 送入一块压缩数据
+ * @return ESP_OK 成功,
+ *         ESP_ERR_INVALID_RESPONSE 数据不是合法的 gzip,
+ *         ESP_ERR_INVALID_SIZE 解压结果超出输出缓冲区
+ */
+esp_err_t gzip_stream_feed(gzip_stream_t *gz, const void *data, size_t len);
+
+/**
+ * @brief 结束解压并校验 CRC32 和长度
+ * @param out_len 输出解压后的字节数
+ * @return ESP_OK 流完整且校验通过, 其他值表示失败
+ */
+esp_err_t gzip_stream_finish(gzip_stream_t *gz, size_t *out_len);
+
+/**
+ * @brief 本次流已送入的压缩字节数
+ */
+size_t gzip_stream_get_compressed_len(const gzip_stream_t *gz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,235 @@
+/**
+ * @file json_arena.c
+ * @brief cJSON 请求级内存池实现
+ *
+ * 钩子安装后 cJSON 不再使用 realloc（生成字符串时扩容改为分配新缓冲区再复制），
+ * 旧缓冲区的 free 在内存池中是空操作，空间在请求结束时一起回收。
+ */
+
+#include "json_arena.h"
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "cJSON.h"
+#include "mem_tag.h"
+#include "sdkconfig.h"
+
+static const char *TAG = "json_arena";
+
+#define ARENA_ALIGN 8    // cJSON 节点含 double
+
+typedef struct chunk {
+    struct chunk *next;
+    size_t size;
+    size_t used;
+    alignas(ARENA_ALIGN) uint8_t data[];
+} chunk_t;
+
+typedef struct {
+    TaskHandle_t owner;
+    chunk_t *base;          // 常驻基础块（内部RAM）
+    chunk_t *extra;         // 本次请求追加的块（PSRAM），最新的在前
+    int depth;
+    json_arena_stats_t stats;
+} task_arena_t;
+
+static task_arena_t arenas[JSON_ARENA_MAX_TASKS];
+static portMUX_TYPE arenas_lock = portMUX_INITIALIZER_UNLOCKED;
+static _Thread_local task_arena_t *current = NULL;
+static atomic_uint heap_fallbacks = 0;
+
+static chunk_t *chunk_new(size_t size, uint32_t caps)
+{
+    chunk_t *chunk = mem_tag_malloc(MEM_TAG_CLIENT, sizeof(chunk_t) + size, caps);
+    if (chunk != NULL) {
+        chunk->next = NULL;
+        chunk->size = size;
+        chunk->used = 0;
+    }
+    return chunk;
+}
+
+static bool chunk_owns(const chunk_t *chunk, const void *ptr)
+{
+    const uint8_t *p = ptr;
+    return p >= chunk->data && p < chunk->data + chunk->size;
+}
+
+static void *chunk_take(chunk_t *chunk, size_t size)
+{
+    if (chunk == NULL || chunk->size - chunk->used < size) {
+        return NULL;
+    }
+    void *ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    return ptr;
+}
+
+static void *arena_malloc(size_t size)
+{
+    task_arena_t *arena = current;
+    if (arena == NULL) {
+        atomic_fetch_add(&heap_fallbacks, 1);
+        return malloc(size);
+    }
+
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    arena->stats.allocs++;
+
+    void *ptr = chunk_take(arena->base, size);
+    if (ptr == NULL) {
+        ptr = chunk_take(arena->extra, size);
+    }
+    if (ptr == NULL) {
+        chunk_t *chunk = chunk_new(size > JSON_ARENA_CHUNK_SIZE ? size : JSON_ARENA_CHUNK_SIZE,
+                                   MALLOC_CAP_SPIRAM);
+        if (chunk == NULL) {
+            ESP_LOGW(TAG, "追加块分配失败 (%u 字节)", (unsigned)size);
+            return NULL;
+        }
+        chunk->next = arena->extra;
+        arena->extra = chunk;
+        arena->stats.chunk_allocs++;
+        ptr = chunk_take(chunk, size);
+    }
+    return ptr;
+}
+
+static void arena_free(void *ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+
+    // 内存池中的指针在请求结束时一起回收
+    task_arena_t *arena = current;
+    if (arena != NULL) {
+        if (arena->base != NULL && chunk_owns(arena->base, ptr)) {
+            return;
+        }
+        for (chunk_t *chunk = arena->extra; chunk != NULL; chunk = chunk->next) {
+            if (chunk_owns(chunk, ptr)) {
+                return;
+            }
+        }
+    }
+    free(ptr);
+}
+
+esp_err_t json_arena_init(void)
+{
+#if CONFIG_TODO_JSON_ARENA
+    cJSON_Hooks hooks = {
+        .malloc_fn = arena_malloc,
+        .free_fn = arena_free,
+    };
+    cJSON_InitHooks(&hooks);
+    ESP_LOGI(TAG, "cJSON 使用请求级内存池（基础块 %d 字节/任务）", JSON_ARENA_BASE_SIZE);
+#endif
+    return ESP_OK;
+}
+
+/**
+ * @brief 找到当前任务的内存池，没有时占用一个空位并分配基础块
+ */
+static task_arena_t *arena_for_task(TaskHandle_t task)
+{
+    task_arena_t *arena = NULL;
+
+    taskENTER_CRITICAL(&arenas_lock);
+    for (int i = 0; i < JSON_ARENA_MAX_TASKS; i++) {
+        if (arenas[i].owner == task) {
+            arena = &arenas[i];
+            break;
+        }
+        if (arena == NULL && arenas[i].owner == NULL) {
+            arena = &arenas[i];
+        }
+    }
+    if (arena != NULL && arena->owner == NULL) {
+        arena->owner = task;
+    }
+    taskEXIT_CRITICAL(&arenas_lock);
+
+    if (arena == NULL) {
+        return NULL;
+    }
+    if (arena->base == NULL) {
+        arena->base = chunk_new(JSON_ARENA_BASE_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (arena->base == NULL) {
+            ESP_LOGW(TAG, "基础块分配失败，本次请求只用追加块");
+        }
+    }
+    return arena;
+}
+
+void json_arena_begin(void)
+{
+#if CONFIG_TODO_JSON_ARENA
+    if (current != NULL) {
+        current->depth++;
+        return;
+    }
+
+    task_arena_t *arena = arena_for_task(xTaskGetCurrentTaskHandle());
+    if (arena == NULL) {
+        // 使用 cJSON 的任务超过上限，这个任务照常 malloc
+        return;
+    }
+    arena->depth = 1;
+    current = arena;
+#endif
+}
+
+void json_arena_end(void)
+{
+    task_arena_t *arena = current;
+    if (arena == NULL || --arena->depth > 0) {
+        return;
+    }
+
+    size_t used = arena->base != NULL ? arena->base->used : 0;
+    while (arena->extra != NULL) {
+        chunk_t *chunk = arena->extra;
+        arena->extra = chunk->next;
+        used += chunk->used;
+        mem_tag_free(MEM_TAG_CLIENT, chunk);
+    }
+    if (arena->base != NULL) {
+        arena->base->used = 0;
+    }
+
+    arena->stats.requests++;
+    arena->stats.last_bytes = used;
+    if (used > arena->stats.peak_bytes) {
+        arena->stats.peak_bytes = used;
+    }
+    current = NULL;
+    ESP_LOGD(TAG, "请求用量 %u 字节", (unsigned)used);
+}
+
+void json_arena_get_stats(json_arena_stats_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+
+    *out = (json_arena_stats_t) { .heap_fallbacks = atomic_load(&heap_fallbacks) };
+    for (int i = 0; i < JSON_ARENA_MAX_TASKS; i++) {
+        const json_arena_stats_t *s = &arenas[i].stats;
+        out->requests += s->requests;
+        out->allocs += s->allocs;
+        out->chunk_allocs += s->chunk_allocs;
+        if (s->peak_bytes > out->peak_bytes) {
+            out->peak_bytes = s->peak_bytes;
+        }
+        if (s->requests > 0) {
+            out->last_bytes = s->last_bytes;
+        }
+    }
+}
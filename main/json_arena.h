@@ -0,0 +1,69 @@
+/**
+ * @file json_arena.h
+ * @brief cJSON 请求级内存池
+ *
+ * 通过 cJSON_InitHooks 接管 cJSON 的分配：一次请求中解析树、生成的字符串都从当前任务的
+ * 内存池中顺序切分，free 不做任何事，请求结束时整体归还。
+ * 每个使用 cJSON 的任务有一个常驻的基础块（内部RAM，第一次使用时分配，之后不再释放），
+ * 小请求（切换状态、推送事件）完全在基础块内完成；列表页、详情等大响应放不下时
+ * 从 PSRAM 追加块，请求结束时释放。内部RAM中不再因 cJSON 反复出现大量小块分配，
+ * 不会与 WiFi 缓冲区交错形成碎片。
+ *
+ * 当前内存池按任务记录（线程局部变量），网络任务和推送任务可同时使用；
+ * 不在 json_arena_begin/json_arena_end 之间的 cJSON 分配照常走 malloc/free。
+ * 从内存池得到的指针（包括 cJSON_PrintUnformatted 的结果）必须在 json_arena_end 之前
+ * 用完并 cJSON_free。
+ */
+
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define JSON_ARENA_MAX_TASKS    4       // 使用 cJSON 的任务数上限，超出的任务回退到 malloc
+#define JSON_ARENA_BASE_SIZE    4096    // 每个任务常驻的基础块（内部RAM）
+#define JSON_ARENA_CHUNK_SIZE   8192    // 基础块放不下时追加的块（PSRAM），更大的分配按需
+
+/**
+ * @brief 统计
+ */
+typedef struct {
+    uint32_t requests;          // 完成的请求（begin/end 对）
+    uint32_t allocs;            // 从内存池切分的次数（即原来的 malloc 次数）
+    uint32_t chunk_allocs;      // 追加块次数（真正的堆分配）
+    uint32_t heap_fallbacks;    // 不在请求中或没有内存池，回退到 malloc 的次数
+    uint32_t last_bytes;        // 最近一次请求用量
+    uint32_t peak_bytes;        // 单次请求最大用量
+} json_arena_stats_t;
+
+/**
+ * @brief 安装 cJSON 分配钩子（在任何 cJSON 调用之前调用一次）
+ */
+esp_err_t json_arena_init(void);
+
+/**
+ * @brief 当前任务开始一次请求，之后的 cJSON 分配从内存池切分（可嵌套）
+ */
+void json_arena_begin(void);
+
+/**
+ * @brief 结束请求，整体归还本次分配（最外层 end 时生效）
+ */
+void json_arena_end(void);
+
+/**
+ * @brief 获取统计（所有任务合计）
+ */
+void json_arena_get_stats(json_arena_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -3,12 +3,25 @@
 #include "driver/gpio.h"
 #include "driver/ledc.h"
 #include "esp_log.h"
+#include "esp_attr.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include <stdlib.h>
 #include <string.h>
 
 static const char *TAG = "LCD";
 static spi_device_handle_t spi_handle;
+static lcd_spi_stats_t spi_stats;
+
+// 跨度缓冲区：预先填好同一颜色的像素，每段跨度直接从这里发，颜色不变时不重填
+DMA_ATTR static uint8_t span_buf[LCD_SPAN_BUF_SIZE];
+static uint16_t span_color;
+static int span_filled = 0;   // 已填充为 span_color 的字节数
+
+// 排队中的传输，按环形顺序复用
+static spi_transaction_t trans_pool[LCD_TRANS_QUEUE_SIZE];
+static int trans_next = 0;
+static int trans_in_flight = 0;
 
 #define ST7789_SWRESET  0x01
 #define ST7789_SLPOUT   0x11
@@ -21,47 +34,108 @@ static spi_device_handle_t spi_handle;
 #define ST7789_MADCTL   0x36
 #define ST7789_COLMOD   0x3A
 
-static void lcd_send_cmd(uint8_t cmd) {
-    gpio_set_level(LCD_PIN_DC, 0); 
-    spi_transaction_t t = {
-        .length = 8,
-        .tx_buffer = &cmd,
-    };
-    spi_device_polling_transmit(spi_handle, &t);
+// DC 电平放在 user 字段里，由驱动在每次传输开始前设置，命令和参数可以连续排队
+static void IRAM_ATTR lcd_spi_pre_transfer_callback(spi_transaction_t *t) {
+    gpio_set_level(LCD_PIN_DC, (int)(intptr_t)t->user);
 }
 
-static void lcd_send_data(uint8_t data) {
-    gpio_set_level(LCD_PIN_DC, 1); 
-    spi_transaction_t t = {
-        .length = 8,
-        .tx_buffer = &data,
-    };
-    spi_device_polling_transmit(spi_handle, &t);
+// 取回最早排队的一个传输（按排队顺序完成）
+static void lcd_reclaim_one(void) {
+    spi_transaction_t *done;
+    spi_device_get_trans_result(spi_handle, &done, portMAX_DELAY);
+    trans_in_flight--;
 }
 
-static void lcd_send_data_array(const uint8_t *data, int len) {
-    gpio_set_level(LCD_PIN_DC, 1); 
-    spi_transaction_t t = {
-        .length = len * 8,
-        .tx_buffer = data,
-    };
-    spi_device_polling_transmit(spi_handle, &t);
+void lcd_wait_idle(void) {
+    while (trans_in_flight > 0) {
+        lcd_reclaim_one();
+    }
+}
+
+// 排队一次传输，不等待完成；不超过 4 字节的直接拷进事务，更长的 data 在传输完成前必须保持有效
+static void lcd_queue(int dc, const void *data, int len) {
+    if (len <= 0) return;
+    if (trans_in_flight == LCD_TRANS_QUEUE_SIZE) {
+        lcd_reclaim_one();
+    }
+
+    spi_transaction_t *t = &trans_pool[trans_next];
+    trans_next = (trans_next + 1) % LCD_TRANS_QUEUE_SIZE;
+    memset(t, 0, sizeof(spi_transaction_t));
+    t->length = len * 8;
+    t->user = (void *)(intptr_t)dc;
+    if (len <= 4) {
+        t->flags = SPI_TRANS_USE_TXDATA;
+        memcpy(t->tx_data, data, len);
+    } else {
+        t->tx_buffer = data;
+    }
+
+    ESP_ERROR_CHECK(spi_device_queue_trans(spi_handle, t, portMAX_DELAY));
+    trans_in_flight++;
+    spi_stats.transactions++;
+    spi_stats.bytes += len;
+}
+
+// 命令字节和参数连续排队（DC 不同，无法合成一次传输）
+static void lcd_send_cmd(uint8_t cmd, const uint8_t *params, int len) {
+    lcd_queue(0, &cmd, 1);
+    lcd_queue(1, params, len);
 }
 
 static void lcd_set_window(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2) {
-    lcd_send_cmd(ST7789_CASET);
-    lcd_send_data(x1 >> 8);
-    lcd_send_data(x1 & 0xFF);
-    lcd_send_data(x2 >> 8);
-    lcd_send_data(x2 & 0xFF);
-
-    lcd_send_cmd(ST7789_RASET);
-    lcd_send_data(y1 >> 8);
-    lcd_send_data(y1 & 0xFF);
-    lcd_send_data(y2 >> 8);
-    lcd_send_data(y2 & 0xFF);
-
-    lcd_send_cmd(ST7789_RAMWR);
+    uint8_t caset[4] = {x1 >> 8, x1 & 0xFF, x2 >> 8, x2 & 0xFF};
+    uint8_t raset[4] = {y1 >> 8, y1 & 0xFF, y2 >> 8, y2 & 0xFF};
+
+    lcd_send_cmd(ST7789_CASET, caset, 4);
+    lcd_send_cmd(ST7789_RASET, raset, 4);
+    lcd_send_cmd(ST7789_RAMWR, NULL, 0);
+    spi_stats.windows++;
+}
+
+// 向已设置好的窗口写 count 个同色像素，按缓冲区大小分块
+static void lcd_send_color(uint16_t color, uint32_t count) {
+    uint32_t total = count * 2;
+    int need = total < LCD_SPAN_BUF_SIZE ? (int)total : LCD_SPAN_BUF_SIZE;
+
+    if (color != span_color) {
+        // 已排队的传输还在读缓冲区，换颜色前等它们发完
+        lcd_wait_idle();
+        span_color = color;
+        span_filled = 0;
+    }
+    for (; span_filled < need; span_filled += 2) {
+        span_buf[span_filled] = color >> 8;
+        span_buf[span_filled + 1] = color & 0xFF;
+    }
+
+    while (total > 0) {
+        int chunk = total > LCD_SPAN_BUF_SIZE ? LCD_SPAN_BUF_SIZE : (int)total;
+        lcd_queue(1, span_buf, chunk);
+        total -= chunk;
+    }
+}
+
+// 裁剪到屏幕后填充矩形区域，一个窗口命令
+static void lcd_fill_area(int x, int y, int w, int h, uint16_t color) {
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > LCD_WIDTH) w = LCD_WIDTH - x;
+    if (y + h > LCD_HEIGHT) h = LCD_HEIGHT - y;
+    if (w <= 0 || h <= 0) return;
+
+    lcd_set_window(x, y, x + w - 1, y + h - 1);
+    lcd_send_color(color, (uint32_t)w * h);
+}
+
+static void lcd_hspan(int x1, int x2, int y, uint16_t color) {
+    if (x1 > x2) { int t = x1; x1 = x2; x2 = t; }
+    lcd_fill_area(x1, y, x2 - x1 + 1, 1, color);
+}
+
+static void lcd_vspan(int x, int y1, int y2, uint16_t color) {
+    if (y1 > y2) { int t = y1; y1 = y2; y2 = t; }
+    lcd_fill_area(x, y1, 1, y2 - y1 + 1, color);
 }
 
 void lcd_init(void) {
@@ -89,7 +163,8 @@ void lcd_init(void) {
         .clock_speed_hz = LCD_PIXEL_CLK,
         .mode = 0,
         .spics_io_num = LCD_PIN_CS,
-        .queue_size = 7,
+        .queue_size = LCD_TRANS_QUEUE_SIZE,
+        .pre_cb = lcd_spi_pre_transfer_callback,
     };
 
     ESP_ERROR_CHECK(spi_bus_initialize(LCD_SPI_HOST, &buscfg, SPI_DMA_CH_AUTO));
@@ -100,25 +175,28 @@ void lcd_init(void) {
     gpio_set_level(LCD_PIN_RST, 1);
     vTaskDelay(pdMS_TO_TICKS(100));
 
-    lcd_send_cmd(ST7789_SWRESET);
+    lcd_send_cmd(ST7789_SWRESET, NULL, 0);
+    lcd_wait_idle();
     vTaskDelay(pdMS_TO_TICKS(150));
 
-    lcd_send_cmd(ST7789_SLPOUT);
+    lcd_send_cmd(ST7789_SLPOUT, NULL, 0);
+    lcd_wait_idle();
     vTaskDelay(pdMS_TO_TICKS(120));
 
-    lcd_send_cmd(ST7789_COLMOD);
-    lcd_send_data(0x55); 
+    lcd_send_cmd(ST7789_COLMOD, (const uint8_t[]){0x55}, 1);
 
-    lcd_send_cmd(ST7789_MADCTL);
-    lcd_send_data(0x00);  
+    lcd_send_cmd(ST7789_MADCTL, (const uint8_t[]){0x00}, 1);
 
-    lcd_send_cmd(ST7789_INVON);
+    lcd_send_cmd(ST7789_INVON, NULL, 0);
+    lcd_wait_idle();
     vTaskDelay(pdMS_TO_TICKS(10));
 
-    lcd_send_cmd(ST7789_NORON);
+    lcd_send_cmd(ST7789_NORON, NULL, 0);
+    lcd_wait_idle();
     vTaskDelay(pdMS_TO_TICKS(10));
 
-    lcd_send_cmd(ST7789_DISPON);
+    lcd_send_cmd(ST7789_DISPON, NULL, 0);
+    lcd_wait_idle();
     vTaskDelay(pdMS_TO_TICKS(120));
 
     ledc_timer_config_t ledc_timer = {
@@ -159,87 +237,106 @@ void lcd_draw_pixel(uint16_t x, uint16_t y, uint16_t color) {
     
     lcd_set_window(x, y, x, y);
     uint8_t data[2] = {color >> 8, color & 0xFF};
-    lcd_send_data_array(data, 2);
+    lcd_queue(1, data, 2);
 }
 
-void lcd_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) {
-    if (x >= LCD_WIDTH || y >= LCD_HEIGHT) return;
-    if (x + w > LCD_WIDTH) w = LCD_WIDTH - x;
-    if (y + h > LCD_HEIGHT) h = LCD_HEIGHT - y;
+void lcd_draw_hline(uint16_t x, uint16_t y, uint16_t w, uint16_t color) {
+    lcd_fill_area(x, y, w, 1, color);
+}
 
-    lcd_set_window(x, y, x + w - 1, y + h - 1);
+void lcd_draw_vline(uint16_t x, uint16_t y, uint16_t h, uint16_t color) {
+    lcd_fill_area(x, y, 1, h, color);
+}
 
-    uint8_t color_high = color >> 8;
-    uint8_t color_low = color & 0xFF;
-    
-    gpio_set_level(LCD_PIN_DC, 1);
-    
-    const int buffer_size = 4096;
-    uint8_t *buffer = malloc(buffer_size);
-    if (buffer) {
-        for (int i = 0; i < buffer_size; i += 2) {
-            buffer[i] = color_high;
-            buffer[i + 1] = color_low;
-        }
-        
-        int total_pixels = w * h * 2;
-        int sent = 0;
-        while (sent < total_pixels) {
-            int chunk = (total_pixels - sent) > buffer_size ? buffer_size : (total_pixels - sent);
-            spi_transaction_t t = {
-                .length = chunk * 8,
-                .tx_buffer = buffer,
-            };
-            spi_device_polling_transmit(spi_handle, &t);
-            sent += chunk;
-        }
-        free(buffer);
-    }
+void lcd_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) {
+    lcd_fill_area(x, y, w, h, color);
 }
 
 void lcd_draw_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) {
-    lcd_draw_line(x, y, x + w - 1, y, color);
-    lcd_draw_line(x + w - 1, y, x + w - 1, y + h - 1, color);
-    lcd_draw_line(x, y + h - 1, x + w - 1, y + h - 1, color);
-    lcd_draw_line(x, y, x, y + h - 1, color);
+    if (w == 0 || h == 0) return;
+
+    lcd_draw_hline(x, y, w, color);
+    if (h > 1) {
+        lcd_draw_hline(x, y + h - 1, w, color);
+    }
+    if (h > 2) {
+        lcd_draw_vline(x, y + 1, h - 2, color);
+        if (w > 1) {
+            lcd_draw_vline(x + w - 1, y + 1, h - 2, color);
+        }
+    }
 }
 
+// Bresenham：沿主轴走，副轴坐标不变的连续像素合成一段跨度
 void lcd_draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
     int dx = abs(x1 - x0);
     int dy = abs(y1 - y0);
     int sx = (x0 < x1) ? 1 : -1;
     int sy = (y0 < y1) ? 1 : -1;
-    int err = dx - dy;
 
-    while (1) {
-        lcd_draw_pixel(x0, y0, color);
-        if (x0 == x1 && y0 == y1) break;
-        int e2 = 2 * err;
-        if (e2 > -dy) {
+    if (dx >= dy) {
+        int err = dx / 2;
+        int y = y0;
+        int run_start = x0;
+        for (int x = x0; ; x += sx) {
+            if (x == x1) {
+                lcd_hspan(run_start, x, y, color);
+                break;
+            }
             err -= dy;
-            x0 += sx;
+            if (err < 0) {
+                lcd_hspan(run_start, x, y, color);
+                y += sy;
+                err += dx;
+                run_start = x + sx;
+            }
         }
-        if (e2 < dx) {
-            err += dx;
-            y0 += sy;
+    } else {
+        int err = dy / 2;
+        int x = x0;
+        int run_start = y0;
+        for (int y = y0; ; y += sy) {
+            if (y == y1) {
+                lcd_vspan(x, run_start, y, color);
+                break;
+            }
+            err -= dx;
+            if (err < 0) {
+                lcd_vspan(x, run_start, y, color);
+                x += sx;
+                err += dy;
+                run_start = y + sy;
+            }
         }
     }
 }
 
+// 以 center 为轴对称的一对跨度 [center-hi, center-lo] 和 [center+lo, center+hi]，lo 为 0 时合成一段
+static void lcd_mirror_span(bool horizontal, int line, int center, int lo, int hi, uint16_t color) {
+    if (lo == 0) {
+        if (horizontal) lcd_hspan(center - hi, center + hi, line, color);
+        else lcd_vspan(line, center - hi, center + hi, color);
+        return;
+    }
+    if (horizontal) {
+        lcd_hspan(center - hi, center - lo, line, color);
+        lcd_hspan(center + lo, center + hi, line, color);
+    } else {
+        lcd_vspan(line, center - hi, center - lo, color);
+        lcd_vspan(line, center + lo, center + hi, color);
+    }
+}
+
+// 中点画圆：x 不变时 y 连续递增的一组点，在上下两行是水平跨度，在左右两列是竖直跨度
 void lcd_draw_circle(uint16_t x0, uint16_t y0, uint16_t r, uint16_t color) {
     int x = r;
     int y = 0;
     int err = 0;
+    int run_start = 0;
 
     while (x >= y) {
-        lcd_draw_pixel(x0 + x, y0 + y, color);
-        lcd_draw_pixel(x0 + y, y0 + x, color);
-        lcd_draw_pixel(x0 - y, y0 + x, color);
-        lcd_draw_pixel(x0 - x, y0 + y, color);
-        lcd_draw_pixel(x0 - x, y0 - y, color);
-        lcd_draw_pixel(x0 - y, y0 - x, color);
-        lcd_draw_pixel(x0 + y, y0 - x, color);
-        lcd_draw_pixel(x0 + x, y0 - y, color);
+        int cur_x = x;
+        int cur_y = y;
 
         if (err <= 0) {
             y += 1;
@@ -249,15 +346,37 @@ void lcd_draw_circle(uint16_t x0, uint16_t y0, uint16_t r, uint16_t color) {
             x -= 1;
             err -= 2 * x + 1;
         }
+
+        if (x != cur_x || x < y) {
+            lcd_mirror_span(true, y0 - cur_x, x0, run_start, cur_y, color);
+            lcd_mirror_span(true, y0 + cur_x, x0, run_start, cur_y, color);
+            lcd_mirror_span(false, x0 - cur_x, y0, run_start, cur_y, color);
+            lcd_mirror_span(false, x0 + cur_x, y0, run_start, cur_y, color);
+            run_start = y;
+        }
     }
 }
 
+// 每行一段跨度，半宽随行号单调递减，逐行下调即可
 void lcd_fill_circle(uint16_t x0, uint16_t y0, uint16_t r, uint16_t color) {
-    for (int y = -r; y <= r; y++) {
-        for (int x = -r; x <= r; x++) {
-            if (x * x + y * y <= r * r) {
-                lcd_draw_pixel(x0 + x, y0 + y, color);
-            }
+    int rr = r * r;
+    int half = r;
+
+    for (int y = 0; y <= r; y++) {
+        while (half * half + y * y > rr) {
+            half--;
+        }
+        lcd_hspan(x0 - half, x0 + half, y0 + y, color);
+        if (y > 0) {
+            lcd_hspan(x0 - half, x0 + half, y0 - y, color);
         }
     }
 }
+
+void lcd_get_spi_stats(lcd_spi_stats_t *stats) {
+    *stats = spi_stats;
+}
+
+void lcd_reset_spi_stats(void) {
+    memset(&spi_stats, 0, sizeof(spi_stats));
+}
@@ -1,21 +1,38 @@
+/**
+ * @file lcd_driver.h
+ * @brief 不经 LVGL 的 ST7789T 直接绘图驱动
+ *
+ * 随固件编译，界面不调用：界面经 lvgl_driver.c 的 esp_lcd + Vernon_ST7789T 面板送屏
+ * （整帧模式为 lcd_frame.c）。本驱动按跨度绘制图元、SPI 传输排队发送，用于脱离界面的屏幕测试
+ * （例如出厂检测画测试图）。它与面板驱动共用 SPI2 总线和背光 LEDC 通道0，两者不能同时初始化：
+ * 调用 lcd_init 代替 main.c 中的面板初始化，不要再启动界面。
+ */
+
 #ifndef LCD_DRIVER_H
 #define LCD_DRIVER_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #define LCD_WIDTH   240
 #define LCD_HEIGHT  320
 
-#define LCD_PIN_MOSI    11
-#define LCD_PIN_CLK     12
-#define LCD_PIN_CS      10
-#define LCD_PIN_DC      13
-#define LCD_PIN_RST     14
-#define LCD_BL_PIN      9
+// 与 main.c 中面板的接线相同
+#define LCD_PIN_MOSI    45
+#define LCD_PIN_CLK     40
+#define LCD_PIN_CS      42
+#define LCD_PIN_DC      41
+#define LCD_PIN_RST     39
+#define LCD_BL_PIN      5
 
 #define LCD_SPI_HOST    SPI2_HOST
 #define LCD_PIXEL_CLK   40000000  
 
+// 跨度缓冲区大小（字节），一段跨度超过时分块发送
+#define LCD_SPAN_BUF_SIZE   (LCD_WIDTH * 2 * 8)
+// 同时排队的 SPI 传输数（一次设置窗口占 5 个）
+#define LCD_TRANS_QUEUE_SIZE    16
+
 // RGB565
 #define COLOR_BLACK     0x0000
 #define COLOR_WHITE     0xFFFF
@@ -29,14 +46,27 @@
 #define COLOR_PURPLE    0x8010
 #define COLOR_GRAY      0x8410
 
+// SPI 传输计数，用于比较各绘图函数的开销
+typedef struct {
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t windows;
+} lcd_spi_stats_t;
+
 void lcd_init(void);
 void lcd_fill_screen(uint16_t color);
 void lcd_draw_pixel(uint16_t x, uint16_t y, uint16_t color);
+void lcd_draw_hline(uint16_t x, uint16_t y, uint16_t w, uint16_t color);
+void lcd_draw_vline(uint16_t x, uint16_t y, uint16_t h, uint16_t color);
 void lcd_draw_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
 void lcd_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
 void lcd_draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
 void lcd_draw_circle(uint16_t x0, uint16_t y0, uint16_t r, uint16_t color);
 void lcd_fill_circle(uint16_t x0, uint16_t y0, uint16_t r, uint16_t color);
 void lcd_set_backlight(uint8_t brightness);
+// 绘图函数只排队传输，返回时可能还没发完；需要确认已上屏时调用
+void lcd_wait_idle(void);
+void lcd_get_spi_stats(lcd_spi_stats_t *stats);
+void lcd_reset_spi_stats(void);
 
 #endif 
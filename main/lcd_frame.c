@@ -0,0 +1,321 @@
+/**
+ * @file lcd_frame.c
+ * @brief 整帧双缓冲渲染与TE同步送屏实现
+ *
+ * 40MHz SPI 写一行约 96us，比面板扫描一行（60Hz 时约 52us）慢：
+ * 从扫描线刚越过的行开始写，扫描线只会越拉越远，写入全部落在本次扫描之后；
+ * 只要下一次扫描追上之前写完（整屏约 31ms，下一次扫描要到约 36ms 才追上），整帧一起显示。
+ */
+
+#include "lcd_frame.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "esp_attr.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_log.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "dirty_region.h"
+
+static const char *TAG = "lcd_frame";
+
+#ifndef CONFIG_TODO_LCD_TE_GPIO
+#define CONFIG_TODO_LCD_TE_GPIO -1
+#endif
+
+#define ST7789_TEON              0x35
+#define TE_MODE_VBLANK           0x00     // 只在帧消隐期间输出TE
+#define TE_WAIT_TIMEOUT_MS       50
+#define FRAME_DONE_TIMEOUT_MS    100
+#define TE_PERIOD_MIN_US         5000     // 超出范围的间隔（中断丢失等）不计入周期
+#define TE_PERIOD_MAX_US         50000
+
+typedef struct {
+    int y1;
+    int y2;
+} row_range_t;
+
+static SemaphoreHandle_t te_sem = NULL;
+static SemaphoreHandle_t frame_done_sem = NULL;
+static portMUX_TYPE frame_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static int64_t te_last_us = 0;
+static uint32_t te_period_us = LCD_FRAME_FALLBACK_PERIOD_US;
+
+// 当前帧（中断中更新）
+static int pending_transfers = 0;
+static int64_t frame_sync_us = 0;
+static int64_t frame_deadline_us = 0;
+static bool frame_queued = false;
+
+static lcd_frame_stats_t stats;
+static uint64_t frame_time_total_us = 0;
+static int64_t last_log_us = 0;
+
+#if CONFIG_TODO_LCD_TE_GPIO >= 0
+static void IRAM_ATTR te_isr(void *arg)
+{
+    (void)arg;
+    int64_t now = esp_timer_get_time();
+    BaseType_t woken = pdFALSE;
+
+    portENTER_CRITICAL_ISR(&frame_lock);
+    int64_t delta = now - te_last_us;
+    if (delta >= TE_PERIOD_MIN_US && delta <= TE_PERIOD_MAX_US) {
+        te_period_us = (uint32_t)delta;
+    }
+    te_last_us = now;
+    portEXIT_CRITICAL_ISR(&frame_lock);
+
+    xSemaphoreGiveFromISR(te_sem, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+#else
+static void te_timer_cb(void *arg)
+{
+    (void)arg;
+    portENTER_CRITICAL(&frame_lock);
+    te_last_us = esp_timer_get_time();
+    portEXIT_CRITICAL(&frame_lock);
+    xSemaphoreGive(te_sem);
+}
+#endif
+
+esp_err_t lcd_frame_init(esp_lcd_panel_io_handle_t io)
+{
+    te_sem = xSemaphoreCreateBinary();
+    frame_done_sem = xSemaphoreCreateBinary();
+    if (te_sem == NULL || frame_done_sem == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+#if CONFIG_TODO_LCD_TE_GPIO >= 0
+    uint8_t mode = TE_MODE_VBLANK;
+    esp_err_t err = esp_lcd_panel_io_tx_param(io, ST7789_TEON, &mode, 1);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "打开TE输出失败: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    gpio_config_t te_conf = {
+        .pin_bit_mask = 1ULL << CONFIG_TODO_LCD_TE_GPIO,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_POSEDGE,
+    };
+    err = gpio_config(&te_conf);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    // 触摸驱动可能已安装过中断服务
+    err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        return err;
+    }
+    err = gpio_isr_handler_add(CONFIG_TODO_LCD_TE_GPIO, te_isr, NULL);
+    if (err != ESP_OK) {
+        return err;
+    }
+    ESP_LOGI(TAG, "整帧模式：TE同步 (GPIO %d)", CONFIG_TODO_LCD_TE_GPIO);
+#else
+    (void)io;
+    const esp_timer_create_args_t timer_args = {
+        .callback = te_timer_cb,
+        .name = "lcd_te",
+    };
+    esp_timer_handle_t timer = NULL;
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(timer, LCD_FRAME_FALLBACK_PERIOD_US));
+    ESP_LOGW(TAG, "整帧模式：未配置TE引脚，按 %d us 节拍送屏，不能保证无撕裂", LCD_FRAME_FALLBACK_PERIOD_US);
+#endif
+
+    last_log_us = esp_timer_get_time();
+    return ESP_OK;
+}
+
+/**
+ * @brief 等到指定时间：整 tick 部分让出CPU，剩下的忙等
+ */
+static void wait_until(int64_t target_us)
+{
+    int64_t remain = target_us - esp_timer_get_time();
+    int64_t tick_us = (int64_t)portTICK_PERIOD_MS * 1000;
+    if (remain > 2 * tick_us) {
+        vTaskDelay((TickType_t)(remain / tick_us - 1));
+        remain = target_us - esp_timer_get_time();
+    }
+    if (remain > 0) {
+        esp_rom_delay_us((uint32_t)remain);
+    }
+}
+
+/**
+ * @brief 本帧脏区对应的行范围，按起始行排序并合并重叠/相邻的范围
+ * @return 范围个数
+ */
+static int collect_dirty_rows(row_range_t *ranges, int max)
+{
+    lv_disp_t *d = _lv_refr_get_disp_refreshing();
+    int ver_res = lv_disp_get_ver_res(d);
+    int n = 0;
+
+    for (int i = 0; i < d->inv_p && n < max; i++) {
+        if (d->inv_area_joined[i]) {
+            continue;
+        }
+        int y1 = LV_MAX(d->inv_areas[i].y1, 0);
+        int y2 = LV_MIN(d->inv_areas[i].y2, ver_res - 1);
+        if (y1 > y2) {
+            continue;
+        }
+
+        // 插入排序，数量不超过 LV_INV_BUF_SIZE
+        int j = n++;
+        while (j > 0 && ranges[j - 1].y1 > y1) {
+            ranges[j] = ranges[j - 1];
+            j--;
+        }
+        ranges[j].y1 = y1;
+        ranges[j].y2 = y2;
+    }
+
+    int merged = 0;
+    for (int i = 0; i < n; i++) {
+        if (merged > 0 && ranges[i].y1 <= ranges[merged - 1].y2 + 1) {
+            ranges[merged - 1].y2 = LV_MAX(ranges[merged - 1].y2, ranges[i].y2);
+        } else {
+            ranges[merged++] = ranges[i];
+        }
+    }
+    return merged;
+}
+
+static void log_periodic(int64_t now)
+{
+    if (now - last_log_us < (int64_t)LCD_FRAME_LOG_INTERVAL_MS * 1000) {
+        return;
+    }
+    last_log_us = now;
+
+    lcd_frame_stats_t s;
+    lcd_frame_get_stats(&s);
+    ESP_LOGI(TAG, "%lu 帧, 丢帧 %lu, 帧时间 平均 %lu.%lu ms 最大 %lu.%lu ms, TE周期 %lu us, TE超时 %lu",
+             s.frames, s.dropped,
+             s.frame_time_avg_us / 1000, (s.frame_time_avg_us % 1000) / 100,
+             s.frame_time_max_us / 1000, (s.frame_time_max_us % 1000) / 100,
+             s.te_period_us, s.te_timeouts);
+}
+
+void lcd_frame_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map)
+{
+    (void)area;
+
+    // 直接模式下每块脏区都渲染在整屏缓冲区的原位，等最后一块渲染完再整帧送屏
+    if (!lv_disp_flush_is_last(drv)) {
+        lv_disp_flush_ready(drv);
+        return;
+    }
+
+    row_range_t ranges[LV_INV_BUF_SIZE];
+    int count = collect_dirty_rows(ranges, LV_INV_BUF_SIZE);
+    if (count == 0) {
+        lv_disp_flush_ready(drv);
+        return;
+    }
+
+    // 上一帧可能还在传输，它的缓冲区下一帧就要拿来渲染
+    if (frame_queued) {
+        if (xSemaphoreTake(frame_done_sem, pdMS_TO_TICKS(FRAME_DONE_TIMEOUT_MS)) != pdTRUE) {
+            ESP_LOGW(TAG, "上一帧传输超时");
+        }
+        frame_queued = false;
+    }
+
+    // 丢掉过期的TE，等下一次帧消隐
+    xSemaphoreTake(te_sem, 0);
+    bool synced = xSemaphoreTake(te_sem, pdMS_TO_TICKS(TE_WAIT_TIMEOUT_MS)) == pdTRUE;
+
+    int hor_res = drv->hor_res;
+    int ver_res = drv->ver_res;
+    portENTER_CRITICAL(&frame_lock);
+    int64_t sync_us = synced ? te_last_us : esp_timer_get_time();
+    uint32_t period_us = te_period_us;
+    if (!synced) {
+        stats.te_timeouts++;
+    }
+    pending_transfers = count;
+    frame_sync_us = sync_us;
+    // 下一次扫描到达最后一段的底部之前要写完
+    frame_deadline_us = sync_us + period_us + (int64_t)period_us * ranges[count - 1].y2 / ver_res;
+    portEXIT_CRITICAL(&frame_lock);
+
+    esp_lcd_panel_handle_t panel = (esp_lcd_panel_handle_t)drv->user_data;
+    lv_disp_draw_buf_t *draw_buf = drv->draw_buf;
+    lv_color_t *other = color_map == draw_buf->buf1 ? draw_buf->buf2 : draw_buf->buf1;
+    frame_queued = true;
+
+    for (int i = 0; i < count; i++) {
+        int y1 = ranges[i].y1;
+        int y2 = ranges[i].y2;
+        size_t offset = (size_t)y1 * hor_res;
+
+        // 扫描线越过起始行后再开始写（多等一行留余量）
+        wait_until(sync_us + (int64_t)period_us * (y1 + 1) / ver_res);
+        lv_area_t rows = {.x1 = 0, .y1 = y1, .x2 = hor_res - 1, .y2 = y2};
+        dirty_region_on_flush(&rows, NULL, i == count - 1);
+        esp_lcd_panel_draw_bitmap(panel, 0, y1, hor_res, y2 + 1, color_map + offset);
+
+        // 传输进行中顺便同步到另一块缓冲区，下一帧在它上面只渲染新的脏区
+        memcpy(other + offset, color_map + offset, (size_t)(y2 - y1 + 1) * hor_res * sizeof(lv_color_t));
+    }
+
+    log_periodic(esp_timer_get_time());
+}
+
+bool lcd_frame_on_trans_done(lv_disp_drv_t *drv)
+{
+    int64_t now = esp_timer_get_time();
+    BaseType_t woken = pdFALSE;
+
+    portENTER_CRITICAL_ISR(&frame_lock);
+    bool done = pending_transfers > 0 && --pending_transfers == 0;
+    if (done) {
+        uint32_t frame_us = (uint32_t)(now - frame_sync_us);
+        stats.frames++;
+        frame_time_total_us += frame_us;
+        if (frame_us > stats.frame_time_max_us) {
+            stats.frame_time_max_us = frame_us;
+        }
+        if (now > frame_deadline_us) {
+            stats.dropped++;
+        }
+    }
+    portEXIT_CRITICAL_ISR(&frame_lock);
+
+    if (done) {
+        lv_disp_flush_ready(drv);
+        xSemaphoreGiveFromISR(frame_done_sem, &woken);
+    }
+    return woken == pdTRUE;
+}
+
+void lcd_frame_get_stats(lcd_frame_stats_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+
+    portENTER_CRITICAL(&frame_lock);
+    *out = stats;
+    out->frame_time_avg_us = stats.frames ? (uint32_t)(frame_time_total_us / stats.frames) : 0;
+    out->te_period_us = te_period_us;
+    portEXIT_CRITICAL(&frame_lock);
+}
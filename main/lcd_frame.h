@@ -0,0 +1,69 @@
+/**
+ * @file lcd_frame.h
+ * @brief 整帧双缓冲渲染与TE同步送屏
+ *
+ * 开启 CONFIG_TODO_LCD_FULL_FRAME 后，LVGL 在 PSRAM 中的两块整屏缓冲区上以直接模式渲染，
+ * 一帧的所有脏区渲染完后，本模块把脏区所在的整行按从上到下的顺序送屏：
+ * 等到面板TE信号（帧消隐开始）后，每段都等扫描线越过起始行再开始传输，
+ * 写入始终落在扫描线之后、下一次扫描之前，整帧一次性出现，不会出现撕裂带。
+ * 送屏的同时把这些行复制到另一块缓冲区，两块缓冲区内容保持一致，下一帧只需渲染新的脏区。
+ *
+ * 没有接TE引脚时用定时器按面板刷新周期节拍送屏，只能限制送屏频率，不能保证不撕裂。
+ */
+
+#ifndef LCD_FRAME_H
+#define LCD_FRAME_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_lcd_panel_io.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LCD_FRAME_FALLBACK_PERIOD_US  16667   // 没有TE时的节拍（约60Hz）
+#define LCD_FRAME_LOG_INTERVAL_MS     60000
+
+/**
+ * @brief 整帧模式统计（自启动以来）
+ */
+typedef struct {
+    uint32_t frames;              // 送出的帧数
+    uint32_t dropped;             // 传输没能在下一次扫描追上之前完成的帧（可能出现撕裂）
+    uint32_t te_timeouts;         // 等不到TE信号的次数
+    uint32_t frame_time_avg_us;   // TE同步到最后一段传输完成的平均耗时
+    uint32_t frame_time_max_us;
+    uint32_t te_period_us;        // 实测TE周期（定时器节拍时为固定值）
+} lcd_frame_stats_t;
+
+/**
+ * @brief 打开面板TE输出并安装TE中断（或节拍定时器）
+ * @param io 面板IO句柄
+ * @return ESP_OK 成功
+ */
+esp_err_t lcd_frame_init(esp_lcd_panel_io_handle_t io);
+
+/**
+ * @brief LVGL flush_cb（直接模式）：非最后一块直接返回，最后一块时把整帧脏行送屏
+ */
+void lcd_frame_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map);
+
+/**
+ * @brief 面板IO颜色传输完成回调中调用（中断上下文），整帧传完时通知LVGL
+ * @return 是否需要切换任务
+ */
+bool lcd_frame_on_trans_done(lv_disp_drv_t *drv);
+
+/**
+ * @brief 获取统计
+ */
+void lcd_frame_get_stats(lcd_frame_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,9 +1,18 @@
 #include "lvgl_driver.h"
 #include "esp_lcd_touch.h"
 #include "touch_driver.h"
+#include "refresh_governor.h"
+#include "lvgl_mem.h"
+#include "mem_tag.h"
+#include "lcd_frame.h"
+#include "draw_blend.h"
+#include "dirty_region.h"
+#include "display_power.h"
 
 static const char *TAG_LVGL = "LVGL";
 
+#define LVGL_MEM_LOG_PERIOD_MS (5 * 60 * 1000)
+
 void *buf1 = NULL;
 void *buf2 = NULL;
 
@@ -11,6 +20,7 @@ lv_disp_draw_buf_t disp_buf;
 lv_disp_drv_t disp_drv;
 lv_disp_t *disp;
 lv_indev_drv_t indev_drv;
+lv_indev_t *touch_indev = NULL;
 
 void example_increase_lvgl_tick(void *arg)
 {
@@ -20,8 +30,12 @@ void example_increase_lvgl_tick(void *arg)
 bool example_notify_lvgl_flush_ready(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
 {
     lv_disp_drv_t *disp_driver = (lv_disp_drv_t *)user_ctx;
+#if CONFIG_TODO_LCD_FULL_FRAME
+    return lcd_frame_on_trans_done(disp_driver);
+#else
     lv_disp_flush_ready(disp_driver);
     return false;
+#endif
 }
 
 void example_lvgl_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map)
@@ -32,6 +46,7 @@ void example_lvgl_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t
     int offsety1 = area->y1;
     int offsety2 = area->y2;
     
+    dirty_region_on_flush(area, color_map, lv_disp_flush_is_last(drv));
     esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, color_map);
 }
 
@@ -45,7 +60,8 @@ void example_touchpad_read(lv_indev_drv_t *drv, lv_indev_data_t *data)
 
     bool touchpad_pressed = esp_lcd_touch_get_coordinates(drv->user_data, touchpad_x, touchpad_y, NULL, &touchpad_cnt, 1);
 
-    if (touchpad_pressed && touchpad_cnt > 0) {
+    // 黑屏时的按压只用于唤醒
+    if (display_power_filter_touch(touchpad_pressed && touchpad_cnt > 0)) {
         data->point.x = touchpad_x[0];
         data->point.y = touchpad_y[0];
         data->state = LV_INDEV_STATE_PR;
@@ -82,22 +98,42 @@ void LVGL_Init(void)
 {
     ESP_LOGI(TAG_LVGL, "初始化LVGL库");
     lv_init();
+    lvgl_mem_start_periodic_log(LVGL_MEM_LOG_PERIOD_MS);
     
-    buf1 = heap_caps_malloc(LVGL_BUF_LEN * sizeof(lv_color_t), MALLOC_CAP_SPIRAM);
+#if CONFIG_TODO_LCD_FULL_FRAME
+    // 两块整屏缓冲区，直接模式渲染，由 lcd_frame 等TE后送屏并同步脏区
+    buf1 = mem_tag_malloc(MEM_TAG_LVGL, LVGL_FULL_FRAME_LEN * sizeof(lv_color_t), MALLOC_CAP_SPIRAM);
+    assert(buf1);
+    buf2 = mem_tag_malloc(MEM_TAG_LVGL, LVGL_FULL_FRAME_LEN * sizeof(lv_color_t), MALLOC_CAP_SPIRAM);
+    assert(buf2);
+    lv_disp_draw_buf_init(&disp_buf, buf1, buf2, LVGL_FULL_FRAME_LEN);
+#else
+    buf1 = mem_tag_malloc(MEM_TAG_LVGL, LVGL_BUF_LEN * sizeof(lv_color_t), MALLOC_CAP_SPIRAM);
     assert(buf1);
-    buf2 = heap_caps_malloc(LVGL_BUF_LEN * sizeof(lv_color_t), MALLOC_CAP_SPIRAM);    
+    buf2 = mem_tag_malloc(MEM_TAG_LVGL, LVGL_BUF_LEN * sizeof(lv_color_t), MALLOC_CAP_SPIRAM);    
     assert(buf2);
     lv_disp_draw_buf_init(&disp_buf, buf1, buf2, LVGL_BUF_LEN);
+#endif
 
     ESP_LOGI(TAG_LVGL, "注册显示驱动到LVGL");
     lv_disp_drv_init(&disp_drv);
     disp_drv.hor_res = EXAMPLE_LCD_H_RES;
     disp_drv.ver_res = EXAMPLE_LCD_V_RES;
+#if CONFIG_TODO_LCD_FULL_FRAME
+    disp_drv.flush_cb = lcd_frame_flush_cb;
+    disp_drv.direct_mode = 1;
+#else
     disp_drv.flush_cb = example_lvgl_flush_cb;
+#endif
     disp_drv.drv_update_cb = example_lvgl_port_update_callback;
     disp_drv.draw_buf = &disp_buf;
     disp_drv.user_data = panel_handle;
+    disp_drv.monitor_cb = refresh_governor_monitor_cb;
+#if CONFIG_TODO_LVGL_BLEND_KERNELS
+    draw_blend_attach(&disp_drv);
+#endif
     disp = lv_disp_drv_register(&disp_drv);
+    dirty_region_init(disp);
 
     ESP_LOGI(TAG_LVGL, "安装LVGL定时器");
     const esp_timer_create_args_t lvgl_tick_timer_args = {
@@ -115,11 +151,13 @@ void LVGL_Init(void)
         indev_drv.type = LV_INDEV_TYPE_POINTER;
         indev_drv.read_cb = example_touchpad_read;
         indev_drv.user_data = tp;
-        lv_indev_drv_register(&indev_drv);
+        touch_indev = lv_indev_drv_register(&indev_drv);
         ESP_LOGI(TAG_LVGL, "触摸输入已注册");
     } else {
         ESP_LOGW(TAG_LVGL, "触摸驱动初始化失败，继续运行无触摸模式");
     }
 
+    refresh_governor_init(disp, touch_indev);
+
     ESP_LOGI(TAG_LVGL, "LVGL初始化完成");
 }
@@ -12,11 +12,13 @@
 #define EXAMPLE_LCD_H_RES              240
 #define EXAMPLE_LCD_V_RES              320
 #define LVGL_BUF_LEN  (EXAMPLE_LCD_H_RES * EXAMPLE_LCD_V_RES / 10)
+#define LVGL_FULL_FRAME_LEN  (EXAMPLE_LCD_H_RES * EXAMPLE_LCD_V_RES)
 #define EXAMPLE_LVGL_TICK_PERIOD_MS    2
 
 extern lv_disp_draw_buf_t disp_buf;
 extern lv_disp_drv_t disp_drv;
 extern lv_disp_t *disp;
+extern lv_indev_t *touch_indev;
 extern esp_lcd_panel_handle_t panel_handle;
 
 bool example_notify_lvgl_flush_ready(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx);
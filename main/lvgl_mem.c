@@ -0,0 +1,213 @@
+/**
+ * @file lvgl_mem.c
+ * @brief LVGL自定义内存分配器实现
+ *
+ * 每块前面加8字节头记录大小和所在区域，用于释放时更新统计。
+ * 只在LVGL任务中调用，不加锁。
+ */
+
+#include "lvgl_mem.h"
+#include <assert.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "mem_tag.h"
+#include "lvgl.h"
+
+static const char *TAG = "lvgl_mem";
+
+#define LVGL_MEM_MAGIC 0x4C56
+
+#define CAPS_INTERNAL (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#define CAPS_PSRAM    (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+
+typedef struct {
+    uint32_t size;
+    uint8_t mem_class;
+    uint8_t in_psram;
+    uint16_t magic;
+} lvgl_mem_hdr_t;
+
+static lvgl_mem_stats_t mem_stats;
+
+static lvgl_mem_class_t size_to_class(size_t size)
+{
+    if (size <= 32) {
+        return LVGL_MEM_CLASS_32;
+    } else if (size <= 128) {
+        return LVGL_MEM_CLASS_128;
+    } else if (size <= 512) {
+        return LVGL_MEM_CLASS_512;
+    } else if (size <= 2048) {
+        return LVGL_MEM_CLASS_2K;
+    } else if (size <= 8192) {
+        return LVGL_MEM_CLASS_8K;
+    }
+    return LVGL_MEM_CLASS_LARGE;
+}
+
+static void stats_add(const lvgl_mem_hdr_t *hdr)
+{
+    lvgl_mem_class_stats_t *cls = &mem_stats.classes[hdr->mem_class];
+    cls->cur_bytes += hdr->size;
+    cls->cur_blocks++;
+    cls->alloc_calls++;
+    if (cls->cur_bytes > cls->peak_bytes) {
+        cls->peak_bytes = cls->cur_bytes;
+    }
+
+    if (hdr->in_psram) {
+        mem_stats.cur_psram_bytes += hdr->size;
+    } else {
+        mem_stats.cur_internal_bytes += hdr->size;
+    }
+
+    mem_tag_record(MEM_TAG_LVGL, hdr->in_psram, sizeof(lvgl_mem_hdr_t) + hdr->size);
+
+    uint32_t total = mem_stats.cur_internal_bytes + mem_stats.cur_psram_bytes;
+    if (total > mem_stats.peak_total_bytes) {
+        mem_stats.peak_total_bytes = total;
+    }
+}
+
+static void stats_remove(const lvgl_mem_hdr_t *hdr)
+{
+    lvgl_mem_class_stats_t *cls = &mem_stats.classes[hdr->mem_class];
+    cls->cur_bytes -= hdr->size;
+    cls->cur_blocks--;
+
+    if (hdr->in_psram) {
+        mem_stats.cur_psram_bytes -= hdr->size;
+    } else {
+        mem_stats.cur_internal_bytes -= hdr->size;
+    }
+    mem_tag_record(MEM_TAG_LVGL, hdr->in_psram, -(int32_t)(sizeof(lvgl_mem_hdr_t) + hdr->size));
+}
+
+/**
+ * @brief 按大小选择首选区域，不足时回退到另一区域
+ */
+static lvgl_mem_hdr_t *raw_alloc(lvgl_mem_hdr_t *old, size_t size)
+{
+    bool prefer_internal = size <= LVGL_MEM_INTERNAL_MAX_SIZE;
+    uint32_t first = prefer_internal ? CAPS_INTERNAL : CAPS_PSRAM;
+    uint32_t second = prefer_internal ? CAPS_PSRAM : CAPS_INTERNAL;
+    size_t total = sizeof(lvgl_mem_hdr_t) + size;
+
+    lvgl_mem_hdr_t *hdr = heap_caps_realloc(old, total, first);
+    bool in_psram = !prefer_internal;
+    if (hdr == NULL) {
+        hdr = heap_caps_realloc(old, total, second);
+        in_psram = prefer_internal;
+        if (hdr != NULL) {
+            mem_stats.fallback_count++;
+        }
+    }
+    if (hdr == NULL) {
+        mem_stats.fail_count++;
+        return NULL;
+    }
+
+    hdr->size = size;
+    hdr->mem_class = size_to_class(size);
+    hdr->in_psram = in_psram;
+    hdr->magic = LVGL_MEM_MAGIC;
+    return hdr;
+}
+
+void *lvgl_mem_alloc(size_t size)
+{
+    if (size == 0) {
+        return NULL;
+    }
+
+    lvgl_mem_hdr_t *hdr = raw_alloc(NULL, size);
+    if (hdr == NULL) {
+        return NULL;
+    }
+    stats_add(hdr);
+    return hdr + 1;
+}
+
+void lvgl_mem_free(void *ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+
+    lvgl_mem_hdr_t *hdr = (lvgl_mem_hdr_t *)ptr - 1;
+    assert(hdr->magic == LVGL_MEM_MAGIC);
+    stats_remove(hdr);
+    hdr->magic = 0;
+    heap_caps_free(hdr);
+}
+
+void *lvgl_mem_realloc(void *ptr, size_t size)
+{
+    if (ptr == NULL) {
+        return lvgl_mem_alloc(size);
+    }
+    if (size == 0) {
+        lvgl_mem_free(ptr);
+        return NULL;
+    }
+
+    lvgl_mem_hdr_t *hdr = (lvgl_mem_hdr_t *)ptr - 1;
+    assert(hdr->magic == LVGL_MEM_MAGIC);
+
+    lvgl_mem_hdr_t saved = *hdr;
+    stats_remove(&saved);
+
+    lvgl_mem_hdr_t *new_hdr = raw_alloc(hdr, size);
+    if (new_hdr == NULL) {
+        // 原块保持不变
+        stats_add(&saved);
+        mem_stats.classes[saved.mem_class].alloc_calls--;
+        return NULL;
+    }
+    stats_add(new_hdr);
+    return new_hdr + 1;
+}
+
+void lvgl_mem_get_stats(lvgl_mem_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+
+    mem_stats.largest_free_internal = heap_caps_get_largest_free_block(CAPS_INTERNAL);
+    mem_stats.largest_free_psram = heap_caps_get_largest_free_block(CAPS_PSRAM);
+    memcpy(stats, &mem_stats, sizeof(lvgl_mem_stats_t));
+}
+
+void lvgl_mem_log_stats(void)
+{
+    static const char *class_names[LVGL_MEM_CLASS_COUNT] = {
+        "<=32", "<=128", "<=512", "<=2K", "<=8K", ">8K"
+    };
+
+    lvgl_mem_stats_t stats;
+    lvgl_mem_get_stats(&stats);
+
+    ESP_LOGI(TAG, "LVGL内存: 内部RAM %lu 字节, PSRAM %lu 字节, 峰值 %lu 字节, 回退 %lu 次, 失败 %lu 次",
+             stats.cur_internal_bytes, stats.cur_psram_bytes, stats.peak_total_bytes,
+             stats.fallback_count, stats.fail_count);
+    ESP_LOGI(TAG, "最大空闲块: 内部RAM %lu 字节, PSRAM %lu 字节",
+             stats.largest_free_internal, stats.largest_free_psram);
+    for (int i = 0; i < LVGL_MEM_CLASS_COUNT; i++) {
+        const lvgl_mem_class_stats_t *cls = &stats.classes[i];
+        ESP_LOGD(TAG, "  %-6s 当前 %lu 字节/%lu 块, 峰值 %lu 字节, 累计分配 %lu 次",
+                 class_names[i], cls->cur_bytes, cls->cur_blocks, cls->peak_bytes, cls->alloc_calls);
+    }
+}
+
+static void periodic_log_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    lvgl_mem_log_stats();
+}
+
+void lvgl_mem_start_periodic_log(uint32_t period_ms)
+{
+    lv_timer_create(periodic_log_cb, period_ms, NULL);
+}
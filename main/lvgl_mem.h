@@ -0,0 +1,88 @@
+/**
+ * @file lvgl_mem.h
+ * @brief LVGL自定义内存分配器
+ *
+ * 替代LVGL内置的固定256KB内存池：小块（对象、样式、短文本）放内部RAM，
+ * 大块（图层缓冲、长文本、图片）放PSRAM，内部RAM不足时互相回退。
+ * 按大小分级统计用量、峰值和最大空闲块。
+ *
+ * LVGL 通过 Kconfig 配置：sdkconfig.defaults 中的 CONFIG_LV_MEM_CUSTOM 打开自定义分配器，
+ * main/CMakeLists.txt 给 LVGL 组件定义 LV_MEM_CUSTOM_INCLUDE/ALLOC/FREE/REALLOC 指向本模块。
+ * 本头文件会被LVGL源码引入，不要包含LVGL头文件。
+ */
+
+#ifndef LVGL_MEM_H
+#define LVGL_MEM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 不超过该大小的分配优先放内部RAM
+#define LVGL_MEM_INTERNAL_MAX_SIZE 1024
+
+/**
+ * @brief 大小分级
+ */
+typedef enum {
+    LVGL_MEM_CLASS_32 = 0,   // <= 32B
+    LVGL_MEM_CLASS_128,      // <= 128B
+    LVGL_MEM_CLASS_512,      // <= 512B
+    LVGL_MEM_CLASS_2K,       // <= 2KB
+    LVGL_MEM_CLASS_8K,       // <= 8KB
+    LVGL_MEM_CLASS_LARGE,    // > 8KB
+    LVGL_MEM_CLASS_COUNT
+} lvgl_mem_class_t;
+
+/**
+ * @brief 单个大小分级的统计
+ */
+typedef struct {
+    uint32_t cur_bytes;      // 当前占用字节
+    uint32_t cur_blocks;     // 当前块数
+    uint32_t peak_bytes;     // 峰值字节
+    uint32_t alloc_calls;    // 累计分配次数
+} lvgl_mem_class_stats_t;
+
+/**
+ * @brief LVGL内存统计
+ */
+typedef struct {
+    lvgl_mem_class_stats_t classes[LVGL_MEM_CLASS_COUNT];
+    uint32_t cur_internal_bytes;     // 当前内部RAM占用
+    uint32_t cur_psram_bytes;        // 当前PSRAM占用
+    uint32_t peak_total_bytes;       // 总占用峰值（高水位）
+    uint32_t fallback_count;         // 首选区域不足而回退到另一区域的次数
+    uint32_t fail_count;             // 分配失败次数
+    uint32_t largest_free_internal;  // 内部RAM最大空闲块
+    uint32_t largest_free_psram;     // PSRAM最大空闲块
+} lvgl_mem_stats_t;
+
+void *lvgl_mem_alloc(size_t size);
+void lvgl_mem_free(void *ptr);
+void *lvgl_mem_realloc(void *ptr, size_t size);
+
+/**
+ * @brief 获取统计快照
+ */
+void lvgl_mem_get_stats(lvgl_mem_stats_t *stats);
+
+/**
+ * @brief 打印一次统计
+ */
+void lvgl_mem_log_stats(void);
+
+/**
+ * @brief 启动周期性统计日志（需在 lv_init 之后调用）
+ * @param period_ms 日志周期
+ */
+void lvgl_mem_start_periodic_log(uint32_t period_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -11,18 +11,31 @@
 #include "Vernon_ST7789T/Vernon_ST7789T.h"
 #include "driver/gpio.h"
 #include "driver/spi_master.h"
-#include "driver/ledc.h"
 #include "nvs_flash.h"
 #include "lvgl_driver.h"
+#include "lcd_frame.h"
 #include "wifi_manager.h"
 #include "todo_client.h"
+#include "todo_pager.h"
+#include "todo_outbox.h"
+#include "todo_push.h"
+#include "todo_refresh.h"
 #include "todo_ui.h"
+#include "refresh_governor.h"
+#include "retry_policy.h"
+#include "display_power.h"
+#include "todo_net.h"
+#include "todo_store.h"
+#include "app_tasks.h"
+#include "mem_tag.h"
 
 static const char *TAG = "TODO_APP";
 
 #define SERVER_URL CONFIG_TODO_SERVER_URL
 
 #define REFRESH_INTERVAL_MS (30 * 60 * 1000)
+#define PUSH_FALLBACK_REFRESH_MS (6 * 60 * 60 * 1000)  // 推送通道在线时只作兜底的轮询间隔
+#define PREFETCH_TAG UINT32_MAX   // 预取详情的结果不交给详情弹窗
 
 #define LCD_H_RES              240
 #define LCD_V_RES              320
@@ -39,34 +52,8 @@ static const char *TAG = "TODO_APP";
 
 esp_lcd_panel_handle_t panel_handle = NULL;
 
-static void lcd_backlight_init(void)
-{
-    ledc_timer_config_t ledc_timer = {
-        .speed_mode       = LEDC_LOW_SPEED_MODE,
-        .timer_num        = LEDC_TIMER_0,
-        .duty_resolution  = LEDC_TIMER_8_BIT,
-        .freq_hz          = 5000,
-        .clk_cfg          = LEDC_AUTO_CLK
-    };
-    ESP_ERROR_CHECK(ledc_timer_config(&ledc_timer));
-
-    ledc_channel_config_t ledc_channel = {
-        .speed_mode     = LEDC_LOW_SPEED_MODE,
-        .channel        = LEDC_CHANNEL_0,
-        .timer_sel      = LEDC_TIMER_0,
-        .intr_type      = LEDC_INTR_DISABLE,
-        .gpio_num       = LCD_PIN_BL,
-        .duty           = 0,
-        .hpoint         = 0
-    };
-    ESP_ERROR_CHECK(ledc_channel_config(&ledc_channel));
-}
-
-static void lcd_backlight_on(void)
-{
-    ESP_ERROR_CHECK(ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, 255));
-    ESP_ERROR_CHECK(ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0));
-}
+static bool wifi_connected = false;
+static bool prefetch_inflight = false;
 
 static void lcd_init(void)
 {
@@ -108,10 +95,144 @@ static void lcd_init(void)
     // 修复文字镜像问题：设置X轴镜像
     ESP_ERROR_CHECK(esp_lcd_panel_mirror(panel_handle, true, false));
     ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(panel_handle, true));
-    lcd_backlight_init();
+#if CONFIG_TODO_LCD_FULL_FRAME
+    ESP_ERROR_CHECK(lcd_frame_init(io_handle));
+#endif
+    ESP_ERROR_CHECK(display_power_init(LCD_PIN_BL));
     ESP_LOGI(TAG, "LCD initialized");
 }
 
+/**
+ * @brief 取出网络任务的结果，交给对应模块（列表数据的变化登记到 todo_store）
+ */
+static void apply_net_results(void)
+{
+    todo_net_result_t result;
+    
+    while (todo_net_poll(&result)) {
+        switch (result.op) {
+            case TODO_NET_FETCH_PAGE:
+                todo_pager_on_fetched(result.tag, result.err, result.block);
+                break;
+            case TODO_NET_SET_COMPLETED:
+                todo_outbox_on_sent(result.err);
+                break;
+            case TODO_NET_FETCH_DETAIL:
+                if (result.tag == PREFETCH_TAG) {
+                    prefetch_inflight = false;
+                } else {
+                    todo_ui_on_detail_fetched(result.tag, result.err);
+                }
+                break;
+        }
+    }
+}
+
+/**
+ * @brief 界面任务：LVGL渲染、触摸和界面逻辑，网络请求交给网络任务
+ */
+static void ui_task(void *arg)
+{
+    (void)arg;
+    
+    if (!wifi_connected) {
+        while (1) {
+            uint32_t next_timer_ms = lv_timer_handler();
+            display_power_process();
+            refresh_governor_wait(next_timer_ms);
+        }
+    }
+    
+    uint32_t last_refresh = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    retry_breaker_state_t breaker_state = RETRY_BREAKER_CLOSED;
+    bool manual_loading = false;  // 手动刷新的第一页到达前保持原有列表和顶栏的刷新提示
+    
+    while (1) {
+        uint32_t next_timer_ms = lv_timer_handler();
+        
+        uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+        
+        // 页数据、写操作结果、详情正文
+        apply_net_results();
+        
+#if CONFIG_TODO_PUSH
+        // 服务器推送的增量变化
+        todo_push_apply_pending();
+        uint32_t refresh_interval = todo_push_is_connected() ? PUSH_FALLBACK_REFRESH_MS : REFRESH_INTERVAL_MS;
+#else
+        uint32_t refresh_interval = REFRESH_INTERVAL_MS;
+#endif
+        
+        if (manual_loading && !todo_pager_is_resetting()) {
+            manual_loading = false;
+            todo_store_changed_structure();  // 整体换上新列表，同时隐藏刷新提示
+        }
+        if (!manual_loading) {
+            // 本轮合并的列表变化交给界面，只重新绑定受影响的卡片
+            todo_store_notify();
+        }
+        
+        if (todo_ui_take_refresh_request()) {
+            ESP_LOGI(TAG, "手动刷新TODO列表");
+            todo_refresh_request(TODO_REFRESH_MANUAL, true);
+        }
+        
+        if (now - last_refresh > refresh_interval) {
+            // 自动刷新只重新获取常驻页，保留滚动位置
+            ESP_LOGI(TAG, "自动刷新TODO列表...");
+            todo_refresh_request(TODO_REFRESH_TIMER, false);
+            last_refresh = now;
+        }
+        
+        // 各来源的刷新请求合并成一次执行
+        esp_err_t refresh_err = ESP_OK;
+        uint32_t served = todo_refresh_run(&refresh_err);
+        if (served != 0) {
+            last_refresh = now;  // 任何刷新都重置自动刷新计时
+            if (refresh_err == ESP_ERR_NOT_ALLOWED) {
+                ESP_LOGW(TAG, "服务器不可用，%lu ms 后重试", retry_policy_wait_ms(RETRY_ENDPOINT_LIST));
+            } else if (refresh_err != ESP_OK) {
+                ESP_LOGE(TAG, "刷新TODO列表失败");
+            }
+            if (served & TODO_REFRESH_BIT(TODO_REFRESH_MANUAL)) {
+                if (refresh_err == ESP_OK) {
+                    manual_loading = true;
+                } else {
+                    todo_ui_update();  // 没有发出请求，隐藏刷新提示，保留原有列表
+                }
+            }
+        } else if (todo_refresh_wait_ms() < next_timer_ms) {
+            // 被最小间隔推迟的请求到期时醒来执行
+            next_timer_ms = todo_refresh_wait_ms();
+        }
+        
+        // 没有在途请求时提交一页（滚动触发的预取、淘汰后重新获取、刷新），结果到达时唤醒本循环
+        todo_pager_process();
+        
+        // 排队的写操作，同一时刻最多一条在途
+        todo_outbox_flush();
+        
+        // 熔断状态变化时更新顶栏提示
+        retry_breaker_state_t state = retry_policy_get_breaker_state();
+        if (state != breaker_state) {
+            breaker_state = state;
+            todo_ui_show_server_status(state);
+        }
+        
+        // 预取可视区域附近的详情，同一时刻最多一条在途
+        if (!prefetch_inflight) {
+            const todo_item_t *prefetch = todo_ui_take_prefetch_item();
+            if (prefetch != NULL &&
+                todo_net_fetch_detail(prefetch->id, prefetch->listId, PREFETCH_TAG) == ESP_OK) {
+                prefetch_inflight = true;
+            }
+        }
+        
+        display_power_process();
+        refresh_governor_wait(next_timer_ms);
+    }
+}
+
 void app_main(void)
 {
     ESP_LOGI(TAG, "=================================");
@@ -135,7 +256,7 @@ void app_main(void)
     
     vTaskDelay(pdMS_TO_TICKS(50));
     lv_timer_handler();
-    lcd_backlight_on();
+    display_power_on();
     
     ESP_LOGI(TAG, "连接WiFi...");
     ret = wifi_init_sta();
@@ -149,6 +270,13 @@ void app_main(void)
             todo_ui_show_wifi_status(true, NULL);
         }
         
+        // 客户端先初始化并预热连接，TCP/TLS握手与下面的时间同步等待重叠
+        ESP_LOGI(TAG, "初始化TODO客户端...");
+        ESP_LOGI(TAG, "服务器地址: %s", SERVER_URL);
+        ESP_LOGW(TAG, "请确保修改SERVER_URL为您的电脑IP地址！");
+        todo_client_init(SERVER_URL);
+        todo_client_prewarm();
+        
         ESP_LOGI(TAG, "初始化SNTP时间同步...");
         esp_sntp_setoperatingmode(SNTP_OPMODE_POLL);
         esp_sntp_setservername(0, "pool.ntp.org");
@@ -189,60 +317,27 @@ void app_main(void)
             ESP_LOGI(TAG, "时间显示将在同步完成后自动更新");
         }
         
-        ESP_LOGI(TAG, "初始化TODO客户端...");
-        ESP_LOGI(TAG, "服务器地址: %s", SERVER_URL);
-        ESP_LOGW(TAG, "请确保修改SERVER_URL为您的电脑IP地址！");
-        todo_client_init(SERVER_URL);
-        
-        static todo_list_t todo_list;
-        if (todo_client_get_list(&todo_list) == ESP_OK) {
-            ESP_LOGI(TAG, "成功获取TODO列表，共%d项", todo_list.count);
-            todo_ui_update(&todo_list);
-        } else {
-            ESP_LOGE(TAG, "获取TODO列表失败");
-        }
+        todo_outbox_init();
+        ESP_ERROR_CHECK(todo_net_start());
         
-        todo_ui_show_loading(false);
+        // 第一页和之后的请求一样，由界面任务交给网络任务获取
+        todo_refresh_request(TODO_REFRESH_MANUAL, true);
         
-        ESP_LOGI(TAG, "进入主循环...");
-        uint32_t last_refresh = 0;
-        
-        while (1) {
-            lv_timer_handler();
-            
-            uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
-            
-            if (todo_ui_take_refresh_request()) {
-                ESP_LOGI(TAG, "手动刷新TODO列表");
-                if (todo_client_get_list(&todo_list) == ESP_OK) {
-                    todo_ui_update(&todo_list);
-                    last_refresh = now;  // 重置自动刷新计时
-                    todo_ui_show_loading(false);
-                } else {
-                    ESP_LOGE(TAG, "手动刷新TODO列表失败");
-                    todo_ui_show_loading(false);
-                }
-            }
-            
-            if (now - last_refresh > REFRESH_INTERVAL_MS) {
-                ESP_LOGI(TAG, "自动刷新TODO列表...");
-                if (todo_client_get_list(&todo_list) == ESP_OK) {
-                    todo_ui_update(&todo_list);
-                    last_refresh = now;
-                }
-            }
-            
-            vTaskDelay(pdMS_TO_TICKS(10));
-        }
+#if CONFIG_TODO_PUSH
+        todo_push_start();
+#endif
         
     } else {
         ESP_LOGE(TAG, "WiFi连接失败！");
         todo_ui_show_wifi_status(false, NULL);
         todo_ui_show_loading(false);
-        
-        while (1) {
-            lv_timer_handler();
-            vTaskDelay(pdMS_TO_TICKS(10));
-        }
     }
+    
+    wifi_connected = ret == ESP_OK;
+#if CONFIG_TODO_MEM_CONSOLE
+    mem_tag_console_start();
+#endif
+    ESP_LOGI(TAG, "进入主循环...");
+    ESP_ERROR_CHECK(app_tasks_create(ui_task, "todo_ui", APP_UI_TASK_STACK_SIZE, APP_UI_TASK_PRIORITY,
+                                     APP_UI_CORE, NULL));
 }
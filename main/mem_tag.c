@@ -0,0 +1,255 @@
+/**
+ * @file mem_tag.c
+ * @brief 按子系统标记的堆内存统计实现
+ *
+ * 释放时用 heap_caps_get_allocated_size 取回块大小、按地址判断所在区域，
+ * 分配时也按实际块大小计入，块前不需要额外的头。
+ */
+
+#include "mem_tag.h"
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_heap_caps.h"
+#include "esp_memory_utils.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#if CONFIG_TODO_MEM_CONSOLE
+#include "esp_console.h"
+#include "app_tasks.h"
+#endif
+
+static const char *TAG = "mem_tag";
+
+#define CAPS_INTERNAL (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#define CAPS_PSRAM    (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+
+static const char *tag_names[MEM_TAG_COUNT] = {
+    [MEM_TAG_UI] = "界面",
+    [MEM_TAG_LVGL] = "LVGL",
+    [MEM_TAG_CLIENT] = "客户端",
+    [MEM_TAG_CACHE] = "缓存",
+    [MEM_TAG_NET] = "网络",
+};
+
+static portMUX_TYPE usage_lock = portMUX_INITIALIZER_UNLOCKED;
+static mem_tag_usage_t usage[MEM_TAG_COUNT];
+static int64_t last_log_us = 0;
+
+void mem_tag_record(mem_tag_t tag, bool psram, int32_t bytes)
+{
+    if (tag >= MEM_TAG_COUNT || bytes == 0) {
+        return;
+    }
+
+    taskENTER_CRITICAL(&usage_lock);
+    mem_tag_usage_t *u = &usage[tag];
+    if (psram) {
+        u->cur_psram += bytes;
+        if (u->cur_psram > u->peak_psram) {
+            u->peak_psram = u->cur_psram;
+        }
+    } else {
+        u->cur_internal += bytes;
+        if (u->cur_internal > u->peak_internal) {
+            u->peak_internal = u->cur_internal;
+        }
+    }
+    taskEXIT_CRITICAL(&usage_lock);
+}
+
+static void record_block(mem_tag_t tag, void *ptr, int sign)
+{
+    if (ptr != NULL) {
+        mem_tag_record(tag, esp_ptr_external_ram(ptr), sign * (int32_t)heap_caps_get_allocated_size(ptr));
+    }
+}
+
+void *mem_tag_malloc(mem_tag_t tag, size_t size, uint32_t caps)
+{
+    void *ptr = heap_caps_malloc(size, caps);
+    record_block(tag, ptr, 1);
+    return ptr;
+}
+
+void *mem_tag_calloc(mem_tag_t tag, size_t n, size_t size, uint32_t caps)
+{
+    void *ptr = heap_caps_calloc(n, size, caps);
+    record_block(tag, ptr, 1);
+    return ptr;
+}
+
+void *mem_tag_realloc(mem_tag_t tag, void *ptr, size_t size, uint32_t caps)
+{
+    bool old_psram = ptr != NULL && esp_ptr_external_ram(ptr);
+    int32_t old_size = ptr != NULL ? (int32_t)heap_caps_get_allocated_size(ptr) : 0;
+
+    void *grown = heap_caps_realloc(ptr, size, caps);
+    if (grown == NULL && size > 0) {
+        return NULL;    // 原块保持不变
+    }
+    mem_tag_record(tag, old_psram, -old_size);
+    record_block(tag, grown, 1);
+    return grown;
+}
+
+void mem_tag_free(mem_tag_t tag, void *ptr)
+{
+    record_block(tag, ptr, -1);
+    heap_caps_free(ptr);
+}
+
+const char *mem_tag_name(mem_tag_t tag)
+{
+    return tag < MEM_TAG_COUNT ? tag_names[tag] : "?";
+}
+
+void mem_tag_get_report(mem_tag_report_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+
+    memset(out, 0, sizeof(*out));
+    taskENTER_CRITICAL(&usage_lock);
+    memcpy(out->tags, usage, sizeof(usage));
+    taskEXIT_CRITICAL(&usage_lock);
+
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, CAPS_INTERNAL);
+    out->used_internal = info.total_allocated_bytes;
+    out->free_internal = info.total_free_bytes;
+    out->min_free_internal = info.minimum_free_bytes;
+    out->largest_free_internal = info.largest_free_block;
+    heap_caps_get_info(&info, CAPS_PSRAM);
+    out->used_psram = info.total_allocated_bytes;
+    out->free_psram = info.total_free_bytes;
+    out->min_free_psram = info.minimum_free_bytes;
+    out->largest_free_psram = info.largest_free_block;
+
+    uint32_t tagged_internal = 0;
+    uint32_t tagged_psram = 0;
+    for (int i = 0; i < MEM_TAG_COUNT; i++) {
+        tagged_internal += out->tags[i].cur_internal;
+        tagged_psram += out->tags[i].cur_psram;
+    }
+    out->untagged_internal = out->used_internal > tagged_internal ? out->used_internal - tagged_internal : 0;
+    out->untagged_psram = out->used_psram > tagged_psram ? out->used_psram - tagged_psram : 0;
+}
+
+// 以KB显示，保留一位小数
+#define KB_FMT "%lu.%lu"
+#define KB_ARG(v) (unsigned long)((v) / 1024), (unsigned long)((v) % 1024 * 10 / 1024)
+
+size_t mem_tag_format(char *buf, size_t len)
+{
+    if (buf == NULL || len == 0) {
+        return 0;
+    }
+
+    mem_tag_report_t r;
+    mem_tag_get_report(&r);
+
+    size_t n = 0;
+#define APPEND(...)                                                         \
+    do {                                                                    \
+        if (n < len) {                                                      \
+            int w = snprintf(buf + n, len - n, __VA_ARGS__);                \
+            n += w > 0 ? (size_t)w : 0;                                     \
+        }                                                                   \
+    } while (0)
+
+    APPEND("KB       内部RAM 当前/峰值   PSRAM 当前/峰值\n");
+    for (int i = 0; i < MEM_TAG_COUNT; i++) {
+        const mem_tag_usage_t *u = &r.tags[i];
+        APPEND("%-6s " KB_FMT "/" KB_FMT "   " KB_FMT "/" KB_FMT "\n", tag_names[i],
+               KB_ARG(u->cur_internal), KB_ARG(u->peak_internal),
+               KB_ARG(u->cur_psram), KB_ARG(u->peak_psram));
+    }
+    APPEND("未标记 " KB_FMT "   " KB_FMT "\n", KB_ARG(r.untagged_internal), KB_ARG(r.untagged_psram));
+    APPEND("已用   " KB_FMT "   " KB_FMT "\n", KB_ARG(r.used_internal), KB_ARG(r.used_psram));
+    APPEND("空闲   " KB_FMT "(最小 " KB_FMT ")   " KB_FMT "(最小 " KB_FMT ")\n",
+           KB_ARG(r.free_internal), KB_ARG(r.min_free_internal),
+           KB_ARG(r.free_psram), KB_ARG(r.min_free_psram));
+    APPEND("最大块 " KB_FMT "   " KB_FMT "\n", KB_ARG(r.largest_free_internal), KB_ARG(r.largest_free_psram));
+#undef APPEND
+
+    return n < len ? n : len - 1;
+}
+
+void mem_tag_log_periodic(void)
+{
+    int64_t now = esp_timer_get_time();
+    if (last_log_us != 0 && now - last_log_us < (int64_t)MEM_TAG_LOG_INTERVAL_MS * 1000) {
+        return;
+    }
+    last_log_us = now;
+
+    mem_tag_report_t r;
+    mem_tag_get_report(&r);
+
+    // 每个子系统 "名称 内部/PSRAM"，一行打完
+    char line[256] = {0};
+    int len = 0;
+    for (int i = 0; i < MEM_TAG_COUNT && len < (int)sizeof(line); i++) {
+        len += snprintf(line + len, sizeof(line) - len, " %s " KB_FMT "/" KB_FMT, tag_names[i],
+                        KB_ARG(r.tags[i].cur_internal), KB_ARG(r.tags[i].cur_psram));
+    }
+    ESP_LOGI(TAG, "内存KB 内部/PSRAM:%s 未标记 " KB_FMT "/" KB_FMT "，空闲 " KB_FMT "/" KB_FMT
+             "，最大空闲块 " KB_FMT "/" KB_FMT, line,
+             KB_ARG(r.untagged_internal), KB_ARG(r.untagged_psram),
+             KB_ARG(r.free_internal), KB_ARG(r.free_psram),
+             KB_ARG(r.largest_free_internal), KB_ARG(r.largest_free_psram));
+}
+
+#if CONFIG_TODO_MEM_CONSOLE
+static int mem_cmd(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    static char text[1024];    // 只在控制台任务中使用
+    mem_tag_format(text, sizeof(text));
+    printf("%s", text);
+    return 0;
+}
+
+esp_err_t mem_tag_console_start(void)
+{
+    esp_console_repl_t *repl = NULL;
+    esp_console_repl_config_t repl_config = ESP_CONSOLE_REPL_CONFIG_DEFAULT();
+    repl_config.prompt = "todo>";
+    repl_config.task_core_id = APP_NET_CORE;
+
+#if CONFIG_ESP_CONSOLE_USB_SERIAL_JTAG
+    esp_console_dev_usb_serial_jtag_config_t hw_config = ESP_CONSOLE_DEV_USB_SERIAL_JTAG_CONFIG_DEFAULT();
+    esp_err_t err = esp_console_new_repl_usb_serial_jtag(&hw_config, &repl_config, &repl);
+#else
+    esp_console_dev_uart_config_t hw_config = ESP_CONSOLE_DEV_UART_CONFIG_DEFAULT();
+    esp_err_t err = esp_console_new_repl_uart(&hw_config, &repl_config, &repl);
+#endif
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "控制台创建失败: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    const esp_console_cmd_t cmd = {
+        .command = "mem",
+        .help = "按子系统显示内部RAM/PSRAM占用、峰值和最大空闲块",
+        .func = mem_cmd,
+    };
+    err = esp_console_cmd_register(&cmd);
+    if (err == ESP_OK) {
+        err = esp_console_start_repl(repl);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "控制台启动失败: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+#else
+esp_err_t mem_tag_console_start(void)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+#endif
@@ -0,0 +1,116 @@
+/**
+ * @file mem_tag.h
+ * @brief 按子系统标记的堆内存统计
+ *
+ * 应用自己的分配都经过 mem_tag_malloc 等函数（或由 lvgl_mem 等分配器调用 mem_tag_record），
+ * 按子系统分别统计内部RAM和PSRAM的当前占用和峰值。
+ * WiFi、lwIP、esp_http_client、mbedTLS 等 IDF 组件内部的分配无法标记，
+ * 整个堆的已用量减去所有标记的部分即为“未标记”，网络栈的占用体现在这里。
+ *
+ * 统计可在任意任务中更新；结果通过控制台 mem 命令、每分钟一行日志和可选的屏幕调试页查看。
+ */
+
+#ifndef MEM_TAG_H
+#define MEM_TAG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MEM_TAG_LOG_INTERVAL_MS 60000
+
+/**
+ * @brief 子系统
+ */
+typedef enum {
+    MEM_TAG_UI = 0,     // 界面数据：分页、列表数据块、写操作队列、详情缓冲区
+    MEM_TAG_LVGL,       // LVGL 对象/样式（lvgl_mem）与绘制缓冲区
+    MEM_TAG_CLIENT,     // HTTP 客户端：cJSON 内存池、gzip 解压状态
+    MEM_TAG_CACHE,      // 渲染与内容缓存：卡片背景、详情正文
+    MEM_TAG_NET,        // 网络任务队列
+    MEM_TAG_COUNT
+} mem_tag_t;
+
+/**
+ * @brief 单个子系统的占用
+ */
+typedef struct {
+    uint32_t cur_internal;
+    uint32_t cur_psram;
+    uint32_t peak_internal;
+    uint32_t peak_psram;
+} mem_tag_usage_t;
+
+/**
+ * @brief 统计快照
+ */
+typedef struct {
+    mem_tag_usage_t tags[MEM_TAG_COUNT];
+    uint32_t used_internal;         // 整个堆已用
+    uint32_t used_psram;
+    uint32_t untagged_internal;     // 未标记（WiFi、lwIP、TLS、HTTP客户端、任务栈等）
+    uint32_t untagged_psram;
+    uint32_t free_internal;
+    uint32_t free_psram;
+    uint32_t min_free_internal;     // 开机以来最小空闲
+    uint32_t min_free_psram;
+    uint32_t largest_free_internal; // 最大空闲块，远小于空闲总量说明碎片严重
+    uint32_t largest_free_psram;
+} mem_tag_report_t;
+
+/**
+ * @brief 按 caps 分配并计入子系统
+ */
+void *mem_tag_malloc(mem_tag_t tag, size_t size, uint32_t caps);
+
+void *mem_tag_calloc(mem_tag_t tag, size_t n, size_t size, uint32_t caps);
+
+void *mem_tag_realloc(mem_tag_t tag, void *ptr, size_t size, uint32_t caps);
+
+/**
+ * @brief 释放并从子系统扣除（tag 必须与分配时一致，NULL 忽略）
+ */
+void mem_tag_free(mem_tag_t tag, void *ptr);
+
+/**
+ * @brief 由自带分配器的模块直接登记占用变化
+ * @param bytes 正数为分配，负数为释放
+ */
+void mem_tag_record(mem_tag_t tag, bool psram, int32_t bytes);
+
+/**
+ * @brief 子系统名称
+ */
+const char *mem_tag_name(mem_tag_t tag);
+
+/**
+ * @brief 获取统计快照
+ */
+void mem_tag_get_report(mem_tag_report_t *report);
+
+/**
+ * @brief 把统计格式化为多行文本（控制台和调试页共用）
+ * @return 写入的字节数（不含结尾'\0'）
+ */
+size_t mem_tag_format(char *buf, size_t len);
+
+/**
+ * @brief 到达周期时打印一行统计（网络任务主循环中调用）
+ */
+void mem_tag_log_periodic(void);
+
+/**
+ * @brief 启动串口控制台并注册 mem 命令（TODO_MEM_CONSOLE）
+ */
+esp_err_t mem_tag_console_start(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
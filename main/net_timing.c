@@ -0,0 +1,141 @@
+/**
+ * @file net_timing.c
+ * @brief 网络请求分阶段耗时统计实现
+ */
+
+#include "net_timing.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "net_timing";
+
+// 桶上界（微秒），最后一个桶收集超过 5 秒的样本
+static const uint32_t bucket_bounds_us[] = {
+    100, 200, 500,
+    1000, 2000, 5000,
+    10000, 20000, 50000,
+    100000, 200000, 500000,
+    1000000, 2000000, 5000000,
+    UINT32_MAX,
+};
+#define BUCKET_COUNT (sizeof(bucket_bounds_us) / sizeof(bucket_bounds_us[0]))
+
+typedef struct {
+    uint32_t buckets[BUCKET_COUNT];
+    uint32_t count;
+    uint32_t max_us;
+} histogram_t;
+
+static histogram_t histograms[NET_PHASE_COUNT];
+
+static const char *phase_names[NET_PHASE_COUNT] = {
+    "解析DNS", "连接", "发送", "等待", "接收", "解析", "界面",
+};
+
+static int64_t last_log_us = 0;
+static uint32_t samples_since_log = 0;
+
+// 网络任务记录请求各阶段，界面任务记录界面更新
+static portMUX_TYPE timing_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void net_timing_record(net_phase_t phase, int64_t duration_us)
+{
+    if (phase >= NET_PHASE_COUNT) {
+        return;
+    }
+
+    uint32_t us = duration_us < 0 ? 0 : duration_us > UINT32_MAX - 1 ? UINT32_MAX - 1 : (uint32_t)duration_us;
+    histogram_t *h = &histograms[phase];
+    size_t i = 0;
+    while (us > bucket_bounds_us[i]) {
+        i++;
+    }
+
+    taskENTER_CRITICAL(&timing_lock);
+    h->buckets[i]++;
+    h->count++;
+    if (us > h->max_us) {
+        h->max_us = us;
+    }
+    samples_since_log++;
+    taskEXIT_CRITICAL(&timing_lock);
+}
+
+/**
+ * @brief 第 permille/1000 个样本所在桶的上界（最后一个桶用最大值代替）
+ */
+static uint32_t percentile(const histogram_t *h, uint32_t permille)
+{
+    if (h->count == 0) {
+        return 0;
+    }
+
+    uint32_t target = (uint32_t)(((uint64_t)h->count * permille + 999) / 1000);
+    uint32_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += h->buckets[i];
+        if (seen >= target) {
+            return bucket_bounds_us[i] < h->max_us ? bucket_bounds_us[i] : h->max_us;
+        }
+    }
+    return h->max_us;
+}
+
+void net_timing_get_summary(net_phase_t phase, net_timing_summary_t *summary)
+{
+    if (phase >= NET_PHASE_COUNT || summary == NULL) {
+        return;
+    }
+
+    histogram_t h;
+    taskENTER_CRITICAL(&timing_lock);
+    h = histograms[phase];
+    taskEXIT_CRITICAL(&timing_lock);
+
+    summary->count = h.count;
+    summary->p50_us = percentile(&h, 500);
+    summary->p95_us = percentile(&h, 950);
+    summary->p99_us = percentile(&h, 990);
+    summary->max_us = h.max_us;
+}
+
+const char *net_timing_phase_name(net_phase_t phase)
+{
+    return phase < NET_PHASE_COUNT ? phase_names[phase] : "?";
+}
+
+void net_timing_log_periodic(void)
+{
+    int64_t now = esp_timer_get_time();
+    taskENTER_CRITICAL(&timing_lock);
+    bool due = now - last_log_us >= (int64_t)NET_TIMING_LOG_INTERVAL_MS * 1000 && samples_since_log > 0;
+    if (due) {
+        samples_since_log = 0;
+    }
+    taskEXIT_CRITICAL(&timing_lock);
+    if (!due) {
+        return;
+    }
+    last_log_us = now;
+
+    // 每阶段 "名称 p50/p95/p99 ms"，一行打完
+    char line[384] = {0};
+    int len = 0;
+    for (int i = 0; i < NET_PHASE_COUNT && len < (int)sizeof(line); i++) {
+        net_timing_summary_t s;
+        net_timing_get_summary(i, &s);
+        if (s.count == 0) {
+            continue;
+        }
+        len += snprintf(line + len, sizeof(line) - len, " %s %lu.%lu/%lu.%lu/%lu.%lu",
+                        phase_names[i],
+                        s.p50_us / 1000, (s.p50_us % 1000) / 100,
+                        s.p95_us / 1000, (s.p95_us % 1000) / 100,
+                        s.p99_us / 1000, (s.p99_us % 1000) / 100);
+    }
+    ESP_LOGI(TAG, "p50/p95/p99 ms:%s", line);
+}
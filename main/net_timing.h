@@ -0,0 +1,73 @@
+/**
+ * @file net_timing.h
+ * @brief 网络请求分阶段耗时统计
+ *
+ * 每次请求按阶段（DNS解析、建立连接、发送请求、等待首字节、接收、解析、界面更新）
+ * 记录耗时，放进固定分桶的直方图，可随时查询 p50/p95/p99，并定期打印一行汇总。
+ * 分桶按 1-2-5 递增，百分位取所在桶的上界，精度足够区分瓶颈在哪个阶段。
+ *
+ * 网络任务记录请求各阶段，界面任务记录界面更新，直方图由自旋锁保护；
+ * 汇总日志只在网络任务中打印。
+ */
+
+#ifndef NET_TIMING_H
+#define NET_TIMING_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NET_TIMING_LOG_INTERVAL_MS  60000
+
+/**
+ * @brief 请求阶段
+ */
+typedef enum {
+    NET_PHASE_RESOLVE = 0,   // DNS解析（复用长连接时没有）
+    NET_PHASE_CONNECT,       // TCP连接 + TLS握手（复用长连接时没有）
+    NET_PHASE_SEND,          // 发送请求头/请求体
+    NET_PHASE_WAIT,          // 请求发出到收到首字节（服务器处理 + Graph 往返）
+    NET_PHASE_RECEIVE,       // 首字节到末字节（含边收边解压）
+    NET_PHASE_PARSE,         // JSON/CBOR 解析
+    NET_PHASE_UI_APPLY,      // 数据绑定到界面
+    NET_PHASE_COUNT,
+} net_phase_t;
+
+/**
+ * @brief 某阶段的汇总
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t p50_us;
+    uint32_t p95_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+} net_timing_summary_t;
+
+/**
+ * @brief 记录一个阶段的耗时
+ */
+void net_timing_record(net_phase_t phase, int64_t duration_us);
+
+/**
+ * @brief 获取某阶段的汇总（自启动以来）
+ */
+void net_timing_get_summary(net_phase_t phase, net_timing_summary_t *summary);
+
+/**
+ * @brief 阶段名称
+ */
+const char *net_timing_phase_name(net_phase_t phase);
+
+/**
+ * @brief 在网络任务中调用，每 NET_TIMING_LOG_INTERVAL_MS 打印一次汇总（没有新样本时不打印）
+ */
+void net_timing_log_periodic(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
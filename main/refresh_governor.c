@@ -0,0 +1,265 @@
+/**
+ * @file refresh_governor.c
+ * @brief 自适应刷新率调节实现
+ */
+
+#include "refresh_governor.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "touch_driver.h"
+
+static const char *TAG = "refresh_gov";
+
+#define ACTIVE_REFR_PERIOD_MS     15    // 交互时约66fps
+#define NORMAL_REFR_PERIOD_MS     30
+#define IDLE_REFR_PERIOD_MS       1000  // 只剩时钟时约1Hz
+
+#define ACTIVE_INDEV_PERIOD_MS    15
+#define NORMAL_INDEV_PERIOD_MS    30
+#define IDLE_INDEV_PERIOD_MS      1000  // 有触摸中断唤醒时空闲可以很慢
+#define IDLE_INDEV_POLL_MS        100   // 没有触摸中断时的空闲轮询周期
+
+#define ACTIVE_HOLD_MS            300   // 松手后保持高帧率的时间
+#define IDLE_AFTER_MS             5000  // 无操作多久后进入空闲
+
+#define MAX_SLEEP_MS              1000  // 主循环最长睡眠
+#define STATS_WINDOW_US           (1000 * 1000)
+#define STATS_LOG_INTERVAL_US     (60LL * 1000 * 1000)
+
+static lv_disp_t *gov_disp = NULL;
+static lv_indev_t *gov_indev = NULL;
+static SemaphoreHandle_t wake_sem = NULL;
+static bool touch_irq_enabled = false;
+static volatile bool touch_irq_pending = false;
+
+static refresh_mode_t current_mode = REFRESH_MODE_NORMAL;
+
+// 统计窗口内的累计值
+static uint32_t win_frames = 0;
+static uint32_t win_render_ms = 0;
+static uint32_t win_frame_interval_max_ms = 0;
+static uint32_t win_wakeups = 0;
+static int64_t win_start_us = 0;
+static int64_t last_frame_us = 0;
+static int64_t last_log_us = 0;
+
+static refresh_governor_stats_t stats;
+
+static void IRAM_ATTR touch_isr_cb(esp_lcd_touch_handle_t touch)
+{
+    (void)touch;
+    BaseType_t hp_task_woken = pdFALSE;
+    touch_irq_pending = true;
+    xSemaphoreGiveFromISR(wake_sem, &hp_task_woken);
+    if (hp_task_woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+static uint32_t indev_period_for(refresh_mode_t mode)
+{
+    switch (mode) {
+        case REFRESH_MODE_ACTIVE:
+            return ACTIVE_INDEV_PERIOD_MS;
+        case REFRESH_MODE_NORMAL:
+            return NORMAL_INDEV_PERIOD_MS;
+        default:
+            return touch_irq_enabled ? IDLE_INDEV_PERIOD_MS : IDLE_INDEV_POLL_MS;
+    }
+}
+
+static uint32_t refr_period_for(refresh_mode_t mode)
+{
+    switch (mode) {
+        case REFRESH_MODE_ACTIVE:
+            return ACTIVE_REFR_PERIOD_MS;
+        case REFRESH_MODE_NORMAL:
+            return NORMAL_REFR_PERIOD_MS;
+        default:
+            return IDLE_REFR_PERIOD_MS;
+    }
+}
+
+static void set_mode(refresh_mode_t mode)
+{
+    if (mode == current_mode) {
+        return;
+    }
+
+    ESP_LOGD(TAG, "刷新模式: %s -> %s",
+             refresh_governor_mode_name(current_mode), refresh_governor_mode_name(mode));
+    current_mode = mode;
+
+    lv_timer_set_period(gov_disp->refr_timer, refr_period_for(mode));
+    if (gov_indev != NULL) {
+        lv_timer_set_period(gov_indev->driver->read_timer, indev_period_for(mode));
+    }
+}
+
+static refresh_mode_t evaluate_mode(void)
+{
+    bool pressed = false;
+    bool scrolling = false;
+
+    if (gov_indev != NULL) {
+        pressed = gov_indev->proc.state == LV_INDEV_STATE_PRESSED;
+        scrolling = lv_indev_get_scroll_obj(gov_indev) != NULL;
+    }
+
+    uint32_t inactive_ms = lv_disp_get_inactive_time(gov_disp);
+
+    if (pressed || scrolling || lv_anim_count_running() > 0 || inactive_ms < ACTIVE_HOLD_MS) {
+        return REFRESH_MODE_ACTIVE;
+    }
+    if (inactive_ms < IDLE_AFTER_MS) {
+        return REFRESH_MODE_NORMAL;
+    }
+    return REFRESH_MODE_IDLE;
+}
+
+static void roll_stats_window(int64_t now_us)
+{
+    int64_t elapsed_us = now_us - win_start_us;
+    if (elapsed_us < STATS_WINDOW_US) {
+        return;
+    }
+
+    stats.mode = current_mode;
+    stats.refr_period_ms = refr_period_for(current_mode);
+    stats.indev_period_ms = indev_period_for(current_mode);
+    stats.fps = (uint32_t)((int64_t)win_frames * 1000000 / elapsed_us);
+    stats.frame_interval_max_ms = win_frame_interval_max_ms;
+    stats.render_time_avg_ms = win_frames ? win_render_ms / win_frames : 0;
+    stats.wakeups_per_sec = (uint32_t)((int64_t)win_wakeups * 1000000 / elapsed_us);
+
+    win_frames = 0;
+    win_render_ms = 0;
+    win_frame_interval_max_ms = 0;
+    win_wakeups = 0;
+    win_start_us = now_us;
+
+    if (now_us - last_log_us >= STATS_LOG_INTERVAL_US) {
+        last_log_us = now_us;
+        ESP_LOGI(TAG, "模式 %s, 刷新周期 %lu ms, %lu fps, 最大帧间隔 %lu ms, 渲染 %lu ms/帧, 唤醒 %lu 次/秒",
+                 refresh_governor_mode_name(stats.mode), stats.refr_period_ms, stats.fps,
+                 stats.frame_interval_max_ms, stats.render_time_avg_ms, stats.wakeups_per_sec);
+    }
+}
+
+void refresh_governor_init(lv_disp_t *disp, lv_indev_t *indev)
+{
+    gov_disp = disp;
+    gov_indev = indev;
+    wake_sem = xSemaphoreCreateBinary();
+
+    if (indev != NULL && tp != NULL) {
+        touch_irq_enabled = esp_lcd_touch_register_interrupt_callback(tp, touch_isr_cb) == ESP_OK;
+    }
+    if (!touch_irq_enabled) {
+        ESP_LOGW(TAG, "触摸中断不可用，空闲时按 %d ms 轮询触摸", IDLE_INDEV_POLL_MS);
+    }
+
+    current_mode = REFRESH_MODE_NORMAL;
+    lv_timer_set_period(gov_disp->refr_timer, NORMAL_REFR_PERIOD_MS);
+    if (gov_indev != NULL) {
+        lv_timer_set_period(gov_indev->driver->read_timer, NORMAL_INDEV_PERIOD_MS);
+    }
+
+    win_start_us = esp_timer_get_time();
+    last_log_us = win_start_us;
+    ESP_LOGI(TAG, "自适应刷新已启用 (%d/%d/%d ms)",
+             ACTIVE_REFR_PERIOD_MS, NORMAL_REFR_PERIOD_MS, IDLE_REFR_PERIOD_MS);
+}
+
+void refresh_governor_monitor_cb(lv_disp_drv_t *drv, uint32_t time, uint32_t px)
+{
+    (void)drv;
+    (void)px;
+
+    int64_t now_us = esp_timer_get_time();
+    if (last_frame_us != 0) {
+        uint32_t interval_ms = (uint32_t)((now_us - last_frame_us) / 1000);
+        if (interval_ms > win_frame_interval_max_ms) {
+            win_frame_interval_max_ms = interval_ms;
+        }
+    }
+    last_frame_us = now_us;
+    win_frames++;
+    win_render_ms += time;
+}
+
+void refresh_governor_wait(uint32_t next_timer_ms)
+{
+    if (gov_disp == NULL) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+        return;
+    }
+
+    refresh_mode_t prev_mode = current_mode;
+    if (touch_irq_pending) {
+        // 触摸中断到来：立即读取触摸并切到高帧率
+        touch_irq_pending = false;
+        if (gov_indev != NULL) {
+            lv_timer_ready(gov_indev->driver->read_timer);
+        }
+        set_mode(REFRESH_MODE_ACTIVE);
+        next_timer_ms = 0;
+    } else {
+        set_mode(evaluate_mode());
+    }
+
+    // 切到更快的模式时（轮询读到按下），next_timer_ms 还是按旧周期算的，不能照睡
+    bool sped_up = current_mode < prev_mode;
+    if (sped_up && next_timer_ms > refr_period_for(current_mode)) {
+        next_timer_ms = refr_period_for(current_mode);
+    }
+
+    // 有待刷新的区域（时钟走字、列表更新、刚按下）时不必等满一个周期；黑屏暂停刷新时除外
+    if ((current_mode != REFRESH_MODE_ACTIVE || sped_up) &&
+        gov_disp->inv_p > 0 && !gov_disp->refr_timer->paused) {
+        lv_timer_ready(gov_disp->refr_timer);
+        next_timer_ms = 0;
+    }
+
+    uint32_t sleep_ms = next_timer_ms > MAX_SLEEP_MS ? MAX_SLEEP_MS : next_timer_ms;
+    if (sleep_ms > 0) {
+        TickType_t ticks = pdMS_TO_TICKS(sleep_ms);
+        xSemaphoreTake(wake_sem, ticks > 0 ? ticks : 1);
+    }
+
+    win_wakeups++;
+    roll_stats_window(esp_timer_get_time());
+}
+
+void refresh_governor_wake(void)
+{
+    if (wake_sem != NULL) {
+        xSemaphoreGive(wake_sem);
+    }
+}
+
+void refresh_governor_get_stats(refresh_governor_stats_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+    *out = stats;
+}
+
+const char *refresh_governor_mode_name(refresh_mode_t mode)
+{
+    switch (mode) {
+        case REFRESH_MODE_ACTIVE:
+            return "active";
+        case REFRESH_MODE_NORMAL:
+            return "normal";
+        case REFRESH_MODE_IDLE:
+            return "idle";
+        default:
+            return "unknown";
+    }
+}
@@ -0,0 +1,79 @@
+/**
+ * @file refresh_governor.h
+ * @brief 自适应刷新率调节
+ *
+ * 根据界面活动调整LVGL显示刷新定时器和触摸读取定时器的周期：
+ * 滚动/按压/动画时提高帧率，只有时钟在走时降到约1Hz，
+ * 空闲时主循环阻塞等待下一个定时器或触摸中断，而不是每10ms轮询一次。
+ */
+
+#ifndef REFRESH_GOVERNOR_H
+#define REFRESH_GOVERNOR_H
+
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 刷新模式
+ */
+typedef enum {
+    REFRESH_MODE_ACTIVE = 0,  // 触摸/滚动/动画中
+    REFRESH_MODE_NORMAL,      // 刚结束交互
+    REFRESH_MODE_IDLE,        // 空闲，只有时钟在变化
+} refresh_mode_t;
+
+/**
+ * @brief 刷新统计（每秒更新一次）
+ */
+typedef struct {
+    refresh_mode_t mode;
+    uint32_t refr_period_ms;         // 当前显示刷新周期
+    uint32_t indev_period_ms;        // 当前触摸读取周期
+    uint32_t fps;                    // 最近1秒实际刷新帧数
+    uint32_t frame_interval_max_ms;  // 最近1秒最大帧间隔（帧节奏）
+    uint32_t render_time_avg_ms;     // 最近1秒平均每帧渲染耗时
+    uint32_t wakeups_per_sec;        // 最近1秒主循环唤醒次数
+} refresh_governor_stats_t;
+
+/**
+ * @brief 初始化刷新调节器（在显示和触摸注册之后调用）
+ * @param disp LVGL显示
+ * @param indev 触摸输入设备，可为NULL
+ */
+void refresh_governor_init(lv_disp_t *disp, lv_indev_t *indev);
+
+/**
+ * @brief LVGL monitor_cb，每刷新一帧调用一次
+ */
+void refresh_governor_monitor_cb(lv_disp_drv_t *drv, uint32_t time, uint32_t px);
+
+/**
+ * @brief 根据活动状态调整刷新率，并睡眠到下一个LVGL定时器到期或被触摸唤醒
+ * @param next_timer_ms lv_timer_handler() 的返回值
+ */
+void refresh_governor_wait(uint32_t next_timer_ms);
+
+/**
+ * @brief 从其他任务唤醒主循环（例如有新数据需要显示）
+ */
+void refresh_governor_wake(void);
+
+/**
+ * @brief 获取刷新统计
+ */
+void refresh_governor_get_stats(refresh_governor_stats_t *stats);
+
+/**
+ * @brief 模式名称
+ */
+const char *refresh_governor_mode_name(refresh_mode_t mode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,211 @@
+/**
+ * @file retry_policy.c
+ * @brief 请求重试策略与熔断器实现
+ */
+
+#include "retry_policy.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+
+static const char *TAG = "retry_policy";
+
+typedef struct {
+    uint32_t base_ms;    // 第一次失败后的退避
+    uint32_t max_ms;     // 退避上限
+} endpoint_policy_t;
+
+// 列表由自动刷新和滚动触发，退避上限放宽；详情和写操作由用户触发，上限较短
+static const endpoint_policy_t policies[RETRY_ENDPOINT_COUNT] = {
+    [RETRY_ENDPOINT_LIST]     = { .base_ms = 2000, .max_ms = 5 * 60 * 1000 },
+    [RETRY_ENDPOINT_DETAIL]   = { .base_ms = 1000, .max_ms = 30 * 1000 },
+    [RETRY_ENDPOINT_MUTATION] = { .base_ms = 1000, .max_ms = 30 * 1000 },
+};
+
+static const char *endpoint_names[RETRY_ENDPOINT_COUNT] = { "列表", "详情", "写操作" };
+
+static uint32_t failures_in_row[RETRY_ENDPOINT_COUNT];
+static int64_t next_allowed_ms[RETRY_ENDPOINT_COUNT];
+
+static retry_breaker_state_t breaker = RETRY_BREAKER_CLOSED;
+static uint32_t server_down_in_row = 0;
+static uint32_t cooldown_ms = RETRY_BREAKER_COOLDOWN_MS;
+static int64_t open_until_ms = 0;
+static int64_t tripped_at_ms = 0;
+static bool probe_in_flight = false;
+
+static retry_policy_stats_t stats;
+
+// 请求在网络任务中更新状态，界面任务读取等待时间和熔断状态；日志在临界区外打印
+static portMUX_TYPE policy_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static int64_t now_ms(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+/**
+ * @brief 第 n 次连续失败后的退避：base * 2^(n-1)，封顶后取 [一半, 全部] 之间的随机值
+ */
+static uint32_t backoff_ms(retry_endpoint_t endpoint, uint32_t n)
+{
+    const endpoint_policy_t *p = &policies[endpoint];
+    uint32_t delay = p->max_ms;
+    if (n <= 16 && (p->base_ms << (n - 1)) < p->max_ms) {
+        delay = p->base_ms << (n - 1);
+    }
+    // 抖动让多台设备不会在服务器恢复的同一时刻一起重试
+    return delay / 2 + esp_random() % (delay / 2 + 1);
+}
+
+/**
+ * @brief 熔断（调用方持有锁）
+ * @return 本次熔断时长
+ */
+static uint32_t breaker_trip(int64_t now)
+{
+    if (breaker == RETRY_BREAKER_CLOSED) {
+        tripped_at_ms = now;
+        stats.breaker_trips++;
+    } else {
+        // 探测失败，冷却时间加倍
+        cooldown_ms = cooldown_ms * 2 > RETRY_BREAKER_COOLDOWN_MAX_MS ? RETRY_BREAKER_COOLDOWN_MAX_MS : cooldown_ms * 2;
+    }
+    breaker = RETRY_BREAKER_OPEN;
+    open_until_ms = now + cooldown_ms + esp_random() % (cooldown_ms / 4 + 1);
+    probe_in_flight = false;
+    return (uint32_t)(open_until_ms - now);
+}
+
+/**
+ * @brief 关闭熔断器（调用方持有锁）
+ * @return true 熔断器原本不是关闭状态
+ */
+static bool breaker_close(int64_t now)
+{
+    bool recovered = breaker != RETRY_BREAKER_CLOSED;
+    if (recovered) {
+        stats.last_recovery_ms = (uint32_t)(now - tripped_at_ms);
+    }
+    breaker = RETRY_BREAKER_CLOSED;
+    cooldown_ms = RETRY_BREAKER_COOLDOWN_MS;
+    server_down_in_row = 0;
+    probe_in_flight = false;
+    return recovered;
+}
+
+bool retry_policy_allow(retry_endpoint_t endpoint)
+{
+    int64_t now = now_ms();
+    bool probing = false;
+
+    taskENTER_CRITICAL(&policy_lock);
+    if (breaker == RETRY_BREAKER_OPEN && now >= open_until_ms) {
+        breaker = RETRY_BREAKER_HALF_OPEN;
+        probing = true;
+    }
+
+    bool allowed;
+    if (breaker == RETRY_BREAKER_OPEN) {
+        allowed = false;
+    } else if (breaker == RETRY_BREAKER_HALF_OPEN) {
+        // 探测请求不受接口退避限制，谁先来谁探测
+        allowed = !probe_in_flight;
+        probe_in_flight = true;
+    } else {
+        allowed = now >= next_allowed_ms[endpoint];
+    }
+
+    if (allowed) {
+        stats.attempts[endpoint]++;
+    } else {
+        stats.rejected[endpoint]++;
+    }
+    taskEXIT_CRITICAL(&policy_lock);
+
+    if (probing) {
+        ESP_LOGI(TAG, "熔断冷却结束，发出探测请求");
+    }
+    return allowed;
+}
+
+void retry_policy_on_success(retry_endpoint_t endpoint)
+{
+    taskENTER_CRITICAL(&policy_lock);
+    failures_in_row[endpoint] = 0;
+    next_allowed_ms[endpoint] = 0;
+    bool recovered = breaker_close(now_ms());
+    uint32_t recovery_ms = stats.last_recovery_ms;
+    taskEXIT_CRITICAL(&policy_lock);
+
+    if (recovered) {
+        ESP_LOGI(TAG, "服务器恢复，熔断 %lu ms 后关闭", recovery_ms);
+    }
+}
+
+void retry_policy_on_failure(retry_endpoint_t endpoint, bool server_down, uint32_t retry_after_ms)
+{
+    int64_t now = now_ms();
+    uint32_t open_ms = 0;
+
+    taskENTER_CRITICAL(&policy_lock);
+    stats.failures[endpoint]++;
+    uint32_t in_row = ++failures_in_row[endpoint];
+
+    uint32_t delay = backoff_ms(endpoint, in_row);
+    if (retry_after_ms > delay) {
+        delay = retry_after_ms;
+    }
+    next_allowed_ms[endpoint] = now + delay;
+
+    if (!server_down) {
+        // 服务器有响应（4xx、数据格式错误），只退避该接口，不影响熔断器
+        breaker_close(now);
+    } else {
+        server_down_in_row++;
+        if (breaker == RETRY_BREAKER_HALF_OPEN || server_down_in_row >= RETRY_BREAKER_THRESHOLD) {
+            open_ms = breaker_trip(now);
+        }
+    }
+    taskEXIT_CRITICAL(&policy_lock);
+
+    ESP_LOGW(TAG, "%s请求连续失败 %lu 次，%lu ms 后重试", endpoint_names[endpoint], in_row, delay);
+    if (open_ms > 0) {
+        ESP_LOGW(TAG, "服务器无响应，熔断 %lu ms", open_ms);
+    }
+}
+
+uint32_t retry_policy_wait_ms(retry_endpoint_t endpoint)
+{
+    int64_t now = now_ms();
+    taskENTER_CRITICAL(&policy_lock);
+    int64_t until = next_allowed_ms[endpoint];
+    if (breaker == RETRY_BREAKER_OPEN && open_until_ms > until) {
+        until = open_until_ms;
+    }
+    taskEXIT_CRITICAL(&policy_lock);
+    return until > now ? (uint32_t)(until - now) : 0;
+}
+
+retry_breaker_state_t retry_policy_get_breaker_state(void)
+{
+    int64_t now = now_ms();
+    taskENTER_CRITICAL(&policy_lock);
+    retry_breaker_state_t state = breaker;
+    if (state == RETRY_BREAKER_OPEN && now >= open_until_ms) {
+        state = RETRY_BREAKER_HALF_OPEN;
+    }
+    taskEXIT_CRITICAL(&policy_lock);
+    return state;
+}
+
+void retry_policy_get_stats(retry_policy_stats_t *out)
+{
+    if (out != NULL) {
+        taskENTER_CRITICAL(&policy_lock);
+        *out = stats;
+        taskEXIT_CRITICAL(&policy_lock);
+    }
+}
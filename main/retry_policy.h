@@ -0,0 +1,96 @@
+/**
+ * @file retry_policy.h
+ * @brief 请求重试策略与熔断器
+ *
+ * 每类接口各自记录连续失败次数，失败后按指数退避（带随机抖动）推迟下一次请求；
+ * 所有接口共用一个熔断器：服务器连续无响应（连接失败、超时、5xx/429）达到阈值后熔断，
+ * 冷却期内直接拒绝请求，冷却结束放行一个探测请求，成功则恢复，失败则加倍冷却时间。
+ *
+ * 请求在网络任务中执行并更新状态，界面任务读取等待时间和熔断状态，状态由自旋锁保护。
+ */
+
+#ifndef RETRY_POLICY_H
+#define RETRY_POLICY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RETRY_BREAKER_THRESHOLD      3          // 连续几次服务器无响应后熔断
+#define RETRY_BREAKER_COOLDOWN_MS    10000      // 首次熔断冷却时间
+#define RETRY_BREAKER_COOLDOWN_MAX_MS (5 * 60 * 1000)
+
+/**
+ * @brief 接口类别，各自独立退避
+ */
+typedef enum {
+    RETRY_ENDPOINT_LIST = 0,   // 列表分页（含连接预热）
+    RETRY_ENDPOINT_DETAIL,     // 详情正文
+    RETRY_ENDPOINT_MUTATION,   // 完成状态切换、创建
+    RETRY_ENDPOINT_COUNT,
+} retry_endpoint_t;
+
+/**
+ * @brief 熔断器状态
+ */
+typedef enum {
+    RETRY_BREAKER_CLOSED = 0,  // 正常
+    RETRY_BREAKER_OPEN,        // 熔断中，拒绝所有请求
+    RETRY_BREAKER_HALF_OPEN,   // 冷却结束，只放行一个探测请求
+} retry_breaker_state_t;
+
+/**
+ * @brief 统计
+ */
+typedef struct {
+    uint32_t attempts[RETRY_ENDPOINT_COUNT];   // 放行的请求
+    uint32_t failures[RETRY_ENDPOINT_COUNT];   // 失败的请求
+    uint32_t rejected[RETRY_ENDPOINT_COUNT];   // 退避或熔断期间被拒绝的请求
+    uint32_t breaker_trips;                    // 熔断次数
+    uint32_t last_recovery_ms;                 // 最近一次从熔断到恢复的用时
+} retry_policy_stats_t;
+
+/**
+ * @brief 现在能否发出该类请求
+ *
+ * 返回true即视为请求已发出（半开状态下占用唯一的探测名额），
+ * 之后必须调用 retry_policy_on_success 或 retry_policy_on_failure。
+ */
+bool retry_policy_allow(retry_endpoint_t endpoint);
+
+/**
+ * @brief 请求成功
+ */
+void retry_policy_on_success(retry_endpoint_t endpoint);
+
+/**
+ * @brief 请求失败
+ * @param endpoint 接口类别
+ * @param server_down 是否属于服务器无响应（连接失败、超时、5xx/429），只有这类失败计入熔断
+ * @param retry_after_ms 服务器 Retry-After 要求的最短等待，0表示没有
+ */
+void retry_policy_on_failure(retry_endpoint_t endpoint, bool server_down, uint32_t retry_after_ms);
+
+/**
+ * @brief 距该类请求下一次可以发出还有多久（毫秒），0表示现在即可
+ */
+uint32_t retry_policy_wait_ms(retry_endpoint_t endpoint);
+
+/**
+ * @brief 熔断器当前状态（冷却到期时返回半开）
+ */
+retry_breaker_state_t retry_policy_get_breaker_state(void);
+
+/**
+ * @brief 获取统计
+ */
+void retry_policy_get_stats(retry_policy_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * @file spsc_ring.c
+ * @brief 单生产者/单消费者无锁环形队列实现
+ *
+ * head/tail 是自由增长的计数器，取模用 mask，head - tail 即占用数（回绕后依然成立）。
+ */
+
+#include "spsc_ring.h"
+#include <string.h>
+
+esp_err_t spsc_ring_init(spsc_ring_t *ring, size_t elem_size, uint32_t capacity, uint32_t caps,
+                         mem_tag_t tag)
+{
+    if (ring == NULL || elem_size == 0 || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(ring, 0, sizeof(spsc_ring_t));
+    ring->slots = mem_tag_malloc(tag, elem_size * capacity, caps);
+    if (ring->slots == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    ring->elem_size = elem_size;
+    ring->mask = capacity - 1;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    return ESP_OK;
+}
+
+bool spsc_ring_push(spsc_ring_t *ring, const void *elem)
+{
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    uint32_t used = head - tail;
+
+    if (used > ring->mask) {
+        ring->full_count++;
+        return false;
+    }
+
+    memcpy(ring->slots + (head & ring->mask) * ring->elem_size, elem, ring->elem_size);
+    // 槽位内容写完后再发布 head，消费者看到新 head 时一定能看到内容
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    if (used + 1 > ring->high_water) {
+        ring->high_water = used + 1;
+    }
+    return true;
+}
+
+bool spsc_ring_pop(spsc_ring_t *ring, void *elem)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    if (head == tail) {
+        return false;
+    }
+
+    memcpy(elem, ring->slots + (tail & ring->mask) * ring->elem_size, ring->elem_size);
+    // 读完再释放槽位，生产者才能覆盖它
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+uint32_t spsc_ring_count(const spsc_ring_t *ring)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    return head - tail;
+}
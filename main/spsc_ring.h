@@ -0,0 +1,66 @@
+/**
+ * @file spsc_ring.h
+ * @brief 单生产者/单消费者无锁环形队列
+ *
+ * 固定大小的槽位，容量为2的幂。生产者只写 head，消费者只写 tail，
+ * 用 acquire/release 原子操作保证槽位内容先于下标对另一核可见，不需要锁或关中断。
+ * 每个队列只能有一个生产者任务和一个消费者任务；满时 push 失败，不覆盖旧数据。
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "mem_tag.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint8_t *slots;
+    size_t elem_size;
+    uint32_t mask;              // 容量 - 1
+    atomic_uint_fast32_t head;  // 下一个写入位置（生产者）
+    atomic_uint_fast32_t tail;  // 下一个读取位置（消费者）
+    uint32_t high_water;        // 最大占用（生产者维护）
+    uint32_t full_count;        // push 因满失败的次数（生产者维护）
+} spsc_ring_t;
+
+/**
+ * @brief 初始化队列
+ * @param elem_size 每个元素的字节数
+ * @param capacity 容量，必须是2的幂
+ * @param caps 槽位内存的 heap_caps（大元素放 MALLOC_CAP_SPIRAM）
+ * @param tag 槽位内存计入的子系统
+ * @return ESP_OK 成功, ESP_ERR_INVALID_ARG 容量不是2的幂, ESP_ERR_NO_MEM 内存不足
+ */
+esp_err_t spsc_ring_init(spsc_ring_t *ring, size_t elem_size, uint32_t capacity, uint32_t caps,
+                         mem_tag_t tag);
+
+/**
+ * @brief 写入一个元素（只能在生产者任务中调用）
+ * @return true 成功, false 队列已满
+ */
+bool spsc_ring_push(spsc_ring_t *ring, const void *elem);
+
+/**
+ * @brief 取出一个元素（只能在消费者任务中调用）
+ * @return true 成功, false 队列为空
+ */
+bool spsc_ring_pop(spsc_ring_t *ring, void *elem);
+
+/**
+ * @brief 当前元素个数（另一方并发修改时只是近似值）
+ */
+uint32_t spsc_ring_count(const spsc_ring_t *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,342 @@
+/**
+ * @file todo_backend.c
+ * @brief 多后端选择与故障切换实现
+ *
+ * 后端表由网络任务（请求）和探测任务共同更新，用自旋锁保护；
+ * 地址在初始化后不再修改，可以直接返回指针。
+ */
+
+#include "todo_backend.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_http_client.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "todo_client.h"
+#include "app_tasks.h"
+
+static const char *TAG = "todo_backend";
+
+#define API_KEY CONFIG_TODO_API_KEY
+
+#define BACKEND_DOWN_MIN_MS      5000
+#define BACKEND_DOWN_MAX_MS      (5 * 60 * 1000)
+#define BACKEND_EWMA_SHIFT       3        // 新样本权重 1/8
+#define BACKEND_PROBE_TIMEOUT_MS 3000
+#define PROBE_TASK_STACK_SIZE    6144     // https 探测需要 mbedTLS 握手
+#define PROBE_TASK_PRIORITY      2
+
+typedef struct {
+    char url[TODO_BACKEND_URL_MAX_LEN];
+    bool tls;
+    uint32_t ewma_ms;
+    uint32_t samples;
+    uint32_t requests;
+    uint32_t failures;
+    uint32_t failures_in_row;
+    int64_t down_until_ms;    // 在此之前视为下线
+    esp_http_client_handle_t probe_client;  // 只在探测任务中使用，跨探测保留TLS会话
+} backend_t;
+
+static backend_t backends[TODO_BACKEND_MAX];
+static int backend_count = 0;
+static int active = 0;
+static portMUX_TYPE backend_lock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t probe_task_handle = NULL;
+
+static int64_t now_ms(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+static bool is_healthy(const backend_t *b, int64_t now)
+{
+    return now >= b->down_until_ms;
+}
+
+esp_err_t todo_backend_init(const char *url_list)
+{
+    if (url_list == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    backend_count = 0;
+    const char *p = url_list;
+    while (*p != '\0' && backend_count < TODO_BACKEND_MAX) {
+        while (*p == ',' || isspace((unsigned char)*p)) {
+            p++;
+        }
+        const char *end = p;
+        while (*end != '\0' && *end != ',') {
+            end++;
+        }
+        size_t len = end - p;
+        while (len > 0 && (isspace((unsigned char)p[len - 1]) || p[len - 1] == '/')) {
+            len--;
+        }
+
+        if (len > 0 && len < TODO_BACKEND_URL_MAX_LEN) {
+            backend_t *b = &backends[backend_count++];
+            memset(b, 0, sizeof(backend_t));
+            memcpy(b->url, p, len);
+            b->tls = strncmp(b->url, "https://", 8) == 0;
+            ESP_LOGI(TAG, "后端 %d: %s", backend_count - 1, b->url);
+            if (!b->tls) {
+                ESP_LOGW(TAG, "后端 %d 使用HTTP，API密钥将明文传输", backend_count - 1);
+            }
+        } else if (len > 0) {
+            ESP_LOGE(TAG, "后端地址过长，忽略");
+        }
+        p = end;
+    }
+
+    if (*p != '\0') {
+        ESP_LOGW(TAG, "最多支持 %d 个后端，其余忽略", TODO_BACKEND_MAX);
+    }
+    active = 0;
+    return backend_count > 0 ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+int todo_backend_count(void)
+{
+    return backend_count;
+}
+
+const char *todo_backend_url(int index)
+{
+    return index >= 0 && index < backend_count ? backends[index].url : "";
+}
+
+bool todo_backend_is_tls(int index)
+{
+    return index >= 0 && index < backend_count && backends[index].tls;
+}
+
+bool todo_backend_any_tls(void)
+{
+    for (int i = 0; i < backend_count; i++) {
+        if (backends[i].tls) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief a 是否比 b 更适合：有延迟样本的优先，其次延迟低，最后按配置顺序
+ */
+static bool better(int a, int b)
+{
+    if (b < 0) {
+        return true;
+    }
+    const backend_t *ba = &backends[a];
+    const backend_t *bb = &backends[b];
+    if ((ba->samples > 0) != (bb->samples > 0)) {
+        return ba->samples > 0;
+    }
+    if (ba->samples > 0 && ba->ewma_ms != bb->ewma_ms) {
+        return ba->ewma_ms < bb->ewma_ms;
+    }
+    return a < b;
+}
+
+int todo_backend_select(uint32_t exclude_mask)
+{
+    int64_t now = now_ms();
+    int best = -1;
+    int soonest = -1;   // 全部下线时选最早恢复的一个
+
+    taskENTER_CRITICAL(&backend_lock);
+    for (int i = 0; i < backend_count; i++) {
+        if (exclude_mask & (1u << i)) {
+            continue;
+        }
+        if (is_healthy(&backends[i], now)) {
+            if (better(i, best)) {
+                best = i;
+            }
+        } else if (soonest < 0 || backends[i].down_until_ms < backends[soonest].down_until_ms) {
+            soonest = i;
+        }
+    }
+
+    int selected = best >= 0 ? best : soonest;
+    const backend_t *cur = &backends[active];
+    if (selected >= 0 && selected != active && !(exclude_mask & (1u << active)) && is_healthy(cur, now)) {
+        // 当前后端仍健康：只有明显更快时才切换
+        const backend_t *cand = &backends[selected];
+        bool faster = cur->samples > 0 && cand->samples > 0 &&
+                      cand->ewma_ms * 100 < cur->ewma_ms * (100 - TODO_BACKEND_SWITCH_MARGIN);
+        if (!faster) {
+            selected = active;
+        }
+    }
+
+    int previous = active;
+    if (selected >= 0) {
+        active = selected;
+    }
+    taskEXIT_CRITICAL(&backend_lock);
+
+    if (selected >= 0 && selected != previous) {
+        ESP_LOGW(TAG, "切换后端: %s -> %s (%lu ms)", backends[previous].url, backends[selected].url,
+                 backends[selected].ewma_ms);
+    }
+    return selected;
+}
+
+void todo_backend_report(int index, bool server_down, uint32_t latency_ms)
+{
+    if (index < 0 || index >= backend_count) {
+        return;
+    }
+
+    int64_t now = now_ms();
+    uint32_t down_ms = 0;
+    backend_t *b = &backends[index];
+
+    taskENTER_CRITICAL(&backend_lock);
+    b->requests++;
+    if (server_down) {
+        b->failures++;
+        b->failures_in_row++;
+        down_ms = BACKEND_DOWN_MAX_MS;
+        if (b->failures_in_row <= 16 && (BACKEND_DOWN_MIN_MS << (b->failures_in_row - 1)) < BACKEND_DOWN_MAX_MS) {
+            down_ms = BACKEND_DOWN_MIN_MS << (b->failures_in_row - 1);
+        }
+        down_ms += esp_random() % (down_ms / 4 + 1);
+        b->down_until_ms = now + down_ms;
+    } else {
+        b->failures_in_row = 0;
+        b->down_until_ms = 0;
+        if (b->samples == 0) {
+            b->ewma_ms = latency_ms;
+        } else {
+            int32_t delta = (int32_t)latency_ms - (int32_t)b->ewma_ms;
+            b->ewma_ms = (uint32_t)((int32_t)b->ewma_ms + delta / (1 << BACKEND_EWMA_SHIFT));
+        }
+        b->samples++;
+    }
+    taskEXIT_CRITICAL(&backend_lock);
+
+    if (server_down) {
+        ESP_LOGW(TAG, "后端 %s 无响应（连续 %lu 次），下线 %lu ms", b->url, b->failures_in_row, down_ms);
+    }
+}
+
+void todo_backend_get_active_url(char *buf, size_t len)
+{
+    taskENTER_CRITICAL(&backend_lock);
+    int index = active;
+    taskEXIT_CRITICAL(&backend_lock);
+    // 地址初始化后不变，不需要在临界区里复制
+    strlcpy(buf, todo_backend_url(index), len);
+}
+
+esp_err_t todo_backend_get_info(int index, todo_backend_info_t *info)
+{
+    if (index < 0 || index >= backend_count || info == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int64_t now = now_ms();
+    const backend_t *b = &backends[index];
+    taskENTER_CRITICAL(&backend_lock);
+    strlcpy(info->url, b->url, sizeof(info->url));
+    info->healthy = is_healthy(b, now);
+    info->active = index == active;
+    info->ewma_ms = b->ewma_ms;
+    info->samples = b->samples;
+    info->requests = b->requests;
+    info->failures = b->failures;
+    taskEXIT_CRITICAL(&backend_lock);
+    return ESP_OK;
+}
+
+static esp_err_t probe_event_handler(esp_http_client_event_t *evt)
+{
+    if (evt->event_id == HTTP_EVENT_ON_CONNECTED) {
+        *(int64_t *)evt->user_data = esp_timer_get_time();
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 用独立连接探测一个后端，延迟从连接建立后算起，与复用长连接的请求可比
+ */
+static void probe(int index)
+{
+    esp_http_client_handle_t client = backends[index].probe_client;
+    if (client == NULL) {
+        char url[TODO_BACKEND_URL_MAX_LEN + 32];
+        snprintf(url, sizeof(url), "%s/api/todos?limit=1", backends[index].url);
+
+        esp_http_client_config_t config = {
+            .url = url,
+            .method = HTTP_METHOD_HEAD,
+            .timeout_ms = BACKEND_PROBE_TIMEOUT_MS,
+            .event_handler = probe_event_handler,
+        };
+        todo_client_apply_tls(&config);
+
+        client = esp_http_client_init(&config);
+        if (client == NULL) {
+            return;
+        }
+        esp_http_client_set_header(client, "X-API-Key", API_KEY);
+        backends[index].probe_client = client;
+    }
+
+    int64_t connected_us = 0;
+    esp_http_client_set_user_data(client, &connected_us);
+
+    int64_t start = esp_timer_get_time();
+    esp_err_t err = esp_http_client_perform(client);
+    int64_t end = esp_timer_get_time();
+    int status = err == ESP_OK ? esp_http_client_get_status_code(client) : -1;
+    // 不占用服务器连接，客户端（连同保存的TLS会话）留到下次探测
+    esp_http_client_close(client);
+
+    bool down = err != ESP_OK || status >= 500 || status == 429;
+    uint32_t latency_ms = (uint32_t)((end - (connected_us > 0 ? connected_us : start)) / 1000);
+    ESP_LOGD(TAG, "探测 %s: 状态码 %d, %lu ms", backends[index].url, status, latency_ms);
+    todo_backend_report(index, down, latency_ms);
+}
+
+static void probe_task(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(TODO_BACKEND_PROBE_INTERVAL_MS));
+
+        for (int i = 0; i < backend_count; i++) {
+            taskENTER_CRITICAL(&backend_lock);
+            bool skip = i == active || !is_healthy(&backends[i], now_ms());
+            taskEXIT_CRITICAL(&backend_lock);
+            // 使用中的后端由真实请求更新；下线中的等退避结束再探测
+            if (!skip) {
+                probe(i);
+            }
+        }
+    }
+}
+
+esp_err_t todo_backend_start_probe(void)
+{
+    if (backend_count < 2 || probe_task_handle != NULL) {
+        return ESP_OK;
+    }
+
+    if (app_tasks_create(probe_task, "todo_probe", PROBE_TASK_STACK_SIZE, PROBE_TASK_PRIORITY,
+                         APP_NET_CORE, &probe_task_handle) != ESP_OK) {
+        ESP_LOGE(TAG, "探测任务创建失败");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
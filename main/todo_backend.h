@@ -0,0 +1,103 @@
+/**
+ * @file todo_backend.h
+ * @brief 多后端选择与故障切换
+ *
+ * CONFIG_TODO_SERVER_URL 可以写多个用逗号分隔的后端地址（按优先顺序）。
+ * 每个后端记录健康状态和延迟的指数移动平均（EWMA），请求发往健康后端中最快的一个；
+ * 服务器无响应的后端按指数退避暂时下线，请求立即切换到下一个后端。
+ * 配置了多个后端时，后台任务定期探测未在使用的后端，更新它们的延迟和健康状态。
+ */
+
+#ifndef TODO_BACKEND_H
+#define TODO_BACKEND_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TODO_BACKEND_MAX             4
+#define TODO_BACKEND_URL_MAX_LEN     128
+#define TODO_BACKEND_SWITCH_MARGIN   20       // 其他后端快出该百分比才切换，避免来回抖动
+#define TODO_BACKEND_PROBE_INTERVAL_MS 30000
+
+/**
+ * @brief 后端状态
+ */
+typedef struct {
+    char url[TODO_BACKEND_URL_MAX_LEN];
+    bool healthy;
+    bool active;               // 当前请求发往该后端
+    uint32_t ewma_ms;          // 延迟EWMA（不含握手），samples 为0时无效
+    uint32_t samples;
+    uint32_t requests;
+    uint32_t failures;         // 服务器无响应的次数
+} todo_backend_info_t;
+
+/**
+ * @brief 解析后端列表
+ * @param url_list 逗号分隔的后端地址，例如 "http://10.0.0.2:5000, https://todo.example.com"
+ * @return ESP_OK 成功, ESP_ERR_INVALID_ARG 没有有效地址
+ */
+esp_err_t todo_backend_init(const char *url_list);
+
+/**
+ * @brief 启动后台探测任务（只有一个后端时不启动，需在WiFi连接后调用）
+ */
+esp_err_t todo_backend_start_probe(void);
+
+/**
+ * @brief 后端数量
+ */
+int todo_backend_count(void);
+
+/**
+ * @brief 选择下一次请求使用的后端
+ * @param exclude_mask 本次请求已经试过的后端（按下标的位掩码）
+ * @return 后端下标，全部被排除时返回-1
+ */
+int todo_backend_select(uint32_t exclude_mask);
+
+/**
+ * @brief 后端地址（不以'/'结尾，指针始终有效）
+ */
+const char *todo_backend_url(int index);
+
+/**
+ * @brief 后端是否使用 https
+ */
+bool todo_backend_is_tls(int index);
+
+/**
+ * @brief 是否有任一后端使用 https
+ */
+bool todo_backend_any_tls(void);
+
+/**
+ * @brief 报告一次请求结果
+ * @param index 后端下标
+ * @param server_down 服务器无响应（连接失败、超时、5xx/429）
+ * @param latency_ms 请求耗时（不含握手），server_down 时忽略
+ */
+void todo_backend_report(int index, bool server_down, uint32_t latency_ms);
+
+/**
+ * @brief 复制当前使用中的后端地址（可在任意任务中调用）
+ */
+void todo_backend_get_active_url(char *buf, size_t len);
+
+/**
+ * @brief 获取后端状态
+ * @return ESP_OK 成功, ESP_ERR_INVALID_ARG 下标越界
+ */
+esp_err_t todo_backend_get_info(int index, todo_backend_info_t *info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
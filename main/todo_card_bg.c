@@ -0,0 +1,151 @@
+/**
+ * @file todo_card_bg.c
+ * @brief 卡片背景预渲染缓存实现
+ */
+
+#include "todo_card_bg.h"
+#include "esp_heap_caps.h"
+#include "mem_tag.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "todo_theme.h"
+
+static const char *TAG = "todo_card_bg";
+
+// 阴影向卡片外扩展的像素数（与LVGL计算 ext_draw_size 的方式一致）
+#define CARD_BG_MARGIN (THEME_CARD_SHADOW_WIDTH / 2 + 1)
+
+enum {
+    CARD_BG_PENDING = 0,
+    CARD_BG_COMPLETED,
+    CARD_BG_COUNT
+};
+
+static lv_img_dsc_t card_bg_img[CARD_BG_COUNT];
+static lv_coord_t card_bg_width = 0;
+static lv_coord_t card_bg_height = 0;
+static bool card_bg_ready = false;
+
+// 覆盖主题中的背景/边框/阴影，改由贴图绘制
+static lv_style_t style_card_flat;
+
+/**
+ * @brief 把一张卡片背景渲染到图片缓冲
+ *
+ * 图片不透明，阴影外圈直接混合到列表背景色上，贴图时就是一次纯拷贝。
+ */
+static esp_err_t render_card_bg(lv_img_dsc_t *img, lv_color_t bg_color)
+{
+    lv_coord_t img_w = card_bg_width + 2 * CARD_BG_MARGIN;
+    lv_coord_t img_h = card_bg_height + 2 * CARD_BG_MARGIN;
+    size_t size = LV_CANVAS_BUF_SIZE_TRUE_COLOR(img_w, img_h);
+
+    uint8_t *buf = mem_tag_malloc(MEM_TAG_CACHE, size, MALLOC_CAP_SPIRAM);
+    if (buf == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    lv_obj_t *canvas = lv_canvas_create(lv_layer_sys());
+    lv_obj_add_flag(canvas, LV_OBJ_FLAG_HIDDEN);
+    lv_canvas_set_buffer(canvas, buf, img_w, img_h, LV_IMG_CF_TRUE_COLOR);
+    lv_canvas_fill_bg(canvas, COLOR_BACKGROUND, LV_OPA_COVER);
+
+    lv_draw_rect_dsc_t rect_dsc;
+    lv_draw_rect_dsc_init(&rect_dsc);
+    rect_dsc.radius = THEME_CARD_RADIUS;
+    rect_dsc.bg_color = bg_color;
+    rect_dsc.border_color = COLOR_CARD_BORDER;
+    rect_dsc.border_width = THEME_CARD_BORDER_WIDTH;
+    rect_dsc.shadow_color = lv_color_black();
+    rect_dsc.shadow_width = THEME_CARD_SHADOW_WIDTH;
+    rect_dsc.shadow_opa = THEME_CARD_SHADOW_OPA;
+    lv_canvas_draw_rect(canvas, CARD_BG_MARGIN, CARD_BG_MARGIN,
+                        card_bg_width, card_bg_height, &rect_dsc);
+
+    lv_obj_del(canvas);
+
+    img->header.always_zero = 0;
+    img->header.cf = LV_IMG_CF_TRUE_COLOR;
+    img->header.w = img_w;
+    img->header.h = img_h;
+    img->data_size = size;
+    img->data = buf;
+    return ESP_OK;
+}
+
+/**
+ * @brief 卡片绘制事件：扩展绘制区域并贴上对应状态的背景
+ */
+static void card_bg_event_cb(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    lv_obj_t *card = lv_event_get_target(e);
+
+    if (code == LV_EVENT_REFR_EXT_DRAW_SIZE) {
+        lv_event_set_ext_draw_size(e, CARD_BG_MARGIN);
+    } else if (code == LV_EVENT_DRAW_MAIN_BEGIN) {
+        const lv_img_dsc_t *img = lv_obj_has_state(card, LV_STATE_CHECKED) ?
+                                  &card_bg_img[CARD_BG_COMPLETED] : &card_bg_img[CARD_BG_PENDING];
+
+        lv_area_t area;
+        lv_obj_get_coords(card, &area);
+        lv_area_increase(&area, CARD_BG_MARGIN, CARD_BG_MARGIN);
+
+        lv_draw_img_dsc_t img_dsc;
+        lv_draw_img_dsc_init(&img_dsc);
+        lv_draw_img(lv_event_get_draw_ctx(e), &img_dsc, &area, img);
+    }
+}
+
+esp_err_t todo_card_bg_init(lv_coord_t width, lv_coord_t height)
+{
+    if (card_bg_ready) {
+        return ESP_OK;
+    }
+
+    card_bg_width = width;
+    card_bg_height = height;
+
+    int64_t start = esp_timer_get_time();
+    esp_err_t ret = render_card_bg(&card_bg_img[CARD_BG_PENDING], COLOR_PENDING);
+    if (ret == ESP_OK) {
+        ret = render_card_bg(&card_bg_img[CARD_BG_COMPLETED], COLOR_COMPLETED);
+        if (ret != ESP_OK) {
+            mem_tag_free(MEM_TAG_CACHE, (void *)card_bg_img[CARD_BG_PENDING].data);
+        }
+    }
+
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "卡片背景预渲染失败（PSRAM不足），使用实时绘制");
+        return ret;
+    }
+
+    lv_style_init(&style_card_flat);
+    lv_style_set_bg_opa(&style_card_flat, LV_OPA_TRANSP);
+    lv_style_set_border_width(&style_card_flat, 0);
+    lv_style_set_shadow_width(&style_card_flat, 0);
+
+    card_bg_ready = true;
+    ESP_LOGI(TAG, "卡片背景预渲染完成 %dx%d, 每张 %lu 字节, 耗时 %lld us",
+             card_bg_img[CARD_BG_PENDING].header.w, card_bg_img[CARD_BG_PENDING].header.h,
+             (unsigned long)card_bg_img[CARD_BG_PENDING].data_size, esp_timer_get_time() - start);
+    return ESP_OK;
+}
+
+void todo_card_bg_attach(lv_obj_t *card)
+{
+    if (!card_bg_ready || card == NULL) {
+        return;
+    }
+
+    if (lv_obj_get_style_width(card, LV_PART_MAIN) != card_bg_width ||
+        lv_obj_get_style_height(card, LV_PART_MAIN) != card_bg_height) {
+        ESP_LOGW(TAG, "卡片尺寸与预渲染背景不一致，保持实时绘制");
+        return;
+    }
+
+    lv_obj_add_style(card, &style_card_flat, 0);
+    lv_obj_add_event_cb(card, card_bg_event_cb, LV_EVENT_REFR_EXT_DRAW_SIZE, NULL);
+    lv_obj_add_event_cb(card, card_bg_event_cb, LV_EVENT_DRAW_MAIN_BEGIN, NULL);
+    lv_obj_refresh_ext_draw_size(card);
+}
@@ -0,0 +1,39 @@
+/**
+ * @file todo_card_bg.h
+ * @brief 卡片背景预渲染缓存
+ *
+ * 卡片的圆角、边框和模糊阴影每种状态只渲染一次到PSRAM中的图片，
+ * 之后每帧直接贴图，滚动时不再重复计算阴影。
+ */
+
+#ifndef TODO_CARD_BG_H
+#define TODO_CARD_BG_H
+
+#include "lvgl.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 预渲染未完成/已完成两种卡片背景
+ * @param width 卡片宽度
+ * @param height 卡片高度
+ * @return ESP_OK 成功, ESP_ERR_NO_MEM 内存不足（卡片退回实时绘制）
+ */
+esp_err_t todo_card_bg_init(lv_coord_t width, lv_coord_t height);
+
+/**
+ * @brief 让卡片改用预渲染背景绘制
+ *
+ * 未初始化或尺寸不匹配时不做任何修改，卡片继续使用主题样式实时绘制。
+ * @param card 卡片对象（需已挂上 TODO_THEME_CARD 样式并设置好尺寸）
+ */
+void todo_card_bg_attach(lv_obj_t *card);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -4,27 +4,152 @@
  */
 
 #include "todo_client.h"
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include "esp_http_client.h"
+#include "esp_crt_bundle.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "lwip/netdb.h"
 #include "cJSON.h"
+#include "json_arena.h"
+#include "todo_detail_cache.h"
+#include "gzip_stream.h"
+#include "cbor_reader.h"
+#include "retry_policy.h"
+#include "todo_backend.h"
+#include "net_timing.h"
 
 static const char *TAG = "todo_client";
-static char server_url[128] = {0};
 
 #define API_KEY CONFIG_TODO_API_KEY
 
-#define HTTP_BUFFER_SIZE 4096
+#define HTTP_BUFFER_SIZE 8192
+
+// 列表只请求摘要字段，正文通过 todo_client_get_detail 按需获取
+#define LIST_SUMMARY_FIELDS "id,listId,title,isCompleted,importance,lastModifiedDateTime"
+// 后端支持时列表用CBOR，否则回退到JSON
+#if CONFIG_TODO_HTTP_CBOR
+#define LIST_ACCEPT "application/cbor, application/json;q=0.5"
+#else
+#define LIST_ACCEPT "application/json"
+#endif
+
 static char http_buffer[HTTP_BUFFER_SIZE];
 static int http_buffer_index = 0;
 
+// 所有API请求共用一个客户端，保持到当前后端的长连接；TLS会话保存下来用于断线后的恢复握手
+static esp_http_client_handle_t api_client = NULL;
+static int current_backend = -1;          // 本次请求发往的后端
+static int tls_session_backend = -1;      // 已保存的TLS会话属于哪个后端
+static bool connected_this_request = false;  // 本次请求是否新建了连接
+static bool connection_open = false;         // 长连接是否还在（决定要不要先解析DNS）
+static int64_t request_start_us = 0;
+
+// 本次请求各阶段的时间点（0表示没有发生），请求结束后计入 net_timing
+static int64_t connected_us = 0;
+static int64_t headers_sent_us = 0;
+static int64_t first_byte_us = 0;
+static todo_client_conn_stats_t conn_stats;
+static uint64_t handshake_full_total_ms = 0;
+static uint64_t handshake_offered_total_ms = 0;
+
+// 请求路径：ID、游标按百分号编码后最长为原长的3倍，只在网络任务中使用，不占任务栈
+#define URL_PATH_MAX (3 * TODO_CURSOR_MAX_LEN + 128)
+static char url_path[URL_PATH_MAX];
+
+// 最近一次请求的失败分类，交给重试策略决定退避和熔断
+static bool last_server_down = false;        // 连接失败/超时/5xx/429
+static uint32_t last_retry_after_ms = 0;     // 服务器 Retry-After
+
+#if CONFIG_TODO_TLS_CUSTOM_CA
+extern const char server_ca_pem_start[] asm("_binary_server_ca_pem_start");
+#endif
+
+#if CONFIG_TODO_HTTP_CBOR
+static bool http_content_cbor = false;  // 本次响应 Content-Type: application/cbor
+#endif
+
+#if CONFIG_TODO_HTTP_GZIP
+static gzip_stream_t *gzip = NULL;
+static bool gzip_active = false;       // 本次响应 Content-Encoding: gzip
+static esp_err_t gzip_err = ESP_OK;
+static int64_t gzip_time_us = 0;       // 本次响应解压耗时
+#endif
+
 /**
  * @brief HTTP事件处理函数
  */
 static esp_err_t http_event_handler(esp_http_client_event_t *evt)
 {
     switch(evt->event_id) {
+        case HTTP_EVENT_ON_CONNECTED: {
+            // 只有新建连接才会触发；复用长连接时没有握手
+            uint32_t ms = (uint32_t)((esp_timer_get_time() - request_start_us) / 1000);
+            connected_this_request = true;
+            connection_open = true;
+            connected_us = esp_timer_get_time();
+            conn_stats.handshake_last_ms = ms;
+            bool tls = todo_backend_is_tls(current_backend);
+            // esp_http_client 不暴露TLS层，只能知道握手时是否带了本后端的会话，
+            // 服务器拒绝恢复时退回完整握手，耗时会接近完整握手
+            bool offered = tls && tls_session_backend == current_backend;
+            if (offered) {
+                conn_stats.handshakes_offered++;
+                handshake_offered_total_ms += ms;
+                conn_stats.handshake_offered_avg_ms = handshake_offered_total_ms / conn_stats.handshakes_offered;
+            } else {
+                conn_stats.handshakes_full++;
+                handshake_full_total_ms += ms;
+                conn_stats.handshake_full_avg_ms = handshake_full_total_ms / conn_stats.handshakes_full;
+            }
+            ESP_LOGI(TAG, "建立%s连接耗时 %lu ms%s", tls ? "TLS" : "TCP", ms, offered ? "（携带已保存会话）" : "");
+            tls_session_backend = tls ? current_backend : -1;
+            break;
+        }
+        case HTTP_EVENT_DISCONNECTED:
+            ESP_LOGD(TAG, "连接已断开");
+            connection_open = false;
+            break;
+        case HTTP_EVENT_HEADERS_SENT:
+            headers_sent_us = esp_timer_get_time();
+            break;
+        case HTTP_EVENT_ON_HEADER:
+            if (first_byte_us == 0) {
+                first_byte_us = esp_timer_get_time();
+            }
+            if (strcasecmp(evt->header_key, "Retry-After") == 0) {
+                // 只支持秒数形式，HTTP日期形式按0处理
+                last_retry_after_ms = strtoul(evt->header_value, NULL, 10) * 1000;
+            }
+#if CONFIG_TODO_HTTP_CBOR
+            if (strcasecmp(evt->header_key, "Content-Type") == 0 &&
+                strncasecmp(evt->header_value, "application/cbor", 16) == 0) {
+                http_content_cbor = true;
+            }
+#endif
+#if CONFIG_TODO_HTTP_GZIP
+            if (strcasecmp(evt->header_key, "Content-Encoding") == 0 &&
+                strcasecmp(evt->header_value, "gzip") == 0 && gzip != NULL) {
+                gzip_active = true;
+                gzip_stream_begin(gzip, http_buffer, HTTP_BUFFER_SIZE);
+            }
+#endif
+            break;
         case HTTP_EVENT_ON_DATA:
+#if CONFIG_TODO_HTTP_GZIP
+            if (gzip_active) {
+                // 边收边解压，压缩数据不落地
+                if (gzip_err == ESP_OK) {
+                    int64_t start = esp_timer_get_time();
+                    gzip_err = gzip_stream_feed(gzip, evt->data, evt->data_len);
+                    gzip_time_us += esp_timer_get_time() - start;
+                }
+                break;
+            }
+#endif
             if (http_buffer_index + evt->data_len < HTTP_BUFFER_SIZE) {
                 memcpy(http_buffer + http_buffer_index, evt->data, evt->data_len);
                 http_buffer_index += evt->data_len;
@@ -36,125 +161,781 @@ static esp_err_t http_event_handler(esp_http_client_event_t *evt)
     return ESP_OK;
 }
 
-esp_err_t todo_client_init(const char *url)
+/**
+ * @brief 为客户端配置补齐证书校验和会话保存
+ */
+static void apply_tls_fields(esp_http_client_config_t *config)
+{
+#if CONFIG_TODO_TLS_CUSTOM_CA
+    config->cert_pem = server_ca_pem_start;
+#else
+    config->crt_bundle_attach = esp_crt_bundle_attach;
+#endif
+    config->save_client_session = true;
+}
+
+esp_err_t todo_client_init(const char *server_urls)
 {
-    if (url == NULL) {
+    if (server_urls == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
     
-    strncpy(server_url, url, sizeof(server_url) - 1);
-    ESP_LOGI(TAG, "TODO客户端初始化，服务器: %s", server_url);
+    ESP_LOGI(TAG, "TODO客户端初始化，服务器: %s", server_urls);
+    json_arena_init();
+    esp_err_t err = todo_backend_init(server_urls);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "没有有效的服务器地址");
+        return err;
+    }
     
-    return ESP_OK;
+#if CONFIG_TODO_HTTP_GZIP
+    if (gzip == NULL) {
+        // 分配失败时不声明 Accept-Encoding，服务器会返回未压缩数据
+        gzip = gzip_stream_create();
+    }
+#endif
+    
+    if (api_client == NULL) {
+        esp_http_client_config_t config = {
+            .url = todo_backend_url(0),
+            .event_handler = http_event_handler,
+            .timeout_ms = 5000,
+            .keep_alive_enable = true,
+        };
+        // 同一个客户端可能切换到 https 后端，任一后端需要时就配置证书
+        if (todo_backend_any_tls()) {
+            apply_tls_fields(&config);
+        }
+        
+        api_client = esp_http_client_init(&config);
+        if (api_client == NULL) {
+            ESP_LOGE(TAG, "HTTP客户端创建失败");
+            return ESP_FAIL;
+        }
+        esp_http_client_set_header(api_client, "X-API-Key", API_KEY);
+#if CONFIG_TODO_HTTP_GZIP
+        if (gzip != NULL) {
+            esp_http_client_set_header(api_client, "Accept-Encoding", "gzip");
+        }
+#endif
+    }
+    
+    todo_backend_start_probe();
+    return todo_detail_cache_init();
 }
 
-esp_err_t todo_client_get_list(todo_list_t *list)
+void todo_client_apply_tls(esp_http_client_config_t *config)
 {
-    if (list == NULL) {
-        return ESP_ERR_INVALID_ARG;
+    if (strncmp(config->url, "https://", 8) == 0) {
+        apply_tls_fields(config);
+    }
+}
+
+/**
+ * @brief 在共用客户端上对当前URL执行一次请求，复用的长连接失效时对幂等请求重连一次
+ */
+static esp_err_t perform(bool idempotent)
+{
+    esp_err_t err = ESP_FAIL;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        http_buffer_index = 0;
+        http_buffer[0] = '\0';
+#if CONFIG_TODO_HTTP_CBOR
+        http_content_cbor = false;
+#endif
+#if CONFIG_TODO_HTTP_GZIP
+        gzip_active = false;
+        gzip_err = ESP_OK;
+        gzip_time_us = 0;
+#endif
+        connected_this_request = false;
+        connected_us = 0;
+        headers_sent_us = 0;
+        first_byte_us = 0;
+        last_retry_after_ms = 0;
+        request_start_us = esp_timer_get_time();
+        conn_stats.requests++;
+        
+        err = esp_http_client_perform(api_client);
+        if (err == ESP_OK) {
+            if (!connected_this_request) {
+                conn_stats.connections_reused++;
+            }
+            break;
+        }
+        
+        // 出错后关闭连接，下次重新建立
+        esp_http_client_close(api_client);
+        connection_open = false;
+        
+        // 复用的长连接可能已被服务器关闭，对幂等请求用新连接重试一次
+        if (connected_this_request || !idempotent) {
+            break;
+        }
+        ESP_LOGW(TAG, "长连接已失效，重新连接: %s", esp_err_to_name(err));
     }
     
-    memset(list, 0, sizeof(todo_list_t));
-    http_buffer_index = 0;
-    memset(http_buffer, 0, HTTP_BUFFER_SIZE);
-    
-    char url[256];
-    snprintf(url, sizeof(url), "%s/api/todos?limit=%d", server_url, MAX_TODOS);
+#if CONFIG_TODO_HTTP_GZIP
+    if (err == ESP_OK && gzip_active) {
+        size_t out_len = 0;
+        err = gzip_err != ESP_OK ? gzip_err : gzip_stream_finish(gzip, &out_len);
+        http_buffer_index = out_len;
+        if (err == ESP_OK) {
+            ESP_LOGI(TAG, "gzip响应: 压缩 %u 字节 -> %d 字节，解压耗时 %lld us",
+                     (unsigned)gzip_stream_get_compressed_len(gzip), http_buffer_index, gzip_time_us);
+        } else {
+            ESP_LOGE(TAG, "gzip解压失败: %s", esp_err_to_name(err));
+        }
+    }
+#endif
     
-    ESP_LOGI(TAG, "获取TODO列表: %s", url);
+    return err;
+}
+
+/**
+ * @brief 新建连接前先自己解析主机名并计时，esp_http_client 随后命中 lwIP 的DNS缓存，
+ *        这样“解析DNS”和“建立连接”两个阶段可以分开统计
+ */
+static void pre_resolve(const char *url)
+{
+    const char *host = strstr(url, "://");
+    if (host == NULL) {
+        return;
+    }
+    host += 3;
+    size_t len = strcspn(host, ":/?");
+    char name[TODO_BACKEND_URL_MAX_LEN];
+    if (len == 0 || len >= sizeof(name)) {
+        return;
+    }
+    memcpy(name, host, len);
+    name[len] = '\0';
     
-    esp_http_client_config_t config = {
-        .url = url,
-        .method = HTTP_METHOD_GET,
-        .event_handler = http_event_handler,
-        .timeout_ms = 5000,
+    struct addrinfo hints = {
+        .ai_family = AF_INET,
+        .ai_socktype = SOCK_STREAM,
     };
+    struct addrinfo *res = NULL;
+    int64_t start = esp_timer_get_time();
+    int ret = getaddrinfo(name, NULL, &hints, &res);
+    net_timing_record(NET_PHASE_RESOLVE, esp_timer_get_time() - start);
+    if (ret != 0) {
+        ESP_LOGW(TAG, "解析 %s 失败: %d", name, ret);
+    }
+    if (res != NULL) {
+        freeaddrinfo(res);
+    }
+}
+
+/**
+ * @brief 把本次请求各阶段的耗时计入直方图
+ */
+static void record_phases(int64_t end_us)
+{
+    int64_t mark = request_start_us;
+    if (connected_us > 0) {
+        net_timing_record(NET_PHASE_CONNECT, connected_us - mark);
+        mark = connected_us;
+    }
+    if (headers_sent_us > 0) {
+        net_timing_record(NET_PHASE_SEND, headers_sent_us - mark);
+        mark = headers_sent_us;
+    }
+    if (first_byte_us > 0) {
+        net_timing_record(NET_PHASE_WAIT, first_byte_us - mark);
+        net_timing_record(NET_PHASE_RECEIVE, end_us - first_byte_us);
+    }
+}
+
+/**
+ * @brief 执行一次API请求，响应体读入 http_buffer 并以'\0'结尾
+ *
+ * 请求发往 todo_backend 选出的后端；后端无响应时换下一个健康后端重发。
+ * 非幂等请求只在连接都没建立起来（请求肯定没到达服务器）时才换后端。
+ * @param method 请求方法
+ * @param path 以'/'开头的路径（含查询参数），或完整URL（只发往该地址，不切换后端）
+ * @param accept Accept 请求头，NULL表示不指定
+ * @param json_body POST的JSON请求体，NULL表示无
+ * @param status 输出HTTP状态码
+ * @return ESP_OK 请求完成（不检查状态码）, ESP_ERR_INVALID_SIZE 完整URL超长, 其他值表示失败
+ */
+static esp_err_t http_request(esp_http_client_method_t method, const char *path, const char *accept,
+                              const char *json_body, int *status)
+{
+    static char url[TODO_BACKEND_URL_MAX_LEN + URL_PATH_MAX];
+    
+    if (api_client == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
     
-    esp_http_client_handle_t client = esp_http_client_init(&config);
+    esp_http_client_set_method(api_client, method);
+    if (accept != NULL) {
+        esp_http_client_set_header(api_client, "Accept", accept);
+    } else {
+        esp_http_client_delete_header(api_client, "Accept");
+    }
+    if (json_body != NULL) {
+        esp_http_client_set_header(api_client, "Content-Type", "application/json");
+        esp_http_client_set_post_field(api_client, json_body, strlen(json_body));
+    } else {
+        esp_http_client_delete_header(api_client, "Content-Type");
+        esp_http_client_set_post_field(api_client, NULL, 0);
+    }
     
-    esp_http_client_set_header(client, "X-API-Key", API_KEY);
-    esp_err_t err = esp_http_client_perform(client);
+    bool idempotent = method != HTTP_METHOD_POST || strstr(path, "/complete") != NULL ||
+                      strstr(path, "/uncomplete") != NULL;
+    bool absolute = strncmp(path, "http", 4) == 0;
     
-    if (err == ESP_OK) {
-        int status = esp_http_client_get_status_code(client);
-        ESP_LOGI(TAG, "HTTP状态码 = %d, 响应长度 = %d", status, http_buffer_index);
+    esp_err_t err = ESP_FAIL;
+    uint32_t tried = 0;
+    while (1) {
+        int backend = absolute && current_backend >= 0 ? current_backend : todo_backend_select(tried);
+        if (backend < 0) {
+            break;
+        }
+        tried |= 1u << backend;
+        if (backend != current_backend) {
+            // 换了主机，旧的长连接不能再用
+            esp_http_client_close(api_client);
+            connection_open = false;
+            current_backend = backend;
+        }
+        
+        int url_len = absolute ? (int)strlcpy(url, path, sizeof(url))
+                               : snprintf(url, sizeof(url), "%s%s", todo_backend_url(backend), path);
+        if (url_len < 0 || url_len >= (int)sizeof(url)) {
+            // 截断的地址会请求到别的资源，不能发出
+            ESP_LOGE(TAG, "请求地址过长（%d 字节）", url_len);
+            last_server_down = false;
+            err = ESP_ERR_INVALID_SIZE;
+            break;
+        }
+        esp_http_client_set_url(api_client, url);
+        
+        if (!connection_open) {
+            pre_resolve(url);
+        }
+        err = perform(idempotent);
+        if (err == ESP_OK) {
+            record_phases(esp_timer_get_time());
+        }
         
-        if (status == 200) {
+        last_server_down = true;
+        if (err == ESP_OK) {
+            *status = esp_http_client_get_status_code(api_client);
+            ESP_LOGI(TAG, "HTTP状态码 = %d, 响应长度 = %d", *status, http_buffer_index);
             http_buffer[http_buffer_index] = '\0';
-            cJSON *root = cJSON_Parse(http_buffer);
-            
-            if (root != NULL) {
-                cJSON *root_listId = cJSON_GetObjectItem(root, "listId");
-                if (cJSON_IsString(root_listId)) {
-                    strncpy(list->default_listId, root_listId->valuestring, TODO_LIST_ID_MAX_LEN - 1);
-                    ESP_LOGI(TAG, "默认列表ID: %s", list->default_listId);
-                }
-                
-                cJSON *value_array = cJSON_GetObjectItem(root, "value");
-                if (cJSON_IsArray(value_array)) {
-                    int array_size = cJSON_GetArraySize(value_array);
-                    list->count = (array_size > MAX_TODOS) ? MAX_TODOS : array_size;
-                    
-                    for (int i = 0; i < list->count; i++) {
-                        cJSON *item = cJSON_GetArrayItem(value_array, i);
-                        if (item) {
-                            cJSON *id = cJSON_GetObjectItem(item, "id");
-                            if (cJSON_IsString(id)) {
-                                strncpy(list->items[i].id, id->valuestring, TODO_ID_MAX_LEN - 1);
-                            }
-                            
-                            cJSON *listId = cJSON_GetObjectItem(item, "listId");
-                            if (cJSON_IsString(listId)) {
-                                strncpy(list->items[i].listId, listId->valuestring, TODO_LIST_ID_MAX_LEN - 1);
-                            } else if (strlen(list->default_listId) > 0) {
-                                strncpy(list->items[i].listId, list->default_listId, TODO_LIST_ID_MAX_LEN - 1);
-                            }
-                            
-                            cJSON *title = cJSON_GetObjectItem(item, "title");
-                            if (cJSON_IsString(title)) {
-                                strncpy(list->items[i].title, title->valuestring, TODO_TITLE_MAX_LEN - 1);
-                            }
-                            
-                            cJSON *body = cJSON_GetObjectItem(item, "body");
-                            if (cJSON_IsString(body)) {
-                                strncpy(list->items[i].body, body->valuestring, TODO_BODY_MAX_LEN - 1);
-                            }
-                            
-                            cJSON *is_completed = cJSON_GetObjectItem(item, "isCompleted");
-                            if (cJSON_IsBool(is_completed)) {
-                                list->items[i].is_completed = cJSON_IsTrue(is_completed);
-                            }
-                            
-                            cJSON *importance = cJSON_GetObjectItem(item, "importance");
-                            if (cJSON_IsString(importance)) {
-                                strncpy(list->items[i].importance, importance->valuestring, 15);
-                            }
-                            
-                            cJSON *last_modified = cJSON_GetObjectItem(item, "lastModifiedDateTime");
-                            if (cJSON_IsString(last_modified)) {
-                                strncpy(list->items[i].last_modified_date, last_modified->valuestring, TODO_DATE_MAX_LEN - 1);
-                            }
-                            
-                            ESP_LOGI(TAG, "TODO[%d]: %s - %s (listId: %s)", i, list->items[i].title, 
-                                    list->items[i].is_completed ? "已完成" : "未完成", list->items[i].listId);
-                        }
+            last_server_down = *status >= 500 || *status == 429;
+        } else {
+            ESP_LOGE(TAG, "HTTP请求执行失败: %s", esp_err_to_name(err));
+        }
+        
+        uint32_t latency_ms = (uint32_t)((esp_timer_get_time() - request_start_us) / 1000);
+        if (connected_this_request && latency_ms >= conn_stats.handshake_last_ms) {
+            latency_ms -= conn_stats.handshake_last_ms;
+        }
+        todo_backend_report(backend, last_server_down, latency_ms);
+        
+        if (!last_server_down || absolute || (!idempotent && err != ESP_ERR_HTTP_CONNECT)) {
+            break;
+        }
+        ESP_LOGW(TAG, "后端 %s 无响应，尝试下一个", todo_backend_url(backend));
+    }
+    
+    return err;
+}
+
+/**
+ * @brief 把请求结果报告给重试策略
+ * @return 原样返回 err
+ */
+static esp_err_t report_result(retry_endpoint_t endpoint, esp_err_t err)
+{
+    if (err == ESP_OK) {
+        retry_policy_on_success(endpoint);
+    } else {
+        retry_policy_on_failure(endpoint, last_server_down, last_retry_after_ms);
+    }
+    return err;
+}
+
+esp_err_t todo_client_prewarm(void)
+{
+    if (!retry_policy_allow(RETRY_ENDPOINT_LIST)) {
+        return ESP_ERR_NOT_ALLOWED;
+    }
+    
+    // HEAD 请求只为提前完成TCP/TLS握手，连接保持给后续请求复用
+    int status = 0;
+    last_server_down = false;
+    esp_err_t err = http_request(HTTP_METHOD_HEAD, "/api/todos?limit=1", NULL, NULL, &status);
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "连接预热完成，握手 %lu ms", conn_stats.handshake_last_ms);
+    }
+    return report_result(RETRY_ENDPOINT_LIST, err);
+}
+
+void todo_client_get_conn_stats(todo_client_conn_stats_t *stats)
+{
+    if (stats != NULL) {
+        *stats = conn_stats;
+    }
+}
+
+/**
+ * @brief 执行GET请求，响应体读入 http_buffer 并以'\0'结尾
+ * @param path 路径或完整URL（见 http_request）
+ * @param accept Accept 请求头，NULL表示不指定
+ * @return ESP_OK 状态码为200, 其他值表示失败
+ */
+static esp_err_t http_get(const char *path, const char *accept)
+{
+    int status = 0;
+    esp_err_t err = http_request(HTTP_METHOD_GET, path, accept, NULL, &status);
+    if (err == ESP_OK && status != 200) {
+        ESP_LOGE(TAG, "HTTP请求失败，状态码: %d", status);
+        err = ESP_FAIL;
+    }
+    return err;
+}
+
+/**
+ * @brief 把 src 百分号编码后追加到 dst（只保留 RFC 3986 非保留字符）
+ * @return false 放不下（dst 内容不完整）
+ */
+static bool append_encoded(char *dst, size_t dst_size, const char *src)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    size_t n = strlen(dst);
+    
+    for (const unsigned char *p = (const unsigned char *)src; *p != '\0'; p++) {
+        bool plain = (*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z') || (*p >= '0' && *p <= '9') ||
+                     *p == '-' || *p == '_' || *p == '.' || *p == '~';
+        if (n + (plain ? 1 : 3) >= dst_size) {
+            return false;
+        }
+        if (plain) {
+            dst[n++] = (char)*p;
+        } else {
+            dst[n++] = '%';
+            dst[n++] = hex[*p >> 4];
+            dst[n++] = hex[*p & 0x0F];
+        }
+    }
+    dst[n] = '\0';
+    return true;
+}
+
+/**
+ * @brief 把一个JSON条目的摘要字段写入 item（缺少 listId 时使用默认列表ID）
+ */
+static void parse_item_json(const cJSON *obj, todo_item_t *item, const char *default_list_id)
+{
+    cJSON *id = cJSON_GetObjectItem(obj, "id");
+    if (cJSON_IsString(id)) {
+        strncpy(item->id, id->valuestring, TODO_ID_MAX_LEN - 1);
+    }
+    
+    cJSON *listId = cJSON_GetObjectItem(obj, "listId");
+    if (cJSON_IsString(listId)) {
+        strncpy(item->listId, listId->valuestring, TODO_LIST_ID_MAX_LEN - 1);
+    } else if (default_list_id != NULL && strlen(default_list_id) > 0) {
+        strncpy(item->listId, default_list_id, TODO_LIST_ID_MAX_LEN - 1);
+    }
+    
+    cJSON *title = cJSON_GetObjectItem(obj, "title");
+    if (cJSON_IsString(title)) {
+        strncpy(item->title, title->valuestring, TODO_TITLE_MAX_LEN - 1);
+    }
+    
+    cJSON *is_completed = cJSON_GetObjectItem(obj, "isCompleted");
+    if (cJSON_IsBool(is_completed)) {
+        item->is_completed = cJSON_IsTrue(is_completed);
+    }
+    
+    cJSON *importance = cJSON_GetObjectItem(obj, "importance");
+    if (cJSON_IsString(importance)) {
+        strncpy(item->importance, importance->valuestring, 15);
+    }
+    
+    cJSON *last_modified = cJSON_GetObjectItem(obj, "lastModifiedDateTime");
+    if (cJSON_IsString(last_modified)) {
+        strncpy(item->last_modified_date, last_modified->valuestring, TODO_DATE_MAX_LEN - 1);
+    }
+}
+
+/**
+ * @brief 用cJSON解析 http_buffer 中的JSON列表页
+ */
+static esp_err_t parse_page_json(todo_page_t *page)
+{
+    json_arena_begin();
+    cJSON *root = cJSON_Parse(http_buffer);
+    if (root == NULL) {
+        json_arena_end();
+        ESP_LOGE(TAG, "JSON解析失败");
+        return ESP_FAIL;
+    }
+    
+    cJSON *root_listId = cJSON_GetObjectItem(root, "listId");
+    if (cJSON_IsString(root_listId)) {
+        strncpy(page->default_listId, root_listId->valuestring, TODO_LIST_ID_MAX_LEN - 1);
+        ESP_LOGD(TAG, "默认列表ID: %s", page->default_listId);
+    }
+    
+    cJSON *next = cJSON_GetObjectItem(root, "nextCursor");
+    if (!cJSON_IsString(next)) {
+        next = cJSON_GetObjectItem(root, "@odata.nextLink");
+    }
+    if (cJSON_IsString(next)) {
+        if (strlen(next->valuestring) < TODO_CURSOR_MAX_LEN) {
+            strcpy(page->next_cursor, next->valuestring);
+        } else {
+            // 截断的游标无法使用，宁可当作最后一页
+            ESP_LOGW(TAG, "下一页游标过长 (%u 字节)，停止分页", (unsigned)strlen(next->valuestring));
+        }
+    }
+    
+    cJSON *value_array = cJSON_GetObjectItem(root, "value");
+    if (cJSON_IsArray(value_array)) {
+        int array_size = cJSON_GetArraySize(value_array);
+        page->count = (array_size > TODO_PAGE_SIZE) ? TODO_PAGE_SIZE : array_size;
+        
+        for (int i = 0; i < page->count; i++) {
+            cJSON *item = cJSON_GetArrayItem(value_array, i);
+            if (item) {
+                parse_item_json(item, &page->items[i], page->default_listId);
+                ESP_LOGD(TAG, "TODO[%d]: %s - %s (listId: %s)", i, page->items[i].title, 
+                        page->items[i].is_completed ? "已完成" : "未完成", page->items[i].listId);
+            }
+        }
+    }
+    cJSON_Delete(root);
+    json_arena_end();
+    
+    return ESP_OK;
+}
+
+#if CONFIG_TODO_HTTP_CBOR
+/**
+ * @brief 读取CBOR文本串到定长缓冲区（超长截断）
+ * @param full_len 输出原始长度，可为NULL
+ */
+static bool cbor_read_text_into(cbor_reader_t *r, char *dst, size_t dst_size, size_t *full_len)
+{
+    const char *text;
+    size_t len;
+    if (!cbor_read_text(r, &text, &len)) {
+        return false;
+    }
+    size_t n = len < dst_size - 1 ? len : dst_size - 1;
+    memcpy(dst, text, n);
+    dst[n] = '\0';
+    if (full_len != NULL) {
+        *full_len = len;
+    }
+    return true;
+}
+
+/**
+ * @brief 按键名找到条目中对应的文本字段
+ */
+static char *item_text_field(todo_item_t *item, const char *key, size_t key_len, size_t *size)
+{
+    if (cbor_text_equals(key, key_len, "id")) {
+        *size = sizeof(item->id);
+        return item->id;
+    } else if (cbor_text_equals(key, key_len, "listId")) {
+        *size = sizeof(item->listId);
+        return item->listId;
+    } else if (cbor_text_equals(key, key_len, "title")) {
+        *size = sizeof(item->title);
+        return item->title;
+    } else if (cbor_text_equals(key, key_len, "importance")) {
+        *size = sizeof(item->importance);
+        return item->importance;
+    } else if (cbor_text_equals(key, key_len, "lastModifiedDateTime")) {
+        *size = sizeof(item->last_modified_date);
+        return item->last_modified_date;
+    }
+    return NULL;
+}
+
+static bool parse_item_cbor(cbor_reader_t *r, todo_item_t *item)
+{
+    uint32_t remaining;
+    if (!cbor_read_map(r, &remaining)) {
+        return false;
+    }
+    
+    while (cbor_container_next(r, &remaining)) {
+        const char *key;
+        size_t key_len;
+        if (!cbor_read_text(r, &key, &key_len)) {
+            return false;
+        }
+        
+        char *dst;
+        size_t dst_size;
+        cbor_type_t type = cbor_peek_type(r);
+        if (type == CBOR_TYPE_SIMPLE && cbor_text_equals(key, key_len, "isCompleted")) {
+            if (!cbor_read_bool(r, &item->is_completed)) {
+                return false;
+            }
+        } else if (type == CBOR_TYPE_TEXT && (dst = item_text_field(item, key, key_len, &dst_size)) != NULL) {
+            if (!cbor_read_text_into(r, dst, dst_size, NULL)) {
+                return false;
+            }
+        } else if (!cbor_skip(r)) {
+            return false;
+        }
+    }
+    return !r->error;
+}
+
+/**
+ * @brief 解析 http_buffer 中的CBOR列表页
+ *
+ * 与JSON结构相同（value/listId/nextCursor），边读边直接写入 page，
+ * 不建立中间树，不分配内存。
+ */
+static esp_err_t parse_page_cbor(todo_page_t *page)
+{
+    cbor_reader_t r;
+    cbor_reader_init(&r, http_buffer, http_buffer_index);
+    
+    uint32_t remaining;
+    if (!cbor_read_map(&r, &remaining)) {
+        ESP_LOGE(TAG, "CBOR解析失败：顶层不是映射");
+        return ESP_FAIL;
+    }
+    
+    while (cbor_container_next(&r, &remaining)) {
+        const char *key;
+        size_t key_len;
+        if (!cbor_read_text(&r, &key, &key_len)) {
+            break;
+        }
+        
+        cbor_type_t type = cbor_peek_type(&r);
+        if (type == CBOR_TYPE_ARRAY && cbor_text_equals(key, key_len, "value")) {
+            uint32_t items;
+            cbor_read_array(&r, &items);
+            while (cbor_container_next(&r, &items)) {
+                if (page->count < TODO_PAGE_SIZE) {
+                    if (!parse_item_cbor(&r, &page->items[page->count])) {
+                        break;
                     }
+                    page->count++;
+                } else if (!cbor_skip(&r)) {
+                    break;
                 }
-                cJSON_Delete(root);
-            } else {
-                ESP_LOGE(TAG, "JSON解析失败");
-                err = ESP_FAIL;
+            }
+        } else if (type == CBOR_TYPE_TEXT && cbor_text_equals(key, key_len, "listId")) {
+            cbor_read_text_into(&r, page->default_listId, sizeof(page->default_listId), NULL);
+        } else if (type == CBOR_TYPE_TEXT && (cbor_text_equals(key, key_len, "nextCursor") ||
+                                              cbor_text_equals(key, key_len, "@odata.nextLink"))) {
+            size_t len = 0;
+            if (cbor_read_text_into(&r, page->next_cursor, sizeof(page->next_cursor), &len) &&
+                len >= sizeof(page->next_cursor)) {
+                // 截断的游标无法使用，宁可当作最后一页
+                ESP_LOGW(TAG, "下一页游标过长 (%u 字节)，停止分页", (unsigned)len);
+                page->next_cursor[0] = '\0';
             }
         } else {
-            ESP_LOGE(TAG, "HTTP请求失败，状态码: %d", status);
-            err = ESP_FAIL;
+            cbor_skip(&r);
+        }
+    }
+    
+    if (r.error) {
+        ESP_LOGE(TAG, "CBOR解析失败");
+        return ESP_FAIL;
+    }
+    
+    // 键的顺序不固定，条目缺少 listId 时最后统一补上默认列表ID
+    for (int i = 0; i < page->count; i++) {
+        if (page->items[i].listId[0] == '\0') {
+            strlcpy(page->items[i].listId, page->default_listId, sizeof(page->items[i].listId));
         }
+    }
+    return ESP_OK;
+}
+#endif
+
+esp_err_t todo_client_parse_item(const char *json, todo_item_t *item)
+{
+    if (json == NULL || item == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    memset(item, 0, sizeof(todo_item_t));
+    json_arena_begin();
+    cJSON *root = cJSON_Parse(json);
+    if (root == NULL) {
+        json_arena_end();
+        return ESP_FAIL;
+    }
+    parse_item_json(root, item, NULL);
+    cJSON_Delete(root);
+    json_arena_end();
+    
+    return item->id[0] != '\0' ? ESP_OK : ESP_ERR_INVALID_RESPONSE;
+}
+
+static esp_err_t get_page(const char *cursor, todo_page_t *page)
+{
+    memset(page, 0, sizeof(todo_page_t));
+    
+    if (cursor != NULL && strncmp(cursor, "http", 4) == 0) {
+        // Graph 风格的 nextLink 已是编码好的完整URL，直接使用
+        strlcpy(url_path, cursor, sizeof(url_path));
     } else {
-        ESP_LOGE(TAG, "HTTP请求执行失败: %s", esp_err_to_name(err));
+        snprintf(url_path, sizeof(url_path), "/api/todos?limit=%d&select=%s",
+                 TODO_PAGE_SIZE, LIST_SUMMARY_FIELDS);
+        // 游标对客户端不透明，常含 '+' '/' '=' '&'
+        if (cursor != NULL && cursor[0] != '\0' &&
+            (strlcat(url_path, "&cursor=", sizeof(url_path)) >= sizeof(url_path) ||
+             !append_encoded(url_path, sizeof(url_path), cursor))) {
+            return ESP_ERR_INVALID_ARG;
+        }
     }
     
-    esp_http_client_cleanup(client);
-    return err;
+    ESP_LOGI(TAG, "获取TODO列表: %s", url_path);
+    
+    esp_err_t err = http_get(url_path, LIST_ACCEPT);
+    if (err != ESP_OK) {
+        return err;
+    }
+    
+    int64_t parse_start = esp_timer_get_time();
+#if CONFIG_TODO_HTTP_CBOR
+    bool cbor = http_content_cbor;
+    err = cbor ? parse_page_cbor(page) : parse_page_json(page);
+#else
+    bool cbor = false;
+    err = parse_page_json(page);
+#endif
+    int64_t parse_us = esp_timer_get_time() - parse_start;
+    net_timing_record(NET_PHASE_PARSE, parse_us);
+    ESP_LOGI(TAG, "解析%s %d 字节耗时 %lld us", cbor ? "CBOR" : "JSON", http_buffer_index, parse_us);
+    if (err != ESP_OK) {
+        return err;
+    }
+    
+    ESP_LOGI(TAG, "本页 %d 条%s", page->count, page->next_cursor[0] ? "" : "（最后一页）");
+    return ESP_OK;
+}
+
+esp_err_t todo_client_get_page(const char *cursor, todo_page_t *page)
+{
+    if (page == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!retry_policy_allow(RETRY_ENDPOINT_LIST)) {
+        return ESP_ERR_NOT_ALLOWED;
+    }
+    
+    last_server_down = false;
+    return report_result(RETRY_ENDPOINT_LIST, get_page(cursor, page));
+}
+
+/**
+ * @brief 从服务器获取正文并写入缓存
+ * @param out 同时复制到该缓冲区，预取时传NULL
+ */
+static esp_err_t fetch_detail_body(const char *todo_id, const char *list_id, char *out, size_t out_len)
+{
+    // Graph 的ID是类 base64 文本，含 '=' '+' '/'
+    strlcpy(url_path, "/api/todos/", sizeof(url_path));
+    if (!append_encoded(url_path, sizeof(url_path), todo_id) ||
+        strlcat(url_path, "?listId=", sizeof(url_path)) >= sizeof(url_path) ||
+        !append_encoded(url_path, sizeof(url_path), list_id)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    int64_t start = esp_timer_get_time();
+    esp_err_t err = http_get(url_path, NULL);
+    if (err != ESP_OK) {
+        return err;
+    }
+    
+    int64_t parse_start = esp_timer_get_time();
+    json_arena_begin();
+    cJSON *root = cJSON_Parse(http_buffer);
+    net_timing_record(NET_PHASE_PARSE, esp_timer_get_time() - parse_start);
+    if (root == NULL) {
+        json_arena_end();
+        ESP_LOGE(TAG, "详情JSON解析失败");
+        return ESP_FAIL;
+    }
+    
+    // 兼容纯字符串和 Graph 风格的 {"content": "..."}
+    const char *body = "";
+    cJSON *body_item = cJSON_GetObjectItem(root, "body");
+    if (cJSON_IsString(body_item)) {
+        body = body_item->valuestring;
+    } else if (cJSON_IsObject(body_item)) {
+        cJSON *content = cJSON_GetObjectItem(body_item, "content");
+        if (cJSON_IsString(content)) {
+            body = content->valuestring;
+        }
+    }
+    
+    if (out != NULL) {
+        strlcpy(out, body, out_len);
+    }
+    // 缓存写入失败不影响本次显示
+    if (todo_detail_cache_put(todo_id, body) != ESP_OK) {
+        ESP_LOGW(TAG, "详情写入缓存失败");
+    }
+    
+    todo_detail_cache_stats_t cache_stats;
+    todo_detail_cache_get_stats(&cache_stats);
+    ESP_LOGI(TAG, "获取详情 %u 字节，耗时 %lld ms（缓存命中 %lu / 未命中 %lu，淘汰 %lu）",
+             (unsigned)strlen(body), (esp_timer_get_time() - start) / 1000,
+             cache_stats.hits, cache_stats.misses, cache_stats.evictions);
+    cJSON_Delete(root);
+    json_arena_end();
+    
+    return ESP_OK;
+}
+
+static esp_err_t fetch_detail(const char *todo_id, const char *list_id, char *out, size_t out_len)
+{
+    if (!retry_policy_allow(RETRY_ENDPOINT_DETAIL)) {
+        return ESP_ERR_NOT_ALLOWED;
+    }
+    
+    last_server_down = false;
+    return report_result(RETRY_ENDPOINT_DETAIL, fetch_detail_body(todo_id, list_id, out, out_len));
+}
+
+esp_err_t todo_client_get_detail(const char *todo_id, const char *list_id, char *body, size_t body_len)
+{
+    if (todo_id == NULL || list_id == NULL || body == NULL || body_len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (todo_detail_cache_get(todo_id, body, body_len)) {
+        ESP_LOGD(TAG, "详情缓存命中");
+        return ESP_OK;
+    }
+    
+    return fetch_detail(todo_id, list_id, body, body_len);
+}
+
+esp_err_t todo_client_prefetch_detail(const char *todo_id, const char *list_id)
+{
+    if (todo_id == NULL || list_id == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (todo_detail_cache_contains(todo_id)) {
+        return ESP_OK;
+    }
+    
+    ESP_LOGD(TAG, "预取详情");
+    return fetch_detail(todo_id, list_id, NULL, 0);
 }
 
 esp_err_t todo_client_set_completed(const char *todo_id, const char *list_id, bool completed)
@@ -164,43 +945,41 @@ esp_err_t todo_client_set_completed(const char *todo_id, const char *list_id, bo
         return ESP_ERR_INVALID_ARG;
     }
     
-    char url[512];
-    snprintf(url, sizeof(url), "%s/api/todos/%s/%s", 
-             server_url, todo_id, completed ? "complete" : "uncomplete");
+    strlcpy(url_path, "/api/todos/", sizeof(url_path));
+    if (!append_encoded(url_path, sizeof(url_path), todo_id)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    strlcat(url_path, completed ? "/complete" : "/uncomplete", sizeof(url_path));
+    
+    if (!retry_policy_allow(RETRY_ENDPOINT_MUTATION)) {
+        ESP_LOGW(TAG, "服务器不可用，暂不发送");
+        return ESP_ERR_NOT_ALLOWED;
+    }
     
-    ESP_LOGI(TAG, "设置完成状态: %s (listId: %s)", url, list_id);
+    ESP_LOGI(TAG, "设置完成状态: %s (listId: %s)", url_path, list_id);
     
+    json_arena_begin();
     cJSON *root = cJSON_CreateObject();
     cJSON_AddStringToObject(root, "listId", list_id);
     char *json_str = cJSON_PrintUnformatted(root);
     
-    esp_http_client_config_t config = {
-        .url = url,
-        .method = HTTP_METHOD_POST,
-        .timeout_ms = 5000,
-    };
-    
-    esp_http_client_handle_t client = esp_http_client_init(&config);
-    
-    esp_http_client_set_header(client, "Content-Type", "application/json");
-    esp_http_client_set_header(client, "X-API-Key", API_KEY);
-    esp_http_client_set_post_field(client, json_str, strlen(json_str));
-    
-    esp_err_t err = esp_http_client_perform(client);
+    int status = 0;
+    last_server_down = false;
+    esp_err_t err = http_request(HTTP_METHOD_POST, url_path, NULL, json_str, &status);
     
     if (err == ESP_OK) {
-        int status = esp_http_client_get_status_code(client);
         ESP_LOGI(TAG, "状态码 = %d", status);
         if (status != 200) {
-            err = ESP_FAIL;
+            // 服务器有响应但拒绝（4xx）时重发也没用
+            err = last_server_down ? ESP_FAIL : ESP_ERR_INVALID_RESPONSE;
         }
     }
     
-    esp_http_client_cleanup(client);
     cJSON_Delete(root);
-    free(json_str);
+    cJSON_free(json_str);
+    json_arena_end();
     
-    return err;
+    return report_result(RETRY_ENDPOINT_MUTATION, err);
 }
 
 esp_err_t todo_client_create(const char *title, const char *body)
@@ -209,9 +988,12 @@ esp_err_t todo_client_create(const char *title, const char *body)
         return ESP_ERR_INVALID_ARG;
     }
     
-    char url[256];
-    snprintf(url, sizeof(url), "%s/api/todos", server_url);
+    if (!retry_policy_allow(RETRY_ENDPOINT_MUTATION)) {
+        ESP_LOGW(TAG, "服务器不可用，暂不发送");
+        return ESP_ERR_NOT_ALLOWED;
+    }
     
+    json_arena_begin();
     cJSON *root = cJSON_CreateObject();
     cJSON_AddStringToObject(root, "title", title);
     if (body) {
@@ -222,31 +1004,20 @@ esp_err_t todo_client_create(const char *title, const char *body)
     
     ESP_LOGI(TAG, "创建TODO: %s", json_str);
     
-    esp_http_client_config_t config = {
-        .url = url,
-        .method = HTTP_METHOD_POST,
-        .timeout_ms = 5000,
-    };
-    
-    esp_http_client_handle_t client = esp_http_client_init(&config);
-    
-    esp_http_client_set_header(client, "Content-Type", "application/json");
-    esp_http_client_set_header(client, "X-API-Key", API_KEY);
-    esp_http_client_set_post_field(client, json_str, strlen(json_str));
-    
-    esp_err_t err = esp_http_client_perform(client);
+    int status = 0;
+    last_server_down = false;
+    esp_err_t err = http_request(HTTP_METHOD_POST, "/api/todos", NULL, json_str, &status);
     
     if (err == ESP_OK) {
-        int status = esp_http_client_get_status_code(client);
         ESP_LOGI(TAG, "状态码 = %d", status);
         if (status != 201 && status != 200) {
-            err = ESP_FAIL;
+            err = last_server_down ? ESP_FAIL : ESP_ERR_INVALID_RESPONSE;
         }
     }
     
-    esp_http_client_cleanup(client);
     cJSON_Delete(root);
-    free(json_str);
+    cJSON_free(json_str);
+    json_arena_end();
     
-    return err;
+    return report_result(RETRY_ENDPOINT_MUTATION, err);
 }
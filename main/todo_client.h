@@ -1,27 +1,35 @@
 /**
  * @file todo_client.h
  * @brief TODO HTTP客户端
+ *
+ * 请求按接口类别经过 retry_policy：失败后指数退避，服务器连续无响应时熔断，
+ * 退避/熔断期间调用直接返回 ESP_ERR_NOT_ALLOWED，不发出请求。
+ *
+ * 客户端不加锁：初始化和预热之后，请求只在网络任务（todo_net）中发出。
  */
 
 #ifndef TODO_CLIENT_H
 #define TODO_CLIENT_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include "esp_err.h"
+#include "esp_http_client.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-// TODO最大数量
-#define MAX_TODOS 6
+// 每页TODO数量（列表按游标分页获取）
+#define TODO_PAGE_SIZE 10
 
 #define TODO_TITLE_MAX_LEN 64
-#define TODO_BODY_MAX_LEN 128
+#define TODO_BODY_MAX_LEN 4096   // 详情正文最大长度（按需获取，不在列表中保存）
 #define TODO_ID_MAX_LEN 256
 #define TODO_LIST_ID_MAX_LEN 256
 #define TODO_DATE_MAX_LEN 32
+#define TODO_CURSOR_MAX_LEN 512  // 下一页游标或 nextLink
 
 /**
  * @brief TODO项结构
@@ -30,41 +38,106 @@ typedef struct {
     char id[TODO_ID_MAX_LEN];
     char listId[TODO_LIST_ID_MAX_LEN];
     char title[TODO_TITLE_MAX_LEN];
-    char body[TODO_BODY_MAX_LEN];
     bool is_completed;
     char importance[16];
     char last_modified_date[TODO_DATE_MAX_LEN];
 } todo_item_t;
 
 /**
- * @brief TODO列表结构
+ * @brief TODO列表的一页
  */
 typedef struct {
-    todo_item_t items[MAX_TODOS];
+    todo_item_t items[TODO_PAGE_SIZE];
     int count;
     char default_listId[TODO_LIST_ID_MAX_LEN];
-} todo_list_t;
+    char next_cursor[TODO_CURSOR_MAX_LEN];  // 下一页游标，空字符串表示已是最后一页
+} todo_page_t;
+
+/**
+ * @brief 连接与握手统计
+ */
+typedef struct {
+    uint32_t requests;                  // 请求次数（含重试）
+    uint32_t connections_reused;        // 复用长连接、无需握手的请求
+    uint32_t handshakes_full;           // 完整握手次数（HTTP时为TCP建连）
+    uint32_t handshakes_offered;        // 携带本后端已保存TLS会话的握手次数（服务器是否接受恢复无从得知）
+    uint32_t handshake_full_avg_ms;
+    uint32_t handshake_offered_avg_ms;
+    uint32_t handshake_last_ms;
+} todo_client_conn_stats_t;
 
 /**
  * @brief 初始化TODO客户端
- * @param server_url 服务器地址，例如 "http://192.168.1.100:5000"
+ *
+ * 多个后端时按 todo_backend 的选择发送请求，后端无响应时自动切换。
+ * @param server_urls 服务器地址，多个用逗号分隔，例如 "http://192.168.1.100:5000,http://192.168.1.101:5000"
  * @return ESP_OK 成功, 其他值表示失败
  */
-esp_err_t todo_client_init(const char *server_url);
+esp_err_t todo_client_init(const char *server_urls);
 
 /**
- * @brief 从服务器获取TODO列表
- * @param list 用于存储TODO列表的结构
- * @return ESP_OK 成功, 其他值表示失败
+ * @brief 预热连接：提前完成TCP/TLS握手，连接保持给后续请求复用
+ * @return ESP_OK 成功, ESP_ERR_NOT_ALLOWED 重试退避或熔断中（未发出请求）, 其他值表示失败
+ */
+esp_err_t todo_client_prewarm(void);
+
+/**
+ * @brief 为 https 地址补齐证书校验和会话保存配置（http 地址不做修改）
+ *
+ * 供推送通道等使用独立连接的模块复用同一套TLS配置。
+ * @param config 已设置 url 的客户端配置
+ */
+void todo_client_apply_tls(esp_http_client_config_t *config);
+
+/**
+ * @brief 获取连接与握手统计
+ */
+void todo_client_get_conn_stats(todo_client_conn_stats_t *stats);
+
+/**
+ * @brief 从服务器获取一页TODO列表
+ *
+ * 服务器返回的 nextCursor 或 @odata.nextLink 原样保存在 page->next_cursor 中，
+ * 作为下一次调用的 cursor 参数。
+ * @param cursor 页游标，NULL或空字符串表示第一页
+ * @param page 用于存储该页的结构（较大，建议放在PSRAM）
+ * @return ESP_OK 成功, ESP_ERR_NOT_ALLOWED 重试退避或熔断中（未发出请求）, 其他值表示失败
  */
-esp_err_t todo_client_get_list(todo_list_t *list);
+esp_err_t todo_client_get_page(const char *cursor, todo_page_t *page);
+
+/**
+ * @brief 从JSON文本解析单个条目的摘要字段（用于推送事件）
+ * @param json 条目JSON，字段与列表中的条目相同
+ * @param item 输出条目
+ * @return ESP_OK 成功, ESP_ERR_INVALID_RESPONSE 缺少id, 其他值表示解析失败
+ */
+esp_err_t todo_client_parse_item(const char *json, todo_item_t *item);
+
+/**
+ * @brief 获取TODO正文（先查LRU缓存，未命中再请求服务器）
+ * @param todo_id TODO的ID
+ * @param list_id 列表ID（用于Graph API）
+ * @param body 输出缓冲区，建议 TODO_BODY_MAX_LEN 字节
+ * @param body_len 缓冲区长度
+ * @return ESP_OK 成功, ESP_ERR_NOT_ALLOWED 重试退避或熔断中（未发出请求）, 其他值表示失败
+ */
+esp_err_t todo_client_get_detail(const char *todo_id, const char *list_id, char *body, size_t body_len);
+
+/**
+ * @brief 预取TODO正文到缓存（已缓存时直接返回）
+ * @param todo_id TODO的ID
+ * @param list_id 列表ID
+ * @return ESP_OK 成功, ESP_ERR_NOT_ALLOWED 重试退避或熔断中（未发出请求）, 其他值表示失败
+ */
+esp_err_t todo_client_prefetch_detail(const char *todo_id, const char *list_id);
 
 /**
  * @brief 标记TODO为完成/未完成
  * @param todo_id TODO的ID
  * @param list_id 列表ID（用于Graph API）
  * @param completed true表示完成，false表示未完成
- * @return ESP_OK 成功, 其他值表示失败
+ * @return ESP_OK 成功, ESP_ERR_NOT_ALLOWED 重试退避或熔断中（未发出请求）,
+ *         ESP_ERR_INVALID_RESPONSE 服务器拒绝（4xx，重发无用）, 其他值表示可重试的失败
  */
 esp_err_t todo_client_set_completed(const char *todo_id, const char *list_id, bool completed);
 
@@ -72,7 +145,8 @@ esp_err_t todo_client_set_completed(const char *todo_id, const char *list_id, bo
  * @brief 创建新TODO
  * @param title 标题
  * @param body 描述
- * @return ESP_OK 成功, 其他值表示失败
+ * @return ESP_OK 成功, ESP_ERR_NOT_ALLOWED 重试退避或熔断中（未发出请求）,
+ *         ESP_ERR_INVALID_RESPONSE 服务器拒绝（4xx，重发无用）, 其他值表示可重试的失败
  */
 esp_err_t todo_client_create(const char *title, const char *body);
 
@@ -0,0 +1,203 @@
+/**
+ * @file todo_detail_cache.c
+ * @brief TODO详情LRU缓存实现
+ *
+ * 条目数很少，直接用数组 + 访问计数实现LRU。
+ * 每个条目一次分配，依次存放 ID 和正文两个字符串。
+ */
+
+#include "todo_detail_cache.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+#include "mem_tag.h"
+#include "esp_log.h"
+
+static const char *TAG = "detail_cache";
+
+typedef struct {
+    char *data;          // "id\0body\0"，NULL表示空槽
+    size_t size;         // data 分配大小
+    uint32_t last_used;  // LRU计数
+} cache_entry_t;
+
+static cache_entry_t entries[TODO_DETAIL_CACHE_ENTRIES];
+static uint32_t use_counter = 0;
+static size_t total_bytes = 0;
+static todo_detail_cache_stats_t cache_stats;
+static SemaphoreHandle_t cache_mutex = NULL;
+
+static const char *entry_body(const cache_entry_t *entry)
+{
+    return entry->data + strlen(entry->data) + 1;
+}
+
+static int find_entry(const char *todo_id)
+{
+    for (int i = 0; i < TODO_DETAIL_CACHE_ENTRIES; i++) {
+        if (entries[i].data != NULL && strcmp(entries[i].data, todo_id) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void free_entry(cache_entry_t *entry)
+{
+    total_bytes -= entry->size;
+    mem_tag_free(MEM_TAG_CACHE, entry->data);
+    entry->data = NULL;
+    entry->size = 0;
+    cache_stats.entries--;
+}
+
+static int find_lru_entry(void)
+{
+    int lru = -1;
+    for (int i = 0; i < TODO_DETAIL_CACHE_ENTRIES; i++) {
+        if (entries[i].data != NULL && (lru < 0 || entries[i].last_used < entries[lru].last_used)) {
+            lru = i;
+        }
+    }
+    return lru;
+}
+
+esp_err_t todo_detail_cache_init(void)
+{
+    if (cache_mutex == NULL) {
+        cache_mutex = xSemaphoreCreateMutex();
+        if (cache_mutex == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    return ESP_OK;
+}
+
+bool todo_detail_cache_get(const char *todo_id, char *body, size_t body_len)
+{
+    if (todo_id == NULL || body == NULL || body_len == 0) {
+        return false;
+    }
+
+    xSemaphoreTake(cache_mutex, portMAX_DELAY);
+    int index = find_entry(todo_id);
+    if (index >= 0) {
+        entries[index].last_used = ++use_counter;
+        strlcpy(body, entry_body(&entries[index]), body_len);
+        cache_stats.hits++;
+    } else {
+        cache_stats.misses++;
+    }
+    xSemaphoreGive(cache_mutex);
+
+    return index >= 0;
+}
+
+bool todo_detail_cache_contains(const char *todo_id)
+{
+    if (todo_id == NULL) {
+        return false;
+    }
+
+    xSemaphoreTake(cache_mutex, portMAX_DELAY);
+    bool found = find_entry(todo_id) >= 0;
+    xSemaphoreGive(cache_mutex);
+    return found;
+}
+
+esp_err_t todo_detail_cache_put(const char *todo_id, const char *body)
+{
+    if (todo_id == NULL || body == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t id_len = strlen(todo_id);
+    size_t body_len = strlen(body);
+    size_t size = id_len + 1 + body_len + 1;
+    if (size > TODO_DETAIL_CACHE_MAX_BYTES) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    char *data = mem_tag_malloc(MEM_TAG_CACHE, size, MALLOC_CAP_SPIRAM);
+    if (data == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(data, todo_id, id_len + 1);
+    memcpy(data + id_len + 1, body, body_len + 1);
+
+    xSemaphoreTake(cache_mutex, portMAX_DELAY);
+
+    int index = find_entry(todo_id);
+    if (index >= 0) {
+        free_entry(&entries[index]);
+    }
+
+    // 先按总字节数淘汰，再找空槽，没有空槽再淘汰一条
+    while (total_bytes + size > TODO_DETAIL_CACHE_MAX_BYTES) {
+        free_entry(&entries[find_lru_entry()]);
+        cache_stats.evictions++;
+    }
+
+    index = -1;
+    for (int i = 0; i < TODO_DETAIL_CACHE_ENTRIES; i++) {
+        if (entries[i].data == NULL) {
+            index = i;
+            break;
+        }
+    }
+    if (index < 0) {
+        index = find_lru_entry();
+        free_entry(&entries[index]);
+        cache_stats.evictions++;
+    }
+
+    entries[index].data = data;
+    entries[index].size = size;
+    entries[index].last_used = ++use_counter;
+    total_bytes += size;
+    cache_stats.entries++;
+
+    xSemaphoreGive(cache_mutex);
+
+    ESP_LOGD(TAG, "缓存正文 %u 字节，当前 %lu 条/%u 字节",
+             (unsigned)body_len, cache_stats.entries, (unsigned)total_bytes);
+    return ESP_OK;
+}
+
+void todo_detail_cache_remove(const char *todo_id)
+{
+    if (todo_id == NULL) {
+        return;
+    }
+
+    xSemaphoreTake(cache_mutex, portMAX_DELAY);
+    int index = find_entry(todo_id);
+    if (index >= 0) {
+        free_entry(&entries[index]);
+    }
+    xSemaphoreGive(cache_mutex);
+}
+
+void todo_detail_cache_clear(void)
+{
+    xSemaphoreTake(cache_mutex, portMAX_DELAY);
+    for (int i = 0; i < TODO_DETAIL_CACHE_ENTRIES; i++) {
+        if (entries[i].data != NULL) {
+            free_entry(&entries[i]);
+        }
+    }
+    xSemaphoreGive(cache_mutex);
+}
+
+void todo_detail_cache_get_stats(todo_detail_cache_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+
+    xSemaphoreTake(cache_mutex, portMAX_DELAY);
+    *stats = cache_stats;
+    stats->bytes = total_bytes;
+    xSemaphoreGive(cache_mutex);
+}
@@ -0,0 +1,82 @@
+/**
+ * @file todo_detail_cache.h
+ * @brief TODO详情（正文）LRU缓存
+ *
+ * 列表只拉取摘要字段，正文在长按时按需获取并缓存在PSRAM中，
+ * 按条目数和总字节数双重限制，超出时淘汰最久未使用的条目。
+ */
+
+#ifndef TODO_DETAIL_CACHE_H
+#define TODO_DETAIL_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TODO_DETAIL_CACHE_ENTRIES   16
+#define TODO_DETAIL_CACHE_MAX_BYTES (32 * 1024)
+
+/**
+ * @brief 缓存统计
+ */
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t entries;
+    uint32_t bytes;
+} todo_detail_cache_stats_t;
+
+/**
+ * @brief 初始化缓存
+ * @return ESP_OK 成功
+ */
+esp_err_t todo_detail_cache_init(void);
+
+/**
+ * @brief 查询正文并复制到调用者缓冲区（命中时更新LRU顺序）
+ * @param todo_id TODO的ID
+ * @param body 输出缓冲区
+ * @param body_len 缓冲区长度
+ * @return true 命中, false 未命中
+ */
+bool todo_detail_cache_get(const char *todo_id, char *body, size_t body_len);
+
+/**
+ * @brief 是否已缓存（不计入命中统计，不改变LRU顺序）
+ */
+bool todo_detail_cache_contains(const char *todo_id);
+
+/**
+ * @brief 写入/替换正文
+ * @param todo_id TODO的ID
+ * @param body 正文
+ * @return ESP_OK 成功, ESP_ERR_NO_MEM 内存不足, ESP_ERR_INVALID_SIZE 单条超出总容量
+ */
+esp_err_t todo_detail_cache_put(const char *todo_id, const char *body);
+
+/**
+ * @brief 删除某条缓存（条目被修改或删除时调用）
+ */
+void todo_detail_cache_remove(const char *todo_id);
+
+/**
+ * @brief 清空缓存
+ */
+void todo_detail_cache_clear(void);
+
+/**
+ * @brief 获取统计
+ */
+void todo_detail_cache_get_stats(todo_detail_cache_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
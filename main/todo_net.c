@@ -0,0 +1,209 @@
+/**
+ * @file todo_net.c
+ * @brief 网络任务实现
+ *
+ * 命令槽位带游标或ID（约0.5KB），两个队列都放在PSRAM。
+ * 获取列表时每次分配一个新数据块，直接写入解析结果，
+ * 连同引用一起交给界面任务，不再经过共享缓冲区和拷贝。
+ */
+
+#include "todo_net.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "spsc_ring.h"
+#include "app_tasks.h"
+#include "mem_tag.h"
+#include "net_timing.h"
+#include "refresh_governor.h"
+
+static const char *TAG = "todo_net";
+
+typedef struct {
+    todo_net_op_t op;
+    bool completed;
+    uint32_t tag;
+    int64_t submit_us;
+    union {
+        char cursor[TODO_CURSOR_MAX_LEN];
+        struct {
+            char id[TODO_ID_MAX_LEN];
+            char list_id[TODO_LIST_ID_MAX_LEN];
+        } todo;
+    };
+} net_cmd_t;
+
+typedef struct {
+    todo_net_result_t result;
+    int64_t submit_us;
+} net_result_t;
+
+static spsc_ring_t cmd_ring;        // 界面任务 -> 网络任务
+static spsc_ring_t result_ring;     // 网络任务 -> 界面任务
+static TaskHandle_t net_task_handle = NULL;
+
+// 以下只在界面任务中访问
+static net_cmd_t submit_cmd;
+static int inflight = 0;
+static todo_net_stats_t stats;
+static uint64_t latency_total_ms = 0;
+static uint32_t completed_count = 0;
+
+static void execute(const net_cmd_t *cmd, todo_net_result_t *result)
+{
+    switch (cmd->op) {
+        case TODO_NET_FETCH_PAGE:
+            result->block = todo_store_block_new();
+            if (result->block == NULL) {
+                result->err = ESP_ERR_NO_MEM;
+                break;
+            }
+            result->err = todo_client_get_page(cmd->cursor, &result->block->page);
+            if (result->err != ESP_OK) {
+                todo_store_block_release(result->block);
+                result->block = NULL;
+            }
+            break;
+        case TODO_NET_SET_COMPLETED:
+            result->err = todo_client_set_completed(cmd->todo.id, cmd->todo.list_id, cmd->completed);
+            break;
+        case TODO_NET_FETCH_DETAIL:
+            result->err = todo_client_prefetch_detail(cmd->todo.id, cmd->todo.list_id);
+            break;
+        default:
+            result->err = ESP_ERR_NOT_SUPPORTED;
+            break;
+    }
+}
+
+static void net_task(void *arg)
+{
+    (void)arg;
+    static net_cmd_t cmd;    // 槽位较大，不占任务栈
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TODO_NET_IDLE_WAKE_MS));
+
+        while (spsc_ring_pop(&cmd_ring, &cmd)) {
+            net_result_t out = {
+                .result = { .op = cmd.op, .tag = cmd.tag },
+                .submit_us = cmd.submit_us,
+            };
+            execute(&cmd, &out.result);
+
+            // 在途数不超过容量，不会满
+            if (!spsc_ring_push(&result_ring, &out)) {
+                ESP_LOGE(TAG, "结果队列已满，丢弃结果 (op %d)", cmd.op);
+            }
+            refresh_governor_wake();
+        }
+
+        net_timing_log_periodic();
+        app_tasks_log_periodic();
+        mem_tag_log_periodic();
+    }
+}
+
+esp_err_t todo_net_start(void)
+{
+    if (net_task_handle != NULL) {
+        return ESP_OK;
+    }
+
+    if (spsc_ring_init(&cmd_ring, sizeof(net_cmd_t), TODO_NET_QUEUE_SIZE, MALLOC_CAP_SPIRAM, MEM_TAG_NET) != ESP_OK ||
+        spsc_ring_init(&result_ring, sizeof(net_result_t), TODO_NET_QUEUE_SIZE, MALLOC_CAP_SPIRAM, MEM_TAG_NET) != ESP_OK) {
+        ESP_LOGE(TAG, "网络任务队列分配失败");
+        return ESP_ERR_NO_MEM;
+    }
+
+    return app_tasks_create(net_task, "todo_net", APP_NET_TASK_STACK_SIZE, APP_NET_TASK_PRIORITY,
+                            APP_NET_CORE, &net_task_handle);
+}
+
+static esp_err_t submit(void)
+{
+    if (net_task_handle == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (inflight >= TODO_NET_QUEUE_SIZE) {
+        stats.rejected++;
+        return ESP_ERR_NO_MEM;
+    }
+
+    submit_cmd.submit_us = esp_timer_get_time();
+    if (!spsc_ring_push(&cmd_ring, &submit_cmd)) {
+        stats.rejected++;
+        return ESP_ERR_NO_MEM;
+    }
+    inflight++;
+    stats.commands++;
+    xTaskNotifyGive(net_task_handle);
+    return ESP_OK;
+}
+
+esp_err_t todo_net_fetch_page(const char *cursor, uint32_t tag)
+{
+    submit_cmd.op = TODO_NET_FETCH_PAGE;
+    submit_cmd.tag = tag;
+    strlcpy(submit_cmd.cursor, cursor != NULL ? cursor : "", sizeof(submit_cmd.cursor));
+    return submit();
+}
+
+esp_err_t todo_net_set_completed(const char *todo_id, const char *list_id, bool completed, uint32_t tag)
+{
+    if (todo_id == NULL || list_id == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    submit_cmd.op = TODO_NET_SET_COMPLETED;
+    submit_cmd.tag = tag;
+    submit_cmd.completed = completed;
+    strlcpy(submit_cmd.todo.id, todo_id, sizeof(submit_cmd.todo.id));
+    strlcpy(submit_cmd.todo.list_id, list_id, sizeof(submit_cmd.todo.list_id));
+    return submit();
+}
+
+esp_err_t todo_net_fetch_detail(const char *todo_id, const char *list_id, uint32_t tag)
+{
+    if (todo_id == NULL || list_id == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    submit_cmd.op = TODO_NET_FETCH_DETAIL;
+    submit_cmd.tag = tag;
+    strlcpy(submit_cmd.todo.id, todo_id, sizeof(submit_cmd.todo.id));
+    strlcpy(submit_cmd.todo.list_id, list_id, sizeof(submit_cmd.todo.list_id));
+    return submit();
+}
+
+bool todo_net_poll(todo_net_result_t *result)
+{
+    static net_result_t in;
+
+    if (net_task_handle == NULL || !spsc_ring_pop(&result_ring, &in)) {
+        return false;
+    }
+    inflight--;
+
+    uint32_t latency_ms = (uint32_t)((esp_timer_get_time() - in.submit_us) / 1000);
+    latency_total_ms += latency_ms;
+    completed_count++;
+    if (latency_ms > stats.latency_max_ms) {
+        stats.latency_max_ms = latency_ms;
+    }
+
+    *result = in.result;
+    return true;
+}
+
+void todo_net_get_stats(todo_net_stats_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+    *out = stats;
+    out->cmd_high_water = cmd_ring.high_water;
+    out->result_high_water = result_ring.high_water;
+    out->latency_avg_ms = completed_count > 0 ? (uint32_t)(latency_total_ms / completed_count) : 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file todo_net.h
+ * @brief 网络任务
+ *
+ * 所有经 todo_client 的HTTP请求都在这个任务中执行（固定在 APP_NET_CORE）。
+ * 界面任务把请求写入命令队列，网络任务执行后把结果写入结果队列并唤醒界面任务，
+ * 界面任务在主循环中取出结果，更新分页数据、写操作队列和详情弹窗。
+ * 两个队列都是单生产者/单消费者无锁队列：命令只由界面任务写入，结果只由网络任务写入。
+ *
+ * 在途请求数不超过队列容量，结果队列不会满；超出时提交函数返回 ESP_ERR_NO_MEM，
+ * 调用方保持原状态，下一轮再提交。
+ */
+
+#ifndef TODO_NET_H
+#define TODO_NET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "todo_client.h"
+#include "todo_store.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TODO_NET_QUEUE_SIZE     8       // 2的幂
+#define TODO_NET_IDLE_WAKE_MS   1000    // 没有请求时也定期醒来打印统计
+
+/**
+ * @brief 请求类型
+ */
+typedef enum {
+    TODO_NET_FETCH_PAGE = 0,    // todo_client_get_page
+    TODO_NET_SET_COMPLETED,     // todo_client_set_completed
+    TODO_NET_FETCH_DETAIL,      // todo_client_prefetch_detail，正文写入详情缓存
+} todo_net_op_t;
+
+/**
+ * @brief 请求结果
+ */
+typedef struct {
+    todo_net_op_t op;
+    esp_err_t err;
+    uint32_t tag;               // 提交时的 tag，原样带回
+    todo_page_block_t *block;   // FETCH_PAGE 成功时的页数据块，引用归取出结果的一方
+} todo_net_result_t;
+
+/**
+ * @brief 统计
+ */
+typedef struct {
+    uint32_t commands;          // 已提交的请求
+    uint32_t rejected;          // 在途请求已满被拒绝
+    uint32_t cmd_high_water;    // 命令队列最大占用
+    uint32_t result_high_water; // 结果队列最大占用
+    uint32_t latency_avg_ms;    // 从提交到结果被取出的平均时间
+    uint32_t latency_max_ms;
+} todo_net_stats_t;
+
+/**
+ * @brief 创建队列和网络任务（在 todo_client_init 之后、界面任务启动之前调用）
+ * @return ESP_OK 成功, ESP_ERR_NO_MEM 内存不足
+ */
+esp_err_t todo_net_start(void);
+
+/**
+ * @brief 提交获取一页列表
+ * @param cursor 页游标，NULL表示第一页
+ * @param tag 原样带回结果
+ * @return ESP_OK 已提交, ESP_ERR_NO_MEM 在途请求已满, ESP_ERR_INVALID_STATE 网络任务未启动
+ */
+esp_err_t todo_net_fetch_page(const char *cursor, uint32_t tag);
+
+/**
+ * @brief 提交完成状态修改
+ * @return 同 todo_net_fetch_page
+ */
+esp_err_t todo_net_set_completed(const char *todo_id, const char *list_id, bool completed, uint32_t tag);
+
+/**
+ * @brief 提交获取详情正文（写入详情缓存，已缓存时直接成功）
+ * @return 同 todo_net_fetch_page
+ */
+esp_err_t todo_net_fetch_detail(const char *todo_id, const char *list_id, uint32_t tag);
+
+/**
+ * @brief 取出一个结果（界面任务主循环中调用）
+ * @return true 取到结果, false 没有结果
+ */
+bool todo_net_poll(todo_net_result_t *result);
+
+/**
+ * @brief 获取统计
+ */
+void todo_net_get_stats(todo_net_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
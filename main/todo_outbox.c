@@ -0,0 +1,115 @@
+/**
+ * @file todo_outbox.c
+ * @brief 待发送的写操作队列实现
+ */
+
+#include "todo_outbox.h"
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "mem_tag.h"
+#include "esp_log.h"
+#include "todo_client.h"
+#include "todo_net.h"
+#include "todo_refresh.h"
+#include "retry_policy.h"
+
+static const char *TAG = "todo_outbox";
+
+typedef struct {
+    char id[TODO_ID_MAX_LEN];
+    char list_id[TODO_LIST_ID_MAX_LEN];
+    bool completed;
+} outbox_entry_t;
+
+static outbox_entry_t *entries = NULL;   // 按排队顺序，entries[0] 为队首
+static int count = 0;
+static bool sending = false;             // 队首已交给网络任务，等待结果
+
+esp_err_t todo_outbox_init(void)
+{
+    if (entries == NULL) {
+        entries = mem_tag_calloc(MEM_TAG_UI, TODO_OUTBOX_SIZE, sizeof(outbox_entry_t), MALLOC_CAP_SPIRAM);
+        if (entries == NULL) {
+            ESP_LOGE(TAG, "写操作队列分配失败");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    return ESP_OK;
+}
+
+static void remove_at(int index)
+{
+    memmove(&entries[index], &entries[index + 1], (count - index - 1) * sizeof(outbox_entry_t));
+    count--;
+}
+
+esp_err_t todo_outbox_set_completed(const char *todo_id, const char *list_id, bool completed)
+{
+    if (todo_id == NULL || list_id == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (entries == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // 已发出的队首不能撤销，同一条目再次切换时排在它后面
+    for (int i = sending ? 1 : 0; i < count; i++) {
+        if (strcmp(entries[i].id, todo_id) == 0) {
+            if (entries[i].completed != completed) {
+                // 还没发出去又切换回来，服务器上的状态本来就是这样
+                remove_at(i);
+                ESP_LOGI(TAG, "切换被撤销，剩余 %d 条待发送", count);
+            }
+            return ESP_OK;
+        }
+    }
+
+    if (count == TODO_OUTBOX_SIZE) {
+        ESP_LOGW(TAG, "写操作队列已满");
+        return ESP_ERR_NO_MEM;
+    }
+
+    outbox_entry_t *entry = &entries[count++];
+    strlcpy(entry->id, todo_id, sizeof(entry->id));
+    strlcpy(entry->list_id, list_id, sizeof(entry->list_id));
+    entry->completed = completed;
+    return ESP_OK;
+}
+
+void todo_outbox_flush(void)
+{
+    if (sending || count == 0 || retry_policy_wait_ms(RETRY_ENDPOINT_MUTATION) > 0) {
+        return;
+    }
+
+    outbox_entry_t *head = &entries[0];
+    sending = todo_net_set_completed(head->id, head->list_id, head->completed, 0) == ESP_OK;
+}
+
+void todo_outbox_on_sent(esp_err_t err)
+{
+    if (!sending) {
+        return;
+    }
+    sending = false;
+
+    if (err == ESP_OK) {
+        remove_at(0);
+        if (count > 0) {
+            ESP_LOGI(TAG, "已发送，剩余 %d 条", count);
+        }
+    } else if (err == ESP_ERR_INVALID_RESPONSE) {
+        // 条目可能已在别处删除或移动，本地乐观修改作废
+        ESP_LOGW(TAG, "服务器拒绝，放弃该操作并重新同步");
+        remove_at(0);
+        todo_refresh_request(TODO_REFRESH_ROLLBACK, false);
+    } else {
+        // 服务器无响应：留在队首，重试策略决定何时再发（期间可能已切换后端）
+        ESP_LOGW(TAG, "发送失败，%d 条待发送", count);
+    }
+}
+
+int todo_outbox_pending(void)
+{
+    return count;
+}
@@ -0,0 +1,55 @@
+/**
+ * @file todo_outbox.h
+ * @brief 待发送的写操作队列
+ *
+ * 点击切换完成状态时先在本地生效并排队，由主循环逐条交给网络任务发送，同一时刻最多一条在途。
+ * 服务器不可用或正在切换后端时操作留在队列中，恢复后按顺序补发，不会丢失；
+ * 服务器明确拒绝的操作被丢弃，并安排一次刷新把本地状态改回服务器的状态。
+ *
+ * 所有函数都在界面任务中调用，不加锁。
+ */
+
+#ifndef TODO_OUTBOX_H
+#define TODO_OUTBOX_H
+
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TODO_OUTBOX_SIZE 16
+
+/**
+ * @brief 初始化队列（PSRAM）
+ * @return ESP_OK 成功, ESP_ERR_NO_MEM 内存不足
+ */
+esp_err_t todo_outbox_init(void);
+
+/**
+ * @brief 排队一次完成状态切换（同一条目尚未发送的切换会被合并）
+ * @return ESP_OK 已排队, ESP_ERR_NO_MEM 队列已满
+ */
+esp_err_t todo_outbox_set_completed(const char *todo_id, const char *list_id, bool completed);
+
+/**
+ * @brief 在主循环中提交队首的操作（已有在途操作或重试退避期间不提交）
+ */
+void todo_outbox_flush(void);
+
+/**
+ * @brief 网络任务返回队首操作的结果（TODO_NET_SET_COMPLETED）
+ */
+void todo_outbox_on_sent(esp_err_t err);
+
+/**
+ * @brief 队列中等待发送的操作数
+ */
+int todo_outbox_pending(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
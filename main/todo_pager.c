@@ -0,0 +1,527 @@
+/**
+ * @file todo_pager.c
+ * @brief TODO列表分页管理实现
+ *
+ * 页表是PSRAM中的动态数组，页只能按顺序发现：第 k 页获取成功后才知道
+ * 第 k+1 页的游标和起始行号。被淘汰的页保留游标和条目数，只释放条目数据。
+ *
+ * 页数据是 todo_store 的引用计数数据块，网络任务获取后直接交过来，不再拷贝；
+ * 修改条目前先取得可写的块（被详情弹窗等持有时写时复制），并登记变更。
+ *
+ * 请求交给网络任务执行，同一时刻最多一页在途。页表被截断时递增代数，
+ * 在途请求带着提交时的代数，结果回来时代数不符就丢弃。
+ */
+
+#include "todo_pager.h"
+#include <stdlib.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "mem_tag.h"
+#include "retry_policy.h"
+#include "todo_net.h"
+#include "todo_store.h"
+
+static const char *TAG = "todo_pager";
+
+#define PAGE_TABLE_INIT_CAP 16
+
+typedef enum {
+    PAGE_EMPTY = 0,    // 数据未常驻
+    PAGE_PENDING,      // 等待获取（常驻页在自动刷新时也会进入该状态）
+    PAGE_LOADED,
+} page_state_t;
+
+typedef struct {
+    char *cursor;          // 该页游标，NULL表示第一页
+    todo_page_block_t *block;  // 常驻数据，NULL表示未常驻
+    uint32_t first_row;    // 该页第一条的行号
+    uint16_t count;        // 条目数，fetched 为 true 时有效
+    uint8_t state;
+    bool fetched;          // 是否获取过
+    bool refreshing;       // 被自动刷新标记，重新获取后清除
+} pager_page_t;
+
+static pager_page_t *pages = NULL;
+static int page_cap = 0;
+static int page_count = 0;
+static int view_first_row = 0;         // 可视区域第一行，决定淘汰和获取的优先级
+
+static int inflight_page = -1;         // 在途请求的页，-1表示没有
+static bool inflight_reset = false;    // 在途请求是替换全部页的第一页
+static uint32_t generation = 0;        // 页表截断时递增
+static bool reset_wanted = false;      // 等待重新获取第一页并替换全部页
+
+static todo_pager_stats_t stats;
+static int64_t walk_start_us = 0;      // 从第一页开始计时，到达最后一页时打印
+static bool end_logged = false;
+
+static void update_memory_stats(void)
+{
+    uint32_t bytes = page_cap * sizeof(pager_page_t);
+    uint32_t resident = 0;
+    for (int i = 0; i < page_count; i++) {
+        if (pages[i].cursor != NULL) {
+            bytes += strlen(pages[i].cursor) + 1;
+        }
+        if (pages[i].block != NULL) {
+            bytes += sizeof(todo_page_block_t);
+            resident++;
+        }
+    }
+
+    stats.known_pages = page_count;
+    stats.resident_pages = resident;
+    stats.resident_bytes = bytes;
+    if (bytes > stats.peak_resident_bytes) {
+        stats.peak_resident_bytes = bytes;
+    }
+}
+
+static void free_items(pager_page_t *page)
+{
+    todo_store_block_release(page->block);
+    page->block = NULL;
+}
+
+/**
+ * @brief 删除第 n 页及之后的所有页
+ */
+static void truncate_pages(int n)
+{
+    if (inflight_page >= n) {
+        generation++;
+    }
+    for (int i = n; i < page_count; i++) {
+        free_items(&pages[i]);
+        mem_tag_free(MEM_TAG_UI, pages[i].cursor);
+        memset(&pages[i], 0, sizeof(pager_page_t));
+    }
+    if (n < page_count) {
+        page_count = n;
+    }
+}
+
+static esp_err_t append_page(const char *cursor, uint32_t first_row)
+{
+    if (page_count == page_cap) {
+        int new_cap = page_cap ? page_cap * 2 : PAGE_TABLE_INIT_CAP;
+        pager_page_t *grown = mem_tag_realloc(MEM_TAG_UI, pages, new_cap * sizeof(pager_page_t), MALLOC_CAP_SPIRAM);
+        if (grown == NULL) {
+            ESP_LOGE(TAG, "页表扩容失败 (%d 页)", new_cap);
+            return ESP_ERR_NO_MEM;
+        }
+        pages = grown;
+        page_cap = new_cap;
+    }
+
+    pager_page_t *page = &pages[page_count];
+    memset(page, 0, sizeof(pager_page_t));
+    page->first_row = first_row;
+    if (cursor != NULL) {
+        size_t len = strlen(cursor) + 1;
+        page->cursor = mem_tag_malloc(MEM_TAG_UI, len, MALLOC_CAP_SPIRAM);
+        if (page->cursor == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        memcpy(page->cursor, cursor, len);
+    }
+    page_count++;
+    return ESP_OK;
+}
+
+/**
+ * @brief 行号所在的页（二分查找起始行号），超出已知范围时返回-1
+ */
+static int page_of_row(int row)
+{
+    if (row < 0 || page_count == 0) {
+        return -1;
+    }
+
+    int lo = 0;
+    int hi = page_count - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (pages[mid].first_row <= (uint32_t)row) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    const pager_page_t *page = &pages[lo];
+    if (!page->fetched || (uint32_t)row >= page->first_row + page->count) {
+        return -1;
+    }
+    return lo;
+}
+
+static void request_page(int index)
+{
+    if (pages[index].state == PAGE_EMPTY) {
+        pages[index].state = PAGE_PENDING;
+    } else {
+        stats.dedup_requests++;
+    }
+}
+
+static int viewport_page(void)
+{
+    int page = page_of_row(view_first_row);
+    return page >= 0 ? page : 0;
+}
+
+static void evict_far_pages(void)
+{
+    int center = viewport_page();
+    for (int i = 0; i < page_count; i++) {
+        if (pages[i].block != NULL && abs(i - center) > TODO_PAGER_KEEP_DISTANCE) {
+            free_items(&pages[i]);
+            pages[i].state = PAGE_EMPTY;
+            pages[i].refreshing = false;  // 再次滚动到时会重新获取
+            stats.evictions++;
+        }
+    }
+}
+
+/**
+ * @brief 把获取到的一页写入页表（接管数据块的引用）
+ */
+static void apply_page(int index, todo_page_block_t *block)
+{
+    pager_page_t *page = &pages[index];
+    const todo_page_t *fetched = &block->page;
+    int known_before = todo_pager_get_count();
+    int pages_before = page_count;
+
+    // 重新获取的页条数或后继游标变了，说明列表结构已变化，后面的页全部作废
+    if (page->fetched && index + 1 < page_count &&
+        (fetched->count != page->count || strcmp(pages[index + 1].cursor, fetched->next_cursor) != 0)) {
+        ESP_LOGI(TAG, "第 %d 页内容变化，丢弃后续 %d 页", index, page_count - index - 1);
+        truncate_pages(index + 1);
+    }
+
+    todo_store_block_release(page->block);
+    page->block = block;
+    page->count = fetched->count;
+    page->fetched = true;
+    page->refreshing = false;
+    page->state = PAGE_LOADED;
+    stats.pages_fetched++;
+
+    if (index == page_count - 1 && fetched->next_cursor[0] != '\0') {
+        if (append_page(fetched->next_cursor, page->first_row + page->count) != ESP_OK) {
+            ESP_LOGE(TAG, "无法记录下一页游标，停止分页");
+        }
+    }
+
+    update_memory_stats();
+    ESP_LOGD(TAG, "第 %d 页 (%d 条)", index, page->count);
+
+    todo_store_changed_rows(page->first_row, page->first_row + page->count - 1);
+    if (page_count != pages_before || todo_pager_get_count() != known_before) {
+        todo_store_changed_structure();
+    }
+
+    if (!todo_pager_has_more() && !end_logged) {
+        end_logged = true;
+        ESP_LOGI(TAG, "已到达列表末尾：共 %d 条 / %d 页，用时 %lld ms，页数据峰值 %lu 字节",
+                 todo_pager_get_count(), page_count, (esp_timer_get_time() - walk_start_us) / 1000,
+                 stats.peak_resident_bytes);
+    }
+}
+
+static void start_fetch(int index, bool reset)
+{
+    const char *cursor = reset ? NULL : pages[index].cursor;
+    if (todo_net_fetch_page(cursor, generation) != ESP_OK) {
+        return;    // 在途请求已满，下一轮再提交
+    }
+    inflight_page = reset ? 0 : index;
+    inflight_reset = reset;
+    if (reset) {
+        walk_start_us = esp_timer_get_time();
+    }
+}
+
+esp_err_t todo_pager_refresh(bool reset)
+{
+    if (!reset && page_count > 0) {
+        for (int i = 0; i < page_count; i++) {
+            if (pages[i].block != NULL) {
+                pages[i].state = PAGE_PENDING;
+                pages[i].refreshing = true;
+            }
+        }
+        return ESP_OK;
+    }
+
+    // 服务器不可用时保留现有列表，不清空后再失败
+    if (retry_policy_wait_ms(RETRY_ENDPOINT_LIST) > 0) {
+        return ESP_ERR_NOT_ALLOWED;
+    }
+
+    // 第一页到达后才替换全部页，期间旧数据继续显示
+    reset_wanted = true;
+    todo_pager_process();
+    return ESP_OK;
+}
+
+void todo_pager_set_viewport(int first_row, int last_row)
+{
+    view_first_row = first_row;
+    if (page_count == 0) {
+        return;
+    }
+
+    evict_far_pages();
+
+    int known = todo_pager_get_count();
+    int last = last_row < known ? last_row : known - 1;
+    for (int row = first_row; row <= last; ) {
+        int index = page_of_row(row);
+        if (index < 0) {
+            break;
+        }
+        if (pages[index].block == NULL) {
+            request_page(index);
+        }
+        row = pages[index].first_row + pages[index].count;
+    }
+
+    if (todo_pager_has_more() && last_row >= known - TODO_PAGER_PREFETCH_ROWS) {
+        request_page(page_count - 1);
+    }
+
+    update_memory_stats();
+}
+
+void todo_pager_process(void)
+{
+    if (inflight_page >= 0 || retry_policy_wait_ms(RETRY_ENDPOINT_LIST) > 0) {
+        return;
+    }
+    if (reset_wanted) {
+        start_fetch(0, true);
+        return;
+    }
+
+    int center = viewport_page();
+    int best = -1;
+    for (int i = 0; i < page_count; i++) {
+        if (pages[i].state == PAGE_PENDING && (best < 0 || abs(i - center) < abs(best - center))) {
+            best = i;
+        }
+    }
+    if (best >= 0) {
+        start_fetch(best, false);
+    }
+}
+
+bool todo_pager_on_fetched(uint32_t tag, esp_err_t err, todo_page_block_t *block)
+{
+    int index = inflight_page;
+    bool reset = inflight_reset;
+    inflight_page = -1;
+    inflight_reset = false;
+
+    if (index < 0 || tag != generation) {
+        stats.stale_results++;
+        todo_store_block_release(block);
+        return false;
+    }
+    if (err != ESP_OK || block == NULL) {
+        // 保持待获取，退避结束后由 todo_pager_process 重试，期间旧数据继续显示
+        if (err != ESP_ERR_NOT_ALLOWED) {
+            stats.fetch_failures++;
+        }
+        if (reset && page_count > 0) {
+            // 已有列表时放弃这次替换；还没有列表时继续重试
+            reset_wanted = false;
+        }
+        return false;
+    }
+
+    if (reset) {
+        reset_wanted = false;
+        truncate_pages(0);
+        view_first_row = 0;
+        end_logged = false;
+        todo_store_changed_structure();
+        if (append_page(NULL, 0) != ESP_OK) {
+            todo_store_block_release(block);
+            return false;
+        }
+    }
+
+    apply_page(index, block);
+    // 请求发出后可视区域可能已经移走
+    evict_far_pages();
+    update_memory_stats();
+    return true;
+}
+
+int todo_pager_get_count(void)
+{
+    if (page_count == 0) {
+        return 0;
+    }
+    const pager_page_t *last = &pages[page_count - 1];
+    return last->first_row + (last->fetched ? last->count : 0);
+}
+
+bool todo_pager_is_refreshing(void)
+{
+    if (reset_wanted) {
+        return true;
+    }
+    for (int i = 0; i < page_count; i++) {
+        if (pages[i].refreshing) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool todo_pager_is_resetting(void)
+{
+    return reset_wanted;
+}
+
+bool todo_pager_has_more(void)
+{
+    return page_count > 0 && !pages[page_count - 1].fetched;
+}
+
+const todo_item_t *todo_pager_get_item(int row)
+{
+    int index = page_of_row(row);
+    if (index < 0) {
+        return NULL;
+    }
+    if (pages[index].block == NULL) {
+        request_page(index);
+        return NULL;
+    }
+    return &pages[index].block->page.items[row - pages[index].first_row];
+}
+
+todo_page_block_t *todo_pager_snapshot(int row, const todo_item_t **item)
+{
+    int index = page_of_row(row);
+    if (index < 0 || pages[index].block == NULL || item == NULL) {
+        return NULL;
+    }
+    *item = &pages[index].block->page.items[row - pages[index].first_row];
+    return todo_store_block_retain(pages[index].block);
+}
+
+/**
+ * @brief 修改前取得第 index 页的可写数据块
+ * @return 条目数组，复制失败时返回NULL
+ */
+static todo_item_t *writable_items(int index)
+{
+    todo_page_block_t *block = todo_store_block_writable(pages[index].block);
+    if (block == NULL) {
+        ESP_LOGW(TAG, "第 %d 页复制失败，本地修改未生效", index);
+        return NULL;
+    }
+    pages[index].block = block;
+    return block->page.items;
+}
+
+void todo_pager_set_completed(int row, bool completed)
+{
+    int index = page_of_row(row);
+    if (index < 0 || pages[index].block == NULL) {
+        return;
+    }
+    todo_item_t *items = writable_items(index);
+    if (items != NULL) {
+        items[row - pages[index].first_row].is_completed = completed;
+        todo_store_changed_rows(row, row);
+    }
+}
+
+/**
+ * @brief 在常驻页中按ID查找条目
+ */
+static bool find_resident_item(const char *todo_id, int *page_index, int *offset)
+{
+    for (int i = 0; i < page_count; i++) {
+        if (pages[i].block == NULL) {
+            continue;
+        }
+        for (int j = 0; j < pages[i].count; j++) {
+            if (strcmp(pages[i].block->page.items[j].id, todo_id) == 0) {
+                *page_index = i;
+                *offset = j;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool todo_pager_apply_upsert(const todo_item_t *item)
+{
+    int index;
+    int offset;
+    if (item == NULL || page_count == 0) {
+        return false;
+    }
+
+    if (!find_resident_item(item->id, &index, &offset)) {
+        return false;
+    }
+
+    todo_item_t *items = writable_items(index);
+    if (items == NULL) {
+        return false;
+    }
+    todo_item_t *dst = &items[offset];
+    char list_id[TODO_LIST_ID_MAX_LEN];
+    strlcpy(list_id, dst->listId, sizeof(list_id));
+    memcpy(dst, item, sizeof(todo_item_t));
+    if (dst->listId[0] == '\0') {
+        strlcpy(dst->listId, list_id, sizeof(dst->listId));
+    }
+    int row = pages[index].first_row + offset;
+    todo_store_changed_rows(row, row);
+    return true;
+}
+
+bool todo_pager_apply_delete(const char *todo_id)
+{
+    int index;
+    int offset;
+    if (todo_id == NULL || !find_resident_item(todo_id, &index, &offset)) {
+        return false;
+    }
+
+    pager_page_t *page = &pages[index];
+    todo_item_t *items = writable_items(index);
+    if (items == NULL) {
+        return false;
+    }
+    memmove(&items[offset], &items[offset + 1], (page->count - offset - 1) * sizeof(todo_item_t));
+    page->count--;
+    page->block->page.count = page->count;
+    for (int i = index + 1; i < page_count; i++) {
+        pages[i].first_row--;
+    }
+    todo_store_changed_structure();
+    return true;
+}
+
+void todo_pager_get_stats(todo_pager_stats_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+    update_memory_stats();
+    *out = stats;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file todo_pager.h
+ * @brief TODO列表分页管理
+ *
+ * 按服务器返回的游标逐页获取列表。页表记录每页的游标和起始行号，
+ * 条目数据只为可视区域附近的页常驻在PSRAM中，远离可视区域的页被淘汰，
+ * 再次滚动回来时用保存的游标重新获取。
+ *
+ * 请求由网络任务异步执行，结果通过 todo_pager_on_fetched 交回。
+ * 所有函数都在界面任务中调用，不加锁。
+ */
+
+#ifndef TODO_PAGER_H
+#define TODO_PAGER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "todo_client.h"
+#include "todo_store.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TODO_PAGER_KEEP_DISTANCE  1   // 与可视页相距超过该页数的条目数据被淘汰
+#define TODO_PAGER_PREFETCH_ROWS  5   // 可视区域距已加载末尾不足该行数时预取下一页
+
+/**
+ * @brief 分页统计
+ */
+typedef struct {
+    uint32_t pages_fetched;      // 累计获取页数
+    uint32_t fetch_failures;     // 获取失败次数
+    uint32_t stale_results;      // 页表已截断，被丢弃的结果
+    uint32_t dedup_requests;     // 被去重的重复请求
+    uint32_t evictions;          // 淘汰页数
+    uint32_t known_pages;        // 页表中的页数
+    uint32_t resident_pages;     // 当前常驻页数
+    uint32_t resident_bytes;     // 当前常驻字节（页数据 + 页表 + 游标）
+    uint32_t peak_resident_bytes;
+} todo_pager_stats_t;
+
+/**
+ * @brief 刷新列表
+ *
+ * reset 为 true 时重新获取第一页，到达后丢弃全部页（手动刷新），获取失败时保留现有列表；
+ * 为 false 时保留页表，只把常驻页标记为待重新获取（自动刷新）。
+ * 两种情况都由 todo_pager_process 逐页提交，刷新期间旧数据继续显示。
+ * @param reset 是否丢弃全部页
+ * @return ESP_OK 已开始, ESP_ERR_NOT_ALLOWED 列表接口退避/熔断中（列表保持不变）
+ */
+esp_err_t todo_pager_refresh(bool reset);
+
+/**
+ * @brief 报告当前可视行范围
+ *
+ * 请求可视行所在但未常驻的页，接近已加载末尾时请求下一页，
+ * 并淘汰远离可视区域的页。重复请求会被去重。
+ */
+void todo_pager_set_viewport(int first_row, int last_row);
+
+/**
+ * @brief 没有在途请求时提交一个待获取的页（优先离可视区域最近的页）
+ *
+ * 获取失败的页保持待获取，列表接口退避/熔断期间不发请求。
+ */
+void todo_pager_process(void);
+
+/**
+ * @brief 网络任务返回一页的结果（TODO_NET_FETCH_PAGE）
+ * @param block 页数据块，引用交给分页模块（过期或失败时释放），可为NULL
+ * @return true 有页数据发生变化（变更已登记到 todo_store）
+ */
+bool todo_pager_on_fetched(uint32_t tag, esp_err_t err, todo_page_block_t *block);
+
+/**
+ * @brief 已知的行数（已获取过的页的条目总数）
+ */
+int todo_pager_get_count(void);
+
+/**
+ * @brief 上一次刷新是否还没有完成（自动刷新标记的页未全部重新获取，或手动刷新的第一页未到达）
+ */
+bool todo_pager_is_refreshing(void);
+
+/**
+ * @brief 手动刷新的第一页是否还没有到达（获取失败且已有列表时放弃替换，返回false）
+ */
+bool todo_pager_is_resetting(void);
+
+/**
+ * @brief 服务器是否还有未获取的页
+ */
+bool todo_pager_has_more(void);
+
+/**
+ * @brief 获取某行的条目
+ * @return 条目指针，所在页未常驻时返回NULL（已自动请求该页）。
+ *         指针在下一次 set_viewport/process/refresh 之前有效
+ */
+const todo_item_t *todo_pager_get_item(int row);
+
+/**
+ * @brief 取得某行所在数据块的快照，之后的修改不影响快照
+ * @param item 输出：快照中该行的条目
+ * @return 数据块（调用者持有一个引用，用完 todo_store_block_release），所在页未常驻时返回NULL
+ */
+todo_page_block_t *todo_pager_snapshot(int row, const todo_item_t **item);
+
+/**
+ * @brief 更新某行的完成状态（本地副本）
+ */
+void todo_pager_set_completed(int row, bool completed);
+
+/**
+ * @brief 应用推送的新增/修改事件（条目在常驻页中时原地更新）
+ * @return true 本地数据已更新（变更已登记到 todo_store）；
+ *         false 条目不在常驻页中（可能是新条目，位置由服务器决定，需要重新获取）
+ */
+bool todo_pager_apply_upsert(const todo_item_t *item);
+
+/**
+ * @brief 应用推送的删除事件（条目在常驻页中时移除，后续页行号前移）
+ * @return true 本地数据已更新（变更已登记到 todo_store）
+ */
+bool todo_pager_apply_delete(const char *todo_id);
+
+/**
+ * @brief 获取统计
+ */
+void todo_pager_get_stats(todo_pager_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
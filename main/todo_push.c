@@ -0,0 +1,344 @@
+/**
+ * @file todo_push.c
+ * @brief 服务器推送（Server-Sent Events）实现
+ *
+ * 推送任务只负责收事件、解析成 todo_push_event_t 放进队列，
+ * 分页数据不加锁，所以事件统一在界面任务的主循环中应用。
+ */
+
+#include "todo_push.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/idf_additions.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "esp_http_client.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "todo_pager.h"
+#include "todo_refresh.h"
+#include "todo_backend.h"
+#include "todo_detail_cache.h"
+#include "refresh_governor.h"
+#include "app_tasks.h"
+
+static const char *TAG = "todo_push";
+
+#define API_KEY CONFIG_TODO_API_KEY
+
+#define PUSH_EVENTS_PATH        "/api/events"
+#define PUSH_TASK_STACK_SIZE    6144
+#define PUSH_TASK_PRIORITY      3
+#define PUSH_QUEUE_LEN          8
+#define PUSH_LINE_MAX           1536
+#define PUSH_READ_BUF_SIZE      512
+#define PUSH_READ_TIMEOUT_MS    60000   // 服务器约每15秒发一次心跳注释，超时即认为断线
+#define PUSH_RETRY_MIN_MS       1000
+#define PUSH_RETRY_MAX_MS       60000
+
+static char events_url[TODO_BACKEND_URL_MAX_LEN + 16] = {0};
+// 客户端跨连接保留，断线重连时用保存的TLS会话做恢复握手；切换后端时重建
+static esp_http_client_handle_t push_client = NULL;
+static char push_client_base[TODO_BACKEND_URL_MAX_LEN] = {0};
+static QueueHandle_t event_queue = NULL;
+static volatile bool connected = false;
+static uint32_t retry_ms = PUSH_RETRY_MIN_MS;
+
+// SSE 解析状态（只在推送任务中使用）
+static char line_buf[PUSH_LINE_MAX];
+static size_t line_len = 0;
+static bool line_overflow = false;
+static char event_name[16];
+static char data_buf[PUSH_LINE_MAX];
+static size_t data_len = 0;
+static char last_event_id[24];
+static todo_push_event_t parsed_event;
+
+static void reset_parser(void)
+{
+    line_len = 0;
+    line_overflow = false;
+    event_name[0] = '\0';
+    data_len = 0;
+}
+
+static void queue_event(const todo_push_event_t *event)
+{
+    if (xQueueSend(event_queue, event, 0) != pdTRUE) {
+        // 主循环跟不上时丢弃事件，改为整体重新同步
+        ESP_LOGW(TAG, "事件队列已满，改为重新同步");
+        todo_refresh_request(TODO_REFRESH_RECONNECT, false);
+    }
+    refresh_governor_wake();
+}
+
+/**
+ * @brief 空行：分发累积的事件
+ */
+static void dispatch_event(void)
+{
+    todo_push_event_t *event = &parsed_event;
+
+    if (data_len == 0) {
+        event_name[0] = '\0';
+        return;
+    }
+    data_buf[data_len] = '\0';
+
+    memset(event, 0, sizeof(todo_push_event_t));
+    event->server_time_ms = strtoll(last_event_id, NULL, 10);
+
+    if (strcmp(event_name, "delete") == 0) {
+        event->type = TODO_PUSH_DELETE;
+    } else if (strcmp(event_name, "resync") == 0) {
+        event->type = TODO_PUSH_RESYNC;
+    } else if (event_name[0] == '\0' || strcmp(event_name, "upsert") == 0) {
+        event->type = TODO_PUSH_UPSERT;
+    } else {
+        ESP_LOGD(TAG, "忽略未知事件: %s", event_name);
+        event_name[0] = '\0';
+        data_len = 0;
+        return;
+    }
+
+    if (event->type != TODO_PUSH_RESYNC && todo_client_parse_item(data_buf, &event->item) != ESP_OK) {
+        ESP_LOGW(TAG, "事件数据解析失败: %s", event_name);
+    } else {
+        queue_event(event);
+    }
+
+    event_name[0] = '\0';
+    data_len = 0;
+}
+
+static void process_line(void)
+{
+    if (line_len == 0) {
+        dispatch_event();
+        return;
+    }
+    if (line_buf[0] == ':') {
+        return;  // 注释（心跳）
+    }
+
+    char *value = strchr(line_buf, ':');
+    if (value != NULL) {
+        *value++ = '\0';
+        if (*value == ' ') {
+            value++;
+        }
+    } else {
+        value = line_buf + line_len;
+    }
+
+    if (strcmp(line_buf, "event") == 0) {
+        strlcpy(event_name, value, sizeof(event_name));
+    } else if (strcmp(line_buf, "data") == 0) {
+        size_t len = strlen(value);
+        size_t need = len + (data_len > 0 ? 1 : 0);
+        if (data_len + need < sizeof(data_buf)) {
+            if (data_len > 0) {
+                data_buf[data_len++] = '\n';
+            }
+            memcpy(data_buf + data_len, value, len);
+            data_len += len;
+        } else {
+            ESP_LOGW(TAG, "事件数据过长，丢弃");
+            data_len = 0;
+        }
+    } else if (strcmp(line_buf, "id") == 0) {
+        strlcpy(last_event_id, value, sizeof(last_event_id));
+    } else if (strcmp(line_buf, "retry") == 0) {
+        uint32_t ms = strtoul(value, NULL, 10);
+        if (ms >= PUSH_RETRY_MIN_MS && ms <= PUSH_RETRY_MAX_MS) {
+            retry_ms = ms;
+        }
+    }
+}
+
+static void feed(const char *buf, int len)
+{
+    for (int i = 0; i < len; i++) {
+        char c = buf[i];
+        if (c == '\n') {
+            if (line_len > 0 && line_buf[line_len - 1] == '\r') {
+                line_len--;
+            }
+            line_buf[line_len] = '\0';
+            if (!line_overflow) {
+                process_line();
+            }
+            line_len = 0;
+            line_overflow = false;
+        } else if (line_len < sizeof(line_buf) - 1) {
+            line_buf[line_len++] = c;
+        } else {
+            line_overflow = true;
+        }
+    }
+}
+
+/**
+ * @brief 建立一次连接并读取直到断开
+ * @return HTTP状态码，连接失败时返回-1
+ */
+static int run_connection(bool *ever_connected)
+{
+    static char buf[PUSH_READ_BUF_SIZE];
+
+    // 每次连接都跟随当前使用的后端
+    char base[TODO_BACKEND_URL_MAX_LEN];
+    todo_backend_get_active_url(base, sizeof(base));
+    if (push_client != NULL && strcmp(base, push_client_base) != 0) {
+        esp_http_client_cleanup(push_client);
+        push_client = NULL;
+    }
+
+    if (push_client == NULL) {
+        snprintf(events_url, sizeof(events_url), "%s%s", base, PUSH_EVENTS_PATH);
+        esp_http_client_config_t config = {
+            .url = events_url,
+            .method = HTTP_METHOD_GET,
+            .timeout_ms = PUSH_READ_TIMEOUT_MS,
+        };
+        todo_client_apply_tls(&config);
+        push_client = esp_http_client_init(&config);
+        if (push_client == NULL) {
+            ESP_LOGE(TAG, "推送客户端创建失败");
+            return -1;
+        }
+        strlcpy(push_client_base, base, sizeof(push_client_base));
+        esp_http_client_set_header(push_client, "X-API-Key", API_KEY);
+        esp_http_client_set_header(push_client, "Accept", "text/event-stream");
+        esp_http_client_set_header(push_client, "Cache-Control", "no-cache");
+    }
+    esp_http_client_handle_t client = push_client;
+    if (last_event_id[0] != '\0') {
+        esp_http_client_set_header(client, "Last-Event-ID", last_event_id);
+    }
+
+    int status = -1;
+    if (esp_http_client_open(client, 0) == ESP_OK) {
+        esp_http_client_fetch_headers(client);
+        status = esp_http_client_get_status_code(client);
+    }
+
+    if (status == 200) {
+        connected = true;
+        retry_ms = PUSH_RETRY_MIN_MS;
+        reset_parser();
+        ESP_LOGI(TAG, "推送通道已连接: %s", events_url);
+
+        if (*ever_connected) {
+            // 断线期间可能漏掉事件
+            todo_refresh_request(TODO_REFRESH_RECONNECT, false);
+        }
+        *ever_connected = true;
+
+        int n;
+        while ((n = esp_http_client_read(client, buf, sizeof(buf))) > 0) {
+            feed(buf, n);
+        }
+        connected = false;
+        ESP_LOGW(TAG, "推送通道断开");
+    } else if (status > 0) {
+        ESP_LOGW(TAG, "推送通道不可用，状态码: %d", status);
+    }
+
+    esp_http_client_close(client);
+    return status;
+}
+
+static void push_task(void *arg)
+{
+    (void)arg;
+    bool ever_connected = false;
+
+    while (1) {
+        int status = run_connection(&ever_connected);
+        if (status == 404) {
+            // 后端不支持推送，按最长间隔重试，主循环继续轮询
+            retry_ms = PUSH_RETRY_MAX_MS;
+        }
+
+        uint32_t delay_ms = retry_ms + esp_random() % (retry_ms / 4 + 1);
+        ESP_LOGD(TAG, "%lu ms 后重连", delay_ms);
+        vTaskDelay(pdMS_TO_TICKS(delay_ms));
+        if (retry_ms < PUSH_RETRY_MAX_MS) {
+            retry_ms = retry_ms * 2 > PUSH_RETRY_MAX_MS ? PUSH_RETRY_MAX_MS : retry_ms * 2;
+        }
+    }
+}
+
+esp_err_t todo_push_start(void)
+{
+    if (event_queue != NULL) {
+        return ESP_OK;
+    }
+
+    event_queue = xQueueCreateWithCaps(PUSH_QUEUE_LEN, sizeof(todo_push_event_t), MALLOC_CAP_SPIRAM);
+    if (event_queue == NULL) {
+        ESP_LOGE(TAG, "事件队列创建失败");
+        return ESP_ERR_NO_MEM;
+    }
+
+    // 与网络任务同核，界面所在的核只做渲染
+    if (app_tasks_create(push_task, "todo_push", PUSH_TASK_STACK_SIZE, PUSH_TASK_PRIORITY,
+                         APP_NET_CORE, NULL) != ESP_OK) {
+        ESP_LOGE(TAG, "推送任务创建失败");
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "推送任务已启动");
+    return ESP_OK;
+}
+
+bool todo_push_is_connected(void)
+{
+    return connected;
+}
+
+bool todo_push_apply_pending(void)
+{
+    static todo_push_event_t event;
+    bool changed = false;
+
+    if (event_queue == NULL) {
+        return false;
+    }
+
+    while (xQueueReceive(event_queue, &event, 0) == pdTRUE) {
+        switch (event.type) {
+            case TODO_PUSH_UPSERT:
+                // 正文可能也改了，下次打开详情时重新获取
+                todo_detail_cache_remove(event.item.id);
+                if (todo_pager_apply_upsert(&event.item)) {
+                    changed = true;
+                } else {
+                    // 不在常驻页中：可能是新条目，位置由服务器决定，只能重新获取
+                    todo_refresh_request(TODO_REFRESH_PUSH, false);
+                }
+                break;
+            case TODO_PUSH_DELETE:
+                todo_detail_cache_remove(event.item.id);
+                changed |= todo_pager_apply_delete(event.item.id);
+                break;
+            case TODO_PUSH_RESYNC:
+                todo_refresh_request(TODO_REFRESH_RECONNECT, false);
+                break;
+        }
+
+        if (event.server_time_ms > 0) {
+            struct timeval tv;
+            gettimeofday(&tv, NULL);
+            int64_t now_ms = (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+            ESP_LOGI(TAG, "推送事件 %d 从服务器到设备 %lld ms", event.type, now_ms - event.server_time_ms);
+        }
+    }
+
+    return changed;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file todo_push.h
+ * @brief 服务器推送（Server-Sent Events）
+ *
+ * 后台任务保持一条到 /api/events 的 SSE 长连接，服务器在条目变化时推送
+ * upsert/delete 事件，主循环取出后增量应用到分页数据和详情缓存。
+ * 断线后指数退避重连，重连成功后安排一次重新同步，弥补断线期间漏掉的事件。
+ */
+
+#ifndef TODO_PUSH_H
+#define TODO_PUSH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "todo_client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 推送事件类型
+ */
+typedef enum {
+    TODO_PUSH_UPSERT = 0,   // 新增或修改，item 为完整摘要
+    TODO_PUSH_DELETE,       // 删除，item 只有 id
+    TODO_PUSH_RESYNC,       // 可能漏了事件，需要重新获取
+} todo_push_type_t;
+
+/**
+ * @brief 推送事件
+ */
+typedef struct {
+    todo_push_type_t type;
+    todo_item_t item;
+    int64_t server_time_ms;   // 事件在服务器产生的时间（SSE id 字段，Unix毫秒），0表示未知
+} todo_push_event_t;
+
+/**
+ * @brief 启动推送任务（需在 todo_client_init 之后调用）
+ *
+ * 每次（重新）连接时使用 todo_backend 当前选中的后端。
+ * @return ESP_OK 成功, 其他值表示失败
+ */
+esp_err_t todo_push_start(void);
+
+/**
+ * @brief 推送通道当前是否已连接
+ */
+bool todo_push_is_connected(void);
+
+/**
+ * @brief 在主循环中应用所有待处理的推送事件
+ * @return true 本地数据有变化，（变更已登记到 todo_store）
+ */
+bool todo_push_apply_pending(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
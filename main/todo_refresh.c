@@ -0,0 +1,130 @@
+/**
+ * @file todo_refresh.c
+ * @brief 列表刷新协调实现
+ *
+ * 请求只在临界区里记下来源和是否需要全部重新获取，真正的刷新在主循环中执行。
+ * 刷新是异步的（页由 todo_pager_process 交给网络任务逐页获取），
+ * 所以“进行中”指上一次刷新标记的页还没有全部获取完，或手动刷新的第一页还没有到达。
+ */
+
+#include "todo_refresh.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "todo_pager.h"
+#include "refresh_governor.h"
+
+static const char *TAG = "todo_refresh";
+
+static const char *source_names[TODO_REFRESH_SOURCE_COUNT] = { "手动", "定时", "重连", "推送", "回滚" };
+
+static portMUX_TYPE request_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t pending_sources = 0;     // 待执行请求的来源
+static uint32_t pending_requests = 0;    // 待执行请求的次数（合并前）
+static bool pending_reset = false;       // 任一请求需要丢弃全部页
+
+static int64_t last_run_ms = -TODO_REFRESH_MIN_INTERVAL_MS;
+static bool deferral_counted = false;
+
+static todo_refresh_stats_t stats;
+
+static int64_t now_ms(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+void todo_refresh_request(todo_refresh_source_t source, bool reset)
+{
+    if (source >= TODO_REFRESH_SOURCE_COUNT) {
+        return;
+    }
+
+    taskENTER_CRITICAL(&request_lock);
+    pending_sources |= TODO_REFRESH_BIT(source);
+    pending_requests++;
+    pending_reset |= reset;
+    stats.requested[source]++;
+    taskEXIT_CRITICAL(&request_lock);
+
+    refresh_governor_wake();
+}
+
+static uint32_t interval_wait_ms(void)
+{
+    int64_t elapsed = now_ms() - last_run_ms;
+    return elapsed >= TODO_REFRESH_MIN_INTERVAL_MS ? 0 : (uint32_t)(TODO_REFRESH_MIN_INTERVAL_MS - elapsed);
+}
+
+/**
+ * @brief 上一次刷新还在进行（全部重新获取不等，它会替换掉进行中的刷新）
+ */
+static bool blocked_by_inflight(void)
+{
+    return !pending_reset && todo_pager_is_refreshing();
+}
+
+uint32_t todo_refresh_wait_ms(void)
+{
+    // 等进行中的刷新时不必定时醒来，最后一页获取完成本身会唤醒主循环
+    if (pending_sources == 0 || blocked_by_inflight()) {
+        return UINT32_MAX;
+    }
+    return interval_wait_ms();
+}
+
+uint32_t todo_refresh_run(esp_err_t *result)
+{
+    if (pending_sources == 0) {
+        return 0;
+    }
+
+    if (blocked_by_inflight() || interval_wait_ms() > 0) {
+        if (!deferral_counted) {
+            deferral_counted = true;
+            stats.deferred++;
+        }
+        return 0;
+    }
+
+    taskENTER_CRITICAL(&request_lock);
+    uint32_t sources = pending_sources;
+    uint32_t requests = pending_requests;
+    bool reset = pending_reset;
+    pending_sources = 0;
+    pending_requests = 0;
+    pending_reset = false;
+    taskEXIT_CRITICAL(&request_lock);
+
+    deferral_counted = false;
+    last_run_ms = now_ms();
+    stats.executed++;
+    stats.coalesced += requests - 1;
+
+    char names[64] = {0};
+    for (int i = 0; i < TODO_REFRESH_SOURCE_COUNT; i++) {
+        if (sources & TODO_REFRESH_BIT(i)) {
+            strlcat(names, source_names[i], sizeof(names));
+            strlcat(names, " ", sizeof(names));
+        }
+    }
+    ESP_LOGI(TAG, "%s刷新（%s），合并 %lu 个请求；累计执行 %lu / 合并 %lu",
+             reset ? "全部" : "常驻页", names, requests, stats.executed, stats.coalesced);
+
+    esp_err_t err = todo_pager_refresh(reset);
+    if (result != NULL) {
+        *result = err;
+    }
+    return sources;
+}
+
+void todo_refresh_get_stats(todo_refresh_stats_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+    taskENTER_CRITICAL(&request_lock);
+    *out = stats;
+    taskEXIT_CRITICAL(&request_lock);
+}
@@ -0,0 +1,77 @@
+/**
+ * @file todo_refresh.h
+ * @brief 列表刷新协调
+ *
+ * 点击顶栏、自动刷新定时、推送通道重连、推送事件都可能在很短时间内各自要求刷新。
+ * 所有刷新请求先登记到这里，由主循环统一执行：同一时刻最多一次刷新在进行，
+ * 期间到达的请求合并成之后的一次；两次刷新之间至少间隔 TODO_REFRESH_MIN_INTERVAL_MS。
+ */
+
+#ifndef TODO_REFRESH_H
+#define TODO_REFRESH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TODO_REFRESH_MIN_INTERVAL_MS  2000
+
+/**
+ * @brief 刷新请求来源
+ */
+typedef enum {
+    TODO_REFRESH_MANUAL = 0,   // 点击顶栏（丢弃全部页重新获取）
+    TODO_REFRESH_TIMER,        // 自动刷新定时
+    TODO_REFRESH_RECONNECT,    // 推送通道重连或事件丢失
+    TODO_REFRESH_PUSH,         // 推送了不在常驻页中的条目
+    TODO_REFRESH_ROLLBACK,     // 排队的写操作被服务器拒绝，本地修改需要撤回
+    TODO_REFRESH_SOURCE_COUNT,
+} todo_refresh_source_t;
+
+#define TODO_REFRESH_BIT(source)  (1u << (source))
+
+/**
+ * @brief 统计
+ */
+typedef struct {
+    uint32_t requested[TODO_REFRESH_SOURCE_COUNT];  // 各来源的请求次数
+    uint32_t executed;        // 实际执行的刷新
+    uint32_t coalesced;       // 合并进其他刷新的请求
+    uint32_t deferred;        // 因进行中或最小间隔被推迟的次数
+} todo_refresh_stats_t;
+
+/**
+ * @brief 登记一次刷新请求（可在任意任务中调用，会唤醒主循环）
+ * @param source 请求来源
+ * @param reset true 丢弃全部页重新获取；false 只重新获取常驻页
+ */
+void todo_refresh_request(todo_refresh_source_t source, bool reset);
+
+/**
+ * @brief 在主循环中执行合并后的刷新（没有待执行的请求或需要推迟时直接返回）
+ * @param result 输出本次刷新结果（返回值非0时有效），可为NULL
+ * @return 本次刷新满足的请求来源（TODO_REFRESH_BIT 的组合），0表示没有执行
+ */
+uint32_t todo_refresh_run(esp_err_t *result);
+
+/**
+ * @brief 待执行的请求距可以执行还有多久（毫秒）
+ *
+ * 没有待执行的请求、或在等进行中的刷新完成时返回 UINT32_MAX。
+ */
+uint32_t todo_refresh_wait_ms(void);
+
+/**
+ * @brief 获取统计
+ */
+void todo_refresh_get_stats(todo_refresh_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
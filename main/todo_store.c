@@ -0,0 +1,161 @@
+/**
+ * @file todo_store.c
+ * @brief 列表数据块与变更通知实现
+ */
+
+#include "todo_store.h"
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "mem_tag.h"
+#include "esp_log.h"
+
+static const char *TAG = "todo_store";
+
+typedef struct {
+    todo_store_subscriber_t cb;
+    void *ctx;
+} subscriber_t;
+
+static subscriber_t subscribers[TODO_STORE_MAX_SUBSCRIBERS];
+static int subscriber_count = 0;
+
+static uint32_t version = 0;
+static todo_store_change_t pending = { .first_row = 1, .last_row = 0 };
+static bool has_pending = false;
+
+static atomic_uint blocks_live = 0;
+static uint32_t blocks_peak = 0;
+static uint32_t cow_copies = 0;
+static uint32_t notifications = 0;
+static uint32_t changes = 0;
+
+todo_page_block_t *todo_store_block_new(void)
+{
+    todo_page_block_t *block = mem_tag_malloc(MEM_TAG_UI, sizeof(todo_page_block_t), MALLOC_CAP_SPIRAM);
+    if (block == NULL) {
+        ESP_LOGE(TAG, "数据块分配失败");
+        return NULL;
+    }
+    atomic_init(&block->refs, 1);
+
+    uint32_t live = atomic_fetch_add(&blocks_live, 1) + 1;
+    if (live > blocks_peak) {
+        blocks_peak = live;
+    }
+    return block;
+}
+
+todo_page_block_t *todo_store_block_retain(todo_page_block_t *block)
+{
+    if (block != NULL) {
+        atomic_fetch_add_explicit(&block->refs, 1, memory_order_relaxed);
+    }
+    return block;
+}
+
+void todo_store_block_release(todo_page_block_t *block)
+{
+    if (block == NULL) {
+        return;
+    }
+    // 最后一个引用：之前其他持有者的读写都已完成
+    if (atomic_fetch_sub_explicit(&block->refs, 1, memory_order_acq_rel) == 1) {
+        mem_tag_free(MEM_TAG_UI, block);
+        atomic_fetch_sub(&blocks_live, 1);
+    }
+}
+
+todo_page_block_t *todo_store_block_writable(todo_page_block_t *block)
+{
+    if (block == NULL || atomic_load_explicit(&block->refs, memory_order_acquire) == 1) {
+        return block;
+    }
+
+    todo_page_block_t *copy = todo_store_block_new();
+    if (copy == NULL) {
+        return NULL;
+    }
+    memcpy(&copy->page, &block->page, sizeof(todo_page_t));
+    todo_store_block_release(block);
+    cow_copies++;
+    return copy;
+}
+
+static void record_change(void)
+{
+    version++;
+    changes++;
+    has_pending = true;
+    pending.version = version;
+}
+
+void todo_store_changed_rows(int first_row, int last_row)
+{
+    if (first_row > last_row) {
+        return;
+    }
+    if (pending.first_row > pending.last_row) {
+        pending.first_row = first_row;
+        pending.last_row = last_row;
+    } else {
+        pending.first_row = first_row < pending.first_row ? first_row : pending.first_row;
+        pending.last_row = last_row > pending.last_row ? last_row : pending.last_row;
+    }
+    record_change();
+}
+
+void todo_store_changed_structure(void)
+{
+    pending.structure = true;
+    record_change();
+}
+
+uint32_t todo_store_version(void)
+{
+    return version;
+}
+
+esp_err_t todo_store_subscribe(todo_store_subscriber_t cb, void *ctx)
+{
+    if (cb == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (subscriber_count == TODO_STORE_MAX_SUBSCRIBERS) {
+        return ESP_ERR_NO_MEM;
+    }
+    subscribers[subscriber_count++] = (subscriber_t) { .cb = cb, .ctx = ctx };
+    return ESP_OK;
+}
+
+bool todo_store_notify(void)
+{
+    if (!has_pending) {
+        return false;
+    }
+
+    // 先取出再通知，订阅者处理中登记的变更留到下一轮
+    todo_store_change_t change = pending;
+    pending = (todo_store_change_t) { .first_row = 1, .last_row = 0 };
+    has_pending = false;
+    notifications++;
+
+    for (int i = 0; i < subscriber_count; i++) {
+        subscribers[i].cb(&change, subscribers[i].ctx);
+    }
+    return true;
+}
+
+void todo_store_get_stats(todo_store_stats_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+    *out = (todo_store_stats_t) {
+        .version = version,
+        .blocks_live = atomic_load(&blocks_live),
+        .blocks_peak = blocks_peak,
+        .cow_copies = cow_copies,
+        .notifications = notifications,
+        .changes = changes,
+    };
+}
@@ -0,0 +1,125 @@
+/**
+ * @file todo_store.h
+ * @brief 列表数据块与变更通知
+ *
+ * 每页条目放在带引用计数的数据块中。网络任务把获取到的页直接写进新数据块，
+ * 连同所有权一起交给分页模块，中间不再拷贝；界面需要在列表变化后继续使用某个条目时
+ * （例如详情弹窗），持有该块的一个引用即可得到不变的快照。
+ * 修改条目时若数据块还被别处引用，先复制一份再改（写时复制），已发出的快照保持不变。
+ *
+ * 分页模块每次修改数据都登记一条变更（哪些行变了、行数或行号是否变了）并递增版本号，
+ * 主循环每轮调用一次 todo_store_notify，把合并后的变更交给订阅者，
+ * 界面只重新绑定受影响的卡片。
+ *
+ * 引用计数可在任意任务中增减；变更登记与通知只在界面任务中进行。
+ */
+
+#ifndef TODO_STORE_H
+#define TODO_STORE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "todo_client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TODO_STORE_MAX_SUBSCRIBERS 4
+
+/**
+ * @brief 一页数据块
+ */
+typedef struct {
+    atomic_int refs;
+    todo_page_t page;
+} todo_page_block_t;
+
+/**
+ * @brief 合并后的变更
+ */
+typedef struct {
+    uint32_t version;       // 变更后的版本号
+    int first_row;          // 内容变化的行范围（含），没有时 first_row > last_row
+    int last_row;
+    bool structure;         // 行数或行号变化（新页、删除、全部替换），需要整体重新绑定
+} todo_store_change_t;
+
+typedef void (*todo_store_subscriber_t)(const todo_store_change_t *change, void *ctx);
+
+/**
+ * @brief 统计
+ */
+typedef struct {
+    uint32_t version;
+    uint32_t blocks_live;       // 当前存在的数据块
+    uint32_t blocks_peak;
+    uint32_t cow_copies;        // 写时复制次数
+    uint32_t notifications;     // 通知订阅者的次数（每次含若干合并的变更）
+    uint32_t changes;           // 登记的变更
+} todo_store_stats_t;
+
+/**
+ * @brief 分配一个数据块（PSRAM，引用计数为1，内容未初始化）
+ * @return 数据块，内存不足时返回NULL
+ */
+todo_page_block_t *todo_store_block_new(void);
+
+/**
+ * @brief 增加引用
+ */
+todo_page_block_t *todo_store_block_retain(todo_page_block_t *block);
+
+/**
+ * @brief 释放引用，最后一个引用释放时回收（NULL 忽略）
+ */
+void todo_store_block_release(todo_page_block_t *block);
+
+/**
+ * @brief 取得可修改的数据块
+ *
+ * 只有调用者持有时直接返回原块；还被别处引用时复制一份，
+ * 调用者对原块的引用转移到新块上。
+ * @return 可修改的数据块，复制失败时返回NULL（原块不变，引用仍归调用者）
+ */
+todo_page_block_t *todo_store_block_writable(todo_page_block_t *block);
+
+/**
+ * @brief 登记若干行内容变化
+ */
+void todo_store_changed_rows(int first_row, int last_row);
+
+/**
+ * @brief 登记行数或行号变化
+ */
+void todo_store_changed_structure(void);
+
+/**
+ * @brief 当前版本号（每登记一次变更递增）
+ */
+uint32_t todo_store_version(void);
+
+/**
+ * @brief 订阅变更
+ * @return ESP_OK 成功, ESP_ERR_NO_MEM 订阅者已满
+ */
+esp_err_t todo_store_subscribe(todo_store_subscriber_t cb, void *ctx);
+
+/**
+ * @brief 有未通知的变更时合并成一条交给所有订阅者（主循环每轮调用一次）
+ * @return true 有变更
+ */
+bool todo_store_notify(void);
+
+/**
+ * @brief 获取统计
+ */
+void todo_store_get_stats(todo_store_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
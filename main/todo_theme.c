@@ -0,0 +1,174 @@
+/**
+ * @file todo_theme.c
+ * @brief TODO界面共享样式表实现
+ */
+
+#include "todo_theme.h"
+
+LV_FONT_DECLARE(lv_font_chinese_14);
+
+static bool theme_inited = false;
+
+static lv_style_t style_screen;
+static lv_style_t style_bar;
+static lv_style_t style_header_title;
+static lv_style_t style_clock;
+static lv_style_t style_list;
+static lv_style_t style_card;
+static lv_style_t style_card_completed;
+static lv_style_t style_card_title;
+static lv_style_t style_card_title_completed;
+static lv_style_t style_card_deadline;
+static lv_style_t style_loading;
+static lv_style_t style_popup_mask;
+static lv_style_t style_popup;
+static lv_style_t style_popup_title;
+static lv_style_t style_popup_body;
+
+void todo_theme_init(void)
+{
+    if (theme_inited) {
+        return;
+    }
+
+    lv_style_init(&style_screen);
+    lv_style_set_bg_color(&style_screen, COLOR_BACKGROUND);
+
+    lv_style_init(&style_bar);
+    lv_style_set_bg_color(&style_bar, COLOR_PRIMARY);
+    lv_style_set_border_width(&style_bar, 0);
+    lv_style_set_radius(&style_bar, 0);  // 顶栏/底栏无圆角
+    lv_style_set_pad_all(&style_bar, 0);
+
+    lv_style_init(&style_header_title);
+    lv_style_set_text_font(&style_header_title, &lv_font_chinese_14);
+    lv_style_set_text_color(&style_header_title, lv_color_white());
+
+    lv_style_init(&style_clock);
+    lv_style_set_text_font(&style_clock, &lv_font_montserrat_22);
+    lv_style_set_text_color(&style_clock, lv_color_white());
+    lv_style_set_text_letter_space(&style_clock, 1);  // 增加字间距
+
+    lv_style_init(&style_list);
+    lv_style_set_bg_color(&style_list, COLOR_BACKGROUND);
+    lv_style_set_border_width(&style_list, 0);
+    lv_style_set_radius(&style_list, 0);
+    lv_style_set_pad_all(&style_list, 5);
+    lv_style_set_pad_row(&style_list, 10);  // 行间距
+
+    lv_style_init(&style_card);
+    lv_style_set_bg_color(&style_card, COLOR_PENDING);
+    lv_style_set_border_color(&style_card, COLOR_CARD_BORDER);
+    lv_style_set_border_width(&style_card, THEME_CARD_BORDER_WIDTH);
+    lv_style_set_radius(&style_card, THEME_CARD_RADIUS);  // 圆角
+    lv_style_set_pad_all(&style_card, 10);
+    lv_style_set_shadow_width(&style_card, THEME_CARD_SHADOW_WIDTH);  // 阴影
+    lv_style_set_shadow_opa(&style_card, THEME_CARD_SHADOW_OPA);
+
+    lv_style_init(&style_card_completed);
+    lv_style_set_bg_color(&style_card_completed, COLOR_COMPLETED);
+
+    lv_style_init(&style_card_title);
+    lv_style_set_text_font(&style_card_title, &lv_font_chinese_14);
+    lv_style_set_text_color(&style_card_title, COLOR_TEXT);
+
+    lv_style_init(&style_card_title_completed);
+    lv_style_set_text_color(&style_card_title_completed, COLOR_TEXT_GRAY);
+    lv_style_set_text_decor(&style_card_title_completed, LV_TEXT_DECOR_STRIKETHROUGH);
+
+    lv_style_init(&style_card_deadline);
+    lv_style_set_text_font(&style_card_deadline, &lv_font_montserrat_14);
+    lv_style_set_text_color(&style_card_deadline, COLOR_TEXT_GRAY);
+
+    lv_style_init(&style_loading);
+    lv_style_set_text_font(&style_loading, &lv_font_chinese_14);
+    lv_style_set_text_color(&style_loading, COLOR_PRIMARY);
+
+    lv_style_init(&style_popup_mask);
+    lv_style_set_bg_color(&style_popup_mask, lv_color_black());
+    lv_style_set_bg_opa(&style_popup_mask, LV_OPA_50);
+    lv_style_set_border_width(&style_popup_mask, 0);
+    lv_style_set_radius(&style_popup_mask, 0);  // 背景无圆角
+
+    lv_style_init(&style_popup);
+    lv_style_set_bg_color(&style_popup, lv_color_white());
+    lv_style_set_border_color(&style_popup, COLOR_PRIMARY);
+    lv_style_set_border_width(&style_popup, 3);
+    lv_style_set_radius(&style_popup, 10);
+    lv_style_set_shadow_width(&style_popup, 20);
+    lv_style_set_shadow_opa(&style_popup, LV_OPA_30);
+
+    lv_style_init(&style_popup_title);
+    lv_style_set_text_font(&style_popup_title, &lv_font_chinese_14);
+    lv_style_set_text_color(&style_popup_title, COLOR_PRIMARY);
+
+    lv_style_init(&style_popup_body);
+    lv_style_set_text_font(&style_popup_body, &lv_font_chinese_14);
+    lv_style_set_text_color(&style_popup_body, COLOR_TEXT);
+
+    theme_inited = true;
+}
+
+void todo_theme_apply(lv_obj_t *obj, todo_theme_role_t role)
+{
+    if (obj == NULL) {
+        return;
+    }
+
+    switch (role) {
+        case TODO_THEME_SCREEN:
+            lv_obj_add_style(obj, &style_screen, 0);
+            break;
+        case TODO_THEME_BAR:
+            lv_obj_add_style(obj, &style_bar, 0);
+            break;
+        case TODO_THEME_HEADER_TITLE:
+            lv_obj_add_style(obj, &style_header_title, 0);
+            break;
+        case TODO_THEME_CLOCK:
+            lv_obj_add_style(obj, &style_clock, 0);
+            break;
+        case TODO_THEME_LIST:
+            lv_obj_add_style(obj, &style_list, 0);
+            break;
+        case TODO_THEME_CARD:
+            lv_obj_add_style(obj, &style_card, 0);
+            lv_obj_add_style(obj, &style_card_completed, LV_STATE_CHECKED);
+            break;
+        case TODO_THEME_CARD_TITLE:
+            lv_obj_add_style(obj, &style_card_title, 0);
+            lv_obj_add_style(obj, &style_card_title_completed, LV_STATE_CHECKED);
+            break;
+        case TODO_THEME_CARD_DEADLINE:
+            lv_obj_add_style(obj, &style_card_deadline, 0);
+            break;
+        case TODO_THEME_LOADING:
+            lv_obj_add_style(obj, &style_loading, 0);
+            break;
+        case TODO_THEME_POPUP_MASK:
+            lv_obj_add_style(obj, &style_popup_mask, 0);
+            break;
+        case TODO_THEME_POPUP:
+            lv_obj_add_style(obj, &style_popup, 0);
+            break;
+        case TODO_THEME_POPUP_TITLE:
+            lv_obj_add_style(obj, &style_popup_title, 0);
+            break;
+        case TODO_THEME_POPUP_BODY:
+            lv_obj_add_style(obj, &style_popup_body, 0);
+            break;
+        default:
+            break;
+    }
+}
+
+void todo_theme_set_completed(lv_obj_t *card, lv_obj_t *title, bool completed)
+{
+    if (completed) {
+        lv_obj_add_state(card, LV_STATE_CHECKED);
+        lv_obj_add_state(title, LV_STATE_CHECKED);
+    } else {
+        lv_obj_clear_state(card, LV_STATE_CHECKED);
+        lv_obj_clear_state(title, LV_STATE_CHECKED);
+    }
+}
@@ -0,0 +1,76 @@
+/**
+ * @file todo_theme.h
+ * @brief TODO界面共享样式表
+ *
+ * 所有控件共用一组静态 lv_style_t，只在启动时初始化一次，
+ * 避免每个对象各自持有本地样式（local style）占用LVGL堆。
+ * 卡片完成/未完成通过 LV_STATE_CHECKED 状态切换。
+ */
+
+#ifndef TODO_THEME_H
+#define TODO_THEME_H
+
+#include <stdbool.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define COLOR_BACKGROUND    lv_color_hex(0xF5F5F5) // 背景色
+#define COLOR_PRIMARY       lv_color_make(174, 173, 227) // 主题色
+#define COLOR_TEXT          lv_color_hex(0x212121) // 文字色
+#define COLOR_TEXT_GRAY     lv_color_hex(0x9E9E9E) // 灰色文字色
+#define COLOR_COMPLETED     lv_color_make(213, 212, 236) // 已完成背景色
+#define COLOR_PENDING       lv_color_hex(0xFFFFFF) // 未完成背景色
+#define COLOR_CARD_BORDER   lv_color_hex(0xE0E0E0) // 卡片边框色
+
+#define THEME_CARD_RADIUS        12  // 卡片圆角
+#define THEME_CARD_BORDER_WIDTH  2   // 卡片边框宽度
+#define THEME_CARD_SHADOW_WIDTH  8   // 卡片阴影宽度
+#define THEME_CARD_SHADOW_OPA    LV_OPA_20
+
+/**
+ * @brief 样式角色
+ */
+typedef enum {
+    TODO_THEME_SCREEN = 0,      // 屏幕背景
+    TODO_THEME_BAR,             // 顶栏/底栏
+    TODO_THEME_HEADER_TITLE,    // 顶栏标题
+    TODO_THEME_CLOCK,           // 底栏时间
+    TODO_THEME_LIST,            // 滚动列表容器
+    TODO_THEME_CARD,            // 卡片（含完成状态）
+    TODO_THEME_CARD_TITLE,      // 卡片标题（含完成状态）
+    TODO_THEME_CARD_DEADLINE,   // 卡片时间
+    TODO_THEME_LOADING,         // 加载提示
+    TODO_THEME_POPUP_MASK,      // 详情遮罩
+    TODO_THEME_POPUP,           // 详情弹窗
+    TODO_THEME_POPUP_TITLE,     // 详情标题
+    TODO_THEME_POPUP_BODY,      // 详情正文
+} todo_theme_role_t;
+
+/**
+ * @brief 初始化共享样式（只需调用一次，需在创建控件前调用）
+ */
+void todo_theme_init(void);
+
+/**
+ * @brief 给对象挂上某个角色的共享样式
+ * @param obj 目标对象
+ * @param role 样式角色
+ */
+void todo_theme_apply(lv_obj_t *obj, todo_theme_role_t role);
+
+/**
+ * @brief 切换卡片完成状态（只改变对象状态，不写本地样式）
+ * @param card 卡片对象
+ * @param title 卡片标题标签
+ * @param completed true已完成，false未完成
+ */
+void todo_theme_set_completed(lv_obj_t *card, lv_obj_t *title, bool completed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
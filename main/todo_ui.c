@@ -11,25 +11,66 @@
 #include "freertos/task.h"
 #include "esp_log.h"
 #include "esp_sntp.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
 #include "todo_client.h"
-
-LV_FONT_DECLARE(lv_font_chinese_14);
+#include "todo_pager.h"
+#include "todo_outbox.h"
+#include "todo_theme.h"
+#include "todo_card_bg.h"
+#include "lvgl_mem.h"
+#include "todo_detail_cache.h"
+#include "todo_net.h"
+#include "todo_store.h"
+#include "net_timing.h"
+#include "mem_tag.h"
 
 static const char *TAG = "todo_ui";
 
+// 列表虚拟化：只创建可视区域所需的卡片（最多露出5行，多1张备用），滚动时循环复用
+#define CARD_POOL_SIZE 6
+
 static lv_obj_t *main_screen = NULL;
 static lv_obj_t *title_label = NULL;
 static lv_obj_t *scroll_container = NULL;
-static lv_obj_t *todo_items[MAX_TODOS] = {NULL};
-static lv_obj_t *todo_title_labels[MAX_TODOS] = {NULL};
-static lv_obj_t *todo_deadline_labels[MAX_TODOS] = {NULL};
+static lv_obj_t *list_spacer = NULL;      // 撑开滚动区域，高度对应全部已知行
+static lv_obj_t *todo_items[CARD_POOL_SIZE] = {NULL};
+static lv_obj_t *todo_title_labels[CARD_POOL_SIZE] = {NULL};
+static lv_obj_t *todo_deadline_labels[CARD_POOL_SIZE] = {NULL};
 static lv_obj_t *loading_label = NULL;
+static lv_obj_t *server_status_label = NULL;
+static lv_obj_t *refreshing_label = NULL;   // 顶栏的刷新提示，刷新期间列表照常显示
+static lv_obj_t *detail_mask = NULL;
 static lv_obj_t *detail_popup = NULL;
+static lv_obj_t *detail_title = NULL;
+static lv_obj_t *detail_body = NULL;
 static lv_obj_t *footer_bar = NULL;
 static lv_obj_t *time_label = NULL;
 static lv_timer_t *time_timer = NULL;
+#if CONFIG_TODO_MEM_DEBUG_PAGE
+static lv_obj_t *mem_page = NULL;
+static lv_obj_t *mem_label = NULL;
+static lv_timer_t *mem_timer = NULL;
+static char mem_text[640];
+#endif
+
+static int slot_rows[CARD_POOL_SIZE];            // 每张卡片绑定的行，-1表示未绑定
+static bool slot_placeholder[CARD_POOL_SIZE];     // 绑定时所在页未常驻，页到达后需重新绑定
+static int view_first_row = -1;
+static int view_last_row = -1;
+static int spacer_rows = -1;
 
-static todo_list_t current_todo_list;
+
+// 详情弹窗持有条目所在数据块的快照：之后的修改、删除都不会改动它，直到下次打开别的条目
+static todo_page_block_t *detail_block = NULL;
+static const todo_item_t *detail_item = NULL;
+static bool detail_loaded = false;        // 快照条目的正文已排版
+static bool detail_pending = false;       // 等待延后排版
+static uint32_t detail_fetch_tag = 0;     // 正文未命中缓存，等待网络任务获取的请求，0表示没有
+static uint32_t detail_fetch_seq = 0;
+static char *detail_body_buf = NULL;      // 详情正文缓冲区（PSRAM）
+
+static uint32_t prefetch_mask = 0;        // 等待预取详情的卡片（按卡片池下标）
 
 static bool long_press_triggered = false;
 static bool header_refresh_requested = false;
@@ -38,13 +79,17 @@ static bool click_processing = false;
 static uint32_t last_click_time = 0;
 #define CLICK_DEBOUNCE_MS 500 
 #define FOOTER_HEIGHT 40 // 底栏高度
+#define CARD_WIDTH 220   // 卡片宽度
+#define CARD_HEIGHT 65   // 卡片高度
+#define CARD_GAP 10      // 卡片间距
+#define CARD_PITCH (CARD_HEIGHT + CARD_GAP)
 
-#define COLOR_BACKGROUND    lv_color_hex(0xF5F5F5) // 背景色
-#define COLOR_PRIMARY       lv_color_make(174, 173, 227) // 主题色
-#define COLOR_TEXT          lv_color_hex(0x212121) // 文字色
-#define COLOR_TEXT_GRAY     lv_color_hex(0x9E9E9E) // 灰色文字色
-#define COLOR_COMPLETED     lv_color_make(213, 212, 236) // 已完成背景色
-#define COLOR_PENDING       lv_color_hex(0xFFFFFF) // 未完成背景色
+// 卡片按 row * CARD_PITCH 定位，16位坐标（上限8191）只够约109行
+#if !LV_USE_LARGE_COORD
+#error "虚拟列表需要32位坐标：sdkconfig 中打开 CONFIG_LV_USE_LARGE_COORD"
+#endif
+#define DETAIL_MISS_DELAY_MS 30       // 详情未命中缓存时，先显示一帧“加载中...”
+#define PREFETCH_ADJACENT_ROWS 1      // 预取可视区域上下各几行
 
 /**
  * @brief 更新时间显示的定时器回调
@@ -76,18 +121,21 @@ static void header_clicked_cb(lv_event_t *e)
     (void)e;
     ESP_LOGI(TAG, "顶栏被点击，触发手动刷新请求");
     header_refresh_requested = true;
-    todo_ui_show_loading(true);
+    lv_obj_scroll_to_y(scroll_container, 0, LV_ANIM_OFF);
+    // 新列表到达前原有卡片保持可见、可点，只在顶栏提示
+    todo_ui_show_refreshing(true);
 }
 
 /**
  * @brief 关闭详细信息弹窗（点击背景遮罩）
+ *
+ * 弹窗常驻，只隐藏不删除，下次打开直接复用。
  */
 static void close_detail_popup_bg(lv_event_t *e)
 {
     (void)e;  // 避免未使用参数警告
-    if (detail_popup != NULL) {
-        lv_obj_del(detail_popup);
-        detail_popup = NULL;
+    if (detail_mask != NULL) {
+        lv_obj_add_flag(detail_mask, LV_OBJ_FLAG_HIDDEN);
     }
 }
 
@@ -113,13 +161,14 @@ static void todo_item_clicked_cb(lv_event_t *e)
         return;
     }
     
-    lv_obj_t *item = lv_event_get_target(e);
-    int index = (int)(intptr_t)lv_event_get_user_data(e);
+    int slot = (int)(intptr_t)lv_event_get_user_data(e);
+    int index = slot_rows[slot];
+    const todo_item_t *item = todo_pager_get_item(index);
     
-    if (index < current_todo_list.count) {
-        const char *todo_id = current_todo_list.items[index].id;
-        const char *list_id = current_todo_list.items[index].listId;
-        bool current_status = current_todo_list.items[index].is_completed;
+    if (item != NULL) {
+        const char *todo_id = item->id;
+        const char *list_id = item->listId;
+        bool current_status = item->is_completed;
         bool new_status = !current_status;
         
         ESP_LOGI(TAG, "TODO[%d] 点击，切换状态: %s -> %s (listId: %s)", 
@@ -128,43 +177,336 @@ static void todo_item_clicked_cb(lv_event_t *e)
         click_processing = true;
         last_click_time = now;
         
-        esp_err_t ret = todo_client_set_completed(todo_id, list_id, new_status);
+        // 先在本地生效，由网络任务发送；服务器暂时不可用时留在队列里补发
+        esp_err_t ret = todo_outbox_set_completed(todo_id, list_id, new_status);
         
         if (ret == ESP_OK) {
-            ESP_LOGI(TAG, "服务器状态更新成功");
-            current_todo_list.items[index].is_completed = new_status;
-            
-            if (new_status) {
-                lv_obj_set_style_bg_color(item, COLOR_COMPLETED, 0);
-                lv_obj_set_style_text_color(todo_title_labels[index], COLOR_TEXT_GRAY, 0);
-                lv_obj_set_style_text_decor(todo_title_labels[index], LV_TEXT_DECOR_STRIKETHROUGH, 0);
-                if (todo_deadline_labels[index]) {
-                    lv_obj_set_style_text_color(todo_deadline_labels[index], COLOR_TEXT_GRAY, 0);
-                }
-            } else {
-                lv_obj_set_style_bg_color(item, COLOR_PENDING, 0);
-                lv_obj_set_style_text_color(todo_title_labels[index], COLOR_TEXT, 0);
-                lv_obj_set_style_text_decor(todo_title_labels[index], LV_TEXT_DECOR_NONE, 0);
-                if (todo_deadline_labels[index]) {
-                    lv_obj_set_style_text_color(todo_deadline_labels[index], COLOR_TEXT_GRAY, 0);
-                }
-            }
+            // 卡片在本轮通知变更时重新绑定
+            todo_pager_set_completed(index, new_status);
         } else {
-            ESP_LOGE(TAG, "服务器状态更新失败");
+            ESP_LOGE(TAG, "状态更新排队失败");
         }
         
         click_processing = false;
     }
 }
 
+/**
+ * @brief 延后填充详情正文
+ *
+ * 弹窗先显示标题和“加载中...”，正文的排版放到之后的LVGL处理中，长按响应不被排版阻塞。
+ * 正文先查LRU缓存，未命中时交给网络任务获取，到达后（todo_ui_on_detail_fetched）再排版。
+ */
+static void detail_fill_body_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    
+    if (lv_obj_has_flag(detail_mask, LV_OBJ_FLAG_HIDDEN) || !detail_pending) {
+        return;
+    }
+    
+    detail_pending = false;
+    const todo_item_t *item = detail_item;
+    if (item == NULL || detail_body_buf == NULL) {
+        lv_label_set_text(detail_body, "详情加载失败");
+        return;
+    }
+    
+    if (!todo_detail_cache_get(item->id, detail_body_buf, TODO_BODY_MAX_LEN)) {
+        uint32_t tag = ++detail_fetch_seq;
+        if (todo_net_fetch_detail(item->id, item->listId, tag) != ESP_OK) {
+            lv_label_set_text(detail_body, "详情加载失败");
+            return;
+        }
+        detail_fetch_tag = tag;
+        return;
+    }
+    
+    if (strlen(detail_body_buf) > 0) {
+        lv_label_set_text(detail_body, detail_body_buf);
+        lv_obj_clear_flag(detail_body, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(detail_body, LV_OBJ_FLAG_HIDDEN);
+    }
+    
+    detail_loaded = true;
+}
+
+void todo_ui_on_detail_fetched(uint32_t tag, esp_err_t err)
+{
+    if (detail_fetch_tag == 0 || tag != detail_fetch_tag) {
+        return;
+    }
+    detail_fetch_tag = 0;
+    if (lv_obj_has_flag(detail_mask, LV_OBJ_FLAG_HIDDEN)) {
+        return;
+    }
+    
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "获取详情失败");
+        lv_label_set_text(detail_body, "详情加载失败");
+        return;
+    }
+    // 正文已写入缓存，按缓存命中的路径排版
+    detail_pending = true;
+    detail_fill_body_cb(NULL);
+}
+
+/**
+ * @brief 可视行及下方相邻行中未缓存详情的卡片加入预取队列
+ */
+static void schedule_prefetch(void)
+{
+    if (view_first_row < 0) {
+        return;
+    }
+    
+    int last = view_last_row + PREFETCH_ADJACENT_ROWS;
+    if (last > view_first_row + CARD_POOL_SIZE - 1) {
+        last = view_first_row + CARD_POOL_SIZE - 1;
+    }
+    for (int row = view_first_row; row <= last; row++) {
+        int slot = row % CARD_POOL_SIZE;
+        if (slot_rows[slot] != row || slot_placeholder[slot]) {
+            continue;
+        }
+        const todo_item_t *item = todo_pager_get_item(row);
+        if (item != NULL && !todo_detail_cache_contains(item->id)) {
+            prefetch_mask |= 1u << slot;
+        }
+    }
+}
+
+/**
+ * @brief 把一行数据绑定到卡片
+ */
+static void bind_slot(int slot, int row)
+{
+    const todo_item_t *item = todo_pager_get_item(row);
+    
+    slot_rows[slot] = row;
+    slot_placeholder[slot] = item == NULL;
+    lv_obj_set_y(todo_items[slot], row * CARD_PITCH);
+    lv_obj_clear_flag(todo_items[slot], LV_OBJ_FLAG_HIDDEN);
+    
+    if (item == NULL) {
+        // 所在页正在获取，先显示占位
+        lv_label_set_text(todo_title_labels[slot], "加载中...");
+        lv_label_set_text(todo_deadline_labels[slot], "");
+        todo_theme_set_completed(todo_items[slot], todo_title_labels[slot], false);
+        return;
+    }
+    
+    lv_label_set_text(todo_title_labels[slot], item->title);
+    
+    if (strlen(item->last_modified_date) >= 16) {
+        char datetime_str[20] = {0};
+        snprintf(datetime_str, sizeof(datetime_str), "%.2s-%.2s %.2s:%.2s",
+                 &item->last_modified_date[5],   // 月
+                 &item->last_modified_date[8],   // 日
+                 &item->last_modified_date[11],  // 时
+                 &item->last_modified_date[14]); // 分
+        lv_label_set_text(todo_deadline_labels[slot], datetime_str);
+    } else {
+        lv_label_set_text(todo_deadline_labels[slot], "");
+    }
+    
+    todo_theme_set_completed(todo_items[slot], todo_title_labels[slot], item->is_completed);
+}
+
+/**
+ * @brief 按滚动位置把卡片池绑定到可视行
+ *
+ * 行号固定映射到 row % CARD_POOL_SIZE 号卡片，滚动时只有新露出的行需要重新绑定。
+ * @param force 列表数据变化时强制重新绑定全部卡片
+ */
+static void bind_visible_rows(bool force)
+{
+    int count = todo_pager_get_count();
+    if (count != spacer_rows) {
+        spacer_rows = count;
+        if (count > 0) {
+            lv_obj_set_height(list_spacer, count * CARD_PITCH - CARD_GAP);
+            lv_obj_clear_flag(list_spacer, LV_OBJ_FLAG_HIDDEN);
+        } else {
+            lv_obj_add_flag(list_spacer, LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+    
+    lv_coord_t scroll_y = lv_obj_get_scroll_y(scroll_container);
+    lv_coord_t view_h = lv_obj_get_content_height(scroll_container);
+    int first = scroll_y > 0 ? scroll_y / CARD_PITCH : 0;
+    int last = (scroll_y + view_h) / CARD_PITCH;
+    if (last > first + CARD_POOL_SIZE - 1) {
+        last = first + CARD_POOL_SIZE - 1;
+    }
+    
+    if (!force && first == view_first_row && last == view_last_row) {
+        return;
+    }
+    view_first_row = first;
+    view_last_row = last;
+    todo_pager_set_viewport(first, last);
+    
+    for (int row = first; row < first + CARD_POOL_SIZE; row++) {
+        int slot = row % CARD_POOL_SIZE;
+        if (row >= count) {
+            slot_rows[slot] = -1;
+            lv_obj_add_flag(todo_items[slot], LV_OBJ_FLAG_HIDDEN);
+        } else if (force || slot_rows[slot] != row || slot_placeholder[slot]) {
+            bind_slot(slot, row);
+        }
+    }
+}
+
+/**
+ * @brief 列表数据变更通知：行号不变时只重新绑定内容变化的卡片
+ */
+static void store_changed_cb(const todo_store_change_t *change, void *ctx)
+{
+    (void)ctx;
+    if (change->structure) {
+        todo_ui_update();
+        return;
+    }
+    
+    int64_t start = esp_timer_get_time();
+    int rebound = 0;
+    for (int slot = 0; slot < CARD_POOL_SIZE; slot++) {
+        int row = slot_rows[slot];
+        if (row >= change->first_row && row <= change->last_row) {
+            bind_slot(slot, row);
+            rebound++;
+        }
+    }
+    if (rebound > 0) {
+        schedule_prefetch();
+    }
+    
+    ESP_LOGD(TAG, "变更 v%lu 行 %d-%d，重新绑定 %d 张卡片", change->version,
+             change->first_row, change->last_row, rebound);
+    net_timing_record(NET_PHASE_UI_APPLY, esp_timer_get_time() - start);
+}
+
+/**
+ * @brief 列表滚动回调（循环复用卡片，接近末尾时预取下一页）
+ */
+static void scroll_cb(lv_event_t *e)
+{
+    (void)e;
+    bind_visible_rows(false);
+}
+
+/**
+ * @brief 列表滚动结束回调（预取可视区域附近的详情）
+ */
+static void scroll_end_cb(lv_event_t *e)
+{
+    (void)e;
+    schedule_prefetch();
+}
+
+/**
+ * @brief 创建常驻的详情弹窗（初始隐藏）
+ */
+static void create_detail_popup(void)
+{
+    detail_mask = lv_obj_create(lv_layer_top());
+    lv_obj_set_size(detail_mask, 240, 320);
+    lv_obj_set_pos(detail_mask, 0, 0);
+    todo_theme_apply(detail_mask, TODO_THEME_POPUP_MASK);
+    lv_obj_clear_flag(detail_mask, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(detail_mask, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(detail_mask, close_detail_popup_bg, LV_EVENT_CLICKED, NULL);
+    
+    // 弹窗本身可点击才能接收拖动，长正文在弹窗内滚动；点击遮罩空白处关闭
+    detail_popup = lv_obj_create(detail_mask);
+    lv_obj_set_size(detail_popup, 200, 150);
+    lv_obj_center(detail_popup);
+    todo_theme_apply(detail_popup, TODO_THEME_POPUP);
+    lv_obj_set_flex_flow(detail_popup, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_scroll_dir(detail_popup, LV_DIR_VER);
+    lv_obj_set_scrollbar_mode(detail_popup, LV_SCROLLBAR_MODE_AUTO);
+    
+    detail_title = lv_label_create(detail_popup);
+    lv_label_set_text(detail_title, "");
+    todo_theme_apply(detail_title, TODO_THEME_POPUP_TITLE);
+    lv_obj_set_width(detail_title, lv_pct(100));
+    
+    detail_body = lv_label_create(detail_popup);
+    lv_label_set_text(detail_body, "");
+    todo_theme_apply(detail_body, TODO_THEME_POPUP_BODY);
+    lv_obj_set_width(detail_body, lv_pct(100));
+    lv_label_set_long_mode(detail_body, LV_LABEL_LONG_WRAP);
+    
+    lv_obj_add_flag(detail_mask, LV_OBJ_FLAG_HIDDEN);
+    
+    detail_body_buf = mem_tag_malloc(MEM_TAG_UI, TODO_BODY_MAX_LEN, MALLOC_CAP_SPIRAM);
+    if (detail_body_buf == NULL) {
+        ESP_LOGE(TAG, "详情缓冲区分配失败");
+    }
+}
+
+#if CONFIG_TODO_MEM_DEBUG_PAGE
+static void mem_page_update_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    mem_tag_format(mem_text, sizeof(mem_text));
+    lv_label_set_text_static(mem_label, mem_text);
+}
+
+/**
+ * @brief 长按底栏打开/关闭内存调试页，点击调试页也可关闭
+ */
+static void mem_page_toggle_cb(lv_event_t *e)
+{
+    (void)e;
+    if (lv_obj_has_flag(mem_page, LV_OBJ_FLAG_HIDDEN)) {
+        mem_page_update_cb(NULL);
+        lv_obj_clear_flag(mem_page, LV_OBJ_FLAG_HIDDEN);
+        lv_timer_resume(mem_timer);
+    } else {
+        lv_obj_add_flag(mem_page, LV_OBJ_FLAG_HIDDEN);
+        lv_timer_pause(mem_timer);
+    }
+}
+
+/**
+ * @brief 创建内存调试页（覆盖列表区域，初始隐藏，显示时每秒更新）
+ */
+static void create_mem_page(void)
+{
+    mem_page = lv_obj_create(main_screen);
+    lv_obj_set_size(mem_page, 240, 320 - 40 - FOOTER_HEIGHT);
+    lv_obj_set_pos(mem_page, 0, 40);
+    todo_theme_apply(mem_page, TODO_THEME_POPUP);
+    lv_obj_add_flag(mem_page, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(mem_page, mem_page_toggle_cb, LV_EVENT_CLICKED, NULL);
+    
+    mem_label = lv_label_create(mem_page);
+    todo_theme_apply(mem_label, TODO_THEME_POPUP_BODY);
+    lv_obj_set_width(mem_label, lv_pct(100));
+    lv_label_set_text_static(mem_label, "");
+    
+    lv_obj_add_flag(mem_page, LV_OBJ_FLAG_HIDDEN);
+    mem_timer = lv_timer_create(mem_page_update_cb, 1000, NULL);
+    lv_timer_pause(mem_timer);
+    
+    lv_obj_add_event_cb(footer_bar, mem_page_toggle_cb, LV_EVENT_LONG_PRESSED, NULL);
+}
+#endif
+
 /**
  * @brief TODO项长按事件回调（长按：显示详细信息）
  */
 static void todo_item_long_pressed_cb(lv_event_t *e)
 {
-    int index = (int)(intptr_t)lv_event_get_user_data(e);
+    int slot = (int)(intptr_t)lv_event_get_user_data(e);
+    int index = slot_rows[slot];
+    const todo_item_t *item = NULL;
+    todo_page_block_t *block = todo_pager_snapshot(index, &item);
     
-    if (index >= current_todo_list.count) {
+    if (block == NULL) {
         return;
     }
     
@@ -172,98 +514,96 @@ static void todo_item_long_pressed_cb(lv_event_t *e)
     
     ESP_LOGI(TAG, "TODO[%d] 长按，显示详细信息", index);
     
-    if (detail_popup != NULL) {
-        lv_obj_del(detail_popup);
+    int64_t start = esp_timer_get_time();
+    
+    if (block == detail_block && item == detail_item && detail_loaded) {
+        // 同一快照：条目没有被修改过（修改会写时复制出新块），直接复用已排版的内容
+        todo_store_block_release(block);
+    } else {
+        // 正文获取和排版延后
+        todo_store_block_release(detail_block);
+        detail_block = block;
+        detail_item = item;
+        bool cached = todo_detail_cache_contains(item->id);
+        lv_label_set_text(detail_title, item->title);
+        lv_label_set_text(detail_body, "加载中...");
+        lv_obj_clear_flag(detail_body, LV_OBJ_FLAG_HIDDEN);
+        detail_loaded = false;
+        detail_pending = true;
+        detail_fetch_tag = 0;
+        // 未命中缓存时先让“加载中...”画出来一帧再发请求
+        lv_timer_t *timer = lv_timer_create(detail_fill_body_cb, cached ? 0 : DETAIL_MISS_DELAY_MS, NULL);
+        lv_timer_set_repeat_count(timer, 1);
     }
     
-    lv_obj_t *bg_mask = lv_obj_create(lv_scr_act());
-    lv_obj_set_size(bg_mask, 240, 320);
-    lv_obj_set_pos(bg_mask, 0, 0);
-    lv_obj_set_style_bg_color(bg_mask, lv_color_black(), 0);
-    lv_obj_set_style_bg_opa(bg_mask, LV_OPA_50, 0);
-    lv_obj_set_style_border_width(bg_mask, 0, 0);
-    lv_obj_set_style_radius(bg_mask, 0, 0);  // 背景无圆角
-    lv_obj_clear_flag(bg_mask, LV_OBJ_FLAG_SCROLLABLE);
-    lv_obj_add_flag(bg_mask, LV_OBJ_FLAG_CLICKABLE);
-    lv_obj_add_event_cb(bg_mask, close_detail_popup_bg, LV_EVENT_CLICKED, NULL);
+    lv_obj_scroll_to_y(detail_popup, 0, LV_ANIM_OFF);
+    lv_obj_clear_flag(detail_mask, LV_OBJ_FLAG_HIDDEN);
     
-    detail_popup = lv_obj_create(bg_mask);
-    lv_obj_set_size(detail_popup, 200, 150);
-    lv_obj_center(detail_popup);
-    lv_obj_set_style_bg_color(detail_popup, lv_color_white(), 0);
-    lv_obj_set_style_border_color(detail_popup, COLOR_PRIMARY, 0);
-    lv_obj_set_style_border_width(detail_popup, 3, 0);
-    lv_obj_set_style_radius(detail_popup, 10, 0);
-    lv_obj_set_style_shadow_width(detail_popup, 20, 0);
-    lv_obj_set_style_shadow_opa(detail_popup, LV_OPA_30, 0);
-    lv_obj_clear_flag(detail_popup, LV_OBJ_FLAG_CLICKABLE);  // 弹窗内容不响应点击
-    
-    lv_obj_t *title = lv_label_create(detail_popup);
-    lv_label_set_text(title, current_todo_list.items[index].title);
-    lv_obj_set_style_text_font(title, &lv_font_chinese_14, 0);
-    lv_obj_set_style_text_color(title, COLOR_PRIMARY, 0);
-    lv_obj_set_pos(title, 10, 10);
-    lv_obj_set_width(title, 180);
-    
-    if (strlen(current_todo_list.items[index].body) > 0) {
-        lv_obj_t *body = lv_label_create(detail_popup);
-        lv_label_set_text(body, current_todo_list.items[index].body);
-        lv_obj_set_style_text_font(body, &lv_font_chinese_14, 0);  // 改用中文字体
-        lv_obj_set_style_text_color(body, COLOR_TEXT, 0);
-        lv_obj_set_pos(body, 10, 40);
-        lv_obj_set_width(body, 180);
-        lv_label_set_long_mode(body, LV_LABEL_LONG_WRAP);
-    }
-    
-    detail_popup = bg_mask;
+    ESP_LOGD(TAG, "详情弹窗打开耗时 %lld us (%s)", esp_timer_get_time() - start,
+             detail_pending ? "延后排版" : "命中缓存");
 }
 
 esp_err_t todo_ui_init(void)
 {
     ESP_LOGI(TAG, "初始化TODO UI");
     
+    todo_theme_init();
+    
     main_screen = lv_scr_act();
-    lv_obj_set_style_bg_color(main_screen, COLOR_BACKGROUND, 0);
+    todo_theme_apply(main_screen, TODO_THEME_SCREEN);
     
     lv_obj_t *header = lv_obj_create(main_screen);
     lv_obj_set_size(header, 240, 40);
     lv_obj_set_pos(header, 0, 0);
-    lv_obj_set_style_bg_color(header, COLOR_PRIMARY, 0);
-    lv_obj_set_style_border_width(header, 0, 0);
-    lv_obj_set_style_radius(header, 0, 0);  // 标题栏无圆角
-    lv_obj_set_style_pad_all(header, 0, 0);
+    todo_theme_apply(header, TODO_THEME_BAR);
     lv_obj_clear_flag(header, LV_OBJ_FLAG_SCROLLABLE);
     lv_obj_add_flag(header, LV_OBJ_FLAG_CLICKABLE);
     lv_obj_add_event_cb(header, header_clicked_cb, LV_EVENT_CLICKED, NULL);
     
     title_label = lv_label_create(header);
     lv_label_set_text(title_label, "待办事项");
-    lv_obj_set_style_text_font(title_label, &lv_font_chinese_14, 0);
-    lv_obj_set_style_text_color(title_label, lv_color_white(), 0);
+    todo_theme_apply(title_label, TODO_THEME_HEADER_TITLE);
     lv_obj_align(title_label, LV_ALIGN_CENTER, 0, 0);
+    
+    server_status_label = lv_label_create(header);
+    lv_label_set_text(server_status_label, "");
+    todo_theme_apply(server_status_label, TODO_THEME_HEADER_TITLE);
+    lv_obj_align(server_status_label, LV_ALIGN_RIGHT_MID, -8, 0);
+    lv_obj_add_flag(server_status_label, LV_OBJ_FLAG_HIDDEN);
+
+    refreshing_label = lv_label_create(header);
+    lv_label_set_text(refreshing_label, "刷新中");
+    todo_theme_apply(refreshing_label, TODO_THEME_HEADER_TITLE);
+    lv_obj_align(refreshing_label, LV_ALIGN_LEFT_MID, 8, 0);
+    lv_obj_add_flag(refreshing_label, LV_OBJ_FLAG_HIDDEN);
 
     scroll_container = lv_obj_create(main_screen);
     lv_obj_set_size(scroll_container, 240, 320 - 40 - FOOTER_HEIGHT);
     lv_obj_set_pos(scroll_container, 0, 40);
-    lv_obj_set_style_bg_color(scroll_container, COLOR_BACKGROUND, 0);
-    lv_obj_set_style_border_width(scroll_container, 0, 0);
-    lv_obj_set_style_radius(scroll_container, 0, 0);
-    lv_obj_set_style_pad_all(scroll_container, 5, 0);
-    lv_obj_set_style_pad_row(scroll_container, 10, 0);  // 行间距
-    lv_obj_set_flex_flow(scroll_container, LV_FLEX_FLOW_COLUMN);  // 垂直排列
+    todo_theme_apply(scroll_container, TODO_THEME_LIST);
     lv_obj_set_scroll_dir(scroll_container, LV_DIR_VER);  // 只允许垂直滚动
     lv_obj_set_scrollbar_mode(scroll_container, LV_SCROLLBAR_MODE_AUTO);  // 自动显示滚动条
+    lv_obj_add_event_cb(scroll_container, scroll_cb, LV_EVENT_SCROLL, NULL);
+    lv_obj_add_event_cb(scroll_container, scroll_end_cb, LV_EVENT_SCROLL_END, NULL);
+    
+    // 卡片按行号手动定位，由占位对象决定可滚动高度
+    list_spacer = lv_obj_create(scroll_container);
+    lv_obj_remove_style_all(list_spacer);
+    lv_obj_set_size(list_spacer, 1, 0);
+    lv_obj_set_pos(list_spacer, 0, 0);
+    lv_obj_clear_flag(list_spacer, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_flag(list_spacer, LV_OBJ_FLAG_HIDDEN);
+
+#if CONFIG_TODO_UI_CARD_BG_CACHE
+    todo_card_bg_init(CARD_WIDTH, CARD_HEIGHT);
+#endif
 
-    for (int i = 0; i < MAX_TODOS; i++) {
+    for (int i = 0; i < CARD_POOL_SIZE; i++) {
+        slot_rows[i] = -1;
         todo_items[i] = lv_obj_create(scroll_container);
-        lv_obj_set_size(todo_items[i], 220, 65);
-        lv_obj_set_style_bg_color(todo_items[i], COLOR_PENDING, 0);
-        lv_obj_set_style_border_color(todo_items[i], lv_color_hex(0xE0E0E0), 0);
-        lv_obj_set_style_border_width(todo_items[i], 2, 0);
-        lv_obj_set_style_radius(todo_items[i], 12, 0);  // 圆角
-        lv_obj_set_style_pad_all(todo_items[i], 10, 0);
-        lv_obj_set_style_shadow_width(todo_items[i], 8, 0);  // 阴影
-        lv_obj_set_style_shadow_opa(todo_items[i], LV_OPA_20, 0);
+        lv_obj_set_size(todo_items[i], CARD_WIDTH, CARD_HEIGHT);
+        todo_theme_apply(todo_items[i], TODO_THEME_CARD);
+        todo_card_bg_attach(todo_items[i]);
         lv_obj_clear_flag(todo_items[i], LV_OBJ_FLAG_SCROLLABLE);
         
         lv_obj_add_flag(todo_items[i], LV_OBJ_FLAG_CLICKABLE);
@@ -272,15 +612,13 @@ esp_err_t todo_ui_init(void)
         
         todo_title_labels[i] = lv_label_create(todo_items[i]);
         lv_label_set_text(todo_title_labels[i], "");
-        lv_obj_set_style_text_font(todo_title_labels[i], &lv_font_chinese_14, 0);
-        lv_obj_set_style_text_color(todo_title_labels[i], COLOR_TEXT, 0);
+        todo_theme_apply(todo_title_labels[i], TODO_THEME_CARD_TITLE);
         lv_obj_set_pos(todo_title_labels[i], 0, 0);
         lv_obj_set_width(todo_title_labels[i], 200);
         
         todo_deadline_labels[i] = lv_label_create(todo_items[i]);
         lv_label_set_text(todo_deadline_labels[i], "");
-        lv_obj_set_style_text_font(todo_deadline_labels[i], &lv_font_montserrat_14, 0);
-        lv_obj_set_style_text_color(todo_deadline_labels[i], COLOR_TEXT_GRAY, 0);
+        todo_theme_apply(todo_deadline_labels[i], TODO_THEME_CARD_DEADLINE);
         lv_obj_set_pos(todo_deadline_labels[i], 0, 22);
         lv_obj_set_width(todo_deadline_labels[i], 200);
         
@@ -289,80 +627,53 @@ esp_err_t todo_ui_init(void)
 
     loading_label = lv_label_create(main_screen);
     lv_label_set_text(loading_label, "加载中...");
-    lv_obj_set_style_text_font(loading_label, &lv_font_chinese_14, 0);
-    lv_obj_set_style_text_color(loading_label, COLOR_PRIMARY, 0);
+    todo_theme_apply(loading_label, TODO_THEME_LOADING);
     lv_obj_set_pos(loading_label, 90, 150);  // 居中位置
     
     footer_bar = lv_obj_create(main_screen);
     lv_obj_set_size(footer_bar, 240, FOOTER_HEIGHT);
     lv_obj_set_pos(footer_bar, 0, 320 - FOOTER_HEIGHT);
-    lv_obj_set_style_bg_color(footer_bar, COLOR_PRIMARY, 0);
-    lv_obj_set_style_border_width(footer_bar, 0, 0);
-    lv_obj_set_style_radius(footer_bar, 0, 0);
-    lv_obj_set_style_pad_all(footer_bar, 0, 0);
+    todo_theme_apply(footer_bar, TODO_THEME_BAR);
     lv_obj_clear_flag(footer_bar, LV_OBJ_FLAG_SCROLLABLE);
     
     time_label = lv_label_create(footer_bar);
     lv_label_set_text(time_label, "01-29  00:00:00");
-    lv_obj_set_style_text_font(time_label, &lv_font_montserrat_22, 0);
-    lv_obj_set_style_text_color(time_label, lv_color_white(), 0);
-    lv_obj_set_style_text_letter_space(time_label, 1, 0);  // 增加字间距
+    todo_theme_apply(time_label, TODO_THEME_CLOCK);
     lv_obj_align(time_label, LV_ALIGN_CENTER, 0, 0);
     
+    create_detail_popup();
+#if CONFIG_TODO_MEM_DEBUG_PAGE
+    create_mem_page();
+#endif
+    ESP_ERROR_CHECK(todo_store_subscribe(store_changed_cb, NULL));
+    
     time_timer = lv_timer_create(update_time_cb, 1000, NULL);
     update_time_cb(NULL);
     
+    lvgl_mem_log_stats();
+    
     ESP_LOGI(TAG, "TODO UI初始化完成");
     return ESP_OK;
 }
 
-void todo_ui_update(const todo_list_t *list)
+void todo_ui_update(void)
 {
-    if (list == NULL) {
-        return;
-    }
-    
-    memcpy(&current_todo_list, list, sizeof(todo_list_t));
+    int64_t start = esp_timer_get_time();
     
-    ESP_LOGI(TAG, "更新UI，TODO数量: %d", list->count);
+    ESP_LOGI(TAG, "更新UI，已知TODO数量: %d%s", todo_pager_get_count(),
+             todo_pager_has_more() ? "（还有更多）" : "");
     
     lv_obj_add_flag(loading_label, LV_OBJ_FLAG_HIDDEN);
+    todo_ui_show_refreshing(false);
     
-    int count = list->count > MAX_TODOS ? MAX_TODOS : list->count;
+    lv_obj_update_layout(scroll_container);
+    bind_visible_rows(true);
     
-    for (int i = 0; i < MAX_TODOS; i++) {
-        lv_obj_add_flag(todo_items[i], LV_OBJ_FLAG_HIDDEN);
-    }
+    // 列表变化后重新计算预取范围
+    prefetch_mask = 0;
+    schedule_prefetch();
     
-    for (int i = 0; i < count && i < MAX_TODOS; i++) {
-        lv_obj_clear_flag(todo_items[i], LV_OBJ_FLAG_HIDDEN);
-        
-        lv_label_set_text(todo_title_labels[i], list->items[i].title);
-        
-        if (strlen(list->items[i].last_modified_date) >= 16) {
-            char datetime_str[20] = {0};
-            snprintf(datetime_str, sizeof(datetime_str), "%.2s-%.2s %.2s:%.2s",
-                     &list->items[i].last_modified_date[5],   // 月
-                     &list->items[i].last_modified_date[8],   // 日
-                     &list->items[i].last_modified_date[11],  // 时
-                     &list->items[i].last_modified_date[14]); // 分
-            lv_label_set_text(todo_deadline_labels[i], datetime_str);
-        } else {
-            lv_label_set_text(todo_deadline_labels[i], "");
-        }
-        
-        if (list->items[i].is_completed) {
-            lv_obj_set_style_bg_color(todo_items[i], COLOR_COMPLETED, 0);
-            lv_obj_set_style_text_color(todo_title_labels[i], COLOR_TEXT_GRAY, 0);
-            lv_obj_set_style_text_decor(todo_title_labels[i], LV_TEXT_DECOR_STRIKETHROUGH, 0);
-            lv_obj_set_style_text_color(todo_deadline_labels[i], COLOR_TEXT_GRAY, 0);
-        } else {
-            lv_obj_set_style_bg_color(todo_items[i], COLOR_PENDING, 0);
-            lv_obj_set_style_text_color(todo_title_labels[i], COLOR_TEXT, 0);
-            lv_obj_set_style_text_decor(todo_title_labels[i], LV_TEXT_DECOR_NONE, 0);
-            lv_obj_set_style_text_color(todo_deadline_labels[i], COLOR_TEXT_GRAY, 0);
-        }
-    }
+    net_timing_record(NET_PHASE_UI_APPLY, esp_timer_get_time() - start);
 }
 
 void todo_ui_show_loading(bool loading)
@@ -373,23 +684,67 @@ void todo_ui_show_loading(bool loading)
     
     if (loading) {
         lv_obj_clear_flag(loading_label, LV_OBJ_FLAG_HIDDEN);
-        for (int i = 0; i < MAX_TODOS; i++) {
-            lv_obj_add_flag(todo_items[i], LV_OBJ_FLAG_HIDDEN);
-        }
     } else {
         lv_obj_add_flag(loading_label, LV_OBJ_FLAG_HIDDEN);
     }
 }
 
+void todo_ui_show_refreshing(bool refreshing)
+{
+    if (refreshing_label == NULL) {
+        return;
+    }
+    
+    if (refreshing) {
+        lv_obj_clear_flag(refreshing_label, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(refreshing_label, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
 void todo_ui_show_wifi_status(bool connected, const char *ip)
 {
     (void)connected;
     (void)ip;
 }
 
+void todo_ui_show_server_status(retry_breaker_state_t state)
+{
+    if (server_status_label == NULL) {
+        return;
+    }
+    
+    switch (state) {
+        case RETRY_BREAKER_OPEN:
+            lv_label_set_text(server_status_label, "离线");
+            lv_obj_clear_flag(server_status_label, LV_OBJ_FLAG_HIDDEN);
+            break;
+        case RETRY_BREAKER_HALF_OPEN:
+            lv_label_set_text(server_status_label, "重连中");
+            lv_obj_clear_flag(server_status_label, LV_OBJ_FLAG_HIDDEN);
+            break;
+        default:
+            lv_obj_add_flag(server_status_label, LV_OBJ_FLAG_HIDDEN);
+            break;
+    }
+}
+
 bool todo_ui_take_refresh_request(void)
 {
     bool requested = header_refresh_requested;
     header_refresh_requested = false;
     return requested;
 }
+
+const todo_item_t *todo_ui_take_prefetch_item(void)
+{
+    while (prefetch_mask != 0) {
+        int slot = __builtin_ctz(prefetch_mask);
+        prefetch_mask &= ~(1u << slot);
+        const todo_item_t *item = todo_pager_get_item(slot_rows[slot]);
+        if (item != NULL && !todo_detail_cache_contains(item->id)) {
+            return item;
+        }
+    }
+    return NULL;
+}
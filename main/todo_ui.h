@@ -8,6 +8,7 @@
 
 #include "lvgl.h"
 #include "todo_client.h"
+#include "retry_policy.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -20,17 +21,28 @@ extern "C" {
 esp_err_t todo_ui_init(void);
 
 /**
- * @brief 更新TODO列表显示
- * @param list TODO列表数据
+ * @brief 重新绑定全部可视行，并隐藏“加载中”和顶栏的刷新提示
+ *
+ * 数据来自 todo_pager，UI只为可视区域附近的行创建卡片。
+ * 平时由 todo_store 的变更通知驱动：行数或行号变化时调用本函数，
+ * 只有内容变化时只重新绑定对应的卡片。
  */
-void todo_ui_update(const todo_list_t *list);
+void todo_ui_update(void);
 
 /**
- * @brief 显示加载状态
+ * @brief 显示加载状态（列表为空时的首次加载，显示在列表区域中间）
  * @param loading true显示加载中，false隐藏
  */
 void todo_ui_show_loading(bool loading);
 
+/**
+ * @brief 在顶栏显示刷新提示，不遮挡也不隐藏现有列表
+ *
+ * 点击顶栏手动刷新时显示，新列表换上（todo_ui_update）后隐藏。
+ * @param refreshing true显示，false隐藏
+ */
+void todo_ui_show_refreshing(bool refreshing);
+
 /**
  * @brief 显示WiFi连接状态
  * @param connected true已连接，false未连接
@@ -38,6 +50,12 @@ void todo_ui_show_loading(bool loading);
  */
 void todo_ui_show_wifi_status(bool connected, const char *ip_str);
 
+/**
+ * @brief 在顶栏显示服务器连接状态（熔断器状态）
+ * @param state 熔断器状态，正常时不显示
+ */
+void todo_ui_show_server_status(retry_breaker_state_t state);
+
 /**
  * @brief 是否有来自UI的手动刷新请求（点击顶栏）
  *
@@ -46,6 +64,20 @@ void todo_ui_show_wifi_status(bool connected, const char *ip_str);
  */
 bool todo_ui_take_refresh_request(void);
 
+/**
+ * @brief 取出一条等待预取详情的TODO（可视区域及相邻行）
+ *
+ * 主循环逐条交给网络任务预取（todo_net_fetch_detail），同一时刻只有一条在途，
+ * 不占满网络任务的队列。
+ * @return 待预取的条目，没有时返回NULL
+ */
+const todo_item_t *todo_ui_take_prefetch_item(void);
+
+/**
+ * @brief 网络任务返回详情弹窗请求的正文（TODO_NET_FETCH_DETAIL，tag 为提交时的序号）
+ */
+void todo_ui_on_detail_fetched(uint32_t tag, esp_err_t err);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,149 @@
+/**
+ * @file draw_blend_ref.h
+ * @brief 主机测试用：LVGL 8.3 纯色填充的参照实现
+ *
+ * 照抄 LVGL 8.3 lv_draw_sw_blend.c 的 lv_draw_sw_blend_basic/fill_normal（纯色、普通混合模式部分），
+ * test_draw_blend 以它为准比较 draw_blend 的结果，bench_draw_blend 用它作标量基准。
+ */
+
+#ifndef DRAW_BLEND_REF_H
+#define DRAW_BLEND_REF_H
+
+#include <stdint.h>
+#include "lvgl.h"
+
+#define FILL_NORMAL_MASK_PX(color)                                  \
+    if (*mask == LV_OPA_COVER) *dest_buf = color;                   \
+    else *dest_buf = lv_color_mix(color, *dest_buf, *mask);         \
+    mask++;                                                         \
+    dest_buf++;
+
+static void ref_fill_normal(lv_color_t *dest_buf, const lv_area_t *dest_area, lv_coord_t dest_stride,
+                            lv_color_t color, lv_opa_t opa, const lv_opa_t *mask, lv_coord_t mask_stride)
+{
+    int32_t w = lv_area_get_width(dest_area);
+    int32_t h = lv_area_get_height(dest_area);
+    int32_t x;
+    int32_t y;
+
+    if (mask == NULL) {
+        if (opa >= LV_OPA_MAX) {
+            for (y = 0; y < h; y++) {
+                for (x = 0; x < w; x++) {
+                    dest_buf[x] = color;
+                }
+                dest_buf += dest_stride;
+            }
+        } else {
+            lv_color_t last_dest_color = lv_color_black();
+            lv_color_t last_res_color = lv_color_mix(color, last_dest_color, opa);
+            uint16_t color_premult[3];
+            lv_color_premult(color, opa, color_premult);
+            lv_opa_t opa_inv = 255 - opa;
+            for (y = 0; y < h; y++) {
+                for (x = 0; x < w; x++) {
+                    if (last_dest_color.full != dest_buf[x].full) {
+                        last_dest_color = dest_buf[x];
+                        dest_buf[x] = lv_color_mix_premult(color_premult, dest_buf[x], opa_inv);
+                        last_res_color = dest_buf[x];
+                    } else {
+                        dest_buf[x] = last_res_color;
+                    }
+                }
+                dest_buf += dest_stride;
+            }
+        }
+    } else if (opa >= LV_OPA_MAX) {
+        int32_t x_end4 = w - 4;
+        for (y = 0; y < h; y++) {
+            for (x = 0; x < w && ((uintptr_t)(mask) & 0x3); x++) {
+                FILL_NORMAL_MASK_PX(color)
+            }
+            for (; x <= x_end4; x += 4) {
+                uint32_t mask32 = *((const uint32_t *)mask);
+                if (mask32 == 0xFFFFFFFF) {
+                    dest_buf[0] = color;
+                    dest_buf[1] = color;
+                    dest_buf[2] = color;
+                    dest_buf[3] = color;
+                    dest_buf += 4;
+                    mask += 4;
+                } else if (mask32) {
+                    FILL_NORMAL_MASK_PX(color)
+                    FILL_NORMAL_MASK_PX(color)
+                    FILL_NORMAL_MASK_PX(color)
+                    FILL_NORMAL_MASK_PX(color)
+                } else {
+                    mask += 4;
+                    dest_buf += 4;
+                }
+            }
+            for (; x < w; x++) {
+                FILL_NORMAL_MASK_PX(color)
+            }
+            dest_buf += (dest_stride - w);
+            mask += (mask_stride - w);
+        }
+    } else {
+        lv_color_t last_dest_color;
+        lv_color_t last_res_color;
+        lv_opa_t last_mask = LV_OPA_TRANSP;
+        last_dest_color.full = dest_buf[0].full;
+        last_res_color.full = dest_buf[0].full;
+        lv_opa_t opa_tmp = LV_OPA_TRANSP;
+
+        for (y = 0; y < h; y++) {
+            const lv_opa_t *mask_tmp_x = mask;
+            for (x = 0; x < w; x++) {
+                if (*mask_tmp_x) {
+                    if (*mask_tmp_x != last_mask) {
+                        opa_tmp = *mask_tmp_x == LV_OPA_COVER ? opa : (uint32_t)((uint32_t)(*mask_tmp_x) * opa) >> 8;
+                    }
+                    if (*mask_tmp_x != last_mask || last_dest_color.full != dest_buf[x].full) {
+                        if (opa_tmp == LV_OPA_COVER) {
+                            last_res_color = color;
+                        } else {
+                            last_res_color = lv_color_mix(color, dest_buf[x], opa_tmp);
+                        }
+                        last_mask = *mask_tmp_x;
+                        last_dest_color.full = dest_buf[x].full;
+                    }
+                    dest_buf[x] = last_res_color;
+                }
+                mask_tmp_x++;
+            }
+            dest_buf += dest_stride;
+            mask += mask_stride;
+        }
+    }
+}
+
+static void ref_blend(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc)
+{
+    const lv_opa_t *mask;
+    if (dsc->mask_buf && dsc->mask_res == LV_DRAW_MASK_RES_TRANSP) {
+        return;
+    } else if (dsc->mask_res == LV_DRAW_MASK_RES_FULL_COVER) {
+        mask = NULL;
+    } else {
+        mask = dsc->mask_buf;
+    }
+
+    lv_coord_t dest_stride = lv_area_get_width(draw_ctx->buf_area);
+    lv_area_t blend_area;
+    if (!_lv_area_intersect(&blend_area, dsc->blend_area, draw_ctx->clip_area)) {
+        return;
+    }
+
+    lv_color_t *dest_buf = draw_ctx->buf;
+    dest_buf += dest_stride * (blend_area.y1 - draw_ctx->buf_area->y1) + (blend_area.x1 - draw_ctx->buf_area->x1);
+
+    lv_coord_t mask_stride = 0;
+    if (mask) {
+        mask_stride = lv_area_get_width(dsc->mask_area);
+        mask += mask_stride * (blend_area.y1 - dsc->mask_area->y1) + (blend_area.x1 - dsc->mask_area->x1);
+    }
+    ref_fill_normal(dest_buf, &blend_area, dest_stride, dsc->color, dsc->opa, mask, mask_stride);
+}
+
+#endif
@@ -0,0 +1,1001 @@
+/**
+ * @file host_cjson.c
+ * @brief 主机测试用：cJSON 1.7 的替身实现
+ *
+ * 解析、打印和内存管理按 cJSON 1.7.18 的做法重写，分配次数和每次的大小与之相同
+ * （节点大小随主机指针宽度变化），用于在主机上驱动 json_arena 和 todo_client。
+ */
+
+#include <ctype.h>
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cJSON.h"
+
+typedef struct {
+    void *(*allocate)(size_t size);
+    void (*deallocate)(void *ptr);
+    void *(*reallocate)(void *ptr, size_t size);
+} internal_hooks;
+
+static internal_hooks global_hooks = {malloc, free, realloc};
+
+void cJSON_InitHooks(cJSON_Hooks *hooks)
+{
+    if (hooks == NULL) {
+        global_hooks.allocate = malloc;
+        global_hooks.deallocate = free;
+        global_hooks.reallocate = realloc;
+        return;
+    }
+
+    global_hooks.allocate = hooks->malloc_fn != NULL ? hooks->malloc_fn : malloc;
+    global_hooks.deallocate = hooks->free_fn != NULL ? hooks->free_fn : free;
+
+    // 与 cJSON 相同：只有标准 malloc/free 时才使用 realloc
+    global_hooks.reallocate = NULL;
+    if (global_hooks.allocate == malloc && global_hooks.deallocate == free) {
+        global_hooks.reallocate = realloc;
+    }
+}
+
+void *cJSON_malloc(size_t size)
+{
+    return global_hooks.allocate(size);
+}
+
+void cJSON_free(void *object)
+{
+    global_hooks.deallocate(object);
+}
+
+static char *cjson_strdup(const char *string)
+{
+    size_t length = strlen(string) + 1;
+    char *copy = global_hooks.allocate(length);
+    if (copy != NULL) {
+        memcpy(copy, string, length);
+    }
+    return copy;
+}
+
+static cJSON *new_item(void)
+{
+    cJSON *node = global_hooks.allocate(sizeof(cJSON));
+    if (node != NULL) {
+        memset(node, 0, sizeof(cJSON));
+    }
+    return node;
+}
+
+void cJSON_Delete(cJSON *item)
+{
+    while (item != NULL) {
+        cJSON *next = item->next;
+        if (!(item->type & cJSON_IsReference) && item->child != NULL) {
+            cJSON_Delete(item->child);
+        }
+        if (!(item->type & cJSON_IsReference) && item->valuestring != NULL) {
+            global_hooks.deallocate(item->valuestring);
+        }
+        if (!(item->type & cJSON_StringIsConst) && item->string != NULL) {
+            global_hooks.deallocate(item->string);
+        }
+        global_hooks.deallocate(item);
+        item = next;
+    }
+}
+
+/* ---------- 解析 ---------- */
+
+typedef struct {
+    const unsigned char *content;
+    size_t length;
+    size_t offset;
+    size_t depth;
+} parse_buffer;
+
+#define can_read(buffer, size) ((buffer)->offset + (size) <= (buffer)->length)
+#define can_access_at_index(buffer, index) ((buffer)->offset + (index) < (buffer)->length)
+#define buffer_at_offset(buffer) ((buffer)->content + (buffer)->offset)
+
+static bool parse_value(cJSON *item, parse_buffer *input);
+
+static parse_buffer *skip_whitespace(parse_buffer *buffer)
+{
+    while (can_access_at_index(buffer, 0) && buffer_at_offset(buffer)[0] <= 32) {
+        buffer->offset++;
+    }
+    if (buffer->offset == buffer->length) {
+        buffer->offset--;
+    }
+    return buffer;
+}
+
+static bool parse_number(cJSON *item, parse_buffer *input)
+{
+    char number[64];
+    size_t i = 0;
+    for (; i < sizeof(number) - 1 && can_access_at_index(input, i); i++) {
+        char c = (char)buffer_at_offset(input)[i];
+        if (!(isdigit((unsigned char)c) || c == '+' || c == '-' || c == 'e' || c == 'E' || c == '.')) {
+            break;
+        }
+        number[i] = c;
+    }
+    number[i] = '\0';
+
+    char *end = NULL;
+    double value = strtod(number, &end);
+    if (end == number) {
+        return false;
+    }
+    item->valuedouble = value;
+    if (value >= INT_MAX) {
+        item->valueint = INT_MAX;
+    } else if (value <= (double)INT_MIN) {
+        item->valueint = INT_MIN;
+    } else {
+        item->valueint = (int)value;
+    }
+    item->type = cJSON_Number;
+    input->offset += (size_t)(end - number);
+    return true;
+}
+
+static unsigned parse_hex4(const unsigned char *input)
+{
+    unsigned h = 0;
+    for (int i = 0; i < 4; i++) {
+        unsigned char c = input[i];
+        h <<= 4;
+        if (c >= '0' && c <= '9') {
+            h += c - '0';
+        } else if (c >= 'A' && c <= 'F') {
+            h += 10 + c - 'A';
+        } else if (c >= 'a' && c <= 'f') {
+            h += 10 + c - 'a';
+        } else {
+            return 0;
+        }
+    }
+    return h;
+}
+
+/**
+ * @brief \\uXXXX（含代理对）转成 UTF-8，返回消耗的输入字节数，0 表示非法
+ */
+static unsigned char utf16_to_utf8(const unsigned char *input, const unsigned char *end, unsigned char **output)
+{
+    if (end - input < 6) {
+        return 0;
+    }
+    unsigned first = parse_hex4(input + 2);
+    unsigned long codepoint;
+    unsigned char length = 6;
+    if (first >= 0xDC00 && first <= 0xDFFF) {
+        return 0;
+    }
+    if (first >= 0xD800 && first <= 0xDBFF) {
+        if (end - input < 12 || input[6] != '\\' || input[7] != 'u') {
+            return 0;
+        }
+        unsigned second = parse_hex4(input + 8);
+        if (second < 0xDC00 || second > 0xDFFF) {
+            return 0;
+        }
+        codepoint = 0x10000 + (((first & 0x3FF) << 10) | (second & 0x3FF));
+        length = 12;
+    } else {
+        codepoint = first;
+    }
+
+    unsigned char utf8_length;
+    unsigned char first_byte_mark;
+    if (codepoint < 0x80) {
+        utf8_length = 1;
+        first_byte_mark = 0;
+    } else if (codepoint < 0x800) {
+        utf8_length = 2;
+        first_byte_mark = 0xC0;
+    } else if (codepoint < 0x10000) {
+        utf8_length = 3;
+        first_byte_mark = 0xE0;
+    } else {
+        utf8_length = 4;
+        first_byte_mark = 0xF0;
+    }
+    for (int i = utf8_length - 1; i > 0; i--) {
+        (*output)[i] = (unsigned char)((codepoint | 0x80) & 0xBF);
+        codepoint >>= 6;
+    }
+    (*output)[0] = utf8_length > 1 ? (unsigned char)((codepoint | first_byte_mark) & 0xFF)
+                                   : (unsigned char)(codepoint & 0x7F);
+    *output += utf8_length;
+    return length;
+}
+
+static bool parse_string(cJSON *item, parse_buffer *input)
+{
+    const unsigned char *input_pointer = buffer_at_offset(input) + 1;
+    const unsigned char *input_end = input_pointer;
+    if (buffer_at_offset(input)[0] != '\"') {
+        return false;
+    }
+
+    // 先找到结尾引号并统计转义占用的字节，输出缓冲区按这个长度一次分配
+    size_t skipped_bytes = 0;
+    while ((size_t)(input_end - input->content) < input->length && *input_end != '\"') {
+        if (input_end[0] == '\\') {
+            if ((size_t)(input_end + 1 - input->content) >= input->length) {
+                return false;
+            }
+            skipped_bytes++;
+            input_end++;
+        }
+        input_end++;
+    }
+    if ((size_t)(input_end - input->content) >= input->length || *input_end != '\"') {
+        return false;
+    }
+
+    size_t allocation_length = (size_t)(input_end - buffer_at_offset(input)) - skipped_bytes;
+    unsigned char *output = global_hooks.allocate(allocation_length + 1);
+    if (output == NULL) {
+        return false;
+    }
+
+    unsigned char *output_pointer = output;
+    while (input_pointer < input_end) {
+        if (*input_pointer != '\\') {
+            *output_pointer++ = *input_pointer++;
+            continue;
+        }
+        unsigned char sequence_length = 2;
+        switch (input_pointer[1]) {
+            case 'b':
+                *output_pointer++ = '\b';
+                break;
+            case 'f':
+                *output_pointer++ = '\f';
+                break;
+            case 'n':
+                *output_pointer++ = '\n';
+                break;
+            case 'r':
+                *output_pointer++ = '\r';
+                break;
+            case 't':
+                *output_pointer++ = '\t';
+                break;
+            case '\"':
+            case '\\':
+            case '/':
+                *output_pointer++ = input_pointer[1];
+                break;
+            case 'u':
+                sequence_length = utf16_to_utf8(input_pointer, input_end, &output_pointer);
+                if (sequence_length == 0) {
+                    global_hooks.deallocate(output);
+                    return false;
+                }
+                break;
+            default:
+                global_hooks.deallocate(output);
+                return false;
+        }
+        input_pointer += sequence_length;
+    }
+    *output_pointer = '\0';
+
+    item->type = cJSON_String;
+    item->valuestring = (char *)output;
+    input->offset = (size_t)(input_end - input->content) + 1;
+    return true;
+}
+
+static bool parse_array(cJSON *item, parse_buffer *input)
+{
+    cJSON *head = NULL;
+    cJSON *current = NULL;
+
+    if (input->depth >= CJSON_NESTING_LIMIT) {
+        return false;
+    }
+    input->depth++;
+
+    input->offset++;
+    skip_whitespace(input);
+    if (can_access_at_index(input, 0) && buffer_at_offset(input)[0] == ']') {
+        goto success;
+    }
+    if (!can_access_at_index(input, 0)) {
+        goto fail;
+    }
+
+    input->offset--;
+    do {
+        cJSON *new = new_item();
+        if (new == NULL) {
+            goto fail;
+        }
+        if (head == NULL) {
+            head = current = new;
+        } else {
+            current->next = new;
+            new->prev = current;
+            current = new;
+        }
+
+        input->offset++;
+        skip_whitespace(input);
+        if (!parse_value(current, input)) {
+            goto fail;
+        }
+        skip_whitespace(input);
+    } while (can_access_at_index(input, 0) && buffer_at_offset(input)[0] == ',');
+
+    if (!can_access_at_index(input, 0) || buffer_at_offset(input)[0] != ']') {
+        goto fail;
+    }
+
+success:
+    input->depth--;
+    if (head != NULL) {
+        head->prev = current;
+    }
+    item->type = cJSON_Array;
+    item->child = head;
+    input->offset++;
+    return true;
+
+fail:
+    if (head != NULL) {
+        cJSON_Delete(head);
+    }
+    return false;
+}
+
+static bool parse_object(cJSON *item, parse_buffer *input)
+{
+    cJSON *head = NULL;
+    cJSON *current = NULL;
+
+    if (input->depth >= CJSON_NESTING_LIMIT) {
+        return false;
+    }
+    input->depth++;
+
+    if (!can_access_at_index(input, 0) || buffer_at_offset(input)[0] != '{') {
+        goto fail;
+    }
+    input->offset++;
+    skip_whitespace(input);
+    if (can_access_at_index(input, 0) && buffer_at_offset(input)[0] == '}') {
+        goto success;
+    }
+    if (!can_access_at_index(input, 0)) {
+        goto fail;
+    }
+
+    input->offset--;
+    do {
+        cJSON *new = new_item();
+        if (new == NULL) {
+            goto fail;
+        }
+        if (head == NULL) {
+            head = current = new;
+        } else {
+            current->next = new;
+            new->prev = current;
+            current = new;
+        }
+
+        // 键名先解析成字符串值，再挪到 string
+        input->offset++;
+        skip_whitespace(input);
+        if (!can_access_at_index(input, 0) || !parse_string(current, input)) {
+            goto fail;
+        }
+        skip_whitespace(input);
+        current->string = current->valuestring;
+        current->valuestring = NULL;
+
+        if (!can_access_at_index(input, 0) || buffer_at_offset(input)[0] != ':') {
+            goto fail;
+        }
+        input->offset++;
+        skip_whitespace(input);
+        if (!parse_value(current, input)) {
+            goto fail;
+        }
+        skip_whitespace(input);
+    } while (can_access_at_index(input, 0) && buffer_at_offset(input)[0] == ',');
+
+    if (!can_access_at_index(input, 0) || buffer_at_offset(input)[0] != '}') {
+        goto fail;
+    }
+
+success:
+    input->depth--;
+    if (head != NULL) {
+        head->prev = current;
+    }
+    item->type = cJSON_Object;
+    item->child = head;
+    input->offset++;
+    return true;
+
+fail:
+    if (head != NULL) {
+        cJSON_Delete(head);
+    }
+    return false;
+}
+
+static bool parse_value(cJSON *item, parse_buffer *input)
+{
+    if (!can_access_at_index(input, 0)) {
+        return false;
+    }
+    if (can_read(input, 4) && strncmp((const char *)buffer_at_offset(input), "null", 4) == 0) {
+        item->type = cJSON_NULL;
+        input->offset += 4;
+        return true;
+    }
+    if (can_read(input, 5) && strncmp((const char *)buffer_at_offset(input), "false", 5) == 0) {
+        item->type = cJSON_False;
+        input->offset += 5;
+        return true;
+    }
+    if (can_read(input, 4) && strncmp((const char *)buffer_at_offset(input), "true", 4) == 0) {
+        item->type = cJSON_True;
+        item->valueint = 1;
+        input->offset += 4;
+        return true;
+    }
+
+    unsigned char c = buffer_at_offset(input)[0];
+    if (c == '\"') {
+        return parse_string(item, input);
+    }
+    if (c == '-' || (c >= '0' && c <= '9')) {
+        return parse_number(item, input);
+    }
+    if (c == '[') {
+        return parse_array(item, input);
+    }
+    if (c == '{') {
+        return parse_object(item, input);
+    }
+    return false;
+}
+
+cJSON *cJSON_ParseWithLength(const char *value, size_t buffer_length)
+{
+    if (value == NULL || buffer_length == 0) {
+        return NULL;
+    }
+
+    parse_buffer buffer = {
+        .content = (const unsigned char *)value,
+        .length = buffer_length,
+    };
+    cJSON *item = new_item();
+    if (item == NULL) {
+        return NULL;
+    }
+
+    // 跳过 UTF-8 BOM
+    skip_whitespace(&buffer);
+    if (can_read(&buffer, 3) && strncmp((const char *)buffer_at_offset(&buffer), "\xEF\xBB\xBF", 3) == 0) {
+        buffer.offset += 3;
+    }
+    if (!parse_value(item, &buffer)) {
+        cJSON_Delete(item);
+        return NULL;
+    }
+    return item;
+}
+
+cJSON *cJSON_Parse(const char *value)
+{
+    if (value == NULL) {
+        return NULL;
+    }
+    return cJSON_ParseWithLength(value, strlen(value) + 1);
+}
+
+/* ---------- 打印 ---------- */
+
+typedef struct {
+    unsigned char *buffer;
+    size_t length;
+    size_t offset;
+} printbuffer;
+
+static unsigned char *ensure(printbuffer *p, size_t needed)
+{
+    if (p->buffer == NULL) {
+        return NULL;
+    }
+    needed += p->offset + 1;
+    if (needed <= p->length) {
+        return p->buffer + p->offset;
+    }
+
+    size_t newsize = needed > INT_MAX / 2 ? (size_t)INT_MAX : needed * 2;
+    unsigned char *newbuffer;
+    if (global_hooks.reallocate != NULL) {
+        newbuffer = global_hooks.reallocate(p->buffer, newsize);
+        if (newbuffer == NULL) {
+            global_hooks.deallocate(p->buffer);
+            p->buffer = NULL;
+            return NULL;
+        }
+    } else {
+        newbuffer = global_hooks.allocate(newsize);
+        if (newbuffer == NULL) {
+            global_hooks.deallocate(p->buffer);
+            p->buffer = NULL;
+            return NULL;
+        }
+        memcpy(newbuffer, p->buffer, p->offset + 1);
+        global_hooks.deallocate(p->buffer);
+    }
+    p->length = newsize;
+    p->buffer = newbuffer;
+    return newbuffer + p->offset;
+}
+
+static void update_offset(printbuffer *p)
+{
+    p->offset += strlen((const char *)p->buffer + p->offset);
+}
+
+static bool print_string_ptr(const unsigned char *input, printbuffer *p)
+{
+    if (input == NULL) {
+        input = (const unsigned char *)"";
+    }
+
+    size_t escape_characters = 0;
+    const unsigned char *ip;
+    for (ip = input; *ip; ip++) {
+        switch (*ip) {
+            case '\"':
+            case '\\':
+            case '\b':
+            case '\f':
+            case '\n':
+            case '\r':
+            case '\t':
+                escape_characters++;
+                break;
+            default:
+                if (*ip < 32) {
+                    escape_characters += 5;
+                }
+                break;
+        }
+    }
+    size_t output_length = (size_t)(ip - input) + escape_characters;
+
+    unsigned char *out = ensure(p, output_length + sizeof("\"\""));
+    if (out == NULL) {
+        return false;
+    }
+    *out++ = '\"';
+    for (ip = input; *ip; ip++) {
+        if (*ip > 31 && *ip != '\"' && *ip != '\\') {
+            *out++ = *ip;
+            continue;
+        }
+        *out++ = '\\';
+        switch (*ip) {
+            case '\\':
+                *out++ = '\\';
+                break;
+            case '\"':
+                *out++ = '\"';
+                break;
+            case '\b':
+                *out++ = 'b';
+                break;
+            case '\f':
+                *out++ = 'f';
+                break;
+            case '\n':
+                *out++ = 'n';
+                break;
+            case '\r':
+                *out++ = 'r';
+                break;
+            case '\t':
+                *out++ = 't';
+                break;
+            default:
+                sprintf((char *)out, "u%04x", *ip);
+                out += 5;
+                break;
+        }
+    }
+    *out++ = '\"';
+    *out = '\0';
+    return true;
+}
+
+static bool print_number(const cJSON *item, printbuffer *p)
+{
+    char number[26] = {0};
+    double d = item->valuedouble;
+    int length;
+    if (isnan(d) || isinf(d)) {
+        length = sprintf(number, "null");
+    } else if (d == (double)item->valueint) {
+        length = sprintf(number, "%d", item->valueint);
+    } else {
+        length = sprintf(number, "%1.15g", d);
+        double test = 0;
+        if (sscanf(number, "%lg", &test) != 1 || test != d) {
+            length = sprintf(number, "%1.17g", d);
+        }
+    }
+    if (length < 0 || length > (int)sizeof(number) - 1) {
+        return false;
+    }
+    unsigned char *out = ensure(p, (size_t)length + 1);
+    if (out == NULL) {
+        return false;
+    }
+    memcpy(out, number, (size_t)length + 1);
+    p->offset += (size_t)length;
+    return true;
+}
+
+static bool print_value(const cJSON *item, printbuffer *p);
+
+static bool print_container(const cJSON *item, printbuffer *p, bool object)
+{
+    unsigned char *out = ensure(p, 1);
+    if (out == NULL) {
+        return false;
+    }
+    *out = object ? '{' : '[';
+    p->offset++;
+
+    for (const cJSON *child = item->child; child != NULL; child = child->next) {
+        if (object) {
+            if (!print_string_ptr((const unsigned char *)child->string, p)) {
+                return false;
+            }
+            update_offset(p);
+            out = ensure(p, 1);
+            if (out == NULL) {
+                return false;
+            }
+            *out = ':';
+            p->offset++;
+        }
+        if (!print_value(child, p)) {
+            return false;
+        }
+        update_offset(p);
+        if (child->next != NULL) {
+            out = ensure(p, 1);
+            if (out == NULL) {
+                return false;
+            }
+            *out = ',';
+            p->offset++;
+        }
+    }
+
+    out = ensure(p, 2);
+    if (out == NULL) {
+        return false;
+    }
+    out[0] = object ? '}' : ']';
+    out[1] = '\0';
+    p->offset++;
+    return true;
+}
+
+static bool print_value(const cJSON *item, printbuffer *p)
+{
+    unsigned char *out;
+    switch (item->type & 0xFF) {
+        case cJSON_NULL:
+            out = ensure(p, 5);
+            if (out == NULL) {
+                return false;
+            }
+            strcpy((char *)out, "null");
+            return true;
+        case cJSON_False:
+            out = ensure(p, 6);
+            if (out == NULL) {
+                return false;
+            }
+            strcpy((char *)out, "false");
+            return true;
+        case cJSON_True:
+            out = ensure(p, 5);
+            if (out == NULL) {
+                return false;
+            }
+            strcpy((char *)out, "true");
+            return true;
+        case cJSON_Number:
+            return print_number(item, p);
+        case cJSON_String:
+            return print_string_ptr((const unsigned char *)item->valuestring, p);
+        case cJSON_Array:
+            return print_container(item, p, false);
+        case cJSON_Object:
+            return print_container(item, p, true);
+        default:
+            return false;
+    }
+}
+
+char *cJSON_PrintUnformatted(const cJSON *item)
+{
+    if (item == NULL) {
+        return NULL;
+    }
+
+    printbuffer p = {0};
+    p.length = 256;
+    p.buffer = global_hooks.allocate(p.length);
+    if (p.buffer == NULL) {
+        return NULL;
+    }
+    p.buffer[0] = '\0';
+    if (!print_value(item, &p)) {
+        if (p.buffer != NULL) {
+            global_hooks.deallocate(p.buffer);
+        }
+        return NULL;
+    }
+    update_offset(&p);
+
+    // 缩到实际长度：有 realloc 时原地缩，否则复制到新块
+    char *printed;
+    if (global_hooks.reallocate != NULL) {
+        printed = global_hooks.reallocate(p.buffer, p.offset + 1);
+        if (printed == NULL) {
+            global_hooks.deallocate(p.buffer);
+        }
+    } else {
+        printed = global_hooks.allocate(p.offset + 1);
+        if (printed != NULL) {
+            memcpy(printed, p.buffer, p.offset + 1);
+        }
+        global_hooks.deallocate(p.buffer);
+    }
+    return printed;
+}
+
+/* ---------- 访问和构造 ---------- */
+
+int cJSON_GetArraySize(const cJSON *array)
+{
+    int size = 0;
+    if (array == NULL) {
+        return 0;
+    }
+    for (const cJSON *child = array->child; child != NULL; child = child->next) {
+        size++;
+    }
+    return size;
+}
+
+cJSON *cJSON_GetArrayItem(const cJSON *array, int index)
+{
+    if (array == NULL || index < 0) {
+        return NULL;
+    }
+    cJSON *child = array->child;
+    while (child != NULL && index > 0) {
+        index--;
+        child = child->next;
+    }
+    return child;
+}
+
+static int case_insensitive_strcmp(const unsigned char *a, const unsigned char *b)
+{
+    if (a == b) {
+        return 0;
+    }
+    for (; tolower(*a) == tolower(*b); a++, b++) {
+        if (*a == '\0') {
+            return 0;
+        }
+    }
+    return tolower(*a) - tolower(*b);
+}
+
+cJSON *cJSON_GetObjectItem(const cJSON *const object, const char *const string)
+{
+    if (object == NULL || string == NULL) {
+        return NULL;
+    }
+    cJSON *element = object->child;
+    while (element != NULL &&
+           (element->string == NULL ||
+            case_insensitive_strcmp((const unsigned char *)string, (const unsigned char *)element->string) != 0)) {
+        element = element->next;
+    }
+    return element;
+}
+
+cJSON_bool cJSON_IsBool(const cJSON *const item)
+{
+    return item != NULL && (item->type & (cJSON_True | cJSON_False)) != 0;
+}
+
+cJSON_bool cJSON_IsTrue(const cJSON *const item)
+{
+    return item != NULL && (item->type & 0xFF) == cJSON_True;
+}
+
+cJSON_bool cJSON_IsFalse(const cJSON *const item)
+{
+    return item != NULL && (item->type & 0xFF) == cJSON_False;
+}
+
+cJSON_bool cJSON_IsNumber(const cJSON *const item)
+{
+    return item != NULL && (item->type & 0xFF) == cJSON_Number;
+}
+
+cJSON_bool cJSON_IsString(const cJSON *const item)
+{
+    return item != NULL && (item->type & 0xFF) == cJSON_String;
+}
+
+cJSON_bool cJSON_IsArray(const cJSON *const item)
+{
+    return item != NULL && (item->type & 0xFF) == cJSON_Array;
+}
+
+cJSON_bool cJSON_IsObject(const cJSON *const item)
+{
+    return item != NULL && (item->type & 0xFF) == cJSON_Object;
+}
+
+cJSON *cJSON_CreateObject(void)
+{
+    cJSON *item = new_item();
+    if (item != NULL) {
+        item->type = cJSON_Object;
+    }
+    return item;
+}
+
+cJSON *cJSON_CreateArray(void)
+{
+    cJSON *item = new_item();
+    if (item != NULL) {
+        item->type = cJSON_Array;
+    }
+    return item;
+}
+
+cJSON *cJSON_CreateString(const char *string)
+{
+    cJSON *item = new_item();
+    if (item != NULL) {
+        item->type = cJSON_String;
+        item->valuestring = cjson_strdup(string);
+        if (item->valuestring == NULL) {
+            cJSON_Delete(item);
+            return NULL;
+        }
+    }
+    return item;
+}
+
+cJSON *cJSON_CreateNumber(double num)
+{
+    cJSON *item = new_item();
+    if (item != NULL) {
+        item->type = cJSON_Number;
+        item->valuedouble = num;
+        if (num >= INT_MAX) {
+            item->valueint = INT_MAX;
+        } else if (num <= (double)INT_MIN) {
+            item->valueint = INT_MIN;
+        } else {
+            item->valueint = (int)num;
+        }
+    }
+    return item;
+}
+
+cJSON *cJSON_CreateBool(cJSON_bool boolean)
+{
+    cJSON *item = new_item();
+    if (item != NULL) {
+        item->type = boolean ? cJSON_True : cJSON_False;
+    }
+    return item;
+}
+
+static void suffix_object(cJSON *container, cJSON *item)
+{
+    cJSON *child = container->child;
+    if (child == NULL) {
+        container->child = item;
+        item->prev = item;
+        item->next = NULL;
+    } else {
+        // 与 cJSON 相同：第一个子项的 prev 指向最后一项
+        child->prev->next = item;
+        item->prev = child->prev;
+        child->prev = item;
+    }
+}
+
+cJSON_bool cJSON_AddItemToArray(cJSON *array, cJSON *item)
+{
+    if (array == NULL || item == NULL || array == item) {
+        return 0;
+    }
+    suffix_object(array, item);
+    return 1;
+}
+
+cJSON_bool cJSON_AddItemToObject(cJSON *object, const char *string, cJSON *item)
+{
+    if (object == NULL || string == NULL || item == NULL || object == item) {
+        return 0;
+    }
+    char *new_key = cjson_strdup(string);
+    if (new_key == NULL) {
+        return 0;
+    }
+    if (!(item->type & cJSON_StringIsConst) && item->string != NULL) {
+        global_hooks.deallocate(item->string);
+    }
+    item->string = new_key;
+    item->type &= ~cJSON_StringIsConst;
+    suffix_object(object, item);
+    return 1;
+}
+
+cJSON *cJSON_AddStringToObject(cJSON *const object, const char *const name, const char *const string)
+{
+    cJSON *item = cJSON_CreateString(string);
+    if (cJSON_AddItemToObject(object, name, item)) {
+        return item;
+    }
+    cJSON_Delete(item);
+    return NULL;
+}
+
+cJSON *cJSON_AddNumberToObject(cJSON *const object, const char *const name, const double number)
+{
+    cJSON *item = cJSON_CreateNumber(number);
+    if (cJSON_AddItemToObject(object, name, item)) {
+        return item;
+    }
+    cJSON_Delete(item);
+    return NULL;
+}
+
+cJSON *cJSON_AddBoolToObject(cJSON *const object, const char *const name, const cJSON_bool boolean)
+{
+    cJSON *item = cJSON_CreateBool(boolean);
+    if (cJSON_AddItemToObject(object, name, item)) {
+        return item;
+    }
+    cJSON_Delete(item);
+    return NULL;
+}
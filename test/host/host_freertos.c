@@ -0,0 +1,133 @@
+/**
+ * @file host_freertos.c
+ * @brief 主机测试用：网络模块用到的 FreeRTOS 接口
+ *
+ * 互斥锁用 pthread 递归锁实现，队列是加锁的环形缓冲区；vTaskDelay 只推进模拟时钟；
+ * app_tasks_create 只登记任务，不启动（后台任务的循环由测试直接驱动需要的部分）。
+ */
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "app_tasks.h"
+
+struct host_semaphore {
+    pthread_mutex_t mutex;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    SemaphoreHandle_t sem = malloc(sizeof(*sem));
+    if (sem != NULL) {
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+        pthread_mutex_init(&sem->mutex, &attr);
+        pthread_mutexattr_destroy(&attr);
+    }
+    return sem;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    (void)ticks;
+    pthread_mutex_lock(&sem->mutex);
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    pthread_mutex_unlock(&sem->mutex);
+    return pdTRUE;
+}
+
+struct host_queue {
+    pthread_mutex_t mutex;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+    uint8_t *items;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    QueueHandle_t queue = calloc(1, sizeof(*queue));
+    if (queue == NULL) {
+        return NULL;
+    }
+    queue->items = malloc((size_t)length * item_size);
+    if (queue->items == NULL) {
+        free(queue);
+        return NULL;
+    }
+    pthread_mutex_init(&queue->mutex, NULL);
+    queue->length = length;
+    queue->item_size = item_size;
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    (void)ticks;
+    BaseType_t ok = pdFALSE;
+    pthread_mutex_lock(&queue->mutex);
+    if (queue->count < queue->length) {
+        UBaseType_t tail = (queue->head + queue->count) % queue->length;
+        memcpy(queue->items + (size_t)tail * queue->item_size, item, queue->item_size);
+        queue->count++;
+        ok = pdTRUE;
+    }
+    pthread_mutex_unlock(&queue->mutex);
+    return ok;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks)
+{
+    (void)ticks;
+    BaseType_t ok = pdFALSE;
+    pthread_mutex_lock(&queue->mutex);
+    if (queue->count > 0) {
+        memcpy(item, queue->items + (size_t)queue->head * queue->item_size, queue->item_size);
+        queue->head = (queue->head + 1) % queue->length;
+        queue->count--;
+        ok = pdTRUE;
+    }
+    pthread_mutex_unlock(&queue->mutex);
+    return ok;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    pthread_mutex_lock(&queue->mutex);
+    UBaseType_t count = queue->count;
+    pthread_mutex_unlock(&queue->mutex);
+    return count;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    host_time_us += (int64_t)ticks * 1000;
+}
+
+esp_err_t app_tasks_create(TaskFunction_t fn, const char *name, uint32_t stack_size,
+                           UBaseType_t priority, int core, TaskHandle_t *handle)
+{
+    (void)fn;
+    (void)name;
+    (void)stack_size;
+    (void)priority;
+    (void)core;
+    // 非空句柄：调用方据此认为任务已创建
+    static char task_tag;
+    if (handle != NULL) {
+        *handle = (TaskHandle_t)&task_tag;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,223 @@
+/**
+ * @file host_heap.c
+ * @brief 主机测试用：两个区域的 heap_caps 模拟
+ *
+ * 每块前面加一个头记录区域和请求的大小，heap_caps_get_allocated_size 返回请求的大小
+ * （真实的堆会向上取整，测试只关心增减是否对称）。加锁以便多线程测试直接使用。
+ */
+
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "esp_heap_caps.h"
+#include "esp_memory_utils.h"
+
+#define HEAP_MAGIC 0x48454150u
+
+typedef struct {
+    alignas(16) uint32_t magic;
+    uint8_t psram;
+    size_t size;
+} block_hdr_t;
+
+typedef struct {
+    size_t capacity;
+    size_t used;
+    size_t min_free;
+    size_t blocks;
+    uint32_t alloc_calls;
+} region_t;
+
+// 与 ESP32-S3 大致相同的量级，测试可调
+#define DEFAULT_INTERNAL_CAPACITY (320 * 1024)
+#define DEFAULT_PSRAM_CAPACITY    (8 * 1024 * 1024)
+
+static region_t regions[2] = {
+    {.capacity = DEFAULT_INTERNAL_CAPACITY, .min_free = DEFAULT_INTERNAL_CAPACITY},
+    {.capacity = DEFAULT_PSRAM_CAPACITY, .min_free = DEFAULT_PSRAM_CAPACITY},
+};
+static int fail_countdown[2] = {-1, -1};
+static pthread_mutex_t heap_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int caps_region(uint32_t caps)
+{
+    return (caps & MALLOC_CAP_SPIRAM) ? 1 : 0;
+}
+
+static block_hdr_t *hdr_of(const void *ptr)
+{
+    return (block_hdr_t *)ptr - 1;
+}
+
+/**
+ * @brief 在区域中占用 size 字节，超出容量或按设定失败时返回 false（调用方持锁）
+ */
+static bool region_take(int r, size_t size)
+{
+    region_t *region = &regions[r];
+    if (fail_countdown[r] == 0) {
+        return false;
+    }
+    if (fail_countdown[r] > 0) {
+        fail_countdown[r]--;
+    }
+    if (region->capacity - region->used < size) {
+        return false;
+    }
+    region->used += size;
+    region->blocks++;
+    region->alloc_calls++;
+    if (region->capacity - region->used < region->min_free) {
+        region->min_free = region->capacity - region->used;
+    }
+    return true;
+}
+
+static void region_give(int r, size_t size)
+{
+    regions[r].used -= size;
+    regions[r].blocks--;
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    int r = caps_region(caps);
+    pthread_mutex_lock(&heap_lock);
+    bool ok = region_take(r, size);
+    pthread_mutex_unlock(&heap_lock);
+    if (!ok) {
+        return NULL;
+    }
+
+    block_hdr_t *hdr = malloc(sizeof(block_hdr_t) + (size > 0 ? size : 1));
+    if (hdr == NULL) {
+        pthread_mutex_lock(&heap_lock);
+        region_give(r, size);
+        pthread_mutex_unlock(&heap_lock);
+        return NULL;
+    }
+    hdr->magic = HEAP_MAGIC;
+    hdr->psram = (uint8_t)r;
+    hdr->size = size;
+    return hdr + 1;
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    if (size != 0 && n > SIZE_MAX / size) {
+        return NULL;
+    }
+    void *ptr = heap_caps_malloc(n * size, caps);
+    if (ptr != NULL) {
+        memset(ptr, 0, n * size);
+    }
+    return ptr;
+}
+
+void heap_caps_free(void *ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+    block_hdr_t *hdr = hdr_of(ptr);
+    if (hdr->magic != HEAP_MAGIC) {
+        fprintf(stderr, "heap_caps_free: %p 不是模拟堆的块\n", ptr);
+        abort();
+    }
+    pthread_mutex_lock(&heap_lock);
+    region_give(hdr->psram, hdr->size);
+    pthread_mutex_unlock(&heap_lock);
+    hdr->magic = 0;
+    free(hdr);
+}
+
+void *heap_caps_realloc(void *ptr, size_t size, uint32_t caps)
+{
+    if (ptr == NULL) {
+        return heap_caps_malloc(size, caps);
+    }
+    if (size == 0) {
+        heap_caps_free(ptr);
+        return NULL;
+    }
+
+    // 与 IDF 相同：区域不符或需要扩容时分配新块并复制，失败时原块保持不变
+    size_t old_size = hdr_of(ptr)->size;
+    void *grown = heap_caps_malloc(size, caps);
+    if (grown == NULL) {
+        return NULL;
+    }
+    memcpy(grown, ptr, old_size < size ? old_size : size);
+    heap_caps_free(ptr);
+    return grown;
+}
+
+size_t heap_caps_get_allocated_size(void *ptr)
+{
+    return ptr != NULL ? hdr_of(ptr)->size : 0;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    const region_t *region = &regions[caps_region(caps)];
+    return region->capacity - region->used;
+}
+
+void heap_caps_get_info(multi_heap_info_t *info, uint32_t caps)
+{
+    const region_t *region = &regions[caps_region(caps)];
+    memset(info, 0, sizeof(*info));
+    pthread_mutex_lock(&heap_lock);
+    info->total_allocated_bytes = region->used;
+    info->total_free_bytes = region->capacity - region->used;
+    info->largest_free_block = info->total_free_bytes;
+    info->minimum_free_bytes = region->min_free;
+    info->allocated_blocks = region->blocks;
+    info->total_blocks = region->blocks + 1;
+    info->free_blocks = 1;
+    pthread_mutex_unlock(&heap_lock);
+}
+
+bool esp_ptr_external_ram(const void *p)
+{
+    return p != NULL && hdr_of(p)->magic == HEAP_MAGIC && hdr_of(p)->psram;
+}
+
+void host_heap_set_capacity(bool psram, size_t bytes)
+{
+    pthread_mutex_lock(&heap_lock);
+    regions[psram].capacity = bytes;
+    regions[psram].min_free = bytes > regions[psram].used ? bytes - regions[psram].used : 0;
+    pthread_mutex_unlock(&heap_lock);
+}
+
+void host_heap_fail_after(bool psram, int count)
+{
+    pthread_mutex_lock(&heap_lock);
+    fail_countdown[psram] = count;
+    pthread_mutex_unlock(&heap_lock);
+}
+
+void host_heap_reset_limits(void)
+{
+    pthread_mutex_lock(&heap_lock);
+    for (int r = 0; r < 2; r++) {
+        regions[r].capacity = r ? DEFAULT_PSRAM_CAPACITY : DEFAULT_INTERNAL_CAPACITY;
+        regions[r].min_free = regions[r].capacity - regions[r].used;
+        fail_countdown[r] = -1;
+    }
+    pthread_mutex_unlock(&heap_lock);
+}
+
+size_t host_heap_used(bool psram)
+{
+    return regions[psram].used;
+}
+
+uint32_t host_heap_alloc_calls(bool psram)
+{
+    return regions[psram].alloc_calls;
+}
@@ -0,0 +1,460 @@
+/**
+ * @file host_http.c
+ * @brief 主机测试用：esp_http_client 替身和脚本化服务器
+ *
+ * 只模拟 todo_client 依赖的行为：长连接复用、换主机时重连、服务器关闭空闲连接后
+ * 下一次复用失败、TLS 会话保存与恢复、响应头和分块的响应体事件。
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "host_http.h"
+#include "host_test.h"
+#include "esp_crt_bundle.h"
+#include "lwip/netdb.h"
+
+#define CLIENT_MAX_HEADERS 8
+#define ORIGIN_MAX_LEN     128
+
+typedef struct {
+    char origin[ORIGIN_MAX_LEN];
+    uint32_t full_ms;
+    uint32_t resumed_ms;
+    host_http_handler_t handler;
+    void *ctx;
+    bool down;
+    uint32_t generation;        // 关闭连接时加一，之前建立的长连接作废
+    host_http_stats_t stats;
+} server_t;
+
+struct esp_http_client {
+    char *url;
+    esp_http_client_method_t method;
+    int timeout_ms;
+    http_event_handle_cb event_handler;
+    void *user_data;
+    bool save_client_session;
+    char *headers[CLIENT_MAX_HEADERS][2];
+    const char *post_data;
+    int post_len;
+    int status;
+    int conn_server;            // 当前长连接所在服务器，-1 表示没有连接
+    uint32_t conn_generation;
+    uint32_t conn_epoch;
+    int session_server;          // 保存的 TLS 会话属于哪个服务器
+    uint32_t session_epoch;
+    host_http_response_t stream; // 流式读取中的响应
+    size_t stream_offset;
+};
+
+static server_t servers[HOST_HTTP_MAX_SERVERS];
+static int server_count = 0;
+static uint32_t epoch = 0;      // host_http_reset 时加一，所有连接和会话作废
+static uint32_t dns_ms = 0;
+
+void host_http_reset(void)
+{
+    memset(servers, 0, sizeof(servers));
+    server_count = 0;
+    dns_ms = 0;
+    epoch++;
+}
+
+static server_t *find_server(const char *origin)
+{
+    for (int i = 0; i < server_count; i++) {
+        if (strcmp(servers[i].origin, origin) == 0) {
+            return &servers[i];
+        }
+    }
+    return NULL;
+}
+
+void host_http_add_server(const char *origin, uint32_t full_ms, uint32_t resumed_ms,
+                          host_http_handler_t handler, void *ctx)
+{
+    if (server_count >= HOST_HTTP_MAX_SERVERS) {
+        return;
+    }
+    server_t *s = &servers[server_count++];
+    memset(s, 0, sizeof(*s));
+    strlcpy(s->origin, origin, sizeof(s->origin));
+    s->full_ms = full_ms;
+    s->resumed_ms = resumed_ms;
+    s->handler = handler;
+    s->ctx = ctx;
+}
+
+void host_http_set_down(const char *origin, bool down)
+{
+    server_t *s = find_server(origin);
+    if (s != NULL) {
+        s->down = down;
+        s->generation++;
+    }
+}
+
+void host_http_drop_connections(const char *origin)
+{
+    server_t *s = find_server(origin);
+    if (s != NULL) {
+        s->generation++;
+    }
+}
+
+void host_http_set_dns_ms(uint32_t ms)
+{
+    dns_ms = ms;
+}
+
+const host_http_stats_t *host_http_get_stats(const char *origin)
+{
+    server_t *s = find_server(origin);
+    return s != NULL ? &s->stats : NULL;
+}
+
+static void advance_ms(uint32_t ms)
+{
+    host_time_us += (int64_t)ms * 1000;
+}
+
+/**
+ * @brief 拆出 URL 的源地址（scheme://host[:port]），返回路径部分
+ */
+static const char *split_origin(const char *url, char *origin, size_t size)
+{
+    const char *host = strstr(url, "://");
+    const char *path = host != NULL ? host + 3 + strcspn(host + 3, "/?") : url + strlen(url);
+    size_t len = (size_t)(path - url);
+    if (len >= size) {
+        len = size - 1;
+    }
+    memcpy(origin, url, len);
+    origin[len] = '\0';
+    return *path != '\0' ? path : "/";
+}
+
+static void dispatch(esp_http_client_handle_t client, esp_http_client_event_id_t id,
+                     void *data, int data_len, const char *key, const char *value)
+{
+    if (client->event_handler == NULL) {
+        return;
+    }
+    esp_http_client_event_t evt = {
+        .event_id = id,
+        .client = client,
+        .data = data,
+        .data_len = data_len,
+        .user_data = client->user_data,
+        .header_key = (char *)key,
+        .header_value = (char *)value,
+    };
+    client->event_handler(&evt);
+}
+
+static char *dup_string(const char *s)
+{
+    size_t len = strlen(s) + 1;
+    char *copy = malloc(len);
+    memcpy(copy, s, len);
+    return copy;
+}
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config)
+{
+    esp_http_client_handle_t client = calloc(1, sizeof(*client));
+    if (client == NULL) {
+        return NULL;
+    }
+    client->url = dup_string(config->url != NULL ? config->url : "");
+    client->method = config->method;
+    client->timeout_ms = config->timeout_ms > 0 ? config->timeout_ms : 5000;
+    client->event_handler = config->event_handler;
+    client->user_data = config->user_data;
+    client->save_client_session = config->save_client_session;
+    client->conn_server = -1;
+    client->session_server = -1;
+    return client;
+}
+
+esp_err_t esp_http_client_set_url(esp_http_client_handle_t client, const char *url)
+{
+    free(client->url);
+    client->url = dup_string(url);
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_method(esp_http_client_handle_t client, esp_http_client_method_t method)
+{
+    client->method = method;
+    return ESP_OK;
+}
+
+static const char *get_header(esp_http_client_handle_t client, const char *key)
+{
+    for (int i = 0; i < CLIENT_MAX_HEADERS; i++) {
+        if (client->headers[i][0] != NULL && strcasecmp(client->headers[i][0], key) == 0) {
+            return client->headers[i][1];
+        }
+    }
+    return NULL;
+}
+
+esp_err_t esp_http_client_delete_header(esp_http_client_handle_t client, const char *key)
+{
+    for (int i = 0; i < CLIENT_MAX_HEADERS; i++) {
+        if (client->headers[i][0] != NULL && strcasecmp(client->headers[i][0], key) == 0) {
+            free(client->headers[i][0]);
+            free(client->headers[i][1]);
+            client->headers[i][0] = NULL;
+            client->headers[i][1] = NULL;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char *key, const char *value)
+{
+    esp_http_client_delete_header(client, key);
+    for (int i = 0; i < CLIENT_MAX_HEADERS; i++) {
+        if (client->headers[i][0] == NULL) {
+            client->headers[i][0] = dup_string(key);
+            client->headers[i][1] = dup_string(value);
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_http_client_set_post_field(esp_http_client_handle_t client, const char *data, int len)
+{
+    client->post_data = data;
+    client->post_len = len;
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_user_data(esp_http_client_handle_t client, void *data)
+{
+    client->user_data = data;
+    return ESP_OK;
+}
+
+int esp_http_client_get_status_code(esp_http_client_handle_t client)
+{
+    return client->status;
+}
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t client)
+{
+    if (client->conn_server >= 0) {
+        client->conn_server = -1;
+        dispatch(client, HTTP_EVENT_DISCONNECTED, NULL, 0, NULL, NULL);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client)
+{
+    esp_http_client_close(client);
+    for (int i = 0; i < CLIENT_MAX_HEADERS; i++) {
+        free(client->headers[i][0]);
+        free(client->headers[i][1]);
+    }
+    free(client->url);
+    free(client);
+    return ESP_OK;
+}
+
+/**
+ * @brief 确保到 server 的连接可用：复用长连接，或新建连接并触发 ON_CONNECTED
+ */
+static esp_err_t connect_to(esp_http_client_handle_t client, int index)
+{
+    server_t *s = &servers[index];
+    bool reusable = client->conn_server == index && client->conn_epoch == epoch;
+    if (reusable && client->conn_generation == s->generation) {
+        return ESP_OK;
+    }
+    if (reusable) {
+        // 服务器已经关掉这条连接：请求写出去后读到对端关闭
+        client->conn_server = -1;
+        advance_ms(1);
+        return ESP_ERR_HTTP_FETCH_HEADER;
+    }
+    // 换了主机，旧连接由 esp_http_client 自己关闭
+    esp_http_client_close(client);
+
+    s->stats.connects++;
+    if (s->down) {
+        s->stats.refused++;
+        advance_ms((uint32_t)client->timeout_ms);
+        return ESP_ERR_HTTP_CONNECT;
+    }
+
+    bool tls = strncmp(s->origin, "https://", 8) == 0;
+    bool resume = tls && client->session_server == index && client->session_epoch == epoch;
+    if (resume) {
+        s->stats.resumed++;
+    }
+    advance_ms(resume ? s->resumed_ms : s->full_ms);
+    if (tls && client->save_client_session) {
+        client->session_server = index;
+        client->session_epoch = epoch;
+    }
+
+    client->conn_server = index;
+    client->conn_generation = s->generation;
+    client->conn_epoch = epoch;
+    dispatch(client, HTTP_EVENT_ON_CONNECTED, NULL, 0, NULL, NULL);
+    return ESP_OK;
+}
+
+/**
+ * @brief 连接服务器、把请求交给处理函数并触发 HEADERS_SENT
+ */
+static esp_err_t send_request(esp_http_client_handle_t client, host_http_response_t *resp)
+{
+    char origin[ORIGIN_MAX_LEN];
+    const char *path = split_origin(client->url, origin, sizeof(origin));
+    client->status = 0;
+
+    int index = -1;
+    for (int i = 0; i < server_count; i++) {
+        if (strcmp(servers[i].origin, origin) == 0) {
+            index = i;
+        }
+    }
+    if (index < 0) {
+        advance_ms((uint32_t)client->timeout_ms);
+        return ESP_ERR_HTTP_CONNECT;
+    }
+
+    esp_err_t err = connect_to(client, index);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    server_t *s = &servers[index];
+    s->stats.requests++;
+    host_http_request_t req = {
+        .client = client,
+        .method = client->method,
+        .path = path,
+        .accept = get_header(client, "Accept"),
+        .api_key = get_header(client, "X-API-Key"),
+        .body = client->post_len > 0 ? client->post_data : NULL,
+        .body_len = client->post_len,
+    };
+    memset(resp, 0, sizeof(*resp));
+    s->handler(&req, resp, s->ctx);
+    dispatch(client, HTTP_EVENT_HEADERS_SENT, NULL, 0, NULL, NULL);
+    return ESP_OK;
+}
+
+/**
+ * @brief 等待首字节并触发响应头事件
+ */
+static esp_err_t receive_headers(esp_http_client_handle_t client, const host_http_response_t *resp)
+{
+    if (resp->err != ESP_OK) {
+        // 服务器不响应：等满超时
+        advance_ms((uint32_t)client->timeout_ms);
+        return resp->err;
+    }
+
+    advance_ms(resp->wait_ms);
+    client->status = resp->status;
+    for (int i = 0; i < HOST_HTTP_MAX_HEADERS && resp->headers[i][0] != NULL; i++) {
+        dispatch(client, HTTP_EVENT_ON_HEADER, NULL, 0, resp->headers[i][0], resp->headers[i][1]);
+    }
+    return ESP_OK;
+}
+
+const char *host_http_request_header(const host_http_request_t *req, const char *key)
+{
+    return get_header(req->client, key);
+}
+
+esp_err_t esp_http_client_perform(esp_http_client_handle_t client)
+{
+    host_http_response_t resp;
+    esp_err_t err = send_request(client, &resp);
+    if (err == ESP_OK) {
+        err = receive_headers(client, &resp);
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    if (client->method != HTTP_METHOD_HEAD && resp.body_len > 0) {
+        size_t chunks = (resp.body_len + HOST_HTTP_CHUNK_SIZE - 1) / HOST_HTTP_CHUNK_SIZE;
+        size_t offset = 0;
+        for (size_t i = 0; i < chunks; i++) {
+            size_t n = resp.body_len - offset < HOST_HTTP_CHUNK_SIZE ? resp.body_len - offset : HOST_HTTP_CHUNK_SIZE;
+            // 传输耗时按块均摊
+            host_time_us += (int64_t)resp.transfer_ms * 1000 / (int64_t)chunks;
+            dispatch(client, HTTP_EVENT_ON_DATA, (uint8_t *)resp.body + offset, (int)n, NULL, NULL);
+            offset += n;
+        }
+    } else {
+        advance_ms(resp.transfer_ms);
+    }
+    dispatch(client, HTTP_EVENT_ON_FINISH, NULL, 0, NULL, NULL);
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_open(esp_http_client_handle_t client, int write_len)
+{
+    (void)write_len;
+    client->stream_offset = 0;
+    return send_request(client, &client->stream);
+}
+
+int64_t esp_http_client_fetch_headers(esp_http_client_handle_t client)
+{
+    if (receive_headers(client, &client->stream) != ESP_OK) {
+        return -1;
+    }
+    return (int64_t)client->stream.body_len;
+}
+
+int esp_http_client_read(esp_http_client_handle_t client, char *buffer, int len)
+{
+    host_http_response_t *resp = &client->stream;
+    size_t remaining = resp->body_len - client->stream_offset;
+    if (remaining == 0 || len <= 0) {
+        // 服务器关闭了连接
+        client->conn_server = -1;
+        return 0;
+    }
+
+    size_t n = remaining < (size_t)len ? remaining : (size_t)len;
+    if (resp->body_len > 0) {
+        host_time_us += (int64_t)resp->transfer_ms * 1000 * (int64_t)n / (int64_t)resp->body_len;
+    }
+    memcpy(buffer, (const uint8_t *)resp->body + client->stream_offset, n);
+    client->stream_offset += n;
+    return (int)n;
+}
+
+esp_err_t esp_crt_bundle_attach(void *conf)
+{
+    (void)conf;
+    return ESP_OK;
+}
+
+int host_getaddrinfo(const char *node, const char *service, const struct addrinfo *hints, struct addrinfo **res)
+{
+    (void)node;
+    (void)service;
+    (void)hints;
+    advance_ms(dns_ms);
+    *res = NULL;
+    return 0;
+}
+
+void host_freeaddrinfo(struct addrinfo *res)
+{
+    (void)res;
+}
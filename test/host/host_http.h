@@ -0,0 +1,102 @@
+/**
+ * @file host_http.h
+ * @brief 主机测试用：esp_http_client 替身背后的脚本化服务器
+ *
+ * 服务器按源地址（"http://10.0.0.2:5000"）登记，esp_http_client_perform 把请求交给
+ * 对应的处理函数，并按 esp_http_client 的顺序触发事件：新建连接时 ON_CONNECTED，
+ * 然后 HEADERS_SENT、逐个 ON_HEADER、按 512 字节分块的 ON_DATA。
+ * 流式接口（open/fetch_headers/read）同样由处理函数一次给出完整响应，read 逐段读出，
+ * 读完即视为服务器关闭了连接。
+ * 模拟时钟 host_time_us 按握手、等待首字节和传输耗时推进，不出网。
+ */
+
+#ifndef HOST_HTTP_H
+#define HOST_HTTP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_http_client.h"
+
+#define HOST_HTTP_MAX_SERVERS   4
+#define HOST_HTTP_MAX_HEADERS   4
+#define HOST_HTTP_CHUNK_SIZE    512     // esp_http_client 默认 buffer_size，每次 ON_DATA 最多这么多
+
+/**
+ * @brief 服务器收到的请求
+ */
+typedef struct {
+    esp_http_client_handle_t client;
+    esp_http_client_method_t method;
+    const char *path;           // 源地址之后的部分（含查询参数）
+    const char *accept;         // Accept 请求头，没有时为 NULL
+    const char *api_key;        // X-API-Key 请求头
+    const char *body;           // POST 请求体，没有时为 NULL
+    int body_len;
+} host_http_request_t;
+
+/**
+ * @brief 处理函数填写的响应（调用前已清零）
+ */
+typedef struct {
+    esp_err_t err;              // 非 ESP_OK：等满超时后 perform 返回该错误，不触发响应事件
+    int status;
+    const char *headers[HOST_HTTP_MAX_HEADERS][2];
+    const void *body;           // 处理函数返回后仍须有效
+    size_t body_len;
+    uint32_t wait_ms;           // 请求发出到首字节
+    uint32_t transfer_ms;       // 首字节到收完
+} host_http_response_t;
+
+/**
+ * @brief 请求头（不区分大小写），没有时返回 NULL
+ */
+const char *host_http_request_header(const host_http_request_t *req, const char *key);
+
+typedef void (*host_http_handler_t)(const host_http_request_t *req, host_http_response_t *resp, void *ctx);
+
+/**
+ * @brief 服务器统计
+ */
+typedef struct {
+    uint32_t requests;
+    uint32_t connects;          // 新建连接（含失败的尝试）
+    uint32_t resumed;           // 其中带已保存 TLS 会话的握手
+    uint32_t refused;           // 下线时被拒绝的连接
+} host_http_stats_t;
+
+/**
+ * @brief 清除所有服务器和统计（已创建的客户端照常可用，连接全部作废）
+ */
+void host_http_reset(void);
+
+/**
+ * @brief 登记服务器
+ * @param origin 源地址，与请求URL的 scheme://host[:port] 部分逐字比较
+ * @param full_ms 新建连接耗时（https 时为完整握手）
+ * @param resumed_ms https 且客户端带上次保存的会话时的握手耗时
+ */
+void host_http_add_server(const char *origin, uint32_t full_ms, uint32_t resumed_ms,
+                          host_http_handler_t handler, void *ctx);
+
+/**
+ * @brief 服务器下线：新连接等满超时后失败，已有长连接在下一次请求时失效
+ */
+void host_http_set_down(const char *origin, bool down);
+
+/**
+ * @brief 服务器关闭所有空闲长连接（客户端下一次复用时读到连接已断开）
+ */
+void host_http_drop_connections(const char *origin);
+
+/**
+ * @brief DNS 解析耗时（默认 0）
+ */
+void host_http_set_dns_ms(uint32_t ms);
+
+/**
+ * @brief 服务器统计，没有登记时返回 NULL
+ */
+const host_http_stats_t *host_http_get_stats(const char *origin);
+
+#endif
@@ -0,0 +1,247 @@
+/**
+ * @file host_lcd.c
+ * @brief 主机测试用：spi_master、GPIO 和 LEDC 替身（见 host_lcd.h），esp_lcd 面板 IO 替身在 host_lcd_io.c
+ */
+
+#include <string.h>
+#include "host_lcd.h"
+#include "driver/gpio.h"
+#include "driver/ledc.h"
+#include "driver/spi_master.h"
+
+#define MAX_GPIO    64
+#define MAX_QUEUE   64
+
+struct spi_device_t {
+    spi_device_interface_config_t config;
+};
+
+typedef struct {
+    spi_transaction_t *trans;
+    uint32_t checksum;
+} queued_t;
+
+static struct spi_device_t device;
+static queued_t queue[MAX_QUEUE];
+static int queue_head = 0;
+static int queue_count = 0;
+static host_spi_stats_t stats;
+static int dc_pin = -1;
+static uint32_t gpio_levels[MAX_GPIO];
+static uint32_t ledc_duty = 0;
+static gpio_isr_t isr_handlers[MAX_GPIO];
+static void *isr_args[MAX_GPIO];
+
+void host_spi_reset(int dc_gpio)
+{
+    queue_head = 0;
+    queue_count = 0;
+    memset(&stats, 0, sizeof(stats));
+    memset(gpio_levels, 0, sizeof(gpio_levels));
+    dc_pin = dc_gpio;
+    host_panel_reset();
+}
+
+int host_spi_pending(void)
+{
+    return queue_count;
+}
+
+const host_spi_stats_t *host_spi_get_stats(void)
+{
+    return &stats;
+}
+
+bool host_gpio_trigger(int gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= MAX_GPIO || isr_handlers[gpio_num] == NULL) {
+        return false;
+    }
+    isr_handlers[gpio_num](isr_args[gpio_num]);
+    return true;
+}
+
+uint32_t host_ledc_duty(void)
+{
+    return ledc_duty;
+}
+
+static const uint8_t *tx_bytes(const spi_transaction_t *t)
+{
+    return (t->flags & SPI_TRANS_USE_TXDATA) ? t->tx_data : t->tx_buffer;
+}
+
+// FNV-1a，用于发现排队期间被改写的缓冲区
+static uint32_t checksum(const spi_transaction_t *t)
+{
+    const uint8_t *p = tx_bytes(t);
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < t->length / 8; i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+}
+
+/**
+ * @brief 传输上总线：pre_cb 设置 DC 后按当时的电平交给面板
+ */
+static void execute(spi_transaction_t *t)
+{
+    if (device.config.pre_cb != NULL) {
+        device.config.pre_cb(t);
+    }
+    size_t len = t->length / 8;
+    int dc = dc_pin >= 0 ? (int)gpio_levels[dc_pin] : 1;
+    host_panel_write(dc, tx_bytes(t), len);
+
+    stats.transactions++;
+    stats.bytes += len;
+    if (device.config.clock_speed_hz > 0) {
+        stats.bus_ns += (uint64_t)len * 8 * 1000000000ull / (uint64_t)device.config.clock_speed_hz;
+    }
+}
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t *config, int dma_chan)
+{
+    (void)host;
+    (void)config;
+    (void)dma_chan;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t *config,
+                             spi_device_handle_t *handle)
+{
+    (void)host;
+    device.config = *config;
+    *handle = &device;
+    return ESP_OK;
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle, spi_transaction_t *trans, TickType_t ticks)
+{
+    (void)ticks;
+    if (queue_count >= handle->config.queue_size || queue_count >= MAX_QUEUE) {
+        stats.overflows++;
+        return ESP_ERR_TIMEOUT;
+    }
+    queued_t *q = &queue[(queue_head + queue_count) % MAX_QUEUE];
+    q->trans = trans;
+    q->checksum = checksum(trans);
+    queue_count++;
+    if ((uint32_t)queue_count > stats.max_queued) {
+        stats.max_queued = queue_count;
+    }
+    return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle, spi_transaction_t **trans, TickType_t ticks)
+{
+    (void)handle;
+    (void)ticks;
+    if (queue_count == 0) {
+        return ESP_ERR_TIMEOUT;
+    }
+    queued_t *q = &queue[queue_head];
+    queue_head = (queue_head + 1) % MAX_QUEUE;
+    queue_count--;
+
+    if (checksum(q->trans) != q->checksum) {
+        stats.hazards++;
+    }
+    execute(q->trans);
+    *trans = q->trans;
+    return ESP_OK;
+}
+
+esp_err_t spi_device_polling_transmit(spi_device_handle_t handle, spi_transaction_t *trans)
+{
+    (void)handle;
+    // 队列里的传输先发完
+    while (queue_count > 0) {
+        spi_transaction_t *done;
+        spi_device_get_trans_result(handle, &done, portMAX_DELAY);
+    }
+    execute(trans);
+    stats.polling++;
+    return ESP_OK;
+}
+
+esp_err_t gpio_config(const gpio_config_t *config)
+{
+    (void)config;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    if (gpio_num >= 0 && gpio_num < MAX_GPIO) {
+        gpio_levels[gpio_num] = level;
+    }
+    return ESP_OK;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num)
+{
+    return gpio_set_level(gpio_num, 0);
+}
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags)
+{
+    (void)intr_alloc_flags;
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void *args)
+{
+    if (gpio_num < 0 || gpio_num >= MAX_GPIO) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    isr_handlers[gpio_num] = isr_handler;
+    isr_args[gpio_num] = args;
+    return ESP_OK;
+}
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t *config)
+{
+    (void)config;
+    return ESP_OK;
+}
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t *config)
+{
+    ledc_duty = config->duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_duty(ledc_mode_t mode, ledc_channel_t channel, uint32_t duty)
+{
+    (void)mode;
+    (void)channel;
+    ledc_duty = duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_update_duty(ledc_mode_t mode, ledc_channel_t channel)
+{
+    (void)mode;
+    (void)channel;
+    return ESP_OK;
+}
+
+esp_err_t ledc_fade_func_install(int intr_alloc_flags)
+{
+    (void)intr_alloc_flags;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_fade_time_and_start(ledc_mode_t mode, ledc_channel_t channel, uint32_t target_duty,
+                                       uint32_t max_fade_time_ms, ledc_fade_mode_t fade_mode)
+{
+    (void)mode;
+    (void)channel;
+    (void)max_fade_time_ms;
+    (void)fade_mode;
+    ledc_duty = target_duty;
+    return ESP_OK;
+}
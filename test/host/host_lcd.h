@@ -0,0 +1,156 @@
+/**
+ * @file host_lcd.h
+ * @brief 主机测试用：SPI 主机、esp_lcd 面板 IO、GPIO、LEDC 替身和按 ST7789 命令解码的面板替身
+ *
+ * SPI 替身（host_lcd.c）：spi_device_queue_trans 只把传输放进队列，
+ * spi_device_get_trans_result 取结果时才按排队顺序执行——调用 pre_cb、按当时 DC 引脚的电平
+ * 把数据交给面板替身。这样驱动在传输完成前改写了发送缓冲区、或在队列里还有传输时手动翻转 DC，
+ * 面板上的结果都会出错；入队时还会记下缓冲区的校验和，执行时不一致计为一次冲突。
+ * 总线时间按时钟频率和字节数累计，只用于比较，不模拟传输与 CPU 的并行。
+ *
+ * esp_lcd 面板 IO 替身（host_lcd_io.c）：按 esp_lcd_panel_io_spi 的行为工作，时间为模拟时钟
+ * host_time_us——发命令或参数（tx_param，以及带命令的 tx_color）前先等所有排队的颜色传输发完，
+ * 命令和参数用轮询传输发送（CPU 等到发完）；颜色数据只排队（队列满时等最早的一个），
+ * 按时钟频率算出它在总线上发完的时刻，时钟走到那一刻才交给面板并调用 on_color_trans_done。
+ * 渲染等 CPU 工作由测试推进时钟，与排队的传输并行。入队时记下缓冲区的校验和，
+ * 发完时不一致（传输完成前缓冲区被改写）计为一次冲突。
+ *
+ * 面板替身（host_panel.c）：240x320 RGB565 显存，解码 CASET/RASET/RAMWR/RAMWRC，
+ * 写指针在窗口内逐行前进、到窗口末尾回到起点，与 ST7789 相同；MADCTL 等其他命令只当作参数丢弃。
+ */
+
+#ifndef HOST_LCD_H
+#define HOST_LCD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define HOST_PANEL_WIDTH    240
+#define HOST_PANEL_HEIGHT   320
+
+/**
+ * @brief SPI 统计
+ */
+typedef struct {
+    uint32_t transactions;      // 上总线的传输（排队和轮询）
+    uint32_t polling;           // 其中轮询传输
+    uint64_t bytes;
+    uint64_t bus_ns;            // 按时钟频率算出的总线时间
+    uint32_t max_queued;        // 同时排队（未取结果）的最大传输数
+    uint32_t hazards;           // 排队后、执行前发送缓冲区被改写的次数
+    uint32_t overflows;         // 队列已满仍入队（真实驱动会一直阻塞）
+} host_spi_stats_t;
+
+/**
+ * @brief 清空队列和统计，面板替身一并复位
+ * @param dc_gpio DC 引脚，执行传输时按它的电平区分命令和数据
+ */
+void host_spi_reset(int dc_gpio);
+
+/**
+ * @brief 队列中尚未执行的传输数
+ */
+int host_spi_pending(void);
+
+const host_spi_stats_t *host_spi_get_stats(void);
+
+/**
+ * @brief 触发 GPIO 中断：调用 gpio_isr_handler_add 安装的处理函数
+ * @return 该引脚没有安装处理函数时返回 false
+ */
+bool host_gpio_trigger(int gpio_num);
+
+/**
+ * @brief 最后设置的背光占空比
+ */
+uint32_t host_ledc_duty(void);
+
+/**
+ * @brief esp_lcd 面板 IO 统计
+ */
+typedef struct {
+    uint32_t transactions;      // 轮询和排队的传输
+    uint32_t polling;           // 命令和参数（轮询）
+    uint32_t color;             // 颜色数据（排队）
+    uint64_t bytes;
+    uint32_t drains;            // 发命令前队列里还有颜色传输、必须先等它们发完的次数
+    uint32_t queue_full;        // 队列满、等最早一个发完的次数
+    int64_t wait_us;            // CPU 等排队传输发完的时间（不含轮询传输本身）
+    uint32_t max_in_flight;     // 同时排队的最大颜色传输数
+    uint32_t hazards;           // 排队后、发完前颜色缓冲区被改写的次数
+    uint32_t callbacks;         // on_color_trans_done 调用次数
+} host_lcd_io_stats_t;
+
+/**
+ * @brief 清空队列和统计（保留 esp_lcd_new_panel_io_spi 的配置），面板替身一并复位
+ */
+void host_lcd_io_reset(void);
+
+/**
+ * @brief 尚未发完的颜色传输数
+ */
+int host_lcd_io_in_flight(void);
+
+/**
+ * @brief 时钟走到最早一个颜色传输发完（相当于 CPU 空等下一个完成中断）
+ * @return 没有排队的传输时返回 false
+ */
+bool host_lcd_io_step(void);
+
+/**
+ * @brief CPU 做了 us 微秒别的工作：时钟前进，期间发完的传输交给面板并回调
+ */
+void host_lcd_io_advance(int64_t us);
+
+/**
+ * @brief 最早一个颜色传输发完的时刻（微秒，向上取整），没有排队的传输时返回 -1
+ */
+int64_t host_lcd_io_next_done_us(void);
+
+/**
+ * @brief 替身内部要让 CPU 等到某一时刻（发命令前取回排队的传输、队列满、轮询传输）时改为调用 hook，
+ *        由测试推进时钟并处理期间的其他事件（须在返回前把时钟推进到 target_us）；NULL 恢复直接拨钟
+ */
+void host_lcd_io_set_wait_hook(void (*hook)(int64_t target_us));
+
+/**
+ * @brief 每个颜色传输排队时调用 trace，给出数据和它在总线上的起止时刻（纳秒）；NULL 取消
+ */
+void host_lcd_io_set_trace(void (*trace)(const void *data, size_t len, int64_t start_ns, int64_t end_ns));
+
+const host_lcd_io_stats_t *host_lcd_io_get_stats(void);
+
+/**
+ * @brief 面板统计
+ */
+typedef struct {
+    uint32_t commands;
+    uint32_t windows;           // CASET 或 RASET 改变了窗口的次数
+    uint32_t ramwr;             // RAMWR（从窗口起点写）
+    uint32_t ramwrc;            // RAMWRC（接着上次的位置写）
+    uint32_t pixels;
+    uint32_t out_of_range;      // 落在显存外被丢弃的像素
+} host_panel_stats_t;
+
+void host_panel_reset(void);
+
+/**
+ * @brief 面板收到一段数据
+ * @param dc 0 为命令（每字节一条），1 为参数或像素
+ */
+void host_panel_write(int dc, const uint8_t *data, size_t len);
+
+/**
+ * @brief 显存中的像素（按发送顺序高字节在前拼成的 16 位值）
+ */
+uint16_t host_panel_pixel(int x, int y);
+
+/**
+ * @brief 用同一颜色清空显存（不计入统计）
+ */
+void host_panel_clear(uint16_t color);
+
+const host_panel_stats_t *host_panel_get_stats(void);
+
+#endif
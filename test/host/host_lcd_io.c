@@ -0,0 +1,254 @@
+/**
+ * @file host_lcd_io.c
+ * @brief 主机测试用：esp_lcd SPI 面板 IO 替身（见 host_lcd.h）
+ */
+
+#include <string.h>
+#include "host_lcd.h"
+#include "host_test.h"
+#include "esp_lcd_panel_io.h"
+
+#define IO_MAX_QUEUE    64
+
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    uint32_t checksum;
+    int64_t end_ns;             // 在总线上发完的时刻
+} color_trans_t;
+
+struct esp_lcd_panel_io_t {
+    esp_lcd_panel_io_spi_config_t config;
+    color_trans_t queue[IO_MAX_QUEUE];
+    int head;
+    int count;
+    int64_t bus_free_ns;        // 总线空闲的时刻
+};
+
+static struct esp_lcd_panel_io_t io_dev;
+static host_lcd_io_stats_t io_stats;
+static void (*wait_hook)(int64_t target_us) = NULL;
+static void (*trace_cb)(const void *data, size_t len, int64_t start_ns, int64_t end_ns) = NULL;
+
+static int64_t now_ns(void)
+{
+    return host_time_us * 1000;
+}
+
+static int64_t bus_ns(size_t len)
+{
+    if (io_dev.config.pclk_hz == 0) {
+        return 0;
+    }
+    return (int64_t)len * 8 * 1000000000ll / io_dev.config.pclk_hz;
+}
+
+// CPU 等到 t 时刻（向上取整到微秒）
+static void cpu_wait_until(int64_t t_ns)
+{
+    int64_t us = (t_ns + 999) / 1000;
+    if (us <= host_time_us) {
+        return;
+    }
+    if (wait_hook != NULL) {
+        wait_hook(us);
+    } else {
+        host_time_us = us;
+    }
+}
+
+// FNV-1a，用于发现排队期间被改写的缓冲区
+static uint32_t checksum(const uint8_t *p, size_t len)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+}
+
+/**
+ * @brief 到当前时刻已发完的颜色传输按顺序交给面板，并调用完成回调（相当于 DMA 完成中断）
+ */
+static void complete_due(void)
+{
+    while (io_dev.count > 0 && io_dev.queue[io_dev.head].end_ns <= now_ns()) {
+        color_trans_t *t = &io_dev.queue[io_dev.head];
+        io_dev.head = (io_dev.head + 1) % IO_MAX_QUEUE;
+        io_dev.count--;
+
+        if (checksum(t->data, t->len) != t->checksum) {
+            io_stats.hazards++;
+        }
+        host_panel_write(1, t->data, t->len);
+        io_stats.callbacks++;
+        if (io_dev.config.on_color_trans_done != NULL) {
+            esp_lcd_panel_io_event_data_t edata = {0};
+            io_dev.config.on_color_trans_done(&io_dev, &edata, io_dev.config.user_ctx);
+        }
+    }
+}
+
+/**
+ * @brief 等最早排队的一个颜色传输发完
+ */
+static void wait_oldest(void)
+{
+    int64_t start = host_time_us;
+    cpu_wait_until(io_dev.queue[io_dev.head].end_ns);
+    io_stats.wait_us += host_time_us - start;
+    complete_due();
+}
+
+// esp_lcd 发命令或参数前先取回所有排队的颜色传输
+static void wait_all(void)
+{
+    if (io_dev.count == 0) {
+        return;
+    }
+    io_stats.drains++;
+    while (io_dev.count > 0) {
+        wait_oldest();
+    }
+}
+
+// 轮询传输：CPU 等它在总线上发完
+static void polling(int dc, const uint8_t *data, size_t len)
+{
+    int64_t start = now_ns() > io_dev.bus_free_ns ? now_ns() : io_dev.bus_free_ns;
+    io_dev.bus_free_ns = start + bus_ns(len);
+    cpu_wait_until(io_dev.bus_free_ns);
+    host_panel_write(dc, data, len);
+    io_stats.transactions++;
+    io_stats.polling++;
+    io_stats.bytes += len;
+}
+
+void host_lcd_io_reset(void)
+{
+    io_dev.head = 0;
+    io_dev.count = 0;
+    io_dev.bus_free_ns = now_ns();
+    memset(&io_stats, 0, sizeof(io_stats));
+    host_panel_reset();
+}
+
+int host_lcd_io_in_flight(void)
+{
+    return io_dev.count;
+}
+
+bool host_lcd_io_step(void)
+{
+    complete_due();
+    if (io_dev.count == 0) {
+        return false;
+    }
+    cpu_wait_until(io_dev.queue[io_dev.head].end_ns);
+    complete_due();
+    return true;
+}
+
+void host_lcd_io_advance(int64_t us)
+{
+    host_time_us += us;
+    complete_due();
+}
+
+int64_t host_lcd_io_next_done_us(void)
+{
+    if (io_dev.count == 0) {
+        return -1;
+    }
+    return (io_dev.queue[io_dev.head].end_ns + 999) / 1000;
+}
+
+void host_lcd_io_set_wait_hook(void (*hook)(int64_t target_us))
+{
+    wait_hook = hook;
+}
+
+void host_lcd_io_set_trace(void (*trace)(const void *data, size_t len, int64_t start_ns, int64_t end_ns))
+{
+    trace_cb = trace;
+}
+
+const host_lcd_io_stats_t *host_lcd_io_get_stats(void)
+{
+    return &io_stats;
+}
+
+esp_err_t esp_lcd_new_panel_io_spi(esp_lcd_spi_bus_handle_t bus, const esp_lcd_panel_io_spi_config_t *io_config,
+                                   esp_lcd_panel_io_handle_t *ret_io)
+{
+    (void)bus;
+    if (io_config == NULL || ret_io == NULL || io_config->trans_queue_depth > IO_MAX_QUEUE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    io_dev.config = *io_config;
+    *ret_io = &io_dev;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_register_event_callbacks(esp_lcd_panel_io_handle_t io,
+                                                    const esp_lcd_panel_io_callbacks_t *cbs, void *user_ctx)
+{
+    io->config.on_color_trans_done = cbs->on_color_trans_done;
+    io->config.user_ctx = user_ctx;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_tx_param(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void *param, size_t param_size)
+{
+    (void)io;
+    complete_due();
+    wait_all();
+    if (lcd_cmd >= 0) {
+        uint8_t cmd = (uint8_t)lcd_cmd;
+        polling(0, &cmd, 1);
+    }
+    if (param != NULL && param_size > 0) {
+        polling(1, param, param_size);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_tx_color(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void *color, size_t color_size)
+{
+    complete_due();
+    if (lcd_cmd >= 0) {
+        wait_all();
+        uint8_t cmd = (uint8_t)lcd_cmd;
+        polling(0, &cmd, 1);
+    }
+    if ((size_t)io->count >= io->config.trans_queue_depth) {
+        io_stats.queue_full++;
+        wait_oldest();
+    }
+
+    color_trans_t *t = &io->queue[(io->head + io->count) % IO_MAX_QUEUE];
+    t->data = color;
+    t->len = color_size;
+    t->checksum = checksum(color, color_size);
+    int64_t start = now_ns() > io->bus_free_ns ? now_ns() : io->bus_free_ns;
+    t->end_ns = start + bus_ns(color_size);
+    io->bus_free_ns = t->end_ns;
+    io->count++;
+    if (trace_cb != NULL) {
+        trace_cb(color, color_size, start, t->end_ns);
+    }
+
+    io_stats.transactions++;
+    io_stats.color++;
+    io_stats.bytes += color_size;
+    if ((uint32_t)io->count > io_stats.max_in_flight) {
+        io_stats.max_in_flight = io->count;
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_del(esp_lcd_panel_io_handle_t io)
+{
+    (void)io;
+    return ESP_OK;
+}
@@ -0,0 +1,46 @@
+/**
+ * @file host_lvgl.c
+ * @brief 主机测试用：LVGL 定时器的替身
+ *
+ * 不运行 lv_timer_handler，只记录周期、暂停和 ready 请求，测试直接调用 timer_cb。
+ */
+
+#include <stdlib.h>
+#include "lvgl.h"
+
+lv_timer_t *lv_timer_create(lv_timer_cb_t timer_xcb, uint32_t period, void *user_data)
+{
+    lv_timer_t *timer = calloc(1, sizeof(lv_timer_t));
+    if (timer != NULL) {
+        timer->timer_cb = timer_xcb;
+        timer->period = period;
+        timer->user_data = user_data;
+        timer->repeat_count = -1;
+    }
+    return timer;
+}
+
+void lv_timer_set_period(lv_timer_t *timer, uint32_t period)
+{
+    timer->period = period;
+}
+
+void lv_timer_set_cb(lv_timer_t *timer, lv_timer_cb_t timer_cb)
+{
+    timer->timer_cb = timer_cb;
+}
+
+void lv_timer_pause(lv_timer_t *timer)
+{
+    timer->paused = 1;
+}
+
+void lv_timer_resume(lv_timer_t *timer)
+{
+    timer->paused = 0;
+}
+
+void lv_timer_ready(lv_timer_t *timer)
+{
+    timer->ready_calls++;
+}
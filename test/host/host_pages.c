@@ -0,0 +1,198 @@
+/**
+ * @file host_pages.c
+ * @brief 主机测试用：列表页测试数据
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "host_pages.h"
+
+static const char B64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// 同一邮箱下 Graph id 的公共部分
+static const char ID_PREFIX[] =
+    "AAMkADQ2NTk4ZjFkLWJhYzEtNDNhYi04ZTU5LTljMmE1ZjA0YzdmNABGAAAAAAC3nJ0xk9"
+    "Q4TqTjWZc1mHcRBwB8yS2aXkVbRbm4uNoK3Hq9AAAAAAESAAB8yS2aXkVbRbm4uNoK3Hq9"
+    "AAIuR6IqAAA";
+
+static const char LIST_ID[] =
+    "AAMkADQ2NTk4ZjFkLWJhYzEtNDNhYi04ZTU5LTljMmE1ZjA0YzdmNAAuAAAAAAC3nJ0xk9"
+    "Q4TqTjWZc1mHcRAQB8yS2aXkVbRbm4uNoK3Hq9AAAAAAESAAA=";
+
+static const char *const TITLES[] = {
+    "买菜", "Review PR for display driver", "给妈妈打电话", "交电费", "Book dentist appointment",
+    "准备周会材料", "Renew passport", "整理发票报销", "Fix bike tyre", "读完《三体》第二部",
+    "Send invoice to client", "预约体检", "Water the plants", "备份照片", "Call the landlord",
+};
+
+static uint32_t mix(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352d;
+    x ^= x >> 15;
+    x *= 0x846ca68b;
+    x ^= x >> 16;
+    return x;
+}
+
+static void b64_tail(char *out, int len, uint32_t seed)
+{
+    for (int i = 0; i < len; i++) {
+        seed = mix(seed + (uint32_t)i);
+        out[i] = B64[seed & 63];
+    }
+    out[len] = '\0';
+}
+
+void host_page_item(int index, host_item_t *item)
+{
+    uint32_t h = mix((uint32_t)index + 1);
+
+    size_t prefix_len = strlen(ID_PREFIX);
+    memcpy(item->id, ID_PREFIX, prefix_len);
+    b64_tail(item->id + prefix_len, 58, h);
+    strcat(item->id, "AAA=");
+
+    strcpy(item->list_id, LIST_ID);
+    snprintf(item->title, sizeof(item->title), "%s #%d",
+             TITLES[h % (sizeof(TITLES) / sizeof(TITLES[0]))], index);
+    item->completed = (h >> 8) % 3 == 0;
+    item->importance = (h >> 12) % 5 == 0 ? "high" : "normal";
+    snprintf(item->modified, sizeof(item->modified), "2026-%02d-%02dT%02d:%02d:%02d.%07uZ",
+             1 + (h >> 4) % 12, 1 + (h >> 9) % 28, (h >> 14) % 24, (h >> 19) % 60, (h >> 25) % 60,
+             (unsigned)(mix(h) % 10000000));
+}
+
+const char *host_page_list_id(void)
+{
+    return LIST_ID;
+}
+
+void host_page_cursor(int next_first, char *buf, size_t size)
+{
+    char tail[97];
+    b64_tail(tail, 96, 0xC0FFEEu + (uint32_t)next_first);
+    snprintf(buf, size, "skip=%d&token=%s", next_first, tail);
+}
+
+size_t host_page_json(char *buf, size_t size, int first, int count, int total)
+{
+    size_t len = 0;
+#define APPEND(...)                                                     \
+    do {                                                                \
+        int n_ = snprintf(buf + len, size - len, __VA_ARGS__);          \
+        if (n_ < 0 || (size_t)n_ >= size - len) {                       \
+            return 0;                                                   \
+        }                                                               \
+        len += (size_t)n_;                                              \
+    } while (0)
+
+    APPEND("{\"listId\":\"%s\",\"value\":[", LIST_ID);
+    for (int i = 0; i < count; i++) {
+        host_item_t item;
+        host_page_item(first + i, &item);
+        APPEND("%s{\"id\":\"%s\",\"listId\":\"%s\",\"title\":\"%s\",\"isCompleted\":%s,"
+               "\"importance\":\"%s\",\"lastModifiedDateTime\":\"%s\"}",
+               i ? "," : "", item.id, item.list_id, item.title, item.completed ? "true" : "false",
+               item.importance, item.modified);
+    }
+    APPEND("]");
+    if (first + count < total) {
+        char cursor[160];
+        host_page_cursor(first + count, cursor, sizeof(cursor));
+        APPEND(",\"nextCursor\":\"%s\"", cursor);
+    }
+    APPEND("}");
+#undef APPEND
+    return len;
+}
+
+typedef struct {
+    uint8_t *buf;
+    size_t size;
+    size_t len;
+    bool overflow;
+} cbor_out_t;
+
+static void cbor_put(cbor_out_t *out, const void *data, size_t n)
+{
+    if (out->overflow || out->size - out->len < n) {
+        out->overflow = true;
+        return;
+    }
+    memcpy(out->buf + out->len, data, n);
+    out->len += n;
+}
+
+/**
+ * @brief 写入项头：主类型 + 最短的长度编码
+ */
+static void cbor_head(cbor_out_t *out, uint8_t major, uint64_t value)
+{
+    uint8_t head[9];
+    size_t n;
+    if (value < 24) {
+        head[0] = (uint8_t)(major << 5 | value);
+        n = 1;
+    } else if (value <= 0xFF) {
+        head[0] = (uint8_t)(major << 5 | 24);
+        head[1] = (uint8_t)value;
+        n = 2;
+    } else if (value <= 0xFFFF) {
+        head[0] = (uint8_t)(major << 5 | 25);
+        head[1] = (uint8_t)(value >> 8);
+        head[2] = (uint8_t)value;
+        n = 3;
+    } else {
+        head[0] = (uint8_t)(major << 5 | 26);
+        for (int i = 0; i < 4; i++) {
+            head[1 + i] = (uint8_t)(value >> (24 - 8 * i));
+        }
+        n = 5;
+    }
+    cbor_put(out, head, n);
+}
+
+static void cbor_text(cbor_out_t *out, const char *text)
+{
+    size_t n = strlen(text);
+    cbor_head(out, 3, n);
+    cbor_put(out, text, n);
+}
+
+size_t host_page_cbor(uint8_t *buf, size_t size, int first, int count, int total)
+{
+    cbor_out_t out = {.buf = buf, .size = size};
+    bool more = first + count < total;
+
+    cbor_head(&out, 5, more ? 3 : 2);
+    cbor_text(&out, "listId");
+    cbor_text(&out, LIST_ID);
+    cbor_text(&out, "value");
+    cbor_head(&out, 4, (uint64_t)count);
+    for (int i = 0; i < count; i++) {
+        host_item_t item;
+        host_page_item(first + i, &item);
+        cbor_head(&out, 5, 6);
+        cbor_text(&out, "id");
+        cbor_text(&out, item.id);
+        cbor_text(&out, "listId");
+        cbor_text(&out, item.list_id);
+        cbor_text(&out, "title");
+        cbor_text(&out, item.title);
+        cbor_text(&out, "isCompleted");
+        cbor_head(&out, 7, item.completed ? 21 : 20);
+        cbor_text(&out, "importance");
+        cbor_text(&out, item.importance);
+        cbor_text(&out, "lastModifiedDateTime");
+        cbor_text(&out, item.modified);
+    }
+    if (more) {
+        char cursor[160];
+        host_page_cursor(first + count, cursor, sizeof(cursor));
+        cbor_text(&out, "nextCursor");
+        cbor_text(&out, cursor);
+    }
+    return out.overflow ? 0 : out.len;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file host_pages.h
+ * @brief 主机测试用：生成与后端列表页相同结构的测试数据
+ *
+ * 字段和长度按 Microsoft Graph 待办接口的实际数据取：id 约 200 字符，
+ * 同一邮箱的 id 共享很长的前缀；每条都带 listId；标题中英文混合。
+ * 同一 index 每次生成的内容相同，便于不同编码之间比较。
+ */
+
+#ifndef HOST_PAGES_H
+#define HOST_PAGES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    char id[232];
+    char list_id[136];
+    char title[64];
+    bool completed;
+    const char *importance;
+    char modified[32];
+} host_item_t;
+
+/**
+ * @brief 第 index 条待办
+ */
+void host_page_item(int index, host_item_t *item);
+
+/**
+ * @brief 列表ID（所有条目相同）
+ */
+const char *host_page_list_id(void);
+
+/**
+ * @brief 从 next_first 条开始的下一页游标
+ */
+void host_page_cursor(int next_first, char *buf, size_t size);
+
+/**
+ * @brief 生成 JSON 列表页：{"listId","value":[...],"nextCursor"}，最后一页不带游标
+ * @param first 第一条的 index
+ * @param count 本页条数
+ * @param total 列表总条数
+ * @return 写入的字节数（不含结尾'\0'），缓冲区不足时返回 0
+ */
+size_t host_page_json(char *buf, size_t size, int first, int count, int total);
+
+/**
+ * @brief 生成同一页的 CBOR 编码（RFC 8949，定长映射/数组，键名和顺序与 JSON 相同）
+ * @return 写入的字节数，缓冲区不足时返回 0
+ */
+size_t host_page_cbor(uint8_t *buf, size_t size, int first, int count, int total);
+
+#endif
@@ -0,0 +1,134 @@
+/**
+ * @file host_panel.c
+ * @brief 主机测试用：按 ST7789 命令解码的面板替身（见 host_lcd.h）
+ */
+
+#include <string.h>
+#include "host_lcd.h"
+
+#define CMD_CASET   0x2A
+#define CMD_RASET   0x2B
+#define CMD_RAMWR   0x2C
+#define CMD_RAMWRC  0x3C
+
+static uint16_t mem[HOST_PANEL_HEIGHT][HOST_PANEL_WIDTH];
+static host_panel_stats_t stats;
+
+static int cmd = -1;
+static int param_index = 0;
+static uint8_t params[4];
+static int xs = 0;
+static int xe = HOST_PANEL_WIDTH - 1;
+static int ys = 0;
+static int ye = HOST_PANEL_HEIGHT - 1;
+static int wx = 0;              // 写指针
+static int wy = 0;
+static bool half = false;       // 已收到一个像素的高字节
+static uint8_t high = 0;
+
+void host_panel_reset(void)
+{
+    memset(mem, 0, sizeof(mem));
+    memset(&stats, 0, sizeof(stats));
+    cmd = -1;
+    param_index = 0;
+    xs = 0;
+    xe = HOST_PANEL_WIDTH - 1;
+    ys = 0;
+    ye = HOST_PANEL_HEIGHT - 1;
+    wx = 0;
+    wy = 0;
+    half = false;
+}
+
+void host_panel_clear(uint16_t color)
+{
+    for (int y = 0; y < HOST_PANEL_HEIGHT; y++) {
+        for (int x = 0; x < HOST_PANEL_WIDTH; x++) {
+            mem[y][x] = color;
+        }
+    }
+}
+
+static void put_pixel(uint16_t color)
+{
+    if (wx < HOST_PANEL_WIDTH && wy < HOST_PANEL_HEIGHT) {
+        mem[wy][wx] = color;
+    } else {
+        stats.out_of_range++;
+    }
+    stats.pixels++;
+
+    if (++wx > xe) {
+        wx = xs;
+        if (++wy > ye) {
+            wy = ys;
+        }
+    }
+}
+
+static void on_command(uint8_t byte)
+{
+    stats.commands++;
+    cmd = byte;
+    param_index = 0;
+    half = false;
+    if (byte == CMD_RAMWR) {
+        stats.ramwr++;
+        wx = xs;
+        wy = ys;
+    } else if (byte == CMD_RAMWRC) {
+        stats.ramwrc++;
+    }
+}
+
+static void on_data(uint8_t byte)
+{
+    if (cmd == CMD_RAMWR || cmd == CMD_RAMWRC) {
+        if (!half) {
+            high = byte;
+            half = true;
+        } else {
+            put_pixel((uint16_t)(high << 8 | byte));
+            half = false;
+        }
+        return;
+    }
+    if ((cmd != CMD_CASET && cmd != CMD_RASET) || param_index >= 4) {
+        return;
+    }
+    params[param_index++] = byte;
+    if (param_index == 4) {
+        int start = params[0] << 8 | params[1];
+        int end = params[2] << 8 | params[3];
+        if (cmd == CMD_CASET) {
+            xs = start;
+            xe = end;
+        } else {
+            ys = start;
+            ye = end;
+        }
+        stats.windows++;
+    }
+}
+
+void host_panel_write(int dc, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        if (dc) {
+            on_data(data[i]);
+        } else {
+            on_command(data[i]);
+        }
+    }
+}
+
+uint16_t host_panel_pixel(int x, int y)
+{
+    return mem[y][x];
+}
+
+const host_panel_stats_t *host_panel_get_stats(void)
+{
+    return &stats;
+}
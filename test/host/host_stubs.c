@@ -0,0 +1,155 @@
+/**
+ * @file host_stubs.c
+ * @brief 主机测试用：ESP-IDF 接口的替身实现（heap_caps 见 host_heap.c）
+ */
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <zlib.h>
+#include "host_test.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "esp_rom_crc.h"
+#include "esp_http_client.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "rom/miniz.h"
+
+int host_test_failures = 0;
+int64_t host_time_us = 0;
+static uint32_t random_state = 0x12345678;
+
+int64_t esp_timer_get_time(void)
+{
+    return host_time_us;
+}
+
+int64_t host_monotonic_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void host_random_seed(uint32_t seed)
+{
+    random_state = seed != 0 ? seed : 1;
+}
+
+uint32_t esp_random(void)
+{
+    // xorshift32
+    uint32_t x = random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    random_state = x;
+    return x;
+}
+
+static pthread_mutex_t critical_lock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+void host_critical_enter(void)
+{
+    pthread_mutex_lock(&critical_lock);
+}
+
+void host_critical_exit(void)
+{
+    pthread_mutex_unlock(&critical_lock);
+}
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+        case ESP_OK: return "ESP_OK";
+        case ESP_FAIL: return "ESP_FAIL";
+        case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+        case ESP_ERR_INVALID_RESPONSE: return "ESP_ERR_INVALID_RESPONSE";
+        case ESP_ERR_NOT_ALLOWED: return "ESP_ERR_NOT_ALLOWED";
+        case ESP_ERR_HTTP_CONNECT: return "ESP_ERR_HTTP_CONNECT";
+        case ESP_ERR_HTTP_FETCH_HEADER: return "ESP_ERR_HTTP_FETCH_HEADER";
+        case ESP_ERR_HTTP_EAGAIN: return "ESP_ERR_HTTP_EAGAIN";
+        default: return "UNKNOWN ERROR";
+    }
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    // 每个线程一个不同的地址，当作任务句柄
+    static _Thread_local char task_tag;
+    return (TaskHandle_t)&task_tag;
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, uint8_t const *buf, uint32_t len)
+{
+    return (uint32_t)crc32(crc, buf, len);
+}
+
+void tinfl_init(tinfl_decompressor *r)
+{
+    if (r->initialized) {
+        inflateReset(&r->zs);
+        return;
+    }
+    r->zs.zalloc = Z_NULL;
+    r->zs.zfree = Z_NULL;
+    r->zs.opaque = Z_NULL;
+    r->initialized = inflateInit2(&r->zs, -MAX_WBITS) == Z_OK;
+}
+
+tinfl_status tinfl_decompress(tinfl_decompressor *r, const mz_uint8 *pIn_buf_next, size_t *pIn_buf_size,
+                              mz_uint8 *pOut_buf_start, mz_uint8 *pOut_buf_next, size_t *pOut_buf_size,
+                              const mz_uint32 decomp_flags)
+{
+    (void)pOut_buf_start;
+    (void)decomp_flags;
+    if (!r->initialized) {
+        return TINFL_STATUS_BAD_PARAM;
+    }
+
+    r->zs.next_in = (Bytef *)pIn_buf_next;
+    r->zs.avail_in = (uInt)*pIn_buf_size;
+    r->zs.next_out = pOut_buf_next;
+    r->zs.avail_out = (uInt)*pOut_buf_size;
+    int ret = inflate(&r->zs, Z_NO_FLUSH);
+    *pIn_buf_size -= r->zs.avail_in;
+    *pOut_buf_size -= r->zs.avail_out;
+
+    if (ret == Z_STREAM_END) {
+        return TINFL_STATUS_DONE;
+    }
+    if (ret != Z_OK && ret != Z_BUF_ERROR) {
+        return TINFL_STATUS_FAILED;
+    }
+    // 与 tinfl 相同：输出区写满而流未结束时要求更多输出空间
+    return r->zs.avail_out == 0 ? TINFL_STATUS_HAS_MORE_OUTPUT : TINFL_STATUS_NEEDS_MORE_INPUT;
+}
+
+size_t strlcpy(char *dst, const char *src, size_t size)
+{
+    size_t len = strlen(src);
+    if (size > 0) {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+
+size_t strlcat(char *dst, const char *src, size_t size)
+{
+    size_t used = strnlen(dst, size);
+    if (used == size) {
+        return size + strlen(src);
+    }
+    return used + strlcpy(dst + used, src, size - used);
+}
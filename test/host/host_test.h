@@ -0,0 +1,80 @@
+/**
+ * @file host_test.h
+ * @brief 主机端单元测试的断言和测试替身控制
+ *
+ * 每个测试程序对应 main/ 下的一个纯逻辑模块，失败的断言打印位置后继续执行，
+ * 全部跑完后按失败数决定退出码，由 ctest 汇总。
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+extern int host_test_failures;
+
+// esp_timer_get_time 返回的时间，测试自行推进
+extern int64_t host_time_us;
+
+/**
+ * @brief 本机单调时钟（微秒），用于基准测试计时，与 host_time_us 无关
+ */
+int64_t host_monotonic_us(void);
+
+/**
+ * @brief 设定 esp_random 的种子（xorshift32，结果可复现）
+ */
+void host_random_seed(uint32_t seed);
+
+/**
+ * @brief 模拟堆（host_heap.c）：设置区域容量，超出时分配失败
+ */
+void host_heap_set_capacity(bool psram, size_t bytes);
+
+/**
+ * @brief 区域再成功分配 count 次后全部失败（-1 取消）
+ */
+void host_heap_fail_after(bool psram, int count);
+
+/**
+ * @brief 恢复默认容量并取消按需失败
+ */
+void host_heap_reset_limits(void);
+
+/**
+ * @brief 区域当前占用字节数和累计分配次数
+ */
+size_t host_heap_used(bool psram);
+uint32_t host_heap_alloc_calls(bool psram);
+
+#define CHECK(cond)                                                             \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            fprintf(stderr, "%s:%d: 断言失败: %s\n", __FILE__, __LINE__, #cond);  \
+            host_test_failures++;                                               \
+        }                                                                       \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                              \
+    do {                                                                        \
+        long long a_ = (long long)(actual);                                     \
+        long long e_ = (long long)(expected);                                   \
+        if (a_ != e_) {                                                         \
+            fprintf(stderr, "%s:%d: %s == %lld，期望 %lld\n", __FILE__, __LINE__,  \
+                    #actual, a_, e_);                                           \
+            host_test_failures++;                                               \
+        }                                                                       \
+    } while (0)
+
+#define RUN_TEST(fn)                \
+    do {                            \
+        printf("-- %s\n", #fn);     \
+        fn();                       \
+    } while (0)
+
+#define HOST_TEST_EXIT_CODE() (host_test_failures == 0 ? 0 : 1)
+
+#endif
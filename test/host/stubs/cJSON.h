@@ -0,0 +1,82 @@
+/**
+ * @file cJSON.h
+ * @brief 主机测试用：cJSON 1.7 的替身（host_cjson.c）
+ *
+ * 只实现固件用到的接口。结构体、类型常量与 cJSON 1.7 相同，
+ * 分配方式也与之一致：每个值一个节点，每个键名和字符串值各一次分配，
+ * 钩子不是 malloc/free 时不使用 realloc（打印缓冲区扩容改为分配新块再复制）。
+ */
+
+#ifndef cJSON__h
+#define cJSON__h
+
+#include <stddef.h>
+
+#define cJSON_Invalid (0)
+#define cJSON_False  (1 << 0)
+#define cJSON_True   (1 << 1)
+#define cJSON_NULL   (1 << 2)
+#define cJSON_Number (1 << 3)
+#define cJSON_String (1 << 4)
+#define cJSON_Array  (1 << 5)
+#define cJSON_Object (1 << 6)
+#define cJSON_Raw    (1 << 7)
+
+#define cJSON_IsReference 256
+#define cJSON_StringIsConst 512
+
+#define CJSON_NESTING_LIMIT 1000
+
+typedef int cJSON_bool;
+
+typedef struct cJSON {
+    struct cJSON *next;
+    struct cJSON *prev;
+    struct cJSON *child;
+    int type;
+    char *valuestring;
+    int valueint;
+    double valuedouble;
+    char *string;
+} cJSON;
+
+typedef struct cJSON_Hooks {
+    void *(*malloc_fn)(size_t sz);
+    void (*free_fn)(void *ptr);
+} cJSON_Hooks;
+
+void cJSON_InitHooks(cJSON_Hooks *hooks);
+
+cJSON *cJSON_Parse(const char *value);
+cJSON *cJSON_ParseWithLength(const char *value, size_t buffer_length);
+char *cJSON_PrintUnformatted(const cJSON *item);
+void cJSON_Delete(cJSON *item);
+
+int cJSON_GetArraySize(const cJSON *array);
+cJSON *cJSON_GetArrayItem(const cJSON *array, int index);
+cJSON *cJSON_GetObjectItem(const cJSON *const object, const char *const string);
+
+cJSON_bool cJSON_IsBool(const cJSON *const item);
+cJSON_bool cJSON_IsTrue(const cJSON *const item);
+cJSON_bool cJSON_IsFalse(const cJSON *const item);
+cJSON_bool cJSON_IsNumber(const cJSON *const item);
+cJSON_bool cJSON_IsString(const cJSON *const item);
+cJSON_bool cJSON_IsArray(const cJSON *const item);
+cJSON_bool cJSON_IsObject(const cJSON *const item);
+
+cJSON *cJSON_CreateObject(void);
+cJSON *cJSON_CreateArray(void);
+cJSON *cJSON_CreateString(const char *string);
+cJSON *cJSON_CreateNumber(double num);
+cJSON *cJSON_CreateBool(cJSON_bool boolean);
+
+cJSON_bool cJSON_AddItemToArray(cJSON *array, cJSON *item);
+cJSON_bool cJSON_AddItemToObject(cJSON *object, const char *string, cJSON *item);
+cJSON *cJSON_AddStringToObject(cJSON *const object, const char *const name, const char *const string);
+cJSON *cJSON_AddNumberToObject(cJSON *const object, const char *const name, const double number);
+cJSON *cJSON_AddBoolToObject(cJSON *const object, const char *const name, const cJSON_bool boolean);
+
+void *cJSON_malloc(size_t size);
+void cJSON_free(void *object);
+
+#endif
@@ -0,0 +1,14 @@
+/**
+ * @file i2c_master.h
+ * @brief 主机测试用：touch_driver.h 中的宏引用的 I2C 端口号
+ */
+
+#ifndef DRIVER_I2C_MASTER_H
+#define DRIVER_I2C_MASTER_H
+
+typedef enum {
+    I2C_NUM_0 = 0,
+    I2C_NUM_1,
+} i2c_port_num_t;
+
+#endif
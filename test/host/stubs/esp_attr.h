@@ -0,0 +1,12 @@
+/**
+ * @file esp_attr.h
+ * @brief 主机测试用：段属性宏为空
+ */
+
+#ifndef ESP_ATTR_H
+#define ESP_ATTR_H
+
+#define IRAM_ATTR
+#define DMA_ATTR
+
+#endif
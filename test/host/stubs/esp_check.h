@@ -0,0 +1,43 @@
+/**
+ * @file esp_check.h
+ * @brief 主机测试用：出错跳转/返回宏（不输出日志）
+ */
+
+#ifndef ESP_CHECK_H
+#define ESP_CHECK_H
+
+#include "esp_err.h"
+
+#define ESP_GOTO_ON_FALSE(a, err_code, goto_tag, log_tag, ...) \
+    do {                                                        \
+        if (!(a)) {                                             \
+            ret = (err_code);                                   \
+            goto goto_tag;                                      \
+        }                                                       \
+    } while (0)
+
+#define ESP_GOTO_ON_ERROR(x, goto_tag, log_tag, ...) \
+    do {                                             \
+        esp_err_t err_rc_ = (x);                     \
+        if (err_rc_ != ESP_OK) {                     \
+            ret = err_rc_;                           \
+            goto goto_tag;                           \
+        }                                            \
+    } while (0)
+
+#define ESP_RETURN_ON_FALSE(a, err_code, log_tag, ...) \
+    do {                                               \
+        if (!(a)) {                                    \
+            return (err_code);                         \
+        }                                              \
+    } while (0)
+
+#define ESP_RETURN_ON_ERROR(x, log_tag, ...) \
+    do {                                     \
+        esp_err_t err_rc_ = (x);             \
+        if (err_rc_ != ESP_OK) {             \
+            return err_rc_;                  \
+        }                                    \
+    } while (0)
+
+#endif
@@ -0,0 +1,13 @@
+/**
+ * @file esp_crt_bundle.h
+ * @brief 主机测试用：证书包只作为配置里的函数指针出现，不做校验
+ */
+
+#ifndef ESP_CRT_BUNDLE_H
+#define ESP_CRT_BUNDLE_H
+
+#include "esp_err.h"
+
+esp_err_t esp_crt_bundle_attach(void *conf);
+
+#endif
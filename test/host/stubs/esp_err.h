@@ -0,0 +1,39 @@
+/**
+ * @file esp_err.h
+ * @brief 主机测试用：ESP-IDF 错误码（数值与 IDF 一致）
+ */
+
+#ifndef ESP_ERR_H
+#define ESP_ERR_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef int esp_err_t;
+
+#define ESP_OK                  0
+#define ESP_FAIL                -1
+#define ESP_ERR_NO_MEM          0x101
+#define ESP_ERR_INVALID_ARG     0x102
+#define ESP_ERR_INVALID_STATE   0x103
+#define ESP_ERR_INVALID_SIZE    0x104
+#define ESP_ERR_NOT_FOUND       0x105
+#define ESP_ERR_NOT_SUPPORTED   0x106
+#define ESP_ERR_TIMEOUT         0x107
+#define ESP_ERR_INVALID_RESPONSE 0x108
+#define ESP_ERR_INVALID_CRC     0x109
+#define ESP_ERR_NOT_FINISHED    0x10C
+#define ESP_ERR_NOT_ALLOWED     0x10D
+
+const char *esp_err_to_name(esp_err_t code);
+
+// 与 IDF 一样出错即终止（不打印回溯）
+#define ESP_ERROR_CHECK(x)              \
+    do {                                \
+        esp_err_t err_rc_ = (x);        \
+        if (err_rc_ != ESP_OK) {        \
+            abort();                    \
+        }                               \
+    } while (0)
+
+#endif
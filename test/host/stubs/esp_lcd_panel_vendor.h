@@ -0,0 +1,11 @@
+/**
+ * @file esp_lcd_panel_vendor.h
+ * @brief 主机测试用：面板驱动包含此头文件只为取得句柄类型
+ */
+
+#ifndef ESP_LCD_PANEL_VENDOR_H
+#define ESP_LCD_PANEL_VENDOR_H
+
+#include "esp_lcd_types.h"
+
+#endif
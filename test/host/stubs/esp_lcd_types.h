@@ -0,0 +1,12 @@
+/**
+ * @file esp_lcd_types.h
+ * @brief 主机测试用：面板和面板 IO 句柄类型
+ */
+
+#ifndef ESP_LCD_TYPES_H
+#define ESP_LCD_TYPES_H
+
+typedef struct esp_lcd_panel_io_t *esp_lcd_panel_io_handle_t;
+typedef struct esp_lcd_panel_t *esp_lcd_panel_handle_t;
+
+#endif
@@ -0,0 +1,23 @@
+/**
+ * @file esp_log.h
+ * @brief 主机测试用：日志宏只求值参数、不输出
+ *
+ * 不做格式检查：模块按 ESP32 的类型写格式串（uint32_t 用 %lu），在 x86-64 上会误报。
+ */
+
+#ifndef ESP_LOG_H
+#define ESP_LOG_H
+
+static inline void host_log_discard(const char *tag, const char *fmt, ...)
+{
+    (void)tag;
+    (void)fmt;
+}
+
+#define ESP_LOGE(tag, ...) host_log_discard(tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) host_log_discard(tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) host_log_discard(tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) host_log_discard(tag, __VA_ARGS__)
+#define ESP_LOGV(tag, ...) host_log_discard(tag, __VA_ARGS__)
+
+#endif
@@ -0,0 +1,13 @@
+/**
+ * @file esp_memory_utils.h
+ * @brief 主机测试用：按模拟堆记录的区域判断指针是否在PSRAM（只对 heap_caps 分配的块有效）
+ */
+
+#ifndef ESP_MEMORY_UTILS_H
+#define ESP_MEMORY_UTILS_H
+
+#include <stdbool.h>
+
+bool esp_ptr_external_ram(const void *p);
+
+#endif
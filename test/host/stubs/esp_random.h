@@ -0,0 +1,13 @@
+/**
+ * @file esp_random.h
+ * @brief 主机测试用：可复现的伪随机数（host_random_seed 设定种子）
+ */
+
+#ifndef ESP_RANDOM_H
+#define ESP_RANDOM_H
+
+#include <stdint.h>
+
+uint32_t esp_random(void);
+
+#endif
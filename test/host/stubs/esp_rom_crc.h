@@ -0,0 +1,13 @@
+/**
+ * @file esp_rom_crc.h
+ * @brief 主机测试用：ROM CRC32 由 zlib 计算（初值0时两者结果相同）
+ */
+
+#ifndef ESP_ROM_CRC_H
+#define ESP_ROM_CRC_H
+
+#include <stdint.h>
+
+uint32_t esp_rom_crc32_le(uint32_t crc, uint8_t const *buf, uint32_t len);
+
+#endif
@@ -0,0 +1,13 @@
+/**
+ * @file esp_rom_sys.h
+ * @brief 主机测试用：忙等延时，由测试程序提供（推进模拟时钟）
+ */
+
+#ifndef ESP_ROM_SYS_H
+#define ESP_ROM_SYS_H
+
+#include <stdint.h>
+
+void esp_rom_delay_us(uint32_t us);
+
+#endif
@@ -0,0 +1,13 @@
+/**
+ * @file esp_timer.h
+ * @brief 主机测试用：时间由测试控制（host_time_us，见 host_test.h）
+ */
+
+#ifndef ESP_TIMER_H
+#define ESP_TIMER_H
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
+
+#endif
@@ -0,0 +1,41 @@
+/**
+ * @file FreeRTOS.h
+ * @brief 主机测试用：临界区用一个全局递归互斥锁代替（相当于关中断），多线程测试可直接使用
+ */
+
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+// 与真实的 FreeRTOS.h 一样带入 stddef.h（NULL、size_t）
+#include <stddef.h>
+#include <stdint.h>
+
+// 节拍按 CONFIG_FREERTOS_HZ=1000 换算（1 tick = 1 ms）
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE 0
+#define pdTRUE  1
+#define pdMS_TO_TICKS(ms)    ((TickType_t)(ms))
+#define portMAX_DELAY        ((TickType_t)0xFFFFFFFFu)
+#define portYIELD_FROM_ISR() ((void)0)
+#define portTICK_PERIOD_MS   1
+
+typedef struct {
+    int unused;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+
+void host_critical_enter(void);
+void host_critical_exit(void);
+
+#define taskENTER_CRITICAL(mux) ((void)(mux), host_critical_enter())
+#define taskEXIT_CRITICAL(mux)  ((void)(mux), host_critical_exit())
+#define portENTER_CRITICAL(mux)     taskENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL(mux)      taskEXIT_CRITICAL(mux)
+#define portENTER_CRITICAL_ISR(mux) taskENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL_ISR(mux)  taskEXIT_CRITICAL(mux)
+
+#endif
@@ -0,0 +1,13 @@
+/**
+ * @file idf_additions.h
+ * @brief 主机测试用：按 caps 创建队列（模拟堆不区分队列存储，直接用 xQueueCreate）
+ */
+
+#ifndef IDF_ADDITIONS_H
+#define IDF_ADDITIONS_H
+
+#include "freertos/queue.h"
+
+#define xQueueCreateWithCaps(length, item_size, caps) ((void)(caps), xQueueCreate((length), (item_size)))
+
+#endif
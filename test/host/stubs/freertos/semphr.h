@@ -0,0 +1,22 @@
+/**
+ * @file semphr.h
+ * @brief 主机测试用：二值信号量和互斥锁
+ *
+ * 二值信号量由测试程序提供：阻塞等待要推进模拟时钟，由测试决定等待期间发生什么。
+ * 互斥锁用 pthread 实现（host_freertos.c），与二值信号量不在同一个测试中使用。
+ */
+
+#ifndef SEMPHR_H
+#define SEMPHR_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct host_semaphore *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t *higher_prio_task_woken);
+
+#endif
@@ -0,0 +1,21 @@
+/**
+ * @file task.h
+ * @brief 主机测试用：任务延时和任务句柄，临界区宏在 FreeRTOS.h 中
+ *
+ * 任务句柄即线程：xTaskGetCurrentTaskHandle 对每个线程返回不同的值（host_stubs.c）。
+ */
+
+#ifndef TASK_H
+#define TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct host_task *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *arg);
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+// 由测试程序提供
+void vTaskDelay(TickType_t ticks);
+
+#endif
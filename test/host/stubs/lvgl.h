@@ -0,0 +1,263 @@
+/**
+ * @file lvgl.h
+ * @brief 主机测试用：被测模块用到的 LVGL 8.3 类型和函数
+ *
+ * 只对应本项目固定的配置（16 位色、不交换字节、ROUND_OFS 0、32 位坐标）。
+ * 颜色混合函数照抄 LVGL 8.3 src/misc/lv_color.h，测试以它们为准；
+ * 结构体只保留被测模块访问的成员，与 LVGL 的内存布局无关。
+ */
+
+#ifndef LVGL_H
+#define LVGL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define LV_COLOR_DEPTH          16
+#define LV_COLOR_16_SWAP        0
+#define LV_COLOR_MIX_ROUND_OFS  0
+#define LV_ATTRIBUTE_FAST_MEM
+#define LV_INV_BUF_SIZE         32
+
+#define LV_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define LV_MAX(a, b) ((a) > (b) ? (a) : (b))
+
+typedef int32_t lv_coord_t;
+typedef uint8_t lv_opa_t;
+
+enum {
+    LV_OPA_TRANSP = 0,
+    LV_OPA_COVER = 255,
+};
+#define LV_OPA_MIN 2
+#define LV_OPA_MAX 253
+
+typedef union {
+    struct {
+        uint16_t blue : 5;
+        uint16_t green : 6;
+        uint16_t red : 5;
+    } ch;
+    uint16_t full;
+} lv_color_t;
+
+#define LV_UDIV255(x) (((x) * 0x8081U) >> 0x17)
+
+static inline lv_color_t lv_color_black(void)
+{
+    lv_color_t c = {.full = 0};
+    return c;
+}
+
+static inline lv_color_t lv_color_mix(lv_color_t c1, lv_color_t c2, uint8_t mix)
+{
+    lv_color_t ret;
+    /*Source: https://stackoverflow.com/a/50012418/1999969*/
+    mix = (uint32_t)((uint32_t)mix + 4) >> 3;
+    uint32_t bg = (uint32_t)((uint32_t)c2.full | ((uint32_t)c2.full << 16)) & 0x7E0F81F;
+    uint32_t fg = (uint32_t)((uint32_t)c1.full | ((uint32_t)c1.full << 16)) & 0x7E0F81F;
+    uint32_t result = ((((fg - bg) * mix) >> 5) + bg) & 0x7E0F81F;
+    ret.full = (uint16_t)((result >> 16) | result);
+    return ret;
+}
+
+static inline void lv_color_premult(lv_color_t c, uint8_t mix, uint16_t *out)
+{
+    out[0] = (uint16_t)c.ch.red * mix;
+    out[1] = (uint16_t)c.ch.green * mix;
+    out[2] = (uint16_t)c.ch.blue * mix;
+}
+
+static inline lv_color_t lv_color_mix_premult(uint16_t *premult_c1, lv_color_t c2, uint8_t mix)
+{
+    lv_color_t ret;
+    ret.ch.red = LV_UDIV255((uint16_t)premult_c1[0] + c2.ch.red * mix);
+    ret.ch.green = LV_UDIV255((uint16_t)premult_c1[1] + c2.ch.green * mix);
+    ret.ch.blue = LV_UDIV255((uint16_t)premult_c1[2] + c2.ch.blue * mix);
+    return ret;
+}
+
+typedef struct {
+    lv_coord_t x1;
+    lv_coord_t y1;
+    lv_coord_t x2;
+    lv_coord_t y2;
+} lv_area_t;
+
+static inline lv_coord_t lv_area_get_width(const lv_area_t *area)
+{
+    return (lv_coord_t)(area->x2 - area->x1 + 1);
+}
+
+static inline lv_coord_t lv_area_get_height(const lv_area_t *area)
+{
+    return (lv_coord_t)(area->y2 - area->y1 + 1);
+}
+
+static inline bool _lv_area_intersect(lv_area_t *res, const lv_area_t *a1, const lv_area_t *a2)
+{
+    res->x1 = a1->x1 > a2->x1 ? a1->x1 : a2->x1;
+    res->y1 = a1->y1 > a2->y1 ? a1->y1 : a2->y1;
+    res->x2 = a1->x2 < a2->x2 ? a1->x2 : a2->x2;
+    res->y2 = a1->y2 < a2->y2 ? a1->y2 : a2->y2;
+    return res->x1 <= res->x2 && res->y1 <= res->y2;
+}
+
+// 与 LVGL 8.3 lv_area.c 相同
+static inline uint32_t lv_area_get_size(const lv_area_t *area_p)
+{
+    return (uint32_t)(area_p->x2 - area_p->x1 + 1) * (area_p->y2 - area_p->y1 + 1);
+}
+
+static inline void _lv_area_join(lv_area_t *a_res_p, const lv_area_t *a1_p, const lv_area_t *a2_p)
+{
+    a_res_p->x1 = LV_MIN(a1_p->x1, a2_p->x1);
+    a_res_p->y1 = LV_MIN(a1_p->y1, a2_p->y1);
+    a_res_p->x2 = LV_MAX(a1_p->x2, a2_p->x2);
+    a_res_p->y2 = LV_MAX(a1_p->y2, a2_p->y2);
+}
+
+typedef enum {
+    LV_BLEND_MODE_NORMAL,
+    LV_BLEND_MODE_ADDITIVE,
+    LV_BLEND_MODE_SUBTRACTIVE,
+    LV_BLEND_MODE_MULTIPLY,
+    LV_BLEND_MODE_REPLACE,
+} lv_blend_mode_t;
+
+typedef enum {
+    LV_DRAW_MASK_RES_TRANSP,
+    LV_DRAW_MASK_RES_FULL_COVER,
+    LV_DRAW_MASK_RES_CHANGED,
+    LV_DRAW_MASK_RES_UNKNOWN,
+} lv_draw_mask_res_t;
+
+typedef struct _lv_draw_ctx_t {
+    void *buf;
+    lv_area_t *buf_area;
+    const lv_area_t *clip_area;
+} lv_draw_ctx_t;
+
+typedef struct {
+    const lv_area_t *blend_area;
+    const lv_color_t *src_buf;
+    lv_color_t color;
+    lv_opa_t *mask_buf;
+    lv_draw_mask_res_t mask_res;
+    const lv_area_t *mask_area;
+    lv_opa_t opa;
+    lv_blend_mode_t blend_mode;
+} lv_draw_sw_blend_dsc_t;
+
+typedef struct {
+    lv_draw_ctx_t base_draw;
+    void (*blend)(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc);
+} lv_draw_sw_ctx_t;
+
+typedef struct {
+    void *buf1;
+    void *buf2;
+    void *buf_act;
+    uint32_t size;
+    volatile int flushing;
+    volatile int flushing_last;
+} lv_disp_draw_buf_t;
+
+typedef struct _lv_disp_drv_t {
+    lv_coord_t hor_res;
+    lv_coord_t ver_res;
+    lv_disp_draw_buf_t *draw_buf;
+    uint32_t direct_mode : 1;
+    void (*set_px_cb)(struct _lv_disp_drv_t *disp_drv, uint8_t *buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+                      lv_color_t color, lv_opa_t opa);
+    uint32_t screen_transp : 1;
+    void (*draw_ctx_init)(struct _lv_disp_drv_t *disp_drv, lv_draw_ctx_t *draw_ctx);
+    void (*draw_ctx_deinit)(struct _lv_disp_drv_t *disp_drv, lv_draw_ctx_t *draw_ctx);
+    size_t draw_ctx_size;
+    void *user_data;
+} lv_disp_drv_t;
+
+// 与 LVGL 8.3 lv_hal_disp.c 相同
+static inline void lv_disp_flush_ready(lv_disp_drv_t *disp_drv)
+{
+    disp_drv->draw_buf->flushing = 0;
+    disp_drv->draw_buf->flushing_last = 0;
+}
+
+static inline bool lv_disp_flush_is_last(lv_disp_drv_t *disp_drv)
+{
+    return disp_drv->draw_buf->flushing_last;
+}
+
+typedef struct _lv_timer_t lv_timer_t;
+typedef void (*lv_timer_cb_t)(lv_timer_t *timer);
+
+typedef struct {
+    lv_disp_drv_t *driver;
+    lv_timer_t *refr_timer;
+    lv_area_t inv_areas[LV_INV_BUF_SIZE];
+    uint8_t inv_area_joined[LV_INV_BUF_SIZE];
+    uint16_t inv_p;
+} lv_disp_t;
+
+// 不旋转
+static inline lv_coord_t lv_disp_get_hor_res(lv_disp_t *disp)
+{
+    return disp->driver->hor_res;
+}
+
+static inline lv_coord_t lv_disp_get_ver_res(lv_disp_t *disp)
+{
+    return disp->driver->ver_res;
+}
+
+typedef struct _lv_obj_t lv_obj_t;
+
+struct _lv_timer_t {
+    uint32_t period;
+    lv_timer_cb_t timer_cb;
+    void *user_data;
+    int32_t repeat_count;
+    uint32_t paused : 1;
+    uint32_t ready_calls;   // 主机替身：lv_timer_ready 的调用次数
+};
+
+// 定时器见 host_lvgl.c，只记录参数，由测试决定何时调用回调
+lv_timer_t *lv_timer_create(lv_timer_cb_t timer_xcb, uint32_t period, void *user_data);
+void lv_timer_set_period(lv_timer_t *timer, uint32_t period);
+void lv_timer_set_cb(lv_timer_t *timer, lv_timer_cb_t timer_cb);
+void lv_timer_pause(lv_timer_t *timer);
+void lv_timer_resume(lv_timer_t *timer);
+void lv_timer_ready(lv_timer_t *timer);
+
+typedef enum {
+    LV_INDEV_STATE_RELEASED = 0,
+    LV_INDEV_STATE_PRESSED,
+} lv_indev_state_t;
+
+typedef struct {
+    lv_timer_t *read_timer;
+} lv_indev_drv_t;
+
+typedef struct {
+    lv_indev_drv_t *driver;
+    struct {
+        lv_indev_state_t state;
+    } proc;
+} lv_indev_t;
+
+// 以下由测试程序提供
+lv_disp_t *_lv_refr_get_disp_refreshing(void);
+void _lv_disp_refr_timer(lv_timer_t *timer);
+void _lv_inv_area(lv_disp_t *disp, const lv_area_t *area_p);
+lv_disp_t *lv_disp_get_default(void);
+void lv_disp_trig_activity(lv_disp_t *disp);
+uint32_t lv_disp_get_inactive_time(const lv_disp_t *disp);
+uint16_t lv_anim_count_running(void);
+lv_obj_t *lv_indev_get_scroll_obj(const lv_indev_t *indev);
+void lv_draw_sw_blend_basic(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc);
+void lv_draw_sw_init_ctx(lv_disp_drv_t *drv, lv_draw_ctx_t *draw_ctx);
+void lv_draw_sw_deinit_ctx(lv_disp_drv_t *drv, lv_draw_ctx_t *draw_ctx);
+
+#endif
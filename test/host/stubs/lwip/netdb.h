@@ -0,0 +1,18 @@
+/**
+ * @file netdb.h
+ * @brief 主机测试用：lwIP 的 getaddrinfo，解析不出网，由 host_http.c 按设定的耗时推进模拟时钟
+ */
+
+#ifndef LWIP_NETDB_H
+#define LWIP_NETDB_H
+
+#include <netdb.h>
+#include <sys/socket.h>
+
+int host_getaddrinfo(const char *node, const char *service, const struct addrinfo *hints, struct addrinfo **res);
+void host_freeaddrinfo(struct addrinfo *res);
+
+#define getaddrinfo host_getaddrinfo
+#define freeaddrinfo host_freeaddrinfo
+
+#endif
@@ -0,0 +1,45 @@
+/**
+ * @file miniz.h
+ * @brief 主机测试用：ROM miniz 的 tinfl 接口，由 zlib 的 raw inflate 实现
+ *
+ * 只提供 gzip_stream 用到的部分，状态码和标志的数值与 miniz 一致。
+ * zlib 自带 32KB 窗口，不依赖调用者的输出缓冲区做回溯，测的是 gzip_stream 自己的逻辑
+ * （头尾状态机、跨块续解、超长和校验失败的处理），不是 ROM 中 tinfl 的实现。
+ */
+
+#ifndef MINIZ_H
+#define MINIZ_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zlib.h>
+
+typedef unsigned char mz_uint8;
+typedef unsigned int mz_uint32;
+
+#define TINFL_FLAG_PARSE_ZLIB_HEADER                1
+#define TINFL_FLAG_HAS_MORE_INPUT                   2
+#define TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF    4
+
+typedef enum {
+    TINFL_STATUS_FAILED_CANNOT_MAKE_PROGRESS = -4,
+    TINFL_STATUS_BAD_PARAM = -3,
+    TINFL_STATUS_ADLER32_MISMATCH = -2,
+    TINFL_STATUS_FAILED = -1,
+    TINFL_STATUS_DONE = 0,
+    TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+    TINFL_STATUS_HAS_MORE_OUTPUT = 2,
+} tinfl_status;
+
+typedef struct {
+    z_stream zs;
+    int initialized;
+} tinfl_decompressor;
+
+void tinfl_init(tinfl_decompressor *r);
+
+tinfl_status tinfl_decompress(tinfl_decompressor *r, const mz_uint8 *pIn_buf_next, size_t *pIn_buf_size,
+                              mz_uint8 *pOut_buf_start, mz_uint8 *pOut_buf_next, size_t *pOut_buf_size,
+                              const mz_uint32 decomp_flags);
+
+#endif
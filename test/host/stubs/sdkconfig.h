@@ -0,0 +1,14 @@
+/**
+ * @file sdkconfig.h
+ * @brief 主机测试用：被测模块用到的 Kconfig 选项（取 sdkconfig.defaults 中的值）
+ */
+
+#ifndef SDKCONFIG_H
+#define SDKCONFIG_H
+
+#define CONFIG_TODO_API_KEY "esp32-todo-secret-key-2025"
+#define CONFIG_TODO_HTTP_GZIP 1
+#define CONFIG_TODO_HTTP_CBOR 1
+#define CONFIG_TODO_JSON_ARENA 1
+
+#endif
@@ -0,0 +1,14 @@
+/**
+ * @file string.h
+ * @brief 主机测试用：补上 newlib 提供而旧版 glibc 没有的 strlcpy/strlcat（实现见 host_stubs.c）
+ */
+
+#ifndef HOST_STRING_H
+#define HOST_STRING_H
+
+#include_next <string.h>
+
+size_t strlcpy(char *dst, const char *src, size_t size);
+size_t strlcat(char *dst, const char *src, size_t size);
+
+#endif
@@ -0,0 +1,15 @@
+/**
+ * @file cdefs.h
+ * @brief 主机测试用：补上 newlib 的 __containerof（glibc 没有）
+ */
+
+#ifndef HOST_SYS_CDEFS_H
+#define HOST_SYS_CDEFS_H
+
+#include_next <sys/cdefs.h>
+
+#ifndef __containerof
+#define __containerof(ptr, type, member) ((type *)((char *)(ptr) - __builtin_offsetof(type, member)))
+#endif
+
+#endif
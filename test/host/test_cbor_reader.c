@@ -0,0 +1,259 @@
+/**
+ * @file test_cbor_reader.c
+ * @brief cbor_reader：RFC 8949 附录A的编码、跳过嵌套项、截断与畸形输入
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "cbor_reader.h"
+
+#define INIT(r, ...)                                    \
+    static const uint8_t data_[] = {__VA_ARGS__};       \
+    cbor_reader_init(&(r), data_, sizeof(data_))
+
+static void test_uint_widths(void)
+{
+    // 0, 23, 24, 1000, 1000000, 1000000000000, 18446744073709551614
+    const uint8_t data[] = {
+        0x00, 0x17, 0x18, 0x18, 0x19, 0x03, 0xE8, 0x1A, 0x00, 0x0F, 0x42, 0x40,
+        0x1B, 0x00, 0x00, 0x00, 0xE8, 0xD4, 0xA5, 0x10, 0x00,
+        0x1B, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+    };
+    const uint64_t expected[] = {0, 23, 24, 1000, 1000000, 1000000000000ULL, 18446744073709551614ULL};
+    cbor_reader_t r;
+    cbor_reader_init(&r, data, sizeof(data));
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        uint64_t v = 0;
+        CHECK_EQ(cbor_peek_type(&r), CBOR_TYPE_UINT);
+        CHECK(cbor_read_uint(&r, &v));
+        CHECK(v == expected[i]);
+    }
+    CHECK_EQ(cbor_peek_type(&r), CBOR_TYPE_END);
+    CHECK(!r.error);
+}
+
+static void test_text_and_bool(void)
+{
+    cbor_reader_t r;
+    // "IETF", "水", true, false, ""
+    INIT(r, 0x64, 'I', 'E', 'T', 'F', 0x63, 0xE6, 0xB0, 0xB4, 0xF5, 0xF4, 0x60);
+    const char *text;
+    size_t len;
+    bool b;
+    CHECK(cbor_read_text(&r, &text, &len));
+    CHECK(cbor_text_equals(text, len, "IETF"));
+    CHECK(!cbor_text_equals(text, len, "IETFX"));
+    CHECK(!cbor_text_equals(text, len, "IET"));
+    CHECK(text == (const char *)data_ + 1);    // 零拷贝
+    CHECK(cbor_read_text(&r, &text, &len));
+    CHECK(cbor_text_equals(text, len, "水"));
+    CHECK(cbor_read_bool(&r, &b) && b);
+    CHECK(cbor_read_bool(&r, &b) && !b);
+    CHECK(cbor_read_text(&r, &text, &len));
+    CHECK_EQ(len, 0);
+    CHECK(!r.error);
+}
+
+static void test_type_mismatch_sets_error(void)
+{
+    cbor_reader_t r;
+    uint64_t v;
+    bool b;
+    INIT(r, 0xF6, 0x01);    // null, 1
+    CHECK_EQ(cbor_peek_type(&r), CBOR_TYPE_SIMPLE);
+    CHECK(!cbor_read_bool(&r, &b));    // null 不是布尔值
+    CHECK(r.error);
+    // 出错后一切读取都失败
+    CHECK(!cbor_read_uint(&r, &v));
+    CHECK_EQ(cbor_peek_type(&r), CBOR_TYPE_END);
+}
+
+static void test_definite_map(void)
+{
+    // {"id": "a1", "isCompleted": true, "n": 7}
+    cbor_reader_t r;
+    INIT(r, 0xA3,
+         0x62, 'i', 'd', 0x62, 'a', '1',
+         0x6B, 'i', 's', 'C', 'o', 'm', 'p', 'l', 'e', 't', 'e', 'd', 0xF5,
+         0x61, 'n', 0x07);
+    uint32_t count;
+    CHECK(cbor_read_map(&r, &count));
+    CHECK_EQ(count, 3);
+
+    int seen = 0;
+    for (uint32_t n = count; cbor_container_next(&r, &n); seen++) {
+        const char *key;
+        size_t key_len;
+        CHECK(cbor_read_text(&r, &key, &key_len));
+        if (cbor_text_equals(key, key_len, "isCompleted")) {
+            bool b = false;
+            CHECK(cbor_read_bool(&r, &b) && b);
+        } else {
+            CHECK(cbor_skip(&r));
+        }
+    }
+    CHECK_EQ(seen, 3);
+    CHECK_EQ(cbor_peek_type(&r), CBOR_TYPE_END);
+    CHECK(!r.error);
+}
+
+static void test_indefinite_array(void)
+{
+    // [_ 1, [2, 3], [_ 4, 5]]
+    cbor_reader_t r;
+    INIT(r, 0x9F, 0x01, 0x82, 0x02, 0x03, 0x9F, 0x04, 0x05, 0xFF, 0xFF);
+    uint32_t count;
+    CHECK(cbor_read_array(&r, &count));
+    CHECK_EQ(count, CBOR_INDEFINITE);
+
+    int items = 0;
+    for (uint32_t n = count; cbor_container_next(&r, &n); items++) {
+        CHECK(cbor_skip(&r));
+    }
+    CHECK_EQ(items, 3);
+    CHECK(!r.error);
+    CHECK_EQ(cbor_peek_type(&r), CBOR_TYPE_END);
+}
+
+static void test_indefinite_missing_break(void)
+{
+    cbor_reader_t r;
+    INIT(r, 0xBF, 0x61, 'a', 0x01);    // {_ "a": 1   （缺结束标记）
+    uint32_t count;
+    CHECK(cbor_read_map(&r, &count));
+    uint32_t n = count;
+    CHECK(cbor_container_next(&r, &n));
+    CHECK(cbor_skip(&r) && cbor_skip(&r));
+    CHECK(!cbor_container_next(&r, &n));
+    CHECK(r.error);
+}
+
+static void test_skip_every_type(void)
+{
+    // -500, h'0102', (_ "ab", "c"), 1(1363896240), 1.5 (半精度), 100000.0 (单精度),
+    // 1.1 (双精度), null, {"k": [h'', {}]}，最后是 42
+    cbor_reader_t r;
+    INIT(r, 0x39, 0x01, 0xF3,
+         0x42, 0x01, 0x02,
+         0x7F, 0x62, 'a', 'b', 0x61, 'c', 0xFF,
+         0xC1, 0x1A, 0x51, 0x4B, 0x67, 0xB0,
+         0xF9, 0x3E, 0x00,
+         0xFA, 0x47, 0xC3, 0x50, 0x00,
+         0xFB, 0x3F, 0xF1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9A,
+         0xF6,
+         0xA1, 0x61, 'k', 0x82, 0x40, 0xA0,
+         0x18, 0x2A);
+    const cbor_type_t types[] = {
+        CBOR_TYPE_NEGINT, CBOR_TYPE_BYTES, CBOR_TYPE_TEXT, CBOR_TYPE_TAG,
+        CBOR_TYPE_SIMPLE, CBOR_TYPE_SIMPLE, CBOR_TYPE_SIMPLE, CBOR_TYPE_SIMPLE, CBOR_TYPE_MAP,
+    };
+    for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+        CHECK_EQ(cbor_peek_type(&r), types[i]);
+        CHECK(cbor_skip(&r));
+    }
+    uint64_t v = 0;
+    CHECK(cbor_read_uint(&r, &v));
+    CHECK_EQ(v, 42);
+    CHECK(!r.error);
+}
+
+static void test_skip_depth_limit(void)
+{
+    // 9 层嵌套超过跳过深度上限，8 层以内可以
+    uint8_t deep[16];
+    memset(deep, 0x81, sizeof(deep));
+    cbor_reader_t r;
+
+    deep[8] = 0x00;
+    cbor_reader_init(&r, deep, 9);
+    CHECK(cbor_skip(&r));
+    CHECK(!r.error);
+
+    memset(deep, 0x81, sizeof(deep));
+    deep[9] = 0x00;
+    cbor_reader_init(&r, deep, 10);
+    CHECK(!cbor_skip(&r));
+    CHECK(r.error);
+}
+
+static void test_truncated_input(void)
+{
+    cbor_reader_t r;
+    const char *text;
+    size_t len;
+    uint64_t v;
+    uint32_t count;
+
+    {
+        INIT(r, 0x65, 'h', 'e', 'l');    // 文本声明5字节只有3字节
+        CHECK(!cbor_read_text(&r, &text, &len));
+        CHECK(r.error);
+    }
+    {
+        INIT(r, 0x1A, 0x00, 0x01);    // 4字节整数只剩2字节
+        CHECK(!cbor_read_uint(&r, &v));
+    }
+    {
+        INIT(r, 0x82, 0x01);    // 两个元素的数组只有一个
+        CHECK(!cbor_skip(&r));
+        CHECK(r.error);
+    }
+    {
+        INIT(r, 0x5A, 0xFF, 0xFF, 0xFF, 0xFF, 0x00);    // 字节串长度远超输入
+        CHECK(!cbor_skip(&r));
+    }
+    {
+        cbor_reader_init(&r, NULL, 0);
+        CHECK_EQ(cbor_peek_type(&r), CBOR_TYPE_END);
+        CHECK(!cbor_read_array(&r, &count));
+    }
+}
+
+static void test_malformed_heads(void)
+{
+    cbor_reader_t r;
+    uint64_t v;
+    uint32_t count;
+    const char *text;
+    size_t len;
+
+    {
+        INIT(r, 0x1C);    // 附加信息 28-30 保留
+        CHECK(!cbor_read_uint(&r, &v));
+    }
+    {
+        INIT(r, 0x1F);    // 整数不能是不定长
+        CHECK(!cbor_read_uint(&r, &v));
+    }
+    {
+        INIT(r, 0x7F, 0x61, 'a', 0xFF);    // 分段文本串不支持直接读取，只能跳过
+        CHECK(!cbor_read_text(&r, &text, &len));
+    }
+    {
+        INIT(r, 0x9B, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00);    // 元素数超过32位
+        CHECK(!cbor_read_array(&r, &count));
+    }
+    {
+        INIT(r, 0x7F, 0x41, 0x00, 0xFF);    // 分段文本串中混入字节串
+        CHECK(!cbor_skip(&r));
+    }
+    {
+        INIT(r, 0xA1, 0x01);    // 读数组头时遇到映射
+        CHECK(!cbor_read_array(&r, &count));
+    }
+}
+
+int main(void)
+{
+    RUN_TEST(test_uint_widths);
+    RUN_TEST(test_text_and_bool);
+    RUN_TEST(test_type_mismatch_sets_error);
+    RUN_TEST(test_definite_map);
+    RUN_TEST(test_indefinite_array);
+    RUN_TEST(test_indefinite_missing_break);
+    RUN_TEST(test_skip_every_type);
+    RUN_TEST(test_skip_depth_limit);
+    RUN_TEST(test_truncated_input);
+    RUN_TEST(test_malformed_heads);
+    return HOST_TEST_EXIT_CODE();
+}
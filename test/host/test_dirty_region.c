@@ -0,0 +1,258 @@
+/**
+ * @file test_dirty_region.c
+ * @brief dirty_region：失效区域按代价合并、按屏幕裁剪、总代价达到整屏时改为整屏重绘，以及送屏统计
+ *
+ * 按 LVGL 8.3 的流程驱动：测试把失效区域写进 disp->inv_areas 后调用刷新定时器的回调，
+ * dirty_region 处理完交给 _lv_disp_refr_timer（由本测试提供，记下当时的区域后清空）。
+ * 屏幕 240x320，整屏代价 240*320 + DIRTY_AREA_OVERHEAD_PX。
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "dirty_region.h"
+
+#define H_RES   240
+#define V_RES   320
+
+static lv_disp_drv_t drv = {
+    .hor_res = H_RES,
+    .ver_res = V_RES,
+};
+static lv_disp_t disp = {.driver = &drv};
+
+static lv_area_t out[LV_INV_BUF_SIZE];
+static int out_n = -1;
+
+// LVGL 的刷新：记下交给它的失效区域，刷新完清空
+void _lv_disp_refr_timer(lv_timer_t *timer)
+{
+    lv_disp_t *d = (lv_disp_t *)timer->user_data;
+    memcpy(out, d->inv_areas, d->inv_p * sizeof(lv_area_t));
+    out_n = d->inv_p;
+    d->inv_p = 0;
+}
+
+/**
+ * @brief 一次刷新：in 作为失效区域，返回交给 LVGL 的区域数（区域在 out 中）
+ */
+static int refresh(const lv_area_t *in, int n)
+{
+    memcpy(disp.inv_areas, in, n * sizeof(lv_area_t));
+    disp.inv_p = n;
+    out_n = -1;
+    disp.refr_timer->timer_cb(disp.refr_timer);
+    return out_n;
+}
+
+// 合并后的顺序不固定，按内容查找
+static bool has_area(lv_coord_t x1, lv_coord_t y1, lv_coord_t x2, lv_coord_t y2)
+{
+    for (int i = 0; i < out_n; i++) {
+        if (out[i].x1 == x1 && out[i].y1 == y1 && out[i].x2 == x2 && out[i].y2 == y2) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int32_t cost(lv_coord_t w, lv_coord_t h)
+{
+    return w * h + DIRTY_AREA_OVERHEAD_PX;
+}
+
+static void test_merge_adjacent_lines(void)
+{
+    // 两行文字隔 2 行像素：外接矩形多出 400 像素，少一块区域省 512
+    static const lv_area_t in[] = {
+        {20, 40, 219, 55},
+        {20, 58, 219, 73},
+    };
+    dirty_region_stats_t before, after;
+    dirty_region_get_stats(&before);
+
+    CHECK_EQ(refresh(in, 2), 1);
+    CHECK(has_area(20, 40, 219, 73));
+
+    dirty_region_get_stats(&after);
+    CHECK_EQ(after.merges - before.merges, 1);
+    CHECK_EQ(after.saved_cost_px - before.saved_cost_px, DIRTY_AREA_OVERHEAD_PX - 2 * 200);
+    CHECK_EQ(after.inv_areas - before.inv_areas, 2);
+    CHECK_EQ(after.coalesced_areas - before.coalesced_areas, 1);
+}
+
+static void test_keep_distant_areas(void)
+{
+    // 左上角的图标和右下角的时间：外接矩形几乎整屏，不合并
+    static const lv_area_t in[] = {
+        {4, 4, 27, 27},
+        {190, 300, 235, 315},
+    };
+    dirty_region_stats_t before, after;
+    dirty_region_get_stats(&before);
+
+    CHECK_EQ(refresh(in, 2), 2);
+    CHECK(has_area(4, 4, 27, 27));
+    CHECK(has_area(190, 300, 235, 315));
+
+    dirty_region_get_stats(&after);
+    CHECK_EQ(after.merges - before.merges, 0);
+    CHECK_EQ(after.full_screen - before.full_screen, 0);
+}
+
+static void test_merge_until_not_worth(void)
+{
+    // 一张卡片上的三个复选框连成一块，另一张卡片上的不动
+    static const lv_area_t in[] = {
+        {10, 100, 29, 119},
+        {34, 100, 53, 119},
+        {58, 100, 77, 119},
+        {10, 250, 29, 269},
+    };
+    dirty_region_stats_t before, after;
+    dirty_region_get_stats(&before);
+
+    CHECK_EQ(refresh(in, 4), 2);
+    CHECK(has_area(10, 100, 77, 119));
+    CHECK(has_area(10, 250, 29, 269));
+
+    dirty_region_get_stats(&after);
+    CHECK_EQ(after.merges - before.merges, 2);
+    // 三块合成一块：省两份固定开销，多出两条 4x20 的缝
+    CHECK_EQ(after.saved_cost_px - before.saved_cost_px, 2 * DIRTY_AREA_OVERHEAD_PX - 2 * 4 * 20);
+}
+
+static void test_clip_to_screen(void)
+{
+    // 伸出屏幕右下角的区域裁到屏幕内，完全在屏幕外的丢掉
+    static const lv_area_t in[] = {
+        {200, 300, 260, 340},
+        {-10, -10, -1, -1},
+        {250, 0, 300, 10},
+    };
+    dirty_region_stats_t before, after;
+    dirty_region_get_stats(&before);
+
+    CHECK_EQ(refresh(in, 3), 1);
+    CHECK(has_area(200, 300, H_RES - 1, V_RES - 1));
+
+    dirty_region_get_stats(&after);
+    CHECK_EQ(after.inv_areas - before.inv_areas, 3);
+    CHECK_EQ(after.coalesced_areas - before.coalesced_areas, 1);
+    CHECK_EQ(after.merges - before.merges, 0);
+
+    // 裁剪后才按代价比较：两块隔 20 列，屏幕内只有 10 行高，合并划算；按原来的 91 行高算则不划算
+    static const lv_area_t edge[] = {
+        {0, 310, 109, 400},
+        {130, 310, 239, 400},
+    };
+    CHECK_EQ(refresh(edge, 2), 1);
+    CHECK(has_area(0, 310, H_RES - 1, V_RES - 1));
+}
+
+/**
+ * @brief 风车形的四块加中间一块拼成整屏：任何两块的外接矩形都不划算。
+ *        中间一块从 (80, 80) 起 center_w x center_h，总代价 = 64000 + center_w * center_h + 5 * 512
+ */
+static int refresh_pinwheel(int center_w, int center_h)
+{
+    lv_area_t in[] = {
+        {0, 0, 159, 79},
+        {160, 0, 239, 239},
+        {80, 240, 239, 319},
+        {0, 80, 79, 319},
+        {80, 80, 80 + center_w - 1, 80 + center_h - 1},
+    };
+    return refresh(in, center_h > 0 ? 5 : 4);
+}
+
+static void test_full_screen_threshold(void)
+{
+    int32_t screen = cost(H_RES, V_RES);
+    dirty_region_stats_t before, after;
+
+    // 只有四块：总代价 66048，远低于整屏
+    dirty_region_get_stats(&before);
+    CHECK_EQ(refresh_pinwheel(0, 0), 4);
+    // 中间 134 行：总代价 77280，比整屏 77312 低，保留五块
+    CHECK(64000 + 80 * 134 + 5 * DIRTY_AREA_OVERHEAD_PX < screen);
+    CHECK_EQ(refresh_pinwheel(80, 134), 5);
+    dirty_region_get_stats(&after);
+    CHECK_EQ(after.merges - before.merges, 0);
+    CHECK_EQ(after.full_screen - before.full_screen, 0);
+
+    // 中间 135 行：总代价 77360，超过整屏，改为整屏一块
+    CHECK(64000 + 80 * 135 + 5 * DIRTY_AREA_OVERHEAD_PX >= screen);
+    dirty_region_get_stats(&before);
+    CHECK_EQ(refresh_pinwheel(80, 135), 1);
+    CHECK(has_area(0, 0, H_RES - 1, V_RES - 1));
+    dirty_region_get_stats(&after);
+    CHECK_EQ(after.full_screen - before.full_screen, 1);
+    CHECK_EQ(after.saved_cost_px - before.saved_cost_px, 64000 + 80 * 135 + 5 * DIRTY_AREA_OVERHEAD_PX - screen);
+
+    // 中间一块 64x168（与下面一块有重叠）：总代价正好等于整屏，也改为整屏
+    CHECK_EQ(64000 + 64 * 168 + 5 * DIRTY_AREA_OVERHEAD_PX, screen);
+    dirty_region_get_stats(&before);
+    CHECK_EQ(refresh_pinwheel(64, 168), 1);
+    CHECK(has_area(0, 0, H_RES - 1, V_RES - 1));
+    dirty_region_get_stats(&after);
+    CHECK_EQ(after.full_screen - before.full_screen, 1);
+
+    // 已经只剩一块时不算整屏回退
+    static const lv_area_t big[] = {{0, 0, H_RES - 1, V_RES - 2}};
+    dirty_region_get_stats(&before);
+    CHECK_EQ(refresh(big, 1), 1);
+    CHECK(has_area(0, 0, H_RES - 1, V_RES - 2));
+    dirty_region_get_stats(&after);
+    CHECK_EQ(after.full_screen - before.full_screen, 0);
+}
+
+static void test_overlapping_merged_before_fallback(void)
+{
+    // 两块大面积重叠：成对合并已经划算，不走整屏回退
+    static const lv_area_t in[] = {
+        {0, 0, 239, 199},
+        {0, 100, 239, 319},
+    };
+    dirty_region_stats_t before, after;
+    dirty_region_get_stats(&before);
+
+    CHECK_EQ(refresh(in, 2), 1);
+    CHECK(has_area(0, 0, H_RES - 1, V_RES - 1));
+
+    dirty_region_get_stats(&after);
+    CHECK_EQ(after.merges - before.merges, 1);
+    CHECK_EQ(after.full_screen - before.full_screen, 0);
+}
+
+static void test_flush_stats(void)
+{
+    dirty_region_stats_t before, after;
+    dirty_region_get_stats(&before);
+
+    // 一帧分两次送屏，第二帧一次
+    lv_area_t a = {0, 0, 239, 31};
+    lv_area_t b = {0, 32, 239, 47};
+    dirty_region_on_flush(&a, NULL, false);
+    dirty_region_on_flush(&b, NULL, true);
+    dirty_region_on_flush(&a, NULL, true);
+
+    dirty_region_get_stats(&after);
+    CHECK_EQ(after.frames - before.frames, 2);
+    CHECK_EQ(after.flushed_areas - before.flushed_areas, 3);
+    CHECK_EQ(after.flushed_px - before.flushed_px, 240 * 32 * 2 + 240 * 16);
+}
+
+int main(void)
+{
+    disp.refr_timer = lv_timer_create(_lv_disp_refr_timer, 33, &disp);
+    dirty_region_init(&disp);
+
+    RUN_TEST(test_merge_adjacent_lines);
+    RUN_TEST(test_keep_distant_areas);
+    RUN_TEST(test_merge_until_not_worth);
+    RUN_TEST(test_clip_to_screen);
+    RUN_TEST(test_full_screen_threshold);
+    RUN_TEST(test_overlapping_merged_before_fallback);
+    RUN_TEST(test_flush_stats);
+    return HOST_TEST_EXIT_CODE();
+}
@@ -0,0 +1,327 @@
+/**
+ * @file test_display_power.c
+ * @brief display_power：模拟时钟上跑 24 小时，核对亮/暗/黑屏切换、唤醒、跳过的刷新和节省的刷新耗时
+ *
+ * 按 main.c 的界面循环每 REFR_PERIOD_MS 走一步：先产生界面变化（时钟每分钟、列表每 5 分钟），
+ * 再读触摸（经 display_power_filter_touch），然后运行刷新定时器（dirty_region 接管后交给本测试的
+ * _lv_disp_refr_timer），最后调用 display_power_process。渲染耗时按像素数推进模拟时钟。
+ * 一天中有五段触摸（其中一段在暗屏时），其余时间无人操作。
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "host_lcd.h"
+#include "dirty_region.h"
+#include "display_power.h"
+
+#define MS              1000LL
+#define S               (1000 * MS)
+#define DAY_US          (86400 * S)
+#define H_RES           240
+#define V_RES           320
+#define REFR_PERIOD_MS  33
+#define RENDER_NS_PX    50          // 模拟的渲染耗时只与像素数成正比
+#define TAP_MS          120
+#define MAX_TRANSITIONS 64
+
+typedef struct {
+    int64_t start_us;
+    int taps;
+    int interval_s;
+} session_t;
+
+typedef struct {
+    int64_t at_us;
+    display_power_state_t from;
+    display_power_state_t to;
+    int64_t inactive_us;        // 切换时距上次操作的时间
+} transition_t;
+
+static const lv_area_t clock_area = {170, 4, 229, 23};     // 60x20
+static const lv_area_t list_area = {0, 40, 239, 319};      // 240x280
+static const lv_area_t card_area = {10, 100, 229, 159};    // 点按的卡片 220x60
+
+// 07:30 看一眼列表，07:36 屏幕暗着时再点一下，中午和晚上各一段，睡前一下
+static const session_t sessions[] = {
+    {27005500 * MS, 12, 10},
+    {27380000 * MS, 1, 0},
+    {44110200 * MS, 1, 0},
+    {64802700 * MS, 30, 8},
+    {81940100 * MS, 1, 0},
+};
+
+static lv_disp_drv_t drv = {
+    .hor_res = H_RES,
+    .ver_res = V_RES,
+};
+static lv_disp_t disp = {.driver = &drv};
+
+static int64_t last_activity_us = 0;
+static transition_t transitions[MAX_TRANSITIONS];
+static int transition_count = 0;
+
+static uint32_t frames = 0;
+static uint64_t rendered_px = 0;
+static uint32_t dark_changes = 0;       // 黑屏时有界面变化的刷新周期
+static uint64_t dark_px = 0;
+
+// ---------- LVGL 替身 ----------
+
+lv_disp_t *lv_disp_get_default(void)
+{
+    return &disp;
+}
+
+void lv_disp_trig_activity(lv_disp_t *d)
+{
+    (void)d;
+    last_activity_us = host_time_us;
+}
+
+uint32_t lv_disp_get_inactive_time(const lv_disp_t *d)
+{
+    (void)d;
+    return (uint32_t)((host_time_us - last_activity_us) / MS);
+}
+
+// 与 LVGL 8.3 相同：按屏幕裁剪，已被包含的不重复记录，记满后改为整屏
+void _lv_inv_area(lv_disp_t *d, const lv_area_t *area_p)
+{
+    lv_area_t screen = {0, 0, H_RES - 1, V_RES - 1};
+    lv_area_t a;
+    if (!_lv_area_intersect(&a, area_p, &screen)) {
+        return;
+    }
+    for (int i = 0; i < d->inv_p; i++) {
+        const lv_area_t *o = &d->inv_areas[i];
+        if (a.x1 >= o->x1 && a.y1 >= o->y1 && a.x2 <= o->x2 && a.y2 <= o->y2) {
+            return;
+        }
+    }
+    if (d->inv_p < LV_INV_BUF_SIZE) {
+        d->inv_areas[d->inv_p++] = a;
+    } else {
+        d->inv_p = 1;
+        d->inv_areas[0] = screen;
+    }
+}
+
+// 渲染并送屏：每块区域按像素数推进模拟时钟
+void _lv_disp_refr_timer(lv_timer_t *timer)
+{
+    lv_disp_t *d = (lv_disp_t *)timer->user_data;
+    if (d->inv_p == 0) {
+        return;
+    }
+    for (int i = 0; i < d->inv_p; i++) {
+        uint32_t px = lv_area_get_size(&d->inv_areas[i]);
+        host_time_us += (int64_t)px * RENDER_NS_PX / 1000;
+        rendered_px += px;
+        dirty_region_on_flush(&d->inv_areas[i], NULL, i == d->inv_p - 1);
+    }
+    frames++;
+    d->inv_p = 0;
+}
+
+// ---------- 一天的模拟 ----------
+
+static bool touch_pressed(int64_t now)
+{
+    for (size_t s = 0; s < sizeof(sessions) / sizeof(sessions[0]); s++) {
+        for (int t = 0; t < sessions[s].taps; t++) {
+            int64_t down = sessions[s].start_us + (int64_t)t * sessions[s].interval_s * S;
+            if (now >= down && now < down + TAP_MS * MS) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void invalidate(const lv_area_t *area)
+{
+    if (disp.refr_timer->paused) {
+        dark_px += lv_area_get_size(area);
+    }
+    _lv_inv_area(&disp, area);
+}
+
+static void run_day(void)
+{
+    bool was_passed = false;
+    display_power_state_t state = display_power_get_state();
+
+    for (int64_t tick = 0; tick < DAY_US; tick += REFR_PERIOD_MS * MS) {
+        if (host_time_us < tick) {
+            host_time_us = tick;
+        }
+        int64_t prev = tick - REFR_PERIOD_MS * MS;
+
+        // 时钟每分钟走字，列表每 5 分钟定时刷新
+        bool changed = false;
+        if (tick > 0 && tick / (60 * S) != prev / (60 * S)) {
+            invalidate(&clock_area);
+            changed = true;
+        }
+        if (tick > 0 && tick / (300 * S) != prev / (300 * S)) {
+            invalidate(&list_area);
+            changed = true;
+        }
+        if (changed && disp.refr_timer->paused) {
+            dark_changes++;
+        }
+
+        // 触摸读取：交给 LVGL 的按压算操作，按下沿点开一张卡片
+        bool pressed = touch_pressed(tick);
+        bool passed = display_power_filter_touch(pressed);
+        if (passed) {
+            last_activity_us = host_time_us;
+            if (!was_passed) {
+                invalidate(&card_area);
+            }
+        }
+        was_passed = passed;
+
+        if (!disp.refr_timer->paused) {
+            disp.refr_timer->timer_cb(disp.refr_timer);
+        }
+        display_power_process();
+
+        display_power_state_t now_state = display_power_get_state();
+        if (now_state != state && transition_count < MAX_TRANSITIONS) {
+            transitions[transition_count++] = (transition_t){
+                .at_us = host_time_us,
+                .from = state,
+                .to = now_state,
+                .inactive_us = host_time_us - last_activity_us,
+            };
+        }
+        state = now_state;
+    }
+    host_time_us = DAY_US;
+}
+
+static int count_transitions(display_power_state_t from, display_power_state_t to)
+{
+    int n = 0;
+    for (int i = 0; i < transition_count; i++) {
+        if (transitions[i].from == from && transitions[i].to == to) {
+            n++;
+        }
+    }
+    return n;
+}
+
+static void test_day(void)
+{
+    int64_t step = REFR_PERIOD_MS * MS;
+
+    // 开机后、每段触摸结束后各暗一次；07:36 暗着时的点按直接恢复亮度，不算唤醒
+    CHECK_EQ(count_transitions(DISPLAY_POWER_ON, DISPLAY_POWER_DIM), 6);
+    CHECK_EQ(count_transitions(DISPLAY_POWER_DIM, DISPLAY_POWER_ON), 1);
+    CHECK_EQ(count_transitions(DISPLAY_POWER_DIM, DISPLAY_POWER_OFF), 5);
+    CHECK_EQ(count_transitions(DISPLAY_POWER_OFF, DISPLAY_POWER_ON), 4);
+    CHECK_EQ(count_transitions(DISPLAY_POWER_ON, DISPLAY_POWER_OFF), 0);
+
+    // 按无操作时间切换，误差不超过一步
+    for (int i = 0; i < transition_count; i++) {
+        const transition_t *t = &transitions[i];
+        if (t->to == DISPLAY_POWER_DIM) {
+            CHECK(t->inactive_us >= CONFIG_TODO_DISPLAY_DIM_SEC * S);
+            CHECK(t->inactive_us < CONFIG_TODO_DISPLAY_DIM_SEC * S + step);
+        } else if (t->to == DISPLAY_POWER_OFF) {
+            CHECK(t->inactive_us >= CONFIG_TODO_DISPLAY_OFF_SEC * S);
+            CHECK(t->inactive_us < CONFIG_TODO_DISPLAY_OFF_SEC * S + step);
+        } else {
+            CHECK(t->inactive_us < step);
+        }
+    }
+
+    display_power_stats_t stats;
+    display_power_get_stats(&stats);
+    CHECK_EQ(stats.state, DISPLAY_POWER_OFF);
+    CHECK_EQ(stats.wakeups, 4);
+    // 每次切换最多少记不到 1 秒
+    uint32_t total_s = stats.on_s + stats.dim_s + stats.off_s;
+    CHECK(total_s <= 86400);
+    CHECK(total_s >= 86400 - (uint32_t)transition_count);
+    CHECK(stats.off_s > 23 * 3600);
+
+    // 黑屏时每次界面变化都跳过，像素一个不差
+    CHECK_EQ(stats.flushes_avoided, dark_changes);
+    CHECK_EQ(stats.skipped_px, dark_px);
+    // 渲染耗时与像素数成正比，按亮屏时的平均值估算应正好等于跳过的渲染耗时
+    CHECK_EQ(stats.cpu_saved_ms, dark_px * RENDER_NS_PX / 1000000);
+
+    dirty_region_stats_t refr;
+    dirty_region_get_stats(&refr);
+    CHECK_EQ(refr.flushed_px, rendered_px);
+    CHECK_EQ(refr.refr_us, rendered_px * RENDER_NS_PX / 1000);
+
+    printf("   24 小时：亮 %lu s，暗 %lu s，黑 %lu s，唤醒 %lu 次\n", (unsigned long)stats.on_s,
+           (unsigned long)stats.dim_s, (unsigned long)stats.off_s, (unsigned long)stats.wakeups);
+    printf("   刷新 %lu 次 / %llu 像素，跳过 %lu 次 / %llu 像素，节省约 %lu ms 渲染\n", (unsigned long)frames,
+           (unsigned long long)rendered_px, (unsigned long)stats.flushes_avoided,
+           (unsigned long long)stats.skipped_px, (unsigned long)stats.cpu_saved_ms);
+}
+
+static void test_dark_one_skip_per_period(void)
+{
+    // 一个刷新周期内的多次变化，LVGL 只会刷新一次，也只记一次跳过
+    display_power_stats_t before, after;
+    host_time_us += S;
+    display_power_get_stats(&before);
+
+    _lv_inv_area(&disp, &clock_area);
+    display_power_process();
+    host_time_us += 10 * MS;
+    _lv_inv_area(&disp, &list_area);
+    display_power_process();
+    display_power_get_stats(&after);
+    CHECK_EQ(after.flushes_avoided - before.flushes_avoided, 1);
+    CHECK_EQ(after.skipped_px - before.skipped_px, 60 * 20);
+
+    host_time_us += (REFR_PERIOD_MS - 10) * MS;
+    display_power_process();
+    display_power_get_stats(&after);
+    CHECK_EQ(after.flushes_avoided - before.flushes_avoided, 2);
+    CHECK_EQ(after.skipped_px - before.skipped_px, 60 * 20 + 240 * 280);
+}
+
+static void test_dark_keeps_no_areas(void)
+{
+    // 一天结束时仍是黑屏：失效区域已被丢掉，唤醒时整屏重绘
+    CHECK(disp.refr_timer->paused);
+    CHECK(disp.inv_p == 0);
+
+    uint32_t before = frames;
+    uint32_t ready_before = disp.refr_timer->ready_calls;
+    display_power_filter_touch(true);
+    display_power_process();
+    CHECK_EQ(display_power_get_state(), DISPLAY_POWER_ON);
+    CHECK(!disp.refr_timer->paused);
+    CHECK_EQ(disp.refr_timer->ready_calls, ready_before + 1);
+    CHECK_EQ(disp.inv_p, 1);
+    disp.refr_timer->timer_cb(disp.refr_timer);
+    CHECK_EQ(frames, before + 1);
+    display_power_filter_touch(false);
+}
+
+int main(void)
+{
+    disp.refr_timer = lv_timer_create(_lv_disp_refr_timer, REFR_PERIOD_MS, &disp);
+    dirty_region_init(&disp);
+    CHECK_EQ(display_power_init(2), ESP_OK);
+
+    // 开机后先整屏画一帧再亮屏
+    _lv_inv_area(&disp, &list_area);
+    disp.refr_timer->timer_cb(disp.refr_timer);
+    display_power_on();
+    CHECK_EQ(host_ledc_duty(), 255);
+
+    run_day();
+    RUN_TEST(test_day);
+    RUN_TEST(test_dark_one_skip_per_period);
+    RUN_TEST(test_dark_keeps_no_areas);
+    return HOST_TEST_EXIT_CODE();
+}
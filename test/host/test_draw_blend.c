@@ -0,0 +1,269 @@
+/**
+ * @file test_draw_blend.c
+ * @brief draw_blend：除以255的移位算法，以及三种填充与 LVGL 8.3 fill_normal 逐位一致
+ *
+ * 直接包含 draw_blend.c 以便测试其中的静态函数。参照实现见 draw_blend_ref.h（照抄 LVGL 8.3
+ * lv_draw_sw_blend.c 的 lv_draw_sw_blend_basic/fill_normal）。
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "esp_random.h"
+#include "draw_blend_ref.h"
+#include "draw_blend.c"
+
+// ---------- LVGL 替身 ----------
+
+static lv_disp_drv_t disp_drv;
+static lv_disp_t disp = {.driver = &disp_drv};
+static int basic_calls = 0;
+
+lv_disp_t *_lv_refr_get_disp_refreshing(void)
+{
+    return &disp;
+}
+
+void lv_draw_sw_blend_basic(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc)
+{
+    (void)draw_ctx;
+    (void)dsc;
+    basic_calls++;
+}
+
+void lv_draw_sw_init_ctx(lv_disp_drv_t *drv, lv_draw_ctx_t *draw_ctx)
+{
+    (void)drv;
+    memset(draw_ctx, 0, sizeof(lv_draw_sw_ctx_t));
+    ((lv_draw_sw_ctx_t *)draw_ctx)->blend = lv_draw_sw_blend_basic;
+}
+
+void lv_draw_sw_deinit_ctx(lv_disp_drv_t *drv, lv_draw_ctx_t *draw_ctx)
+{
+    (void)drv;
+    (void)draw_ctx;
+}
+
+// ---------- 测试 ----------
+
+#define BUF_W 37
+#define BUF_H 9
+#define MASK_W 48
+#define MASK_H 12
+
+static lv_area_t buf_area = {.x1 = 100, .y1 = 200, .x2 = 100 + BUF_W - 1, .y2 = 200 + BUF_H - 1};
+static lv_color_t initial[BUF_W * BUF_H];
+static lv_color_t got[BUF_W * BUF_H + 1];
+static lv_color_t want[BUF_W * BUF_H];
+static lv_opa_t mask_storage[MASK_W * MASK_H + 4];
+
+static lv_draw_sw_ctx_t sw_ctx;
+
+static lv_color_t random_color(void)
+{
+    lv_color_t c = {.full = (uint16_t)esp_random()};
+    return c;
+}
+
+/**
+ * @brief 背景：大片同色中夹杂随机像素，覆盖混合缓存命中和失效
+ */
+static void fill_background(int style)
+{
+    lv_color_t base = random_color();
+    for (int i = 0; i < BUF_W * BUF_H; i++) {
+        if (style == 0) {
+            initial[i] = base;
+        } else if (style == 1) {
+            initial[i] = esp_random() % 8 == 0 ? random_color() : base;
+        } else if (style == 2) {
+            initial[i].full = i < 5 ? 0 : (esp_random() % 2 ? base.full : 0);    // 纯黑与缓存初值
+        } else {
+            initial[i] = random_color();
+        }
+    }
+}
+
+/**
+ * @brief 遮罩：成段全透明/全覆盖，边缘是随机中间值
+ */
+static void fill_mask_values(lv_opa_t *mask, int style)
+{
+    for (int i = 0; i < MASK_W * MASK_H; i++) {
+        uint32_t r = esp_random();
+        if (style == 0) {
+            mask[i] = (i / 5) % 2 ? LV_OPA_COVER : LV_OPA_TRANSP;
+        } else if (style == 1) {
+            mask[i] = r % 4 == 0 ? (lv_opa_t)(r >> 8) : ((i / 7) % 3 == 0 ? 0 : 255);
+        } else {
+            mask[i] = (lv_opa_t)(r >> 8);
+        }
+    }
+}
+
+static int compare_case(lv_draw_sw_blend_dsc_t *dsc, lv_area_t *clip)
+{
+    // 目标缓冲区偏移一个像素，覆盖非4字节对齐的起点
+    lv_color_t *dest = got + ((esp_random() & 1) ? 1 : 0);
+    memcpy(dest, initial, sizeof(initial));
+    memcpy(want, initial, sizeof(initial));
+
+    sw_ctx.base_draw.buf = dest;
+    sw_ctx.base_draw.buf_area = &buf_area;
+    sw_ctx.base_draw.clip_area = clip;
+    sw_ctx.blend(&sw_ctx.base_draw, dsc);
+
+    sw_ctx.base_draw.buf = want;
+    ref_blend(&sw_ctx.base_draw, dsc);
+    return memcmp(dest, want, sizeof(want)) == 0;
+}
+
+static void test_div255(void)
+{
+    for (uint32_t x = 0; x < 65535; x++) {
+        if (div255(x) != LV_UDIV255(x) || div255(x) != x / 255) {
+            CHECK_EQ(div255(x), x / 255);
+            break;
+        }
+    }
+
+    // 双通道只用于 5 位分量乘 8 位系数之和，每个通道不超过 31*255
+    const uint32_t lane_max = 31 * 255;
+    for (uint32_t hi = 0; hi <= lane_max; hi++) {
+        for (uint32_t lo = 0; lo <= lane_max; lo++) {
+            uint32_t both = div255_x2((hi << 16) | lo);
+            if (both != (((hi / 255) << 16) | (lo / 255))) {
+                CHECK_EQ(both, ((hi / 255) << 16) | (lo / 255));
+                return;
+            }
+        }
+    }
+}
+
+static void test_unpack_pack_roundtrip(void)
+{
+    for (uint32_t c = 0; c <= 0xFFFF; c++) {
+        uint32_t back = pack_rbg(unpack_rb((uint16_t)c), (c >> 5) & 0x3F);
+        if (back != c) {
+            CHECK_EQ(back, c);
+            break;
+        }
+    }
+}
+
+static void test_matches_lvgl(void)
+{
+    const lv_opa_t opas[] = {3, 64, 127, 128, 200, 252, 253, 254, 255};
+    const lv_area_t blend_areas[] = {
+        {100, 200, 100 + BUF_W - 1, 200 + BUF_H - 1},   // 整个缓冲区
+        {103, 201, 131, 207},                           // 内部
+        {90, 195, 110, 203},                            // 越过左上角
+        {120, 205, 160, 220},                           // 越过右下角
+        {101, 202, 101, 202},                           // 单像素
+        {102, 200, 104, 208},                           // 3 像素宽
+    };
+    lv_area_t clip = buf_area;
+    lv_area_t mask_area;
+    int cases = 0;
+    int mismatches = 0;
+
+    for (int round = 0; round < 40; round++) {
+        for (size_t a = 0; a < sizeof(blend_areas) / sizeof(blend_areas[0]); a++) {
+            for (size_t o = 0; o < sizeof(opas); o++) {
+                for (int kind = 0; kind < 4; kind++) {
+                    fill_background(round % 4);
+                    lv_draw_sw_blend_dsc_t dsc = {
+                        .blend_area = &blend_areas[a],
+                        .color = random_color(),
+                        .opa = opas[o],
+                        .blend_mode = LV_BLEND_MODE_NORMAL,
+                        .mask_res = LV_DRAW_MASK_RES_CHANGED,
+                    };
+                    if (kind >= 2) {
+                        // 遮罩区域比混合区域大，起点偏移 0..3 字节
+                        lv_opa_t *mask = mask_storage + esp_random() % 4;
+                        fill_mask_values(mask, round % 3);
+                        mask_area.x1 = blend_areas[a].x1 - (lv_coord_t)(esp_random() % 3);
+                        mask_area.y1 = blend_areas[a].y1 - 1;
+                        mask_area.x2 = mask_area.x1 + MASK_W - 1;
+                        mask_area.y2 = mask_area.y1 + MASK_H - 1;
+                        if (lv_area_get_width(&blend_areas[a]) + 2 > MASK_W ||
+                            lv_area_get_height(&blend_areas[a]) + 1 > MASK_H) {
+                            continue;
+                        }
+                        dsc.mask_buf = mask;
+                        dsc.mask_area = &mask_area;
+                        dsc.mask_res = kind == 3 ? LV_DRAW_MASK_RES_FULL_COVER : LV_DRAW_MASK_RES_CHANGED;
+                    } else if (kind == 1) {
+                        // 裁剪区域小于缓冲区
+                        clip = (lv_area_t){105, 202, 125, 206};
+                    }
+                    cases++;
+                    if (!compare_case(&dsc, &clip)) {
+                        mismatches++;
+                        if (mismatches <= 5) {
+                            fprintf(stderr, "不一致: 区域 %zu, opa %u, 类型 %d, 轮 %d\n", a, opas[o], kind, round);
+                        }
+                    }
+                    clip = buf_area;
+                }
+            }
+        }
+    }
+    CHECK(cases > 1000);
+    CHECK_EQ(mismatches, 0);
+}
+
+static void test_fallbacks_and_no_ops(void)
+{
+    lv_area_t clip = buf_area;
+    lv_area_t outside = {10, 10, 20, 20};
+    lv_color_t src[4] = {{.full = 0x1234}};
+    fill_background(3);
+
+    // 贴图、非普通混合模式、set_px_cb 交给 LVGL
+    lv_draw_sw_blend_dsc_t dsc = {.blend_area = &buf_area, .opa = 255, .src_buf = src};
+    int before = basic_calls;
+    sw_ctx.base_draw.buf = got;
+    sw_ctx.base_draw.buf_area = &buf_area;
+    sw_ctx.base_draw.clip_area = &clip;
+    sw_ctx.blend(&sw_ctx.base_draw, &dsc);
+    dsc.src_buf = NULL;
+    dsc.blend_mode = LV_BLEND_MODE_ADDITIVE;
+    sw_ctx.blend(&sw_ctx.base_draw, &dsc);
+    dsc.blend_mode = LV_BLEND_MODE_NORMAL;
+    disp_drv.screen_transp = 1;
+    sw_ctx.blend(&sw_ctx.base_draw, &dsc);
+    disp_drv.screen_transp = 0;
+    CHECK_EQ(basic_calls - before, 3);
+
+    // 全透明遮罩、与裁剪区域不相交：不改动缓冲区
+    lv_opa_t mask[16] = {0};
+    lv_draw_sw_blend_dsc_t transp = {
+        .blend_area = &buf_area, .opa = 255, .color = {.full = 0xFFFF},
+        .mask_buf = mask, .mask_res = LV_DRAW_MASK_RES_TRANSP, .mask_area = &buf_area,
+    };
+    memcpy(got, initial, sizeof(initial));
+    sw_ctx.base_draw.buf = got;
+    sw_ctx.blend(&sw_ctx.base_draw, &transp);
+    CHECK(memcmp(got, initial, sizeof(initial)) == 0);
+
+    lv_draw_sw_blend_dsc_t away = {.blend_area = &outside, .opa = 255, .color = {.full = 0xFFFF}};
+    sw_ctx.blend(&sw_ctx.base_draw, &away);
+    CHECK(memcmp(got, initial, sizeof(initial)) == 0);
+}
+
+int main(void)
+{
+    host_random_seed(44);
+    draw_blend_attach(&disp_drv);
+    CHECK(disp_drv.draw_ctx_size == sizeof(lv_draw_sw_ctx_t));
+    disp_drv.draw_ctx_init(&disp_drv, &sw_ctx.base_draw);
+    CHECK(sw_ctx.blend == blend_cb);
+
+    RUN_TEST(test_div255);
+    RUN_TEST(test_unpack_pack_roundtrip);
+    RUN_TEST(test_matches_lvgl);
+    RUN_TEST(test_fallbacks_and_no_ops);
+    return HOST_TEST_EXIT_CODE();
+}
@@ -0,0 +1,311 @@
+/**
+ * @file test_gzip_stream.c
+ * @brief gzip_stream：分块解压、可选头部字段、超长与校验失败，
+ *        以及 100/1000 条列表的传输字节数和解压耗时
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+#include "host_test.h"
+#include "host_pages.h"
+#include "gzip_stream.h"
+
+#define OUT_SIZE 8192
+
+static char payload[4096];
+static size_t payload_len;
+static char out[OUT_SIZE];
+
+/**
+ * @brief 生成一段类似列表响应的 JSON 文本
+ */
+static void make_payload(void)
+{
+    payload_len = 0;
+    for (int i = 0; payload_len + 96 < sizeof(payload); i++) {
+        payload_len += snprintf(payload + payload_len, sizeof(payload) - payload_len,
+                                "{\"id\":\"AAMkAD%04d\",\"title\":\"任务 %d\",\"status\":\"%s\"},",
+                                i, i, i % 3 ? "notStarted" : "completed");
+    }
+}
+
+/**
+ * @brief 用 zlib 生成 raw deflate 数据
+ */
+static size_t deflate_raw(const void *src, size_t len, uint8_t *dst, size_t dst_size)
+{
+    z_stream zs = {0};
+    deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    zs.next_in = (Bytef *)src;
+    zs.avail_in = (uInt)len;
+    zs.next_out = dst;
+    zs.avail_out = (uInt)dst_size;
+    deflate(&zs, Z_FINISH);
+    size_t n = zs.total_out;
+    deflateEnd(&zs);
+    return n;
+}
+
+static void put_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = (v >> 24) & 0xFF;
+}
+
+/**
+ * @brief 组装 gzip 流
+ * @param flags gzip 头部 FLG，按标志写入 FEXTRA/FNAME/FCOMMENT/FHCRC
+ */
+static size_t make_gzip(const void *src, size_t len, uint8_t flags, uint8_t *dst, size_t dst_size)
+{
+    size_t n = 0;
+    const uint8_t header[10] = {0x1F, 0x8B, 8, flags, 0, 0, 0, 0, 0, 3};
+    memcpy(dst, header, sizeof(header));
+    n += sizeof(header);
+    if (flags & 0x04) {
+        const uint8_t extra[] = {5, 0, 'A', 'P', 1, 0, 'x'};
+        memcpy(dst + n, extra, sizeof(extra));
+        n += sizeof(extra);
+    }
+    if (flags & 0x08) {
+        memcpy(dst + n, "todos.json", 11);
+        n += 11;
+    }
+    if (flags & 0x10) {
+        memcpy(dst + n, "comment", 8);
+        n += 8;
+    }
+    if (flags & 0x02) {
+        dst[n++] = 0x12;
+        dst[n++] = 0x34;
+    }
+    n += deflate_raw(src, len, dst + n, dst_size - n - 8);
+    put_le32(dst + n, (uint32_t)crc32(0, src, (uInt)len));
+    put_le32(dst + n + 4, (uint32_t)len);
+    return n + 8;
+}
+
+/**
+ * @brief 按固定块大小送入，返回第一个失败的结果
+ */
+static esp_err_t feed_chunked(gzip_stream_t *gz, const uint8_t *data, size_t len, size_t chunk)
+{
+    for (size_t pos = 0; pos < len; pos += chunk) {
+        size_t n = len - pos < chunk ? len - pos : chunk;
+        esp_err_t err = gzip_stream_feed(gz, data + pos, n);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    return ESP_OK;
+}
+
+static gzip_stream_t *gz;
+static uint8_t packed[OUT_SIZE];
+
+static void test_single_chunk(void)
+{
+    size_t len = make_gzip(payload, payload_len, 0, packed, sizeof(packed));
+    CHECK(len < payload_len / 2);
+
+    gzip_stream_begin(gz, out, sizeof(out));
+    CHECK_EQ(gzip_stream_feed(gz, packed, len), ESP_OK);
+    size_t out_len = 0;
+    CHECK_EQ(gzip_stream_finish(gz, &out_len), ESP_OK);
+    CHECK_EQ(out_len, payload_len);
+    CHECK(memcmp(out, payload, payload_len) == 0);
+    CHECK_EQ(out[out_len], '\0');
+    CHECK_EQ(gzip_stream_get_compressed_len(gz), len);
+}
+
+static void test_every_chunk_size(void)
+{
+    // 头、尾和 deflate 数据在任意位置被拆开
+    size_t len = make_gzip(payload, payload_len, 0, packed, sizeof(packed));
+    const size_t chunks[] = {1, 2, 3, 7, 10, 11, 64, 333};
+    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        memset(out, 0xAA, sizeof(out));
+        gzip_stream_begin(gz, out, sizeof(out));
+        CHECK_EQ(feed_chunked(gz, packed, len, chunks[i]), ESP_OK);
+        size_t out_len = 0;
+        CHECK_EQ(gzip_stream_finish(gz, &out_len), ESP_OK);
+        CHECK_EQ(out_len, payload_len);
+        CHECK(memcmp(out, payload, payload_len) == 0);
+    }
+}
+
+static void test_optional_header_fields(void)
+{
+    const uint8_t flag_sets[] = {0x04, 0x08, 0x10, 0x02, 0x1E};
+    for (size_t i = 0; i < sizeof(flag_sets); i++) {
+        size_t len = make_gzip(payload, payload_len, flag_sets[i], packed, sizeof(packed));
+        gzip_stream_begin(gz, out, sizeof(out));
+        CHECK_EQ(feed_chunked(gz, packed, len, 3), ESP_OK);
+        size_t out_len = 0;
+        CHECK_EQ(gzip_stream_finish(gz, &out_len), ESP_OK);
+        CHECK_EQ(out_len, payload_len);
+    }
+}
+
+static void test_empty_extra_field(void)
+{
+    // FEXTRA 长度为0时直接进入下一个字段
+    uint8_t data[64];
+    const uint8_t header[] = {0x1F, 0x8B, 8, 0x04 | 0x08, 0, 0, 0, 0, 0, 3, 0, 0, 'n', 0};
+    memcpy(data, header, sizeof(header));
+    size_t n = sizeof(header) + deflate_raw("ok", 2, data + sizeof(header), sizeof(data) - sizeof(header) - 8);
+    put_le32(data + n, (uint32_t)crc32(0, (const Bytef *)"ok", 2));
+    put_le32(data + n + 4, 2);
+
+    gzip_stream_begin(gz, out, sizeof(out));
+    CHECK_EQ(gzip_stream_feed(gz, data, n + 8), ESP_OK);
+    CHECK_EQ(gzip_stream_finish(gz, NULL), ESP_OK);
+    CHECK(strcmp(out, "ok") == 0);
+}
+
+static void test_output_too_large(void)
+{
+    size_t len = make_gzip(payload, payload_len, 0, packed, sizeof(packed));
+    // 结尾'\0'占1字节，正好放得下时成功，少1字节时失败
+    gzip_stream_begin(gz, out, payload_len + 1);
+    CHECK_EQ(gzip_stream_feed(gz, packed, len), ESP_OK);
+    CHECK_EQ(gzip_stream_finish(gz, NULL), ESP_OK);
+
+    gzip_stream_begin(gz, out, payload_len);
+    CHECK_EQ(feed_chunked(gz, packed, len, 100), ESP_ERR_INVALID_SIZE);
+    CHECK_EQ(gzip_stream_feed(gz, packed, 1), ESP_ERR_INVALID_RESPONSE);
+    CHECK(gzip_stream_finish(gz, NULL) != ESP_OK);
+}
+
+static void test_not_gzip(void)
+{
+    gzip_stream_begin(gz, out, sizeof(out));
+    CHECK_EQ(gzip_stream_feed(gz, "{\"todos\":[]}", 12), ESP_ERR_INVALID_RESPONSE);
+    CHECK_EQ(gzip_stream_finish(gz, NULL), ESP_ERR_INVALID_RESPONSE);
+}
+
+static void test_corrupt_deflate(void)
+{
+    size_t len = make_gzip(payload, payload_len, 0, packed, sizeof(packed));
+    packed[10] = 0xFF;    // 第一个 deflate 块头：保留的块类型 11
+    gzip_stream_begin(gz, out, sizeof(out));
+    CHECK_EQ(gzip_stream_feed(gz, packed, len), ESP_ERR_INVALID_RESPONSE);
+}
+
+static void test_bad_trailer(void)
+{
+    size_t len = make_gzip(payload, payload_len, 0, packed, sizeof(packed));
+
+    packed[len - 8] ^= 0x01;    // CRC32
+    gzip_stream_begin(gz, out, sizeof(out));
+    CHECK_EQ(gzip_stream_feed(gz, packed, len), ESP_OK);
+    CHECK_EQ(gzip_stream_finish(gz, NULL), ESP_ERR_INVALID_CRC);
+    packed[len - 8] ^= 0x01;
+
+    packed[len - 4] ^= 0x01;    // ISIZE
+    gzip_stream_begin(gz, out, sizeof(out));
+    CHECK_EQ(gzip_stream_feed(gz, packed, len), ESP_OK);
+    CHECK_EQ(gzip_stream_finish(gz, NULL), ESP_ERR_INVALID_CRC);
+}
+
+static void test_truncated(void)
+{
+    size_t len = make_gzip(payload, payload_len, 0, packed, sizeof(packed));
+    // 连接中途断开：缺尾部，或缺一部分 deflate 数据
+    const size_t cut[] = {len - 1, len - 8, len / 2, 5};
+    for (size_t i = 0; i < sizeof(cut) / sizeof(cut[0]); i++) {
+        gzip_stream_begin(gz, out, sizeof(out));
+        CHECK_EQ(gzip_stream_feed(gz, packed, cut[i]), ESP_OK);
+        CHECK_EQ(gzip_stream_finish(gz, NULL), ESP_ERR_INVALID_RESPONSE);
+    }
+}
+
+static void test_reuse_after_error(void)
+{
+    // 出错后 begin 开始新的流，解压器状态完全重置
+    gzip_stream_begin(gz, out, sizeof(out));
+    gzip_stream_feed(gz, "garbage", 7);
+
+    size_t len = make_gzip("second", 6, 0, packed, sizeof(packed));
+    gzip_stream_begin(gz, out, sizeof(out));
+    CHECK_EQ(gzip_stream_feed(gz, packed, len), ESP_OK);
+    CHECK_EQ(gzip_stream_finish(gz, NULL), ESP_OK);
+    CHECK(strcmp(out, "second") == 0);
+    CHECK_EQ(gzip_stream_get_compressed_len(gz), len);
+}
+
+#define BENCH_PAGE_SIZE 10     // 与 TODO_PAGE_SIZE 相同
+#define BENCH_MSS       1436   // 按一个 TCP 段的大小分块到达
+#define BENCH_ROUNDS    20
+
+/**
+ * @brief 整个列表按页获取：每页未压缩/gzip 字节数求和，并测量流式解压耗时
+ *
+ * 压缩用 zlib 最高级别（与 Python gzip 模块默认相同）；解压走 gzip_stream，
+ * 主机上 tinfl 由 zlib 代替，所以耗时只能说明 gzip_stream 自身的开销量级，不是 ESP32 上的数字。
+ */
+static void bench_list(int total)
+{
+    static char page[OUT_SIZE];
+    static uint8_t page_gz[OUT_SIZE];
+    size_t raw_bytes = 0;
+    size_t gz_bytes = 0;
+    int64_t decode_us = 0;
+    int pages = 0;
+
+    for (int first = 0; first < total; first += BENCH_PAGE_SIZE) {
+        int count = total - first < BENCH_PAGE_SIZE ? total - first : BENCH_PAGE_SIZE;
+        size_t len = host_page_json(page, sizeof(page), first, count, total);
+        CHECK(len > 0);  // 一页能放进 8KB 接收缓冲区
+        size_t gz_len = make_gzip(page, len, 0, page_gz, sizeof(page_gz));
+        raw_bytes += len;
+        gz_bytes += gz_len;
+        pages++;
+
+        int64_t start = host_monotonic_us();
+        for (int round = 0; round < BENCH_ROUNDS; round++) {
+            gzip_stream_begin(gz, out, sizeof(out));
+            CHECK_EQ(feed_chunked(gz, page_gz, gz_len, BENCH_MSS), ESP_OK);
+            size_t out_len = 0;
+            CHECK_EQ(gzip_stream_finish(gz, &out_len), ESP_OK);
+            CHECK_EQ(out_len, len);
+        }
+        decode_us += host_monotonic_us() - start;
+        CHECK(memcmp(out, page, len) == 0);
+    }
+
+    // 重复的 id 前缀和键名至少能压掉三分之二
+    CHECK(gz_bytes * 3 < raw_bytes);
+    double per_page_us = (double)decode_us / BENCH_ROUNDS / pages;
+    printf("   %d 条 (%d 页): JSON %zu 字节, gzip %zu 字节 (%.1f%%), 解压 %.1f us/页 (主机)\n",
+           total, pages, raw_bytes, gz_bytes, 100.0 * gz_bytes / raw_bytes, per_page_us);
+}
+
+static void test_list_bytes_and_decode_time(void)
+{
+    bench_list(100);
+    bench_list(1000);
+}
+
+int main(void)
+{
+    make_payload();
+    gz = gzip_stream_create();
+    CHECK(gz != NULL);
+
+    RUN_TEST(test_single_chunk);
+    RUN_TEST(test_every_chunk_size);
+    RUN_TEST(test_optional_header_fields);
+    RUN_TEST(test_empty_extra_field);
+    RUN_TEST(test_output_too_large);
+    RUN_TEST(test_not_gzip);
+    RUN_TEST(test_corrupt_deflate);
+    RUN_TEST(test_bad_trailer);
+    RUN_TEST(test_truncated);
+    RUN_TEST(test_reuse_after_error);
+    RUN_TEST(test_list_bytes_and_decode_time);
+    return HOST_TEST_EXIT_CODE();
+}
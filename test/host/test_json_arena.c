@@ -0,0 +1,177 @@
+/**
+ * @file test_json_arena.c
+ * @brief json_arena：安装 cJSON 钩子后反复解析列表页，统计内存池峰值、追加块和回退 malloc 的次数，
+ *        并核对追加块在 json_arena_end 时全部归还
+ *
+ * cJSON 为 host_cjson.c 的替身，分配次数和大小与 cJSON 1.7.18 相同（节点按 64 位主机计）。
+ * 列表页由 host_pages.c 生成，字段长度取自实际数据。
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "host_pages.h"
+#include "esp_heap_caps.h"
+#include "cJSON.h"
+#include "json_arena.h"
+
+#define ROUNDS      10000
+#define PAGE_ITEMS  10          // 与 TODO_PAGE_SIZE 相同
+#define LIST_TOTAL  25
+
+static char page_json[8192];
+static size_t page_len;
+
+static bool page_ok(const cJSON *root)
+{
+    const cJSON *value = cJSON_GetObjectItem(root, "value");
+    if (!cJSON_IsArray(value) || cJSON_GetArraySize(value) != PAGE_ITEMS) {
+        return false;
+    }
+    for (int i = 0; i < PAGE_ITEMS; i++) {
+        host_item_t want;
+        host_page_item(i, &want);
+        const cJSON *item = cJSON_GetArrayItem(value, i);
+        const cJSON *id = cJSON_GetObjectItem(item, "id");
+        const cJSON *title = cJSON_GetObjectItem(item, "title");
+        if (!cJSON_IsString(id) || strcmp(id->valuestring, want.id) != 0 ||
+            !cJSON_IsString(title) || strcmp(title->valuestring, want.title) != 0) {
+            return false;
+        }
+    }
+    return cJSON_IsString(cJSON_GetObjectItem(root, "nextCursor"));
+}
+
+static void test_outside_request_uses_heap(void)
+{
+    json_arena_stats_t before, after;
+    json_arena_get_stats(&before);
+
+    // 不在请求中：照常 malloc/free，记为回退
+    cJSON *root = cJSON_Parse("{\"a\":\"b\"}");
+    CHECK(root != NULL);
+    cJSON_Delete(root);
+
+    json_arena_get_stats(&after);
+    // 根节点、成员节点、键名、字符串值
+    CHECK_EQ(after.heap_fallbacks - before.heap_fallbacks, 4);
+    CHECK_EQ(after.allocs - before.allocs, 0);
+    CHECK_EQ(after.requests - before.requests, 0);
+}
+
+static void test_parse_page_rounds(void)
+{
+    json_arena_stats_t before, after;
+
+    // 第一次请求分配常驻的基础块，之后内部RAM不再变化
+    json_arena_begin();
+    cJSON_Delete(cJSON_Parse(page_json));
+    json_arena_end();
+
+    size_t internal_base = host_heap_used(false);
+    size_t psram_base = host_heap_used(true);
+    uint32_t internal_calls = host_heap_alloc_calls(false);
+    uint32_t psram_calls = host_heap_alloc_calls(true);
+    json_arena_get_stats(&before);
+
+    size_t psram_peak = psram_base;
+    int bad_pages = 0;
+    int leaked = 0;
+    for (int i = 0; i < ROUNDS; i++) {
+        json_arena_begin();
+        cJSON *root = cJSON_Parse(page_json);
+        if (root == NULL || ((i == 0 || i == ROUNDS - 1) && !page_ok(root))) {
+            bad_pages++;
+        }
+        cJSON_Delete(root);
+        if (host_heap_used(true) > psram_peak) {
+            psram_peak = host_heap_used(true);
+        }
+        json_arena_end();
+
+        if (host_heap_used(true) != psram_base || host_heap_used(false) != internal_base) {
+            leaked++;
+        }
+    }
+
+    json_arena_get_stats(&after);
+    uint32_t requests = after.requests - before.requests;
+    uint32_t allocs = after.allocs - before.allocs;
+    uint32_t chunks = after.chunk_allocs - before.chunk_allocs;
+    uint32_t fallbacks = after.heap_fallbacks - before.heap_fallbacks;
+
+    CHECK_EQ(bad_pages, 0);
+    CHECK_EQ(leaked, 0);
+    CHECK_EQ(requests, ROUNDS);
+    CHECK_EQ(fallbacks, 0);
+    // 真正的堆分配只有追加块，基础块一直复用
+    CHECK_EQ(host_heap_alloc_calls(false) - internal_calls, 0);
+    CHECK_EQ(host_heap_alloc_calls(true) - psram_calls, chunks);
+    // 一页约 10KB：基础块放不下的部分正好放进一个追加块
+    CHECK(after.peak_bytes > JSON_ARENA_BASE_SIZE);
+    CHECK(after.peak_bytes <= JSON_ARENA_BASE_SIZE + JSON_ARENA_CHUNK_SIZE);
+    CHECK_EQ(chunks, ROUNDS);
+    CHECK_EQ(after.last_bytes, after.peak_bytes);
+
+    printf("   列表页 %zu 字节 x %d 次\n", page_len, ROUNDS);
+    printf("   每次 %lu 次 cJSON 分配 -> 内存池；堆分配 %lu 次（追加块），回退 malloc %lu 次\n",
+           (unsigned long)(allocs / ROUNDS), (unsigned long)(chunks / ROUNDS), (unsigned long)fallbacks);
+    printf("   内存池峰值 %lu 字节（基础块 %d），请求中 PSRAM 最多 +%zu 字节，结束后全部归还\n",
+           (unsigned long)after.peak_bytes, JSON_ARENA_BASE_SIZE, psram_peak - psram_base);
+}
+
+static void test_chunks_released_at_end(void)
+{
+    size_t internal_base = host_heap_used(false);
+    size_t psram_base = host_heap_used(true);
+
+    // 嵌套：内层 end 不归还，最外层 end 才归还
+    json_arena_begin();
+    json_arena_begin();
+    cJSON *root = cJSON_Parse(page_json);
+    CHECK(root != NULL && page_ok(root));
+    json_arena_end();
+    CHECK(host_heap_used(true) > psram_base);
+    CHECK(page_ok(root));
+    cJSON_Delete(root);
+    CHECK(host_heap_used(true) > psram_base);
+    json_arena_end();
+    CHECK_EQ(host_heap_used(true), psram_base);
+    CHECK_EQ(host_heap_used(false), internal_base);
+
+    // 超过追加块大小的单次分配：单独一块，同样在结束时归还
+    size_t big_len = 3 * JSON_ARENA_CHUNK_SIZE;
+    char *big = malloc(big_len + 3);
+    CHECK(big != NULL);
+    big[0] = '"';
+    memset(big + 1, 'x', big_len);
+    big[big_len + 1] = '"';
+    big[big_len + 2] = '\0';
+
+    json_arena_stats_t before, after;
+    json_arena_get_stats(&before);
+    json_arena_begin();
+    cJSON *str = cJSON_Parse(big);
+    CHECK(cJSON_IsString(str) && strlen(str->valuestring) == big_len);
+    CHECK(host_heap_used(true) >= psram_base + big_len);
+    cJSON_Delete(str);
+    json_arena_end();
+    json_arena_get_stats(&after);
+    CHECK_EQ(after.chunk_allocs - before.chunk_allocs, 1);
+    CHECK(after.last_bytes >= big_len);
+    CHECK_EQ(host_heap_used(true), psram_base);
+    CHECK_EQ(host_heap_used(false), internal_base);
+    free(big);
+}
+
+int main(void)
+{
+    page_len = host_page_json(page_json, sizeof(page_json), 0, PAGE_ITEMS, LIST_TOTAL);
+    CHECK(page_len > 0);
+    CHECK_EQ(json_arena_init(), ESP_OK);
+
+    RUN_TEST(test_outside_request_uses_heap);
+    RUN_TEST(test_parse_page_rounds);
+    RUN_TEST(test_chunks_released_at_end);
+    return HOST_TEST_EXIT_CODE();
+}
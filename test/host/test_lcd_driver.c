@@ -0,0 +1,335 @@
+/**
+ * @file test_lcd_driver.c
+ * @brief lcd_driver：按跨度绘制的图元与改动前逐像素绘制的结果一致，每种图元改动前后的 SPI 传输数和字节数，
+ *        以及传输排队返回、按顺序在后台发送
+ *
+ * SPI 和面板由 host_lcd.c/host_panel.c 替代：传输在取结果时才执行并解码进显存，
+ * 测试比较显存与参照实现画出的图像。参照实现照抄改动前的 lcd_driver.c（逐像素，
+ * 每个像素设置一次窗口：CASET/RASET 各 1 个命令字节加 4 个参数字节、RAMWR 1 个命令字节，
+ * 每字节一次轮询传输，共 11 次，再加 2 字节像素 1 次），其开销按像素数计算。
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "host_lcd.h"
+#include "freertos/task.h"
+#include "lcd_driver.h"
+
+#define PIXEL_TRANS     12      // 改动前每个像素的传输数
+#define PIXEL_BYTES     13
+#define OLD_FILL_BUF    4096    // 改动前 lcd_fill_rect 每次 malloc 的缓冲区
+
+void vTaskDelay(TickType_t ticks)
+{
+    (void)ticks;
+}
+
+// ---------- 参照实现（改动前的 lcd_driver.c） ----------
+
+static uint16_t ref[LCD_HEIGHT][LCD_WIDTH];
+static uint32_t ref_trans = 0;
+static uint64_t ref_bytes = 0;
+
+static void ref_reset(void)
+{
+    memset(ref, 0, sizeof(ref));
+    ref_trans = 0;
+    ref_bytes = 0;
+}
+
+static void ref_pixel(uint16_t x, uint16_t y, uint16_t color)
+{
+    if (x >= LCD_WIDTH || y >= LCD_HEIGHT) return;
+    ref[y][x] = color;
+    ref_trans += PIXEL_TRANS;
+    ref_bytes += PIXEL_BYTES;
+}
+
+static void ref_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+{
+    if (x >= LCD_WIDTH || y >= LCD_HEIGHT) return;
+    if (x + w > LCD_WIDTH) w = LCD_WIDTH - x;
+    if (y + h > LCD_HEIGHT) h = LCD_HEIGHT - y;
+    for (int j = y; j < y + h; j++) {
+        for (int i = x; i < x + w; i++) {
+            ref[j][i] = color;
+        }
+    }
+    uint32_t total = (uint32_t)w * h * 2;
+    ref_trans += 11 + (total + OLD_FILL_BUF - 1) / OLD_FILL_BUF;
+    ref_bytes += 11 + total;
+}
+
+static void ref_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color)
+{
+    int dx = abs(x1 - x0);
+    int dy = abs(y1 - y0);
+    int sx = (x0 < x1) ? 1 : -1;
+    int sy = (y0 < y1) ? 1 : -1;
+    int err = dx - dy;
+
+    while (1) {
+        ref_pixel(x0, y0, color);
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = 2 * err;
+        if (e2 > -dy) {
+            err -= dy;
+            x0 += sx;
+        }
+        if (e2 < dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+static void ref_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+{
+    ref_line(x, y, x + w - 1, y, color);
+    ref_line(x + w - 1, y, x + w - 1, y + h - 1, color);
+    ref_line(x, y + h - 1, x + w - 1, y + h - 1, color);
+    ref_line(x, y, x, y + h - 1, color);
+}
+
+static void ref_circle(uint16_t x0, uint16_t y0, uint16_t r, uint16_t color)
+{
+    int x = r;
+    int y = 0;
+    int err = 0;
+
+    while (x >= y) {
+        ref_pixel(x0 + x, y0 + y, color);
+        ref_pixel(x0 + y, y0 + x, color);
+        ref_pixel(x0 - y, y0 + x, color);
+        ref_pixel(x0 - x, y0 + y, color);
+        ref_pixel(x0 - x, y0 - y, color);
+        ref_pixel(x0 - y, y0 - x, color);
+        ref_pixel(x0 + y, y0 - x, color);
+        ref_pixel(x0 + x, y0 - y, color);
+
+        if (err <= 0) {
+            y += 1;
+            err += 2 * y + 1;
+        }
+        if (err > 0) {
+            x -= 1;
+            err -= 2 * x + 1;
+        }
+    }
+}
+
+static void ref_fill_circle(uint16_t x0, uint16_t y0, uint16_t r, uint16_t color)
+{
+    for (int y = -r; y <= r; y++) {
+        for (int x = -r; x <= r; x++) {
+            if (x * x + y * y <= r * r) {
+                ref_pixel(x0 + x, y0 + y, color);
+            }
+        }
+    }
+}
+
+// ---------- 辅助 ----------
+
+static void begin(void)
+{
+    lcd_wait_idle();
+    host_spi_reset(LCD_PIN_DC);
+    lcd_reset_spi_stats();
+    ref_reset();
+}
+
+/**
+ * @brief 等传输发完，显存与参照图像逐像素比较
+ * @return 不一致的像素数
+ */
+static int finish_and_diff(void)
+{
+    lcd_wait_idle();
+    int diff = 0;
+    for (int y = 0; y < LCD_HEIGHT; y++) {
+        for (int x = 0; x < LCD_WIDTH; x++) {
+            if (host_panel_pixel(x, y) != ref[y][x]) {
+                diff++;
+            }
+        }
+    }
+    return diff;
+}
+
+static void report(const char *name)
+{
+    lcd_spi_stats_t s;
+    lcd_get_spi_stats(&s);
+    const host_spi_stats_t *bus = host_spi_get_stats();
+    // 驱动自己的计数与总线上实际的传输一致
+    CHECK_EQ(s.transactions, bus->transactions);
+    CHECK_EQ(s.bytes, bus->bytes);
+    CHECK_EQ(bus->hazards, 0);
+    CHECK_EQ(bus->overflows, 0);
+    printf("   %-22s 改动前 %7lu 次传输 %8llu 字节 -> 跨度 %5lu 次传输 %7lu 字节, %4lu 个窗口\n", name,
+           (unsigned long)ref_trans, (unsigned long long)ref_bytes, (unsigned long)s.transactions,
+           (unsigned long)s.bytes, (unsigned long)s.windows);
+}
+
+// ---------- 测试 ----------
+
+static void test_rect(void)
+{
+    begin();
+    lcd_draw_rect(20, 30, 200, 100, COLOR_RED);
+    ref_rect(20, 30, 200, 100, COLOR_RED);
+    CHECK_EQ(finish_and_diff(), 0);
+    lcd_spi_stats_t s;
+    lcd_get_spi_stats(&s);
+    CHECK_EQ(s.windows, 4);
+    report("draw_rect 200x100");
+}
+
+static void test_circle(void)
+{
+    begin();
+    lcd_draw_circle(120, 160, 40, COLOR_GREEN);
+    ref_circle(120, 160, 40, COLOR_GREEN);
+    CHECK_EQ(finish_and_diff(), 0);
+    report("draw_circle r=40");
+
+    // 贴边的圆：屏幕外的部分被裁掉
+    begin();
+    lcd_draw_circle(10, 300, 40, COLOR_GREEN);
+    ref_circle(10, 300, 40, COLOR_GREEN);
+    CHECK_EQ(finish_and_diff(), 0);
+    CHECK_EQ(host_panel_get_stats()->out_of_range, 0);
+}
+
+static void test_fill_circle(void)
+{
+    begin();
+    lcd_fill_circle(120, 160, 40, COLOR_BLUE);
+    ref_fill_circle(120, 160, 40, COLOR_BLUE);
+    CHECK_EQ(finish_and_diff(), 0);
+    lcd_spi_stats_t s;
+    lcd_get_spi_stats(&s);
+    CHECK_EQ(s.windows, 2 * 40 + 1);
+    report("fill_circle r=40");
+
+    begin();
+    lcd_fill_circle(230, 5, 40, COLOR_BLUE);
+    ref_fill_circle(230, 5, 40, COLOR_BLUE);
+    CHECK_EQ(finish_and_diff(), 0);
+    CHECK_EQ(host_panel_get_stats()->out_of_range, 0);
+}
+
+static void test_fill_rect(void)
+{
+    begin();
+    lcd_fill_screen(COLOR_WHITE);
+    ref_fill_rect(0, 0, LCD_WIDTH, LCD_HEIGHT, COLOR_WHITE);
+    CHECK_EQ(finish_and_diff(), 0);
+    report("fill_screen");
+
+    // 换颜色：跨度缓冲区重填前等已排队的传输发完，否则显存里会混进新颜色
+    begin();
+    for (int i = 0; i < 8; i++) {
+        uint16_t color = i % 2 ? COLOR_ORANGE : COLOR_CYAN;
+        lcd_fill_rect(i * 30, 0, 30, LCD_HEIGHT, color);
+        ref_fill_rect(i * 30, 0, 30, LCD_HEIGHT, color);
+    }
+    CHECK_EQ(finish_and_diff(), 0);
+    report("fill_rect 8 条换色");
+}
+
+/**
+ * @brief 检查显存中的直线：主轴上每步恰好一个像素，偏离理想直线不超过半个像素
+ */
+static void check_line(int x0, int y0, int x1, int y1, uint16_t color)
+{
+    int dx = abs(x1 - x0);
+    int dy = abs(y1 - y0);
+    bool x_major = dx >= dy;
+    int len = x_major ? dx : dy;
+    int major0 = x_major ? x0 : y0;
+    int step = (x_major ? x1 > x0 : y1 > y0) ? 1 : -1;
+    int total = 0;
+
+    for (int i = 0; i <= len; i++) {
+        int major = major0 + i * step;
+        int hits = 0;
+        int limit = x_major ? LCD_HEIGHT : LCD_WIDTH;
+        for (int minor = 0; minor < limit; minor++) {
+            int x = x_major ? major : minor;
+            int y = x_major ? minor : major;
+            if (host_panel_pixel(x, y) != color) {
+                continue;
+            }
+            hits++;
+            // 理想直线在该主轴坐标处的副轴坐标 * len
+            int ideal = x_major ? y0 * len + (y1 - y0) * i : x0 * len + (x1 - x0) * i;
+            CHECK(abs(minor * len - ideal) * 2 <= len);
+        }
+        CHECK_EQ(hits, 1);
+        total += hits;
+    }
+    CHECK_EQ(total, len + 1);
+    CHECK(host_panel_pixel(x0, y0) == color);
+    CHECK(host_panel_pixel(x1, y1) == color);
+}
+
+static void test_lines(void)
+{
+    static const int lines[][4] = {
+        {0, 0, 239, 319},
+        {10, 300, 230, 40},
+        {5, 100, 234, 110},
+        {200, 10, 190, 310},
+        {120, 160, 120, 160},
+    };
+    for (size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); i++) {
+        const int *l = lines[i];
+        begin();
+        lcd_draw_line(l[0], l[1], l[2], l[3], COLOR_MAGENTA);
+        ref_line(l[0], l[1], l[2], l[3], COLOR_MAGENTA);
+        lcd_wait_idle();
+        check_line(l[0], l[1], l[2], l[3], COLOR_MAGENTA);
+        if (i < 2) {
+            report(i == 0 ? "draw_line 对角" : "draw_line 斜线");
+        }
+    }
+}
+
+static void test_queue_overlap(void)
+{
+    // 图元排队后就返回，传输在后台发送：返回时队列里还有传输，队列深度不超过配置
+    begin();
+    lcd_fill_rect(0, 0, LCD_WIDTH, 64, COLOR_PURPLE);
+    ref_fill_rect(0, 0, LCD_WIDTH, 64, COLOR_PURPLE);
+    CHECK(host_spi_pending() > 1);
+    lcd_fill_circle(120, 200, 30, COLOR_YELLOW);
+    ref_fill_circle(120, 200, 30, COLOR_YELLOW);
+    CHECK(host_spi_pending() > 0);
+    const host_spi_stats_t *bus = host_spi_get_stats();
+    CHECK(bus->max_queued <= LCD_TRANS_QUEUE_SIZE);
+    CHECK(bus->max_queued > 1);
+    // 命令和像素都排队：DC 由 pre_cb 按每个传输设置，不用轮询传输隔开
+    CHECK_EQ(bus->polling, 0);
+
+    CHECK_EQ(finish_and_diff(), 0);
+    CHECK_EQ(host_spi_pending(), 0);
+    CHECK_EQ(bus->hazards, 0);
+    CHECK_EQ(bus->overflows, 0);
+}
+
+int main(void)
+{
+    host_spi_reset(LCD_PIN_DC);
+    lcd_init();
+
+    RUN_TEST(test_rect);
+    RUN_TEST(test_circle);
+    RUN_TEST(test_fill_circle);
+    RUN_TEST(test_fill_rect);
+    RUN_TEST(test_lines);
+    RUN_TEST(test_queue_overlap);
+    return HOST_TEST_EXIT_CODE();
+}
@@ -0,0 +1,521 @@
+/**
+ * @file test_lcd_frame.c
+ * @brief lcd_frame：整帧模式下两块整屏缓冲区的交换与同步、等 TE 后按行送屏不撕裂、丢帧和 TE 超时统计
+ *
+ * 按 LVGL 8.3 直接模式的刷新流程驱动 lcd_frame_flush_cb：每块脏区渲染在 buf_act 的原位，
+ * 送屏前等上一次的 flushing 清零，最后一块送出后交换 buf_act。面板为 Vernon_ST7789T 驱动加
+ * host_lcd_io.c 的 esp_lcd 替身（40 MHz，颜色传输在模拟时钟上发完才写进显存并回调
+ * lcd_frame_on_trans_done）。面板每 TE_PERIOD_US 扫描一遍，扫描开始时触发 TE 引脚中断；
+ * 与 lcd_frame 的假设相同，第 r 行在扫描开始后 period * r / 320 被读出。
+ *
+ * 撕裂按传输的实际起止时刻判断：一段传输内各行按时间均分，每行必须在本次扫描读过它之后写、
+ * 在下一次扫描读到它之前写完，且一帧所有行落在同一个扫描间隔内，否则这一帧记为撕裂。
+ * 该判断不看 lcd_frame 自己的截止时间，用来核对它的丢帧统计。
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "host_lcd.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_rom_sys.h"
+#include "Vernon_ST7789T/Vernon_ST7789T.h"
+#include "dirty_region.h"
+#include "lcd_frame.h"
+
+#define H_RES           240
+#define V_RES           320
+#define PCLK_HZ         (40 * 1000 * 1000)
+#define TE_PERIOD_US    16667
+#define TE_PHASE_US     5000        // 第一次扫描开始的时刻
+#define RENDER_NS_PX    50          // 渲染每像素的模拟 CPU 时间
+#define MAX_BANDS       LV_INV_BUF_SIZE
+
+struct host_semaphore {
+    int count;
+};
+
+typedef struct {
+    int buf;                    // 0/1：从哪块缓冲区送出
+    int y1;
+    int rows;
+    int64_t start_ns;
+    int64_t end_ns;
+} band_t;
+
+static lv_color_t fb[2][H_RES * V_RES];
+static lv_disp_draw_buf_t draw_buf = {
+    .buf1 = fb[0],
+    .buf2 = fb[1],
+    .buf_act = fb[0],
+    .size = H_RES * V_RES,
+};
+static lv_disp_drv_t drv = {
+    .hor_res = H_RES,
+    .ver_res = V_RES,
+    .draw_buf = &draw_buf,
+    .direct_mode = 1,
+};
+static lv_disp_t disp = {.driver = &drv};
+static esp_lcd_panel_io_handle_t io = NULL;
+static uint16_t expect[V_RES][H_RES];
+
+static bool te_enabled = true;
+static int64_t next_scan_us = TE_PHASE_US;
+
+static band_t bands[MAX_BANDS];
+static int band_count = 0;
+static int flush_calls = 0;         // dirty_region_on_flush
+static int frame_end_calls = 0;
+
+// ---------- 模拟时钟：面板扫描（TE）和颜色传输完成 ----------
+
+/**
+ * @brief 时钟推进到 target_us，按时间顺序处理期间的传输完成和扫描开始
+ */
+static void sim_advance_to(int64_t target_us)
+{
+    while (true) {
+        int64_t next = target_us;
+        int64_t dma = host_lcd_io_next_done_us();
+        if (dma >= 0 && dma < next) {
+            next = dma;
+        }
+        if (next_scan_us < next) {
+            next = next_scan_us;
+        }
+        host_lcd_io_advance(next > host_time_us ? next - host_time_us : 0);
+        if (host_time_us >= next_scan_us) {
+            next_scan_us += TE_PERIOD_US;
+            if (te_enabled) {
+                host_gpio_trigger(CONFIG_TODO_LCD_TE_GPIO);
+            }
+        }
+        if (host_time_us >= target_us) {
+            return;
+        }
+    }
+}
+
+// 推进到下一个事件（不超过 limit_us）
+static void sim_step(int64_t limit_us)
+{
+    int64_t next = next_scan_us < limit_us ? next_scan_us : limit_us;
+    int64_t dma = host_lcd_io_next_done_us();
+    if (dma >= 0 && dma < next) {
+        next = dma;
+    }
+    sim_advance_to(next);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    sim_advance_to(host_time_us + (int64_t)ticks * 1000);
+}
+
+void esp_rom_delay_us(uint32_t us)
+{
+    sim_advance_to(host_time_us + us);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return calloc(1, sizeof(struct host_semaphore));
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    int64_t deadline = host_time_us + (int64_t)ticks * 1000;
+    while (sem->count == 0) {
+        if (host_time_us >= deadline) {
+            return pdFALSE;
+        }
+        sim_step(deadline);
+    }
+    sem->count = 0;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    sem->count = 1;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t *higher_prio_task_woken)
+{
+    sem->count = 1;
+    *higher_prio_task_woken = pdFALSE;
+    return pdTRUE;
+}
+
+// ---------- LVGL 和 dirty_region 替身 ----------
+
+lv_disp_t *_lv_refr_get_disp_refreshing(void)
+{
+    return &disp;
+}
+
+void dirty_region_on_flush(const lv_area_t *area, lv_color_t *color_map, bool frame_end)
+{
+    CHECK(color_map == NULL);
+    CHECK_EQ(area->x1, 0);
+    CHECK_EQ(area->x2, H_RES - 1);
+    flush_calls++;
+    if (frame_end) {
+        frame_end_calls++;
+    }
+}
+
+// 对应 example_notify_lvgl_flush_ready（整帧模式）
+static bool on_color_trans_done(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *ctx)
+{
+    return lcd_frame_on_trans_done(ctx);
+}
+
+static void trace(const void *data, size_t len, int64_t start_ns, int64_t end_ns)
+{
+    const lv_color_t *p = data;
+    int buf = (p >= fb[1] && p < fb[1] + H_RES * V_RES) ? 1 : 0;
+    CHECK(p >= fb[buf] && p < fb[buf] + H_RES * V_RES);
+    CHECK_EQ(len % (H_RES * sizeof(lv_color_t)), 0);
+    if (band_count < MAX_BANDS) {
+        band_t *b = &bands[band_count++];
+        b->buf = buf;
+        b->y1 = (int)((p - fb[buf]) / H_RES);
+        b->rows = (int)(len / (H_RES * sizeof(lv_color_t)));
+        b->start_ns = start_ns;
+        b->end_ns = end_ns;
+    }
+}
+
+// ---------- 辅助 ----------
+
+static uint16_t pattern(int x, int y, int seed)
+{
+    return (uint16_t)(x * 131 + y * 7 + seed * 40503);
+}
+
+/**
+ * @brief 按 LVGL 直接模式刷新一帧：areas 为本帧的失效区域（坐标含端点），joined 非 0 的不渲染也不送屏
+ */
+static void refresh_frame(const lv_area_t *areas, const uint8_t *joined, int n, int seed)
+{
+    memcpy(disp.inv_areas, areas, n * sizeof(lv_area_t));
+    memset(disp.inv_area_joined, 0, sizeof(disp.inv_area_joined));
+    if (joined != NULL) {
+        memcpy(disp.inv_area_joined, joined, n);
+    }
+    disp.inv_p = n;
+    band_count = 0;
+
+    int last = -1;
+    for (int i = 0; i < n; i++) {
+        if (!disp.inv_area_joined[i]) {
+            last = i;
+        }
+    }
+
+    lv_area_t full = {0, 0, H_RES - 1, V_RES - 1};
+    lv_color_t *buf = draw_buf.buf_act;
+    for (int i = 0; i < n; i++) {
+        if (disp.inv_area_joined[i]) {
+            continue;
+        }
+        const lv_area_t *a = &areas[i];
+        for (int y = a->y1; y <= a->y2; y++) {
+            for (int x = a->x1; x <= a->x2; x++) {
+                uint16_t c = pattern(x, y, seed);
+                buf[y * H_RES + x].full = c;
+                expect[y][x] = c;
+            }
+        }
+        int64_t px = (int64_t)lv_area_get_width(a) * lv_area_get_height(a);
+        sim_advance_to(host_time_us + px * RENDER_NS_PX / 1000);
+
+        // draw_buf_flush：双缓冲时等上一次送屏完成
+        while (draw_buf.flushing) {
+            sim_step(host_time_us + 1000000);
+        }
+        draw_buf.flushing = 1;
+        draw_buf.flushing_last = i == last;
+        bool flushing_last = draw_buf.flushing_last;
+        lcd_frame_flush_cb(&drv, &full, buf);
+        if (flushing_last) {
+            draw_buf.buf_act = draw_buf.buf_act == draw_buf.buf1 ? draw_buf.buf2 : draw_buf.buf1;
+        }
+    }
+    disp.inv_p = 0;
+}
+
+// 等本帧传完
+static void wait_frame_done(void)
+{
+    while (draw_buf.flushing || host_lcd_io_in_flight() > 0) {
+        sim_step(host_time_us + 1000000);
+    }
+}
+
+static int panel_diff(void)
+{
+    int diff = 0;
+    for (int y = 0; y < V_RES; y++) {
+        for (int x = 0; x < H_RES; x++) {
+            // 不交换字节：低字节先上总线
+            uint16_t c = expect[y][x];
+            if (host_panel_pixel(x, y) != (uint16_t)(c >> 8 | c << 8)) {
+                diff++;
+            }
+        }
+    }
+    return diff;
+}
+
+/**
+ * @brief 本帧的传输是否撕裂（见文件说明）
+ */
+static bool frame_torn(void)
+{
+    const int64_t period_ns = (int64_t)TE_PERIOD_US * 1000;
+    const int64_t phase_ns = (int64_t)TE_PHASE_US * 1000;
+    int64_t frame_k = -1;
+
+    for (int i = 0; i < band_count; i++) {
+        const band_t *b = &bands[i];
+        int64_t row_ns = (b->end_ns - b->start_ns) / b->rows;
+        for (int r = 0; r < b->rows; r++) {
+            int y = b->y1 + r;
+            int64_t write_start = b->start_ns + row_ns * r;
+            int64_t write_end = b->start_ns + row_ns * (r + 1);
+            int64_t scan_offset = phase_ns + period_ns * y / V_RES;
+            if (write_start < scan_offset) {
+                return true;
+            }
+            // 开始写之前最近一次读这一行的扫描
+            int64_t k = (write_start - scan_offset) / period_ns;
+            if (write_end > scan_offset + (k + 1) * period_ns) {
+                return true;
+            }
+            if (frame_k >= 0 && k != frame_k) {
+                return true;
+            }
+            frame_k = k;
+        }
+    }
+    return false;
+}
+
+static void set_pclk(unsigned int pclk_hz)
+{
+    esp_lcd_panel_io_spi_config_t io_config = {
+        .dc_gpio_num = 41,
+        .cs_gpio_num = 42,
+        .pclk_hz = pclk_hz,
+        .lcd_cmd_bits = 8,
+        .lcd_param_bits = 8,
+        .trans_queue_depth = 10,
+        .on_color_trans_done = on_color_trans_done,
+        .user_ctx = &drv,
+    };
+    CHECK_EQ(esp_lcd_new_panel_io_spi(1, &io_config, &io), ESP_OK);
+}
+
+// ---------- 测试 ----------
+
+static void test_full_screen_first_frame(void)
+{
+    lv_area_t full = {0, 0, H_RES - 1, V_RES - 1};
+    lcd_frame_stats_t before;
+    lcd_frame_get_stats(&before);
+
+    refresh_frame(&full, NULL, 1, 1);
+    wait_frame_done();
+    CHECK_EQ(panel_diff(), 0);
+    CHECK(!frame_torn());
+    CHECK_EQ(band_count, 1);
+    CHECK_EQ(bands[0].buf, 0);
+    CHECK_EQ(flush_calls, 1);
+    CHECK_EQ(frame_end_calls, 1);
+
+    lcd_frame_stats_t s;
+    lcd_frame_get_stats(&s);
+    CHECK_EQ(s.frames, before.frames + 1);
+    CHECK_EQ(s.dropped, 0);
+    CHECK_EQ(s.te_timeouts, 0);
+    CHECK_EQ(s.te_period_us, TE_PERIOD_US);
+    // 整屏 320 行在 40 MHz 下约 30.7 ms，在下一次扫描追上之前写完
+    CHECK(s.frame_time_max_us > 30000);
+    CHECK(s.frame_time_max_us < TE_PERIOD_US * 2);
+    CHECK_EQ(host_lcd_io_get_stats()->hazards, 0);
+    // 渲染和送屏用的是同一块，送屏时同步到另一块
+    CHECK(memcmp(fb[0], fb[1], sizeof(fb[0])) == 0);
+}
+
+static void test_buffer_swap_keeps_buffers_in_sync(void)
+{
+    // 每帧只改一小块：下一帧在另一块缓冲区上渲染，其余内容靠上一帧送屏时的同步
+    static const lv_area_t cards[] = {
+        {10, 40, 229, 99},
+        {10, 110, 229, 169},
+        {0, 0, H_RES - 1, 23},
+        {10, 40, 119, 99},
+        {120, 180, 229, 239},
+        {10, 250, 229, 309},
+    };
+    for (int i = 0; i < (int)(sizeof(cards) / sizeof(cards[0])); i++) {
+        int act = draw_buf.buf_act == draw_buf.buf1 ? 0 : 1;
+        refresh_frame(&cards[i], NULL, 1, 10 + i);
+        wait_frame_done();
+        CHECK_EQ(band_count, 1);
+        CHECK_EQ(bands[0].buf, act);
+        CHECK_EQ(bands[0].y1, cards[i].y1);
+        CHECK_EQ(bands[0].rows, cards[i].y2 - cards[i].y1 + 1);
+        CHECK_EQ(panel_diff(), 0);
+        CHECK(memcmp(fb[0], fb[1], sizeof(fb[0])) == 0);
+        CHECK(!frame_torn());
+    }
+    // 交替从两块缓冲区送出：加上第一帧共 7 次交换
+    CHECK(draw_buf.buf_act == draw_buf.buf2);
+
+    lcd_frame_stats_t s;
+    lcd_frame_get_stats(&s);
+    CHECK_EQ(s.dropped, 0);
+    CHECK_EQ(host_lcd_io_get_stats()->hazards, 0);
+}
+
+static void test_rows_sorted_and_merged(void)
+{
+    // 乱序、相邻和被合并掉的区域：按起始行排序，相邻的合成一段，joined 的不送
+    static const lv_area_t areas[] = {
+        {0, 200, 99, 239},
+        {20, 10, 60, 29},
+        {100, 100, 150, 119},
+        {30, 30, 200, 49},
+    };
+    static const uint8_t joined[] = {0, 0, 1, 0};
+    flush_calls = 0;
+    frame_end_calls = 0;
+
+    refresh_frame(areas, joined, 4, 20);
+    wait_frame_done();
+    CHECK_EQ(band_count, 2);
+    CHECK_EQ(bands[0].y1, 10);
+    CHECK_EQ(bands[0].rows, 40);
+    CHECK_EQ(bands[1].y1, 200);
+    CHECK_EQ(bands[1].rows, 40);
+    CHECK(bands[0].end_ns <= bands[1].start_ns);
+    CHECK_EQ(flush_calls, 2);
+    CHECK_EQ(frame_end_calls, 1);
+    CHECK_EQ(panel_diff(), 0);
+    CHECK(!frame_torn());
+}
+
+static void test_band_waits_for_scanline(void)
+{
+    // 只有屏幕下部的一段：TE 之后要等扫描线越过起始行再开始写
+    lv_area_t low = {0, 280, H_RES - 1, 299};
+    refresh_frame(&low, NULL, 1, 30);
+    wait_frame_done();
+    CHECK_EQ(band_count, 1);
+    const int64_t period_ns = (int64_t)TE_PERIOD_US * 1000;
+    int64_t scan_row = (bands[0].start_ns - (int64_t)TE_PHASE_US * 1000) % period_ns * V_RES / period_ns;
+    CHECK(scan_row >= low.y1);
+    CHECK(!frame_torn());
+    CHECK_EQ(panel_diff(), 0);
+}
+
+static void test_slow_bus_counts_dropped(void)
+{
+    // 20 MHz 时整屏要约 61 ms，下一次扫描追上时还没写完：lcd_frame 记丢帧，撕裂判断也认为撕裂
+    lcd_frame_stats_t before;
+    lcd_frame_get_stats(&before);
+    set_pclk(PCLK_HZ / 2);
+    lv_area_t full = {0, 0, H_RES - 1, V_RES - 1};
+    refresh_frame(&full, NULL, 1, 40);
+    wait_frame_done();
+    CHECK(frame_torn());
+    CHECK_EQ(panel_diff(), 0);
+
+    lcd_frame_stats_t s;
+    lcd_frame_get_stats(&s);
+    CHECK_EQ(s.dropped, before.dropped + 1);
+
+    // 恢复 40 MHz 后一小块不丢帧
+    set_pclk(PCLK_HZ);
+    lv_area_t card = {10, 40, 229, 99};
+    refresh_frame(&card, NULL, 1, 41);
+    wait_frame_done();
+    lcd_frame_get_stats(&s);
+    CHECK_EQ(s.dropped, before.dropped + 1);
+    CHECK(!frame_torn());
+}
+
+static void test_missing_te_times_out(void)
+{
+    // TE 线断开：等满超时后照样送屏，计一次 TE 超时
+    lcd_frame_stats_t before;
+    lcd_frame_get_stats(&before);
+    te_enabled = false;
+    lv_area_t card = {10, 110, 229, 169};
+    int64_t start = host_time_us;
+    refresh_frame(&card, NULL, 1, 50);
+    wait_frame_done();
+    te_enabled = true;
+
+    lcd_frame_stats_t s;
+    lcd_frame_get_stats(&s);
+    CHECK_EQ(s.te_timeouts, before.te_timeouts + 1);
+    CHECK_EQ(s.frames, before.frames + 1);
+    CHECK(host_time_us - start >= 50000);
+    CHECK_EQ(panel_diff(), 0);
+}
+
+static void test_report(void)
+{
+    lcd_frame_stats_t s;
+    lcd_frame_get_stats(&s);
+    const host_lcd_io_stats_t *io_stats = host_lcd_io_get_stats();
+    printf("   %lu 帧, 丢帧 %lu, TE超时 %lu, 帧时间 平均 %lu us 最大 %lu us, TE周期 %lu us\n",
+           (unsigned long)s.frames, (unsigned long)s.dropped, (unsigned long)s.te_timeouts,
+           (unsigned long)s.frame_time_avg_us, (unsigned long)s.frame_time_max_us, (unsigned long)s.te_period_us);
+    printf("   颜色传输 %lu 次, 发命令前等排队传输 %lu 次, 冲突 %lu\n", (unsigned long)io_stats->color,
+           (unsigned long)io_stats->drains, (unsigned long)io_stats->hazards);
+}
+
+int main(void)
+{
+    host_lcd_io_set_wait_hook(sim_advance_to);
+    host_lcd_io_set_trace(trace);
+    set_pclk(PCLK_HZ);
+
+    // 与 main.c 的 lcd_init 相同的初始化顺序
+    esp_lcd_panel_handle_t panel = NULL;
+    esp_lcd_panel_dev_st7789t_config_t panel_config = {
+        .reset_gpio_num = 39,
+        .rgb_endian = LCD_RGB_ENDIAN_BGR,
+        .bits_per_pixel = 16,
+    };
+    CHECK_EQ(esp_lcd_new_panel_st7789t(io, &panel_config, &panel), ESP_OK);
+    CHECK_EQ(esp_lcd_panel_reset(panel), ESP_OK);
+    CHECK_EQ(esp_lcd_panel_init(panel), ESP_OK);
+    CHECK_EQ(esp_lcd_panel_mirror(panel, true, false), ESP_OK);
+    CHECK_EQ(esp_lcd_panel_disp_on_off(panel, true), ESP_OK);
+    CHECK_EQ(lcd_frame_init(io), ESP_OK);
+    drv.user_data = panel;
+    host_lcd_io_reset();
+    // 先让 TE 周期测出来
+    sim_advance_to(host_time_us + 3 * TE_PERIOD_US);
+
+    RUN_TEST(test_full_screen_first_frame);
+    RUN_TEST(test_buffer_swap_keeps_buffers_in_sync);
+    RUN_TEST(test_rows_sorted_and_merged);
+    RUN_TEST(test_band_waits_for_scanline);
+    RUN_TEST(test_slow_bus_counts_dropped);
+    RUN_TEST(test_missing_te_times_out);
+    RUN_TEST(test_report);
+    return HOST_TEST_EXIT_CODE();
+}
@@ -0,0 +1,309 @@
+/**
+ * @file test_lcd_panel.c
+ * @brief Vernon_ST7789T：LVGL 逐条刷新时的命令顺序、窗口续写和传输与渲染的并行
+ *
+ * 面板 IO 为 host_lcd_io.c 的 esp_lcd 替身，颜色数据排队、按 40 MHz 时钟在模拟时钟上发完后
+ * 才写进面板替身的显存并回调。测试照 LVGL 8.3 双缓冲的刷新流程驱动驱动：渲染到空闲的缓冲区，
+ * 等上一块的 flushing 标志被完成回调清掉，再调用 draw_bitmap 并交换缓冲区（与 main.c/lvgl_driver.c
+ * 的接法相同）。参照实现照抄改动前的 draw_bitmap（每块都发 CASET/RASET/RAMWR），用同一替身比较。
+ * 面板替身不解码 MADCTL，显存按逻辑坐标比较。
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "host_lcd.h"
+#include "freertos/task.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_lcd_panel_commands.h"
+#include "Vernon_ST7789T/Vernon_ST7789T.h"
+
+#define H_RES           240
+#define V_RES           320
+#define BUF_LEN         (H_RES * V_RES / 10)    // 与 lvgl_driver.h 的 LVGL_BUF_LEN 相同
+#define PCLK_HZ         (40 * 1000 * 1000)
+#define RENDER_US       2500                    // 渲染一条（32 行）的模拟 CPU 时间
+
+typedef esp_err_t (*draw_fn_t)(int x_start, int y_start, int x_end, int y_end, const void *color_data);
+
+static esp_lcd_panel_io_handle_t io = NULL;
+static esp_lcd_panel_handle_t panel = NULL;
+static uint16_t bufs[2][BUF_LEN];
+static int buf_act = 0;
+static bool flushing = false;           // LVGL 的 draw_buf->flushing
+static bool ready_on_done = true;       // false：flush_cb 返回就当作刷完（错误接法）
+static uint16_t expect[V_RES][H_RES];
+
+void vTaskDelay(TickType_t ticks)
+{
+    host_lcd_io_advance((int64_t)ticks * 1000);
+}
+
+// 对应 example_notify_lvgl_flush_ready -> lv_disp_flush_ready
+static bool on_color_trans_done(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *ctx)
+{
+    if (ready_on_done) {
+        flushing = false;
+    }
+    return false;
+}
+
+static esp_err_t draw_panel(int x_start, int y_start, int x_end, int y_end, const void *color_data)
+{
+    return esp_lcd_panel_draw_bitmap(panel, x_start, y_start, x_end, y_end, color_data);
+}
+
+// 改动前的 draw_bitmap（x/y_gap 为 0，16 位色）
+static esp_err_t draw_ref(int x_start, int y_start, int x_end, int y_end, const void *color_data)
+{
+    esp_lcd_panel_io_tx_param(io, LCD_CMD_CASET, (uint8_t[]) {
+        (x_start >> 8) & 0xFF,
+        x_start & 0xFF,
+        ((x_end - 1) >> 8) & 0xFF,
+        (x_end - 1) & 0xFF,
+    }, 4);
+    esp_lcd_panel_io_tx_param(io, LCD_CMD_RASET, (uint8_t[]) {
+        (y_start >> 8) & 0xFF,
+        y_start & 0xFF,
+        ((y_end - 1) >> 8) & 0xFF,
+        (y_end - 1) & 0xFF,
+    }, 4);
+    size_t len = (x_end - x_start) * (y_end - y_start) * 2;
+    return esp_lcd_panel_io_tx_color(io, LCD_CMD_RAMWR, color_data, len);
+}
+
+static uint16_t pattern(int x, int y, int seed)
+{
+    return (uint16_t)(x * 31 + y * 977 + seed * 40503);
+}
+
+static void wait_flushing(void)
+{
+    while (flushing) {
+        if (!host_lcd_io_step()) {
+            // 没有排队的传输却一直在刷新：完成回调丢了
+            CHECK(!flushing);
+            flushing = false;
+        }
+    }
+}
+
+/**
+ * @brief 按 LVGL 双缓冲的流程刷新一块区域（坐标含端点），区域内像素为 pattern(seed)
+ */
+static void refresh_area(int x1, int y1, int x2, int y2, int seed, draw_fn_t draw)
+{
+    int w = x2 - x1 + 1;
+    int rows = BUF_LEN / w;
+    for (int y = y1; y <= y2; y += rows) {
+        int ye = y + rows - 1 < y2 ? y + rows - 1 : y2;
+        uint16_t *buf = bufs[buf_act];
+        int i = 0;
+        for (int yy = y; yy <= ye; yy++) {
+            for (int xx = x1; xx <= x2; xx++) {
+                uint16_t c = pattern(xx, yy, seed);
+                // 与 LV_COLOR_16_SWAP 相同，高字节先上总线
+                buf[i++] = (uint16_t)(c >> 8 | c << 8);
+                expect[yy][xx] = c;
+            }
+        }
+        host_lcd_io_advance((int64_t)RENDER_US * (ye - y + 1) / 32);
+
+        wait_flushing();
+        flushing = true;
+        CHECK_EQ(draw(x1, y, x2 + 1, ye + 1, buf), ESP_OK);
+        if (!ready_on_done) {
+            flushing = false;
+        }
+        buf_act ^= 1;
+    }
+}
+
+static void finish(void)
+{
+    wait_flushing();
+    while (host_lcd_io_step()) {
+    }
+}
+
+static int panel_diff(void)
+{
+    int diff = 0;
+    for (int y = 0; y < V_RES; y++) {
+        for (int x = 0; x < H_RES; x++) {
+            if (host_panel_pixel(x, y) != expect[y][x]) {
+                diff++;
+            }
+        }
+    }
+    return diff;
+}
+
+static void begin(void)
+{
+    finish();
+    host_lcd_io_reset();
+    memset(expect, 0, sizeof(expect));
+}
+
+// ---------- 测试 ----------
+
+static void test_full_screen_strips(void)
+{
+    begin();
+    refresh_area(0, 0, H_RES - 1, V_RES - 1, 1, draw_panel);
+    finish();
+    CHECK_EQ(panel_diff(), 0);
+
+    // 10 条只在第一条设置一次窗口，之后续写
+    const host_panel_stats_t *p = host_panel_get_stats();
+    const host_lcd_io_stats_t *s = host_lcd_io_get_stats();
+    CHECK_EQ(p->windows, 2);
+    CHECK_EQ(p->ramwr, 1);
+    CHECK_EQ(s->polling, 5);
+    CHECK_EQ(s->color, 10);
+    CHECK_EQ(s->callbacks, 10);
+    CHECK_EQ(s->drains, 0);
+    CHECK_EQ(s->hazards, 0);
+    CHECK_EQ(p->out_of_range, 0);
+}
+
+static void test_area_sequence(void)
+{
+    begin();
+    // 卡片区域：220 宽，每条 34 行，100 行分 3 条
+    refresh_area(10, 40, 229, 139, 2, draw_panel);
+    CHECK_EQ(host_panel_get_stats()->ramwr, 1);
+    // 紧接在下方、列范围相同的区域接着写
+    refresh_area(10, 140, 229, 179, 3, draw_panel);
+    CHECK_EQ(host_panel_get_stats()->ramwr, 1);
+    // 右边界相同、左边界不同
+    refresh_area(50, 180, 229, 189, 4, draw_panel);
+    CHECK_EQ(host_panel_get_stats()->ramwr, 2);
+    // 列范围不同
+    refresh_area(0, 190, 119, 199, 4, draw_panel);
+    CHECK_EQ(host_panel_get_stats()->ramwr, 3);
+    // 列范围相同但不相接
+    refresh_area(0, 260, 119, 279, 5, draw_panel);
+    CHECK_EQ(host_panel_get_stats()->ramwr, 4);
+    // 写到显存底部后窗口会绕回，回到顶部要重新设置
+    refresh_area(0, 300, H_RES - 1, V_RES - 1, 6, draw_panel);
+    refresh_area(0, 0, H_RES - 1, 19, 7, draw_panel);
+    CHECK_EQ(host_panel_get_stats()->ramwr, 6);
+    finish();
+
+    CHECK_EQ(panel_diff(), 0);
+    CHECK_EQ(host_panel_get_stats()->out_of_range, 0);
+    CHECK_EQ(host_lcd_io_get_stats()->hazards, 0);
+}
+
+static void test_command_ends_continuation(void)
+{
+    // 其他命令结束显存写入，之后的一块必须重新设置窗口
+    for (int op = 0; op < 3; op++) {
+        begin();
+        refresh_area(0, 0, H_RES - 1, 31, 8 + op, draw_panel);
+        finish();
+        switch (op) {
+        case 0:
+            esp_lcd_panel_mirror(panel, true, false);
+            break;
+        case 1:
+            esp_lcd_panel_invert_color(panel, true);
+            break;
+        default:
+            esp_lcd_panel_disp_on_off(panel, true);
+            break;
+        }
+        refresh_area(0, 32, H_RES - 1, 63, 8 + op, draw_panel);
+        finish();
+        CHECK_EQ(host_panel_get_stats()->ramwr, 2);
+        CHECK_EQ(panel_diff(), 0);
+    }
+}
+
+/**
+ * @brief 刷新整屏，返回用时（微秒）
+ */
+static int64_t timed_full_screen(draw_fn_t draw, int seed)
+{
+    begin();
+    int64_t start = host_time_us;
+    refresh_area(0, 0, H_RES - 1, V_RES - 1, seed, draw);
+    finish();
+    CHECK_EQ(panel_diff(), 0);
+    CHECK_EQ(host_lcd_io_get_stats()->hazards, 0);
+    return host_time_us - start;
+}
+
+static void test_pipeline_overlap(void)
+{
+    int64_t ref_us = timed_full_screen(draw_ref, 11);
+    host_lcd_io_stats_t ref = *host_lcd_io_get_stats();
+    int64_t us = timed_full_screen(draw_panel, 12);
+    host_lcd_io_stats_t cur = *host_lcd_io_get_stats();
+
+    // 下一条的渲染与上一条的传输并行：用时接近总线时间加一条的渲染，而不是两者之和
+    int64_t strip_bus_us = (int64_t)BUF_LEN * 2 * 8 * 1000000 / PCLK_HZ;
+    int64_t serial_us = 10 * (RENDER_US + strip_bus_us);
+    CHECK(us >= 10 * strip_bus_us);
+    CHECK(us <= RENDER_US + 10 * strip_bus_us + 100);
+    CHECK(us < serial_us * 2 / 3);
+    // 同一时刻只有一块在总线上（双缓冲），flush_cb 不等排队的传输
+    CHECK_EQ(cur.max_in_flight, 1);
+    CHECK_EQ(cur.wait_us, 0);
+    CHECK_EQ(ref.polling, 10 * 5);
+    CHECK_EQ(cur.polling, 5);
+
+    printf("   整屏 10 条（每条渲染 %d us，总线 %lld us）：串行 %lld us\n", RENDER_US, (long long)strip_bus_us,
+           (long long)serial_us);
+    printf("   每条设置窗口：%lld us，轮询传输 %lu 次 -> 续写：%lld us，轮询传输 %lu 次\n", (long long)ref_us,
+           (unsigned long)ref.polling, (long long)us, (unsigned long)cur.polling);
+}
+
+static void test_early_flush_ready_corrupts(void)
+{
+    // 对照：flush_cb 返回就当作刷完，CPU 会在传输发完前改写缓冲区，替身能发现
+    ready_on_done = false;
+    begin();
+    refresh_area(0, 0, H_RES - 1, V_RES - 1, 13, draw_panel);
+    finish();
+    ready_on_done = true;
+    CHECK(host_lcd_io_get_stats()->hazards > 0);
+    CHECK(host_lcd_io_get_stats()->max_in_flight > 1);
+    CHECK(panel_diff() > 0);
+}
+
+int main(void)
+{
+    // 与 main.c 的 lcd_init 相同的配置和初始化顺序
+    esp_lcd_panel_io_spi_config_t io_config = {
+        .dc_gpio_num = 41,
+        .cs_gpio_num = 42,
+        .pclk_hz = PCLK_HZ,
+        .lcd_cmd_bits = 8,
+        .lcd_param_bits = 8,
+        .spi_mode = 0,
+        .trans_queue_depth = 10,
+        .on_color_trans_done = on_color_trans_done,
+        .user_ctx = NULL,
+    };
+    CHECK_EQ(esp_lcd_new_panel_io_spi(1, &io_config, &io), ESP_OK);
+    esp_lcd_panel_dev_st7789t_config_t panel_config = {
+        .reset_gpio_num = 39,
+        .rgb_endian = LCD_RGB_ENDIAN_BGR,
+        .bits_per_pixel = 16,
+    };
+    CHECK_EQ(esp_lcd_new_panel_st7789t(io, &panel_config, &panel), ESP_OK);
+    CHECK_EQ(esp_lcd_panel_reset(panel), ESP_OK);
+    CHECK_EQ(esp_lcd_panel_init(panel), ESP_OK);
+    CHECK_EQ(esp_lcd_panel_mirror(panel, true, false), ESP_OK);
+    CHECK_EQ(esp_lcd_panel_disp_on_off(panel, true), ESP_OK);
+
+    RUN_TEST(test_full_screen_strips);
+    RUN_TEST(test_area_sequence);
+    RUN_TEST(test_command_ends_continuation);
+    RUN_TEST(test_pipeline_overlap);
+    RUN_TEST(test_early_flush_ready_corrupts);
+    return HOST_TEST_EXIT_CODE();
+}
@@ -0,0 +1,313 @@
+/**
+ * @file test_lvgl_mem.c
+ * @brief lvgl_mem：内部RAM/PSRAM 首选与互相回退、跨大小分级的 realloc、失败处理，
+ *        以及反复创建/删除详情弹窗和列表后统计归零
+ *
+ * 主机上没有 LVGL，弹窗和列表按 LVGL 8.3 创建这些对象时的分配序列模拟：
+ * 每个对象一个 lv_obj_t 和 spec_attr，样式数组随样式增加而 realloc，标签文本按长度分配，
+ * 可滚动的弹窗正文另有一块图层缓冲。
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "esp_heap_caps.h"
+#include "esp_random.h"
+#include "lvgl_mem.h"
+#include "mem_tag.h"
+
+#define OBJ_SIZE        48      // lv_obj_t（32 位目标）
+#define SPEC_ATTR_SIZE  32      // 可滚动/有子对象时的 spec_attr
+#define STYLE_ENTRY     8       // 每个样式数组项（样式指针 + 选择器）
+#define LAYER_BUF_SIZE  (240 * 60 * 2)
+
+static lvgl_mem_stats_t stats(void)
+{
+    lvgl_mem_stats_t s;
+    lvgl_mem_get_stats(&s);
+    return s;
+}
+
+static void check_empty(void)
+{
+    lvgl_mem_stats_t s = stats();
+    for (int i = 0; i < LVGL_MEM_CLASS_COUNT; i++) {
+        CHECK_EQ(s.classes[i].cur_bytes, 0);
+        CHECK_EQ(s.classes[i].cur_blocks, 0);
+    }
+    CHECK_EQ(s.cur_internal_bytes, 0);
+    CHECK_EQ(s.cur_psram_bytes, 0);
+
+    // mem_tag 中的 LVGL 计数和模拟堆也要回到零（包括块头）
+    mem_tag_report_t r;
+    mem_tag_get_report(&r);
+    CHECK_EQ(r.tags[MEM_TAG_LVGL].cur_internal, 0);
+    CHECK_EQ(r.tags[MEM_TAG_LVGL].cur_psram, 0);
+    CHECK_EQ(host_heap_used(false), 0);
+    CHECK_EQ(host_heap_used(true), 0);
+}
+
+// ---------- 对象分配序列 ----------
+
+typedef struct {
+    void *obj;
+    void *spec_attr;
+    void *styles;
+    void *text;
+    void *layer;
+} sim_obj_t;
+
+static void *alloc_filled(size_t size)
+{
+    uint8_t *p = lvgl_mem_alloc(size);
+    if (p != NULL) {
+        memset(p, (int)(size & 0xFF), size);
+    }
+    return p;
+}
+
+static void sim_obj_create(sim_obj_t *o, int style_count, size_t text_len, bool scrollable)
+{
+    memset(o, 0, sizeof(*o));
+    o->obj = alloc_filled(OBJ_SIZE);
+    if (scrollable) {
+        o->spec_attr = alloc_filled(SPEC_ATTR_SIZE);
+    }
+    // lv_obj_add_style 每次把样式数组扩大一项
+    for (int i = 1; i <= style_count; i++) {
+        void *grown = lvgl_mem_realloc(o->styles, (size_t)i * STYLE_ENTRY);
+        CHECK(grown != NULL);
+        o->styles = grown;
+    }
+    if (text_len > 0) {
+        o->text = alloc_filled(text_len + 1);
+    }
+    if (scrollable && text_len > 1024) {
+        o->layer = alloc_filled(LAYER_BUF_SIZE);
+    }
+}
+
+static void sim_obj_delete(sim_obj_t *o)
+{
+    lvgl_mem_free(o->layer);
+    lvgl_mem_free(o->text);
+    lvgl_mem_free(o->styles);
+    lvgl_mem_free(o->spec_attr);
+    lvgl_mem_free(o->obj);
+    memset(o, 0, sizeof(*o));
+}
+
+#define POPUP_OBJS 4    // 半透明遮罩、容器、标题、正文
+#define LIST_CARDS 40   // 每张卡片：背景、复选框、标题、截止日期
+
+static void popup_open(sim_obj_t popup[POPUP_OBJS], size_t body_len)
+{
+    sim_obj_create(&popup[0], 2, 0, false);
+    sim_obj_create(&popup[1], 3, 0, true);
+    sim_obj_create(&popup[2], 2, 20 + esp_random() % 100, false);
+    sim_obj_create(&popup[3], 2, body_len, true);
+}
+
+static void list_build(sim_obj_t cards[LIST_CARDS][4])
+{
+    for (int i = 0; i < LIST_CARDS; i++) {
+        sim_obj_create(&cards[i][0], 2, 0, true);
+        sim_obj_create(&cards[i][1], 1, 0, false);
+        sim_obj_create(&cards[i][2], 2, 10 + esp_random() % 200, false);
+        sim_obj_create(&cards[i][3], 1, 16, false);
+    }
+}
+
+// ---------- 测试 ----------
+
+static void test_placement_by_size(void)
+{
+    lvgl_mem_stats_t before = stats();
+    void *small = lvgl_mem_alloc(64);
+    void *edge = lvgl_mem_alloc(LVGL_MEM_INTERNAL_MAX_SIZE);
+    void *large = lvgl_mem_alloc(LVGL_MEM_INTERNAL_MAX_SIZE + 1);
+    lvgl_mem_stats_t s = stats();
+
+    CHECK_EQ(s.cur_internal_bytes, 64 + LVGL_MEM_INTERNAL_MAX_SIZE);
+    CHECK_EQ(s.cur_psram_bytes, LVGL_MEM_INTERNAL_MAX_SIZE + 1);
+    CHECK_EQ(s.classes[LVGL_MEM_CLASS_128].cur_blocks, 1);
+    CHECK_EQ(s.classes[LVGL_MEM_CLASS_2K].cur_blocks, 2);
+    CHECK_EQ(s.fallback_count, before.fallback_count);
+    CHECK(lvgl_mem_alloc(0) == NULL);
+
+    lvgl_mem_free(small);
+    lvgl_mem_free(edge);
+    lvgl_mem_free(large);
+    lvgl_mem_free(NULL);
+    check_empty();
+}
+
+static void test_fallback_between_regions(void)
+{
+    lvgl_mem_stats_t before = stats();
+
+    // 内部RAM分配失败：小块回退到PSRAM
+    host_heap_fail_after(false, 0);
+    void *small = lvgl_mem_alloc(100);
+    host_heap_reset_limits();
+    CHECK(small != NULL);
+    lvgl_mem_stats_t s = stats();
+    CHECK_EQ(s.cur_psram_bytes, 100);
+    CHECK_EQ(s.cur_internal_bytes, 0);
+    CHECK_EQ(s.fallback_count, before.fallback_count + 1);
+
+    // PSRAM 已满：大块回退到内部RAM
+    host_heap_set_capacity(true, host_heap_used(true) + 1000);
+    void *large = lvgl_mem_alloc(20000);
+    host_heap_reset_limits();
+    CHECK(large != NULL);
+    s = stats();
+    CHECK_EQ(s.cur_internal_bytes, 20000);
+    CHECK_EQ(s.fallback_count, before.fallback_count + 2);
+
+    // 两个区域都失败：返回 NULL 并计数，统计不变
+    host_heap_fail_after(false, 0);
+    host_heap_fail_after(true, 0);
+    CHECK(lvgl_mem_alloc(16) == NULL);
+    host_heap_reset_limits();
+    s = stats();
+    CHECK_EQ(s.fail_count, before.fail_count + 1);
+    CHECK_EQ(s.cur_internal_bytes, 20000);
+
+    // 释放时按块头记录的区域扣除
+    lvgl_mem_free(small);
+    lvgl_mem_free(large);
+    check_empty();
+}
+
+static void test_realloc_across_classes(void)
+{
+    static const size_t sizes[] = {8, 100, 600, 3000, 12000, 40, 2048, 2049, 1};
+    static const lvgl_mem_class_t classes[] = {
+        LVGL_MEM_CLASS_32, LVGL_MEM_CLASS_128, LVGL_MEM_CLASS_2K, LVGL_MEM_CLASS_8K, LVGL_MEM_CLASS_LARGE,
+        LVGL_MEM_CLASS_128, LVGL_MEM_CLASS_2K, LVGL_MEM_CLASS_8K, LVGL_MEM_CLASS_32,
+    };
+    uint8_t *p = NULL;
+    size_t prev = 0;
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        p = lvgl_mem_realloc(p, sizes[i]);
+        CHECK(p != NULL);
+        // 保留的前缀内容不变
+        for (size_t k = 0; k < prev && k < sizes[i]; k++) {
+            if (p[k] != (uint8_t)k) {
+                CHECK_EQ(p[k], (uint8_t)k);
+                break;
+            }
+        }
+        for (size_t k = 0; k < sizes[i]; k++) {
+            p[k] = (uint8_t)k;
+        }
+        prev = sizes[i];
+
+        lvgl_mem_stats_t s = stats();
+        for (int c = 0; c < LVGL_MEM_CLASS_COUNT; c++) {
+            CHECK_EQ(s.classes[c].cur_blocks, c == (int)classes[i] ? 1 : 0);
+            CHECK_EQ(s.classes[c].cur_bytes, c == (int)classes[i] ? sizes[i] : 0);
+        }
+        bool internal = sizes[i] <= LVGL_MEM_INTERNAL_MAX_SIZE;
+        CHECK_EQ(s.cur_internal_bytes, internal ? sizes[i] : 0);
+        CHECK_EQ(s.cur_psram_bytes, internal ? 0 : sizes[i]);
+    }
+
+    // 扩容失败：原块和统计都保持不变
+    lvgl_mem_stats_t before = stats();
+    host_heap_fail_after(false, 0);
+    host_heap_fail_after(true, 0);
+    CHECK(lvgl_mem_realloc(p, 5000) == NULL);
+    host_heap_reset_limits();
+    lvgl_mem_stats_t after = stats();
+    CHECK(memcmp(before.classes, after.classes, sizeof(before.classes)) == 0);
+    CHECK_EQ(after.fail_count, before.fail_count + 1);
+    CHECK_EQ(p[0], 0);
+
+    CHECK(lvgl_mem_realloc(p, 0) == NULL);
+    check_empty();
+}
+
+static void test_popup_and_list_churn(void)
+{
+    static sim_obj_t cards[LIST_CARDS][4];
+    sim_obj_t popup[POPUP_OBJS];
+    host_random_seed(29);
+
+    lvgl_mem_stats_t before = stats();
+    uint32_t peak = 0;
+    for (int round = 0; round < 200; round++) {
+        list_build(cards);
+        for (int i = 0; i < 5; i++) {
+            // 正文长度覆盖所有分级：短备注到带图层缓冲的长正文
+            size_t body_len = (esp_random() % 4 == 0) ? 2000 + esp_random() % 6000 : esp_random() % 400;
+            popup_open(popup, body_len);
+            // 打开期间文本更新：lv_label_set_text 对旧文本 realloc
+            popup[3].text = lvgl_mem_realloc(popup[3].text, esp_random() % 3000 + 1);
+            CHECK(popup[3].text != NULL);
+            for (int k = POPUP_OBJS - 1; k >= 0; k--) {
+                sim_obj_delete(&popup[k]);
+            }
+        }
+        lvgl_mem_stats_t s = stats();
+        uint32_t total = s.cur_internal_bytes + s.cur_psram_bytes;
+        if (total > peak) {
+            peak = total;
+        }
+        // 刷新列表：全部删除后重建
+        for (int i = LIST_CARDS - 1; i >= 0; i--) {
+            for (int k = 3; k >= 0; k--) {
+                sim_obj_delete(&cards[i][k]);
+            }
+        }
+        if (round % 50 == 0) {
+            check_empty();
+        }
+    }
+
+    lvgl_mem_stats_t s = stats();
+    check_empty();
+    CHECK(s.peak_total_bytes >= peak);
+    CHECK(s.classes[LVGL_MEM_CLASS_32].alloc_calls > before.classes[LVGL_MEM_CLASS_32].alloc_calls);
+    CHECK(s.classes[LVGL_MEM_CLASS_LARGE].alloc_calls > before.classes[LVGL_MEM_CLASS_LARGE].alloc_calls);
+    CHECK_EQ(s.fail_count, before.fail_count);
+    CHECK_EQ(s.fallback_count, before.fallback_count);
+    printf("   200 轮列表重建 + 1000 次弹窗：峰值 %u 字节，内部RAM分配 %u 次，PSRAM分配 %u 次\n",
+           (unsigned)s.peak_total_bytes, (unsigned)host_heap_alloc_calls(false),
+           (unsigned)host_heap_alloc_calls(true));
+}
+
+static void test_churn_under_internal_pressure(void)
+{
+    static sim_obj_t cards[LIST_CARDS][4];
+    lvgl_mem_stats_t before = stats();
+
+    // 内部RAM只剩 4KB：放不下的小块回退到 PSRAM，全部释放后依然归零
+    host_heap_set_capacity(false, host_heap_used(false) + 4096);
+    list_build(cards);
+    lvgl_mem_stats_t s = stats();
+    CHECK(s.fallback_count > before.fallback_count);
+    CHECK(s.cur_internal_bytes <= 4096);
+    CHECK(s.cur_psram_bytes > 0);
+    CHECK_EQ(s.fail_count, before.fail_count);
+    CHECK(s.largest_free_internal < 4096);
+    host_heap_reset_limits();
+
+    for (int i = 0; i < LIST_CARDS; i++) {
+        for (int k = 0; k < 4; k++) {
+            sim_obj_delete(&cards[i][k]);
+        }
+    }
+    check_empty();
+}
+
+int main(void)
+{
+    RUN_TEST(test_placement_by_size);
+    RUN_TEST(test_fallback_between_regions);
+    RUN_TEST(test_realloc_across_classes);
+    RUN_TEST(test_popup_and_list_churn);
+    RUN_TEST(test_churn_under_internal_pressure);
+    return HOST_TEST_EXIT_CODE();
+}
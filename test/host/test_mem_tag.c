@@ -0,0 +1,163 @@
+/**
+ * @file test_mem_tag.c
+ * @brief mem_tag：按子系统分区域计数、峰值、realloc 跨区域、全部释放后归零，以及报告格式
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "esp_heap_caps.h"
+#include "mem_tag.h"
+
+#define CAPS_INTERNAL (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#define CAPS_PSRAM    (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+
+static mem_tag_usage_t usage_of(mem_tag_t tag)
+{
+    mem_tag_report_t r;
+    mem_tag_get_report(&r);
+    return r.tags[tag];
+}
+
+static void check_all_zero(void)
+{
+    mem_tag_report_t r;
+    mem_tag_get_report(&r);
+    for (int i = 0; i < MEM_TAG_COUNT; i++) {
+        CHECK_EQ(r.tags[i].cur_internal, 0);
+        CHECK_EQ(r.tags[i].cur_psram, 0);
+    }
+}
+
+static void test_alloc_free_balance(void)
+{
+    void *ui = mem_tag_malloc(MEM_TAG_UI, 100, CAPS_INTERNAL);
+    void *ui2 = mem_tag_calloc(MEM_TAG_UI, 10, 30, CAPS_PSRAM);
+    void *net = mem_tag_malloc(MEM_TAG_NET, 4000, CAPS_INTERNAL);
+    CHECK(ui != NULL && ui2 != NULL && net != NULL);
+
+    mem_tag_usage_t u = usage_of(MEM_TAG_UI);
+    CHECK_EQ(u.cur_internal, 100);
+    CHECK_EQ(u.cur_psram, 300);
+    CHECK_EQ(usage_of(MEM_TAG_NET).cur_internal, 4000);
+    CHECK_EQ(usage_of(MEM_TAG_CACHE).cur_internal, 0);
+
+    mem_tag_free(MEM_TAG_NET, net);
+    mem_tag_free(MEM_TAG_UI, ui);
+    mem_tag_free(MEM_TAG_UI, ui2);
+    mem_tag_free(MEM_TAG_UI, NULL);
+    check_all_zero();
+
+    // 峰值保留历史最大值
+    u = usage_of(MEM_TAG_UI);
+    CHECK_EQ(u.peak_internal, 100);
+    CHECK_EQ(u.peak_psram, 300);
+    CHECK_EQ(usage_of(MEM_TAG_NET).peak_internal, 4000);
+}
+
+static void test_peak_tracks_maximum(void)
+{
+    void *blocks[8];
+    uint32_t before = usage_of(MEM_TAG_CACHE).peak_psram;
+    for (int i = 0; i < 8; i++) {
+        blocks[i] = mem_tag_malloc(MEM_TAG_CACHE, 1000, CAPS_PSRAM);
+    }
+    for (int i = 0; i < 4; i++) {
+        mem_tag_free(MEM_TAG_CACHE, blocks[i]);
+    }
+    for (int i = 0; i < 2; i++) {
+        blocks[i] = mem_tag_malloc(MEM_TAG_CACHE, 1000, CAPS_PSRAM);
+    }
+    CHECK_EQ(usage_of(MEM_TAG_CACHE).cur_psram, 6000);
+    CHECK_EQ(usage_of(MEM_TAG_CACHE).peak_psram, before > 8000 ? before : 8000);
+
+    for (int i = 0; i < 2; i++) {
+        mem_tag_free(MEM_TAG_CACHE, blocks[i]);
+    }
+    for (int i = 4; i < 8; i++) {
+        mem_tag_free(MEM_TAG_CACHE, blocks[i]);
+    }
+    check_all_zero();
+}
+
+static void test_realloc_across_regions(void)
+{
+    char *p = mem_tag_realloc(MEM_TAG_CLIENT, NULL, 64, CAPS_INTERNAL);
+    CHECK(p != NULL);
+    memset(p, 'a', 64);
+    CHECK_EQ(usage_of(MEM_TAG_CLIENT).cur_internal, 64);
+
+    // 扩大并搬到PSRAM：内部RAM扣除旧块，PSRAM计入新块，内容保留
+    p = mem_tag_realloc(MEM_TAG_CLIENT, p, 5000, CAPS_PSRAM);
+    CHECK(p != NULL);
+    CHECK_EQ(usage_of(MEM_TAG_CLIENT).cur_internal, 0);
+    CHECK_EQ(usage_of(MEM_TAG_CLIENT).cur_psram, 5000);
+    CHECK(p[0] == 'a' && p[63] == 'a');
+
+    // 失败时原块和计数都不变
+    host_heap_fail_after(false, 0);
+    char *q = mem_tag_realloc(MEM_TAG_CLIENT, p, 100, CAPS_INTERNAL);
+    host_heap_reset_limits();
+    CHECK(q == NULL);
+    CHECK_EQ(usage_of(MEM_TAG_CLIENT).cur_psram, 5000);
+    CHECK_EQ(usage_of(MEM_TAG_CLIENT).cur_internal, 0);
+
+    // size 为 0 等同释放
+    CHECK(mem_tag_realloc(MEM_TAG_CLIENT, p, 0, CAPS_PSRAM) == NULL);
+    check_all_zero();
+}
+
+static void test_failed_alloc_not_counted(void)
+{
+    host_heap_set_capacity(false, host_heap_used(false) + 1000);
+    void *p = mem_tag_malloc(MEM_TAG_LVGL, 2000, CAPS_INTERNAL);
+    host_heap_reset_limits();
+    CHECK(p == NULL);
+    CHECK_EQ(usage_of(MEM_TAG_LVGL).cur_internal, 0);
+}
+
+static void test_record_and_report(void)
+{
+    // 自带分配器的模块（lvgl_mem）直接登记
+    mem_tag_record(MEM_TAG_LVGL, true, 2048);
+    mem_tag_record(MEM_TAG_LVGL, false, 512);
+    mem_tag_record(MEM_TAG_COUNT, false, 512);
+    CHECK_EQ(usage_of(MEM_TAG_LVGL).cur_psram, 2048);
+    CHECK_EQ(usage_of(MEM_TAG_LVGL).cur_internal, 512);
+
+    // 已用量减去已标记的部分即未标记
+    void *untagged = heap_caps_malloc(3000, CAPS_INTERNAL);
+    void *tagged = mem_tag_malloc(MEM_TAG_UI, 1000, CAPS_INTERNAL);
+    mem_tag_report_t r;
+    mem_tag_get_report(&r);
+    CHECK_EQ(r.used_internal, host_heap_used(false));
+    CHECK_EQ(r.untagged_internal, r.used_internal - 512 - 1000);
+    CHECK(r.free_internal > 0 && r.largest_free_internal <= r.free_internal);
+
+    char text[1024];
+    size_t n = mem_tag_format(text, sizeof(text));
+    CHECK_EQ(n, strlen(text));
+    CHECK(strstr(text, "LVGL") != NULL);
+    CHECK(strstr(text, "未标记") != NULL);
+    char tiny[16];
+    CHECK_EQ(mem_tag_format(tiny, sizeof(tiny)), sizeof(tiny) - 1);
+    CHECK_EQ(strlen(tiny), sizeof(tiny) - 1);
+    CHECK_EQ(mem_tag_format(NULL, 10), 0);
+
+    mem_tag_free(MEM_TAG_UI, tagged);
+    heap_caps_free(untagged);
+    mem_tag_record(MEM_TAG_LVGL, true, -2048);
+    mem_tag_record(MEM_TAG_LVGL, false, -512);
+    check_all_zero();
+    CHECK_EQ(host_heap_used(false), 0);
+    CHECK_EQ(host_heap_used(true), 0);
+}
+
+int main(void)
+{
+    RUN_TEST(test_alloc_free_balance);
+    RUN_TEST(test_peak_tracks_maximum);
+    RUN_TEST(test_realloc_across_regions);
+    RUN_TEST(test_failed_alloc_not_counted);
+    RUN_TEST(test_record_and_report);
+    return HOST_TEST_EXIT_CODE();
+}
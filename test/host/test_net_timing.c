@@ -0,0 +1,133 @@
+/**
+ * @file test_net_timing.c
+ * @brief net_timing：分桶、百分位取桶上界、最大值截断与越界输入
+ *
+ * 直方图是全局的，每个用例使用不同的阶段，互不影响。
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "net_timing.h"
+
+static net_timing_summary_t summary(net_phase_t phase)
+{
+    net_timing_summary_t s;
+    memset(&s, 0xAA, sizeof(s));
+    net_timing_get_summary(phase, &s);
+    return s;
+}
+
+static void test_empty_phase(void)
+{
+    net_timing_summary_t s = summary(NET_PHASE_RESOLVE);
+    CHECK_EQ(s.count, 0);
+    CHECK_EQ(s.p50_us, 0);
+    CHECK_EQ(s.p95_us, 0);
+    CHECK_EQ(s.p99_us, 0);
+    CHECK_EQ(s.max_us, 0);
+}
+
+static void test_single_sample_reports_max(void)
+{
+    // 150us 落在上界 200us 的桶，百分位不超过实际最大值
+    net_timing_record(NET_PHASE_CONNECT, 150);
+    net_timing_summary_t s = summary(NET_PHASE_CONNECT);
+    CHECK_EQ(s.count, 1);
+    CHECK_EQ(s.p50_us, 150);
+    CHECK_EQ(s.p99_us, 150);
+    CHECK_EQ(s.max_us, 150);
+}
+
+static void test_bucket_bounds(void)
+{
+    // 等于上界的样本归入该桶
+    net_timing_record(NET_PHASE_SEND, 200);
+    net_timing_record(NET_PHASE_SEND, 1000);
+    net_timing_record(NET_PHASE_SEND, 1001);
+    net_timing_summary_t s = summary(NET_PHASE_SEND);
+    CHECK_EQ(s.p50_us, 1000);     // 第2个样本
+    CHECK_EQ(s.p95_us, 1001);     // 2000 的桶，按最大值截断
+    CHECK_EQ(s.max_us, 1001);
+}
+
+static void test_percentiles(void)
+{
+    // 1ms..100ms 各一个
+    for (int i = 1; i <= 100; i++) {
+        net_timing_record(NET_PHASE_WAIT, i * 1000);
+    }
+    net_timing_summary_t s = summary(NET_PHASE_WAIT);
+    CHECK_EQ(s.count, 100);
+    CHECK_EQ(s.p50_us, 50000);
+    CHECK_EQ(s.p95_us, 100000);
+    CHECK_EQ(s.p99_us, 100000);
+    CHECK_EQ(s.max_us, 100000);
+}
+
+static void test_tail_sample(void)
+{
+    // 99 个快请求 + 1 个 10 秒：p99 仍在快的桶，最大值单独体现
+    for (int i = 0; i < 99; i++) {
+        net_timing_record(NET_PHASE_RECEIVE, 800);
+    }
+    net_timing_record(NET_PHASE_RECEIVE, 10 * 1000 * 1000);
+    net_timing_summary_t s = summary(NET_PHASE_RECEIVE);
+    CHECK_EQ(s.p50_us, 1000);
+    CHECK_EQ(s.p99_us, 1000);
+    CHECK_EQ(s.max_us, 10 * 1000 * 1000);
+
+    // 再来一个慢请求，p99 落进最后一个桶，取实际最大值
+    net_timing_record(NET_PHASE_RECEIVE, 7 * 1000 * 1000);
+    s = summary(NET_PHASE_RECEIVE);
+    CHECK_EQ(s.p99_us, 10 * 1000 * 1000);
+}
+
+static void test_out_of_range_input(void)
+{
+    net_timing_record(NET_PHASE_PARSE, -5);
+    net_timing_summary_t s = summary(NET_PHASE_PARSE);
+    CHECK_EQ(s.count, 1);
+    CHECK_EQ(s.max_us, 0);
+    CHECK_EQ(s.p50_us, 0);
+
+    net_timing_record(NET_PHASE_PARSE, INT64_MAX);
+    s = summary(NET_PHASE_PARSE);
+    CHECK_EQ(s.count, 2);
+    CHECK_EQ(s.max_us, UINT32_MAX - 1);
+    CHECK_EQ(s.p99_us, UINT32_MAX - 1);
+
+    // 越界的阶段被忽略
+    net_timing_record(NET_PHASE_COUNT, 100);
+    net_timing_summary_t before = summary(NET_PHASE_UI_APPLY);
+    net_timing_summary_t bad = before;
+    net_timing_get_summary(NET_PHASE_COUNT, &bad);
+    CHECK(memcmp(&bad, &before, sizeof(bad)) == 0);
+    CHECK_EQ(before.count, 0);
+}
+
+static void test_phase_names_and_log(void)
+{
+    for (int i = 0; i < NET_PHASE_COUNT; i++) {
+        CHECK(net_timing_phase_name(i) != NULL);
+        CHECK(strcmp(net_timing_phase_name(i), "?") != 0);
+    }
+    CHECK(strcmp(net_timing_phase_name(NET_PHASE_COUNT), "?") == 0);
+
+    // 所有阶段都有样本时汇总行不越界
+    net_timing_record(NET_PHASE_UI_APPLY, UINT32_MAX);
+    host_time_us += (int64_t)NET_TIMING_LOG_INTERVAL_MS * 1000;
+    net_timing_log_periodic();
+    net_timing_log_periodic();
+}
+
+int main(void)
+{
+    RUN_TEST(test_empty_phase);
+    RUN_TEST(test_single_sample_reports_max);
+    RUN_TEST(test_bucket_bounds);
+    RUN_TEST(test_percentiles);
+    RUN_TEST(test_tail_sample);
+    RUN_TEST(test_out_of_range_input);
+    RUN_TEST(test_phase_names_and_log);
+    return HOST_TEST_EXIT_CODE();
+}
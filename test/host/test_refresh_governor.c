@@ -0,0 +1,406 @@
+/**
+ * @file test_refresh_governor.c
+ * @brief refresh_governor：滚动时的帧节奏、空闲时的唤醒次数、触摸到首帧的延迟
+ *
+ * 本文件模拟 main.c 的界面循环：lv_timer_handler（刷新、触摸读取、时钟三个定时器）
+ * 之后调用 refresh_governor_wait，信号量等待推进模拟时钟。
+ * 渲染一帧按固定耗时推进时钟并调用 monitor_cb；触摸按脚本按下/松开，
+ * 按下沿产生触摸中断，拖动和松手后的惯性滚动期间每次读取都使列表失效。
+ */
+
+#include <stdlib.h>
+#include "host_test.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "touch_driver.h"
+#include "refresh_governor.h"
+
+#define MS 1000LL
+
+#define RENDER_SCROLL_MS   8     // 滚动时重绘列表区域
+#define RENDER_CLOCK_MS    2     // 只有时钟走字
+#define SCROLL_THROW_MS    400   // 松手后的惯性滚动
+
+/* ---------- FreeRTOS 和触摸驱动替身 ---------- */
+
+struct host_semaphore {
+    bool given;
+};
+
+static struct host_semaphore sem_pool[4];
+static int sem_count = 0;
+
+esp_lcd_touch_handle_t tp = NULL;
+static bool touch_irq_supported = true;
+static esp_lcd_touch_interrupt_callback_t touch_isr = NULL;
+
+// 触摸脚本：按下沿时刻（触摸中断）和松开时刻
+static int64_t touch_down_us = -1;
+static int64_t touch_up_us = -1;
+static bool touch_drags = true;   // false：点按，不滚动
+
+esp_err_t esp_lcd_touch_register_interrupt_callback(esp_lcd_touch_handle_t touch,
+                                                    esp_lcd_touch_interrupt_callback_t callback)
+{
+    if (!touch_irq_supported) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    touch_isr = callback;
+    return ESP_OK;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    struct host_semaphore *sem = &sem_pool[sem_count++ % 4];
+    sem->given = false;
+    return sem;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    sem->given = true;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t *higher_prio_task_woken)
+{
+    sem->given = true;
+    *higher_prio_task_woken = pdTRUE;
+    return pdTRUE;
+}
+
+/**
+ * @brief 等待到超时；等待期间到达触摸按下沿时，有中断就在那一刻被唤醒
+ */
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    if (sem->given) {
+        sem->given = false;
+        return pdTRUE;
+    }
+    int64_t deadline = host_time_us + (int64_t)ticks * MS;
+    if (touch_isr != NULL && touch_down_us > host_time_us && touch_down_us <= deadline) {
+        host_time_us = touch_down_us;
+        touch_isr(tp);
+        sem->given = false;
+        return pdTRUE;
+    }
+    host_time_us = deadline;
+    return pdFALSE;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    host_time_us += (int64_t)ticks * MS;
+}
+
+/* ---------- LVGL 替身：显示、触摸和定时器调度 ---------- */
+
+typedef struct {
+    lv_timer_t *timer;
+    int64_t last_run_us;
+    uint32_t ready_seen;
+} sim_timer_t;
+
+// 按 lv_timer_handler 的执行顺序：后创建的定时器在链表头，先执行
+enum { SIM_CLOCK, SIM_INDEV, SIM_REFR, SIM_TIMER_COUNT };
+
+static sim_timer_t sim_timers[SIM_TIMER_COUNT];
+static lv_disp_drv_t disp_drv;
+static lv_disp_t disp;
+static lv_indev_drv_t indev_drv;
+static lv_indev_t indev;
+
+static int64_t last_activity_us = 0;
+static int64_t scroll_until_us = 0;
+static char scroll_obj;
+
+// 测试记录的每一帧
+static int64_t first_frame_after_us = -1;   // 等待的触摸后第一帧完成时刻
+static int64_t frame_interval_max_us = 0;   // 测量区间内的最大帧间隔
+static int64_t last_frame_done_us = 0;
+static uint32_t frames = 0;
+static uint32_t loop_wakeups = 0;
+
+uint32_t lv_disp_get_inactive_time(const lv_disp_t *d)
+{
+    return (uint32_t)((host_time_us - last_activity_us) / MS);
+}
+
+uint16_t lv_anim_count_running(void)
+{
+    return 0;
+}
+
+lv_obj_t *lv_indev_get_scroll_obj(const lv_indev_t *i)
+{
+    return host_time_us < scroll_until_us ? (lv_obj_t *)&scroll_obj : NULL;
+}
+
+static void refr_timer_cb(lv_timer_t *timer)
+{
+    if (disp.inv_p == 0) {
+        return;  // 与 LVGL 一样，没有失效区域时不渲染也不调用 monitor_cb
+    }
+    uint32_t render_ms = host_time_us < scroll_until_us ? RENDER_SCROLL_MS : RENDER_CLOCK_MS;
+    disp.inv_p = 0;
+    host_time_us += render_ms * MS;
+
+    if (frames > 0 && host_time_us - last_frame_done_us > frame_interval_max_us) {
+        frame_interval_max_us = host_time_us - last_frame_done_us;
+    }
+    if (first_frame_after_us < 0 && touch_down_us >= 0 && host_time_us > touch_down_us) {
+        first_frame_after_us = host_time_us;
+    }
+    last_frame_done_us = host_time_us;
+    frames++;
+    refresh_governor_monitor_cb(&disp_drv, render_ms, 240 * 320);
+}
+
+static void indev_read_cb(lv_timer_t *timer)
+{
+    bool pressed = touch_down_us >= 0 && host_time_us >= touch_down_us && host_time_us < touch_up_us;
+    if (pressed) {
+        last_activity_us = host_time_us;
+        if (touch_drags) {
+            scroll_until_us = host_time_us + SCROLL_THROW_MS * MS;
+        }
+    }
+    indev.proc.state = pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    if (host_time_us < scroll_until_us) {
+        disp.inv_p = 1;
+    }
+}
+
+static void clock_timer_cb(lv_timer_t *timer)
+{
+    disp.inv_p = 1;  // 顶栏时钟每秒走字
+}
+
+/**
+ * @brief 与 lv_timer_handler 相同：运行到期或被 ready 的定时器，返回距下一个到期的毫秒数
+ */
+static uint32_t sim_timer_handler(void)
+{
+    for (int i = 0; i < SIM_TIMER_COUNT; i++) {
+        sim_timer_t *t = &sim_timers[i];
+        if (t->timer->paused) {
+            continue;
+        }
+        bool ready = t->timer->ready_calls != t->ready_seen;
+        t->ready_seen = t->timer->ready_calls;
+        if (ready || host_time_us - t->last_run_us >= (int64_t)t->timer->period * MS) {
+            t->last_run_us = host_time_us;
+            t->timer->timer_cb(t->timer);
+        }
+    }
+
+    int64_t next_us = INT64_MAX;
+    for (int i = 0; i < SIM_TIMER_COUNT; i++) {
+        sim_timer_t *t = &sim_timers[i];
+        if (t->timer->paused) {
+            continue;
+        }
+        int64_t remain = t->last_run_us + (int64_t)t->timer->period * MS - host_time_us;
+        if (remain < next_us) {
+            next_us = remain;
+        }
+    }
+    return next_us <= 0 ? 0 : (uint32_t)((next_us + MS - 1) / MS);
+}
+
+static void run_until(int64_t end_us)
+{
+    while (host_time_us < end_us) {
+        uint32_t next_timer_ms = sim_timer_handler();
+        refresh_governor_wait(next_timer_ms);
+        loop_wakeups++;
+    }
+}
+
+static void setup(bool irq)
+{
+    static bool created = false;
+    if (!created) {
+        sim_timers[SIM_REFR].timer = lv_timer_create(refr_timer_cb, 30, NULL);
+        sim_timers[SIM_INDEV].timer = lv_timer_create(indev_read_cb, 30, NULL);
+        sim_timers[SIM_CLOCK].timer = lv_timer_create(clock_timer_cb, 1000, NULL);
+        created = true;
+    }
+    for (int i = 0; i < SIM_TIMER_COUNT; i++) {
+        sim_timers[i].last_run_us = host_time_us;
+        sim_timers[i].ready_seen = sim_timers[i].timer->ready_calls;
+    }
+    disp_drv.set_px_cb = NULL;
+    disp.driver = &disp_drv;
+    disp.refr_timer = sim_timers[SIM_REFR].timer;
+    indev_drv.read_timer = sim_timers[SIM_INDEV].timer;
+    indev.driver = &indev_drv;
+
+    static char touch_dev;
+    tp = (esp_lcd_touch_handle_t)&touch_dev;
+    touch_irq_supported = irq;
+    touch_isr = NULL;
+    touch_down_us = -1;
+    touch_up_us = -1;
+    touch_drags = true;
+    last_activity_us = host_time_us;
+    refresh_governor_init(&disp, &indev);
+
+    // 进入空闲并让统计窗口只包含稳态
+    run_until(host_time_us + 10000 * MS);
+}
+
+static refresh_governor_stats_t stats(void)
+{
+    refresh_governor_stats_t s;
+    refresh_governor_get_stats(&s);
+    return s;
+}
+
+/**
+ * @brief 只有时钟在走：约 1 fps，有触摸中断时只为三个 1 秒定时器醒来
+ */
+static void idle_minute(bool irq, uint32_t *wakeups_per_sec, uint32_t *fps)
+{
+    setup(irq);
+    CHECK_EQ(stats().mode, REFRESH_MODE_IDLE);
+
+    uint32_t wakeups = loop_wakeups;
+    uint32_t frame_count = frames;
+    int64_t start = host_time_us;
+    run_until(start + 60000 * MS);
+    int64_t elapsed_ms = (host_time_us - start) / MS;
+
+    *wakeups_per_sec = (uint32_t)((int64_t)(loop_wakeups - wakeups) * 1000 / elapsed_ms);
+    *fps = (uint32_t)((int64_t)(frames - frame_count) * 1000 / elapsed_ms);
+    CHECK_EQ(stats().mode, REFRESH_MODE_IDLE);
+    CHECK_EQ(stats().fps, *fps);
+    CHECK_EQ(stats().wakeups_per_sec, *wakeups_per_sec);
+}
+
+static void test_idle_wakeups(void)
+{
+    uint32_t wakeups_irq, fps_irq, wakeups_poll, fps_poll;
+    idle_minute(true, &wakeups_irq, &fps_irq);
+    CHECK_EQ(stats().refr_period_ms, 1000);
+    CHECK_EQ(stats().indev_period_ms, 1000);
+    idle_minute(false, &wakeups_poll, &fps_poll);
+    CHECK_EQ(stats().indev_period_ms, 100);
+
+    // 时钟每秒一帧；有中断时只为时钟醒来，没有中断时按 100 ms 轮询触摸
+    CHECK_EQ(fps_irq, 1);
+    CHECK_EQ(fps_poll, 1);
+    CHECK(wakeups_irq <= 3);
+    CHECK(wakeups_poll >= 10 && wakeups_poll <= 12);
+    printf("   空闲: 1 fps，有触摸中断 %u 次唤醒/秒，轮询触摸 %u 次唤醒/秒（原来 10 ms 轮询为 100 次/秒）\n",
+           (unsigned)wakeups_irq, (unsigned)wakeups_poll);
+}
+
+/**
+ * @brief 空闲中按下并拖动 3 秒：中断唤醒后立即进入高帧率，拖动期间帧间隔稳定
+ */
+static void scroll(bool irq, int64_t *latency_us, uint32_t *fps, int64_t *max_interval_us)
+{
+    setup(irq);
+    int64_t down = host_time_us + 437 * MS;  // 不与定时器对齐
+    touch_down_us = down;
+    touch_up_us = down + 3000 * MS;
+    first_frame_after_us = -1;
+
+    // 先走到按下后的 500 ms，量首帧延迟
+    run_until(down + 500 * MS);
+    *latency_us = first_frame_after_us - down;
+    CHECK_EQ(disp.refr_timer->period, 15);
+    CHECK_EQ(indev_drv.read_timer->period, 15);
+
+    // 拖动中段 2 秒的帧节奏
+    frame_interval_max_us = 0;
+    uint32_t frame_count = frames;
+    int64_t start = host_time_us;
+    run_until(down + 2500 * MS);
+    *fps = (uint32_t)((int64_t)(frames - frame_count) * 1000 * MS / (host_time_us - start));
+    *max_interval_us = frame_interval_max_us;
+    refresh_governor_stats_t s = stats();
+    CHECK_EQ(s.mode, REFRESH_MODE_ACTIVE);
+    CHECK_EQ(s.refr_period_ms, 15);
+    CHECK(s.frame_interval_max_ms <= 16);
+    CHECK(s.fps >= 60);
+
+    // 松手、惯性滚动结束、5 秒无操作后回到空闲
+    run_until(touch_up_us + SCROLL_THROW_MS * MS + 100 * MS);
+    CHECK_EQ(disp.refr_timer->period, 30);
+    run_until(touch_up_us + 6500 * MS);
+    CHECK_EQ(disp.refr_timer->period, 1000);
+    CHECK_EQ(stats().mode, REFRESH_MODE_IDLE);
+}
+
+static void test_scroll_frame_pacing(void)
+{
+    int64_t latency_irq, latency_poll, max_irq, max_poll;
+    uint32_t fps_irq, fps_poll;
+    scroll(true, &latency_irq, &fps_irq, &max_irq);
+    scroll(false, &latency_poll, &fps_poll, &max_poll);
+
+    // 中断在按下的那一刻唤醒并立即读取触摸，首帧只差一次渲染
+    CHECK(latency_irq >= 0 && latency_irq <= (RENDER_SCROLL_MS + 1) * MS);
+    // 轮询时最坏等满一个 100 ms 周期
+    CHECK(latency_poll > 0 && latency_poll <= (100 + RENDER_SCROLL_MS + 1) * MS);
+    CHECK(fps_irq >= 60 && fps_poll >= 60);
+    CHECK(max_irq <= 16 * MS && max_poll <= 16 * MS);
+    printf("   滚动: %u fps，最大帧间隔 %.1f ms；按下到首帧 %.1f ms（中断）/ %.1f ms（100 ms 轮询）\n",
+           (unsigned)fps_irq, max_irq / 1000.0, latency_irq / 1000.0, latency_poll / 1000.0);
+}
+
+/**
+ * @brief 其他任务唤醒（新数据）后，空闲时的失效区域不必等满 1 秒
+ */
+static void test_wake_renders_pending_invalidation(void)
+{
+    setup(true);
+    run_until(host_time_us + 250 * MS);
+    int64_t start = host_time_us;
+    uint32_t frame_count = frames;
+
+    // 网络任务交来新的列表：失效并唤醒
+    disp.inv_p = 1;
+    refresh_governor_wake();
+    run_until(host_time_us + 1);
+    CHECK_EQ(frames - frame_count, 1);
+    CHECK(host_time_us - start <= RENDER_CLOCK_MS * MS + 1);
+
+    // 黑屏暂停刷新时不提前渲染
+    lv_timer_pause(disp.refr_timer);
+    disp.inv_p = 1;
+    frame_count = frames;
+    run_until(host_time_us + 3000 * MS);
+    CHECK_EQ(frames - frame_count, 0);
+    lv_timer_resume(disp.refr_timer);
+    disp.inv_p = 0;
+}
+
+/**
+ * @brief 点按（不滚动）：松手后保持高帧率 300 ms 再降到 normal
+ */
+static void test_tap_holds_active(void)
+{
+    setup(true);
+    touch_down_us = host_time_us + 100 * MS;
+    touch_up_us = touch_down_us + 80 * MS;
+    touch_drags = false;
+    run_until(touch_up_us + 200 * MS);
+    CHECK_EQ(disp.refr_timer->period, 15);
+    run_until(touch_up_us + 400 * MS);
+    CHECK_EQ(disp.refr_timer->period, 30);
+}
+
+int main(void)
+{
+    host_time_us = 1000 * MS;
+    RUN_TEST(test_idle_wakeups);
+    RUN_TEST(test_scroll_frame_pacing);
+    RUN_TEST(test_tap_holds_active);
+    RUN_TEST(test_wake_renders_pending_invalidation);
+    return HOST_TEST_EXIT_CODE();
+}
@@ -0,0 +1,205 @@
+/**
+ * @file test_retry_policy.c
+ * @brief retry_policy：指数退避与抖动、Retry-After、熔断/半开/恢复、冷却加倍与上限
+ *
+ * 模块状态是全局的，每个用例开始时用 on_success 把各接口和熔断器恢复到初始状态。
+ */
+
+#include "host_test.h"
+#include "retry_policy.h"
+
+#define MS 1000LL
+
+static void advance_ms(int64_t ms)
+{
+    host_time_us += ms * MS;
+}
+
+static void reset_policy(void)
+{
+    for (int i = 0; i < RETRY_ENDPOINT_COUNT; i++) {
+        retry_policy_on_success(i);
+    }
+    advance_ms(1);
+}
+
+static void trip_breaker(void)
+{
+    for (int i = 0; i < RETRY_BREAKER_THRESHOLD; i++) {
+        retry_policy_on_failure(RETRY_ENDPOINT_LIST, true, 0);
+    }
+}
+
+static void test_initial_state(void)
+{
+    for (int i = 0; i < RETRY_ENDPOINT_COUNT; i++) {
+        CHECK(retry_policy_allow(i));
+        CHECK_EQ(retry_policy_wait_ms(i), 0);
+        retry_policy_on_success(i);
+    }
+    CHECK_EQ(retry_policy_get_breaker_state(), RETRY_BREAKER_CLOSED);
+}
+
+static void test_backoff_doubles_with_jitter(void)
+{
+    // 详情：基础 1s，上限 30s；第 n 次失败等待 [d/2, d]，d = min(1s * 2^(n-1), 30s)
+    for (int seed = 1; seed <= 50; seed++) {
+        reset_policy();
+        host_random_seed(seed);
+        for (uint32_t n = 1; n <= 20; n++) {
+            retry_policy_on_failure(RETRY_ENDPOINT_DETAIL, false, 0);
+            uint32_t d = n <= 5 ? 1000u << (n - 1) : 30000;
+            uint32_t wait = retry_policy_wait_ms(RETRY_ENDPOINT_DETAIL);
+            CHECK(wait >= d / 2);
+            CHECK(wait <= d);
+        }
+    }
+
+    // 列表上限 5 分钟
+    reset_policy();
+    for (int n = 0; n < 32; n++) {
+        retry_policy_on_failure(RETRY_ENDPOINT_LIST, false, 0);
+    }
+    CHECK(retry_policy_wait_ms(RETRY_ENDPOINT_LIST) >= 150000);
+    CHECK(retry_policy_wait_ms(RETRY_ENDPOINT_LIST) <= 300000);
+}
+
+static void test_endpoints_back_off_independently(void)
+{
+    reset_policy();
+    retry_policy_stats_t before, after;
+    retry_policy_get_stats(&before);
+
+    retry_policy_on_failure(RETRY_ENDPOINT_MUTATION, false, 0);
+    CHECK(!retry_policy_allow(RETRY_ENDPOINT_MUTATION));
+    CHECK(retry_policy_allow(RETRY_ENDPOINT_LIST));
+    retry_policy_on_success(RETRY_ENDPOINT_LIST);
+
+    retry_policy_get_stats(&after);
+    CHECK_EQ(after.rejected[RETRY_ENDPOINT_MUTATION] - before.rejected[RETRY_ENDPOINT_MUTATION], 1);
+    CHECK_EQ(after.failures[RETRY_ENDPOINT_MUTATION] - before.failures[RETRY_ENDPOINT_MUTATION], 1);
+    CHECK_EQ(after.attempts[RETRY_ENDPOINT_LIST] - before.attempts[RETRY_ENDPOINT_LIST], 1);
+
+    // 退避到期后放行，成功后清零
+    advance_ms(retry_policy_wait_ms(RETRY_ENDPOINT_MUTATION));
+    CHECK(retry_policy_allow(RETRY_ENDPOINT_MUTATION));
+    retry_policy_on_success(RETRY_ENDPOINT_MUTATION);
+    retry_policy_on_failure(RETRY_ENDPOINT_MUTATION, false, 0);
+    CHECK(retry_policy_wait_ms(RETRY_ENDPOINT_MUTATION) <= 1000);
+}
+
+static void test_retry_after_is_minimum(void)
+{
+    reset_policy();
+    retry_policy_on_failure(RETRY_ENDPOINT_MUTATION, false, 20000);
+    CHECK_EQ(retry_policy_wait_ms(RETRY_ENDPOINT_MUTATION), 20000);
+    advance_ms(19999);
+    CHECK(!retry_policy_allow(RETRY_ENDPOINT_MUTATION));
+    advance_ms(1);
+    CHECK(retry_policy_allow(RETRY_ENDPOINT_MUTATION));
+    retry_policy_on_success(RETRY_ENDPOINT_MUTATION);
+}
+
+static void test_client_errors_do_not_trip(void)
+{
+    reset_policy();
+    for (int i = 0; i < 10; i++) {
+        retry_policy_on_failure(RETRY_ENDPOINT_DETAIL, false, 0);
+    }
+    CHECK_EQ(retry_policy_get_breaker_state(), RETRY_BREAKER_CLOSED);
+
+    // 中间有一次成功，连续计数重新开始
+    reset_policy();
+    retry_policy_on_failure(RETRY_ENDPOINT_LIST, true, 0);
+    retry_policy_on_failure(RETRY_ENDPOINT_LIST, true, 0);
+    retry_policy_on_success(RETRY_ENDPOINT_DETAIL);
+    retry_policy_on_failure(RETRY_ENDPOINT_LIST, true, 0);
+    retry_policy_on_failure(RETRY_ENDPOINT_LIST, true, 0);
+    CHECK_EQ(retry_policy_get_breaker_state(), RETRY_BREAKER_CLOSED);
+}
+
+static void test_breaker_trip_probe_recover(void)
+{
+    reset_policy();
+    retry_policy_stats_t before, after;
+    retry_policy_get_stats(&before);
+
+    trip_breaker();
+    CHECK_EQ(retry_policy_get_breaker_state(), RETRY_BREAKER_OPEN);
+    // 熔断期间所有接口都被拒绝，等待时间为冷却时间加最多 1/4 抖动
+    CHECK(!retry_policy_allow(RETRY_ENDPOINT_DETAIL));
+    uint32_t wait = retry_policy_wait_ms(RETRY_ENDPOINT_DETAIL);
+    CHECK(wait >= RETRY_BREAKER_COOLDOWN_MS);
+    CHECK(wait <= RETRY_BREAKER_COOLDOWN_MS * 5 / 4);
+
+    // 冷却结束：半开，只放行一个探测请求
+    advance_ms(wait);
+    CHECK_EQ(retry_policy_get_breaker_state(), RETRY_BREAKER_HALF_OPEN);
+    CHECK(retry_policy_allow(RETRY_ENDPOINT_DETAIL));
+    CHECK(!retry_policy_allow(RETRY_ENDPOINT_LIST));
+
+    // 探测失败：重新熔断，冷却加倍
+    retry_policy_on_failure(RETRY_ENDPOINT_DETAIL, true, 0);
+    CHECK_EQ(retry_policy_get_breaker_state(), RETRY_BREAKER_OPEN);
+    uint32_t wait2 = retry_policy_wait_ms(RETRY_ENDPOINT_MUTATION);
+    CHECK(wait2 >= RETRY_BREAKER_COOLDOWN_MS * 2);
+    CHECK(wait2 <= RETRY_BREAKER_COOLDOWN_MS * 2 * 5 / 4);
+
+    // 第二次探测成功：恢复，记录从熔断到恢复的用时
+    advance_ms(wait2);
+    CHECK(retry_policy_allow(RETRY_ENDPOINT_MUTATION));
+    retry_policy_on_success(RETRY_ENDPOINT_MUTATION);
+    CHECK_EQ(retry_policy_get_breaker_state(), RETRY_BREAKER_CLOSED);
+    CHECK(retry_policy_allow(RETRY_ENDPOINT_DETAIL));
+    retry_policy_on_success(RETRY_ENDPOINT_DETAIL);
+
+    retry_policy_get_stats(&after);
+    CHECK_EQ(after.breaker_trips - before.breaker_trips, 1);
+    CHECK_EQ(after.last_recovery_ms, wait + wait2);
+
+    // 恢复后冷却时间回到初值
+    trip_breaker();
+    CHECK(retry_policy_wait_ms(RETRY_ENDPOINT_DETAIL) <= RETRY_BREAKER_COOLDOWN_MS * 5 / 4);
+}
+
+static void test_half_open_client_error_closes(void)
+{
+    // 探测请求得到 4xx：服务器有响应，熔断器关闭，只退避该接口
+    reset_policy();
+    trip_breaker();
+    advance_ms(retry_policy_wait_ms(RETRY_ENDPOINT_LIST));
+    CHECK(retry_policy_allow(RETRY_ENDPOINT_DETAIL));
+    retry_policy_on_failure(RETRY_ENDPOINT_DETAIL, false, 0);
+    CHECK_EQ(retry_policy_get_breaker_state(), RETRY_BREAKER_CLOSED);
+    CHECK(!retry_policy_allow(RETRY_ENDPOINT_DETAIL));
+    CHECK(retry_policy_allow(RETRY_ENDPOINT_MUTATION));
+    retry_policy_on_success(RETRY_ENDPOINT_MUTATION);
+}
+
+static void test_cooldown_cap(void)
+{
+    reset_policy();
+    trip_breaker();
+    for (int i = 0; i < 20; i++) {
+        advance_ms(retry_policy_wait_ms(RETRY_ENDPOINT_LIST));
+        CHECK(retry_policy_allow(RETRY_ENDPOINT_LIST));
+        retry_policy_on_failure(RETRY_ENDPOINT_LIST, true, 0);
+    }
+    uint32_t wait = retry_policy_wait_ms(RETRY_ENDPOINT_DETAIL);
+    CHECK(wait >= RETRY_BREAKER_COOLDOWN_MAX_MS);
+    CHECK(wait <= RETRY_BREAKER_COOLDOWN_MAX_MS * 5 / 4);
+}
+
+int main(void)
+{
+    host_time_us = 1000000 * MS;
+    RUN_TEST(test_initial_state);
+    RUN_TEST(test_backoff_doubles_with_jitter);
+    RUN_TEST(test_endpoints_back_off_independently);
+    RUN_TEST(test_retry_after_is_minimum);
+    RUN_TEST(test_client_errors_do_not_trip);
+    RUN_TEST(test_breaker_trip_probe_recover);
+    RUN_TEST(test_half_open_client_error_closes);
+    RUN_TEST(test_cooldown_cap);
+    return HOST_TEST_EXIT_CODE();
+}
@@ -0,0 +1,169 @@
+/**
+ * @file test_spsc_ring.c
+ * @brief spsc_ring：参数检查、先进先出、满/空、计数器回绕，以及两个线程并发收发
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include "host_test.h"
+#include "esp_heap_caps.h"
+#include "spsc_ring.h"
+
+typedef struct {
+    uint32_t seq;
+    uint32_t check;     // seq 的变换，检查元素内容没有读到一半
+    uint8_t pad[24];
+} item_t;
+
+static item_t make_item(uint32_t seq)
+{
+    item_t item = {.seq = seq, .check = seq * 2654435761u};
+    for (size_t i = 0; i < sizeof(item.pad); i++) {
+        item.pad[i] = (uint8_t)(seq + i);
+    }
+    return item;
+}
+
+static bool item_ok(const item_t *item, uint32_t seq)
+{
+    item_t want = make_item(seq);
+    return memcmp(item, &want, sizeof(want)) == 0;
+}
+
+static void ring_free(spsc_ring_t *ring)
+{
+    mem_tag_free(MEM_TAG_NET, ring->slots);
+}
+
+static void test_init_args(void)
+{
+    spsc_ring_t ring;
+    CHECK_EQ(spsc_ring_init(&ring, sizeof(item_t), 0, MALLOC_CAP_8BIT, MEM_TAG_NET), ESP_ERR_INVALID_ARG);
+    CHECK_EQ(spsc_ring_init(&ring, sizeof(item_t), 6, MALLOC_CAP_8BIT, MEM_TAG_NET), ESP_ERR_INVALID_ARG);
+    CHECK_EQ(spsc_ring_init(&ring, 0, 8, MALLOC_CAP_8BIT, MEM_TAG_NET), ESP_ERR_INVALID_ARG);
+    CHECK_EQ(spsc_ring_init(NULL, sizeof(item_t), 8, MALLOC_CAP_8BIT, MEM_TAG_NET), ESP_ERR_INVALID_ARG);
+    CHECK_EQ(spsc_ring_init(&ring, sizeof(item_t), 1, MALLOC_CAP_8BIT, MEM_TAG_NET), ESP_OK);
+    ring_free(&ring);
+}
+
+static void test_fifo_full_empty(void)
+{
+    spsc_ring_t ring;
+    item_t item;
+    CHECK_EQ(spsc_ring_init(&ring, sizeof(item_t), 8, MALLOC_CAP_8BIT, MEM_TAG_NET), ESP_OK);
+    CHECK(!spsc_ring_pop(&ring, &item));
+    CHECK_EQ(spsc_ring_count(&ring), 0);
+
+    for (uint32_t i = 0; i < 8; i++) {
+        item = make_item(i);
+        CHECK(spsc_ring_push(&ring, &item));
+    }
+    CHECK_EQ(spsc_ring_count(&ring), 8);
+    item = make_item(99);
+    CHECK(!spsc_ring_push(&ring, &item));
+    CHECK(!spsc_ring_push(&ring, &item));
+    CHECK_EQ(ring.full_count, 2);
+    CHECK_EQ(ring.high_water, 8);
+
+    // 满时失败不覆盖旧数据
+    for (uint32_t i = 0; i < 8; i++) {
+        CHECK(spsc_ring_pop(&ring, &item));
+        CHECK(item_ok(&item, i));
+    }
+    CHECK(!spsc_ring_pop(&ring, &item));
+    CHECK_EQ(spsc_ring_count(&ring), 0);
+
+    // 交替收发，high_water 保持历史最大值
+    for (uint32_t i = 0; i < 20; i++) {
+        item = make_item(100 + i);
+        CHECK(spsc_ring_push(&ring, &item));
+        CHECK(spsc_ring_pop(&ring, &item));
+        CHECK(item_ok(&item, 100 + i));
+    }
+    CHECK_EQ(ring.high_water, 8);
+    ring_free(&ring);
+}
+
+static void test_counter_wraparound(void)
+{
+    spsc_ring_t ring;
+    item_t item;
+    CHECK_EQ(spsc_ring_init(&ring, sizeof(item_t), 4, MALLOC_CAP_8BIT, MEM_TAG_NET), ESP_OK);
+
+    // head/tail 是自由增长的 32 位计数器，从接近上限处开始，收发中途回绕
+    atomic_store(&ring.head, UINT32_MAX - 2);
+    atomic_store(&ring.tail, UINT32_MAX - 2);
+    uint32_t next_push = 0;
+    uint32_t next_pop = 0;
+    for (int round = 0; round < 6; round++) {
+        while (true) {
+            item = make_item(next_push);
+            if (!spsc_ring_push(&ring, &item)) {
+                break;
+            }
+            next_push++;
+        }
+        CHECK_EQ(spsc_ring_count(&ring), 4);
+        for (int i = 0; i < 3; i++) {
+            CHECK(spsc_ring_pop(&ring, &item));
+            CHECK(item_ok(&item, next_pop));
+            next_pop++;
+        }
+        CHECK_EQ(spsc_ring_count(&ring), 1);
+    }
+    CHECK((uint32_t)atomic_load(&ring.head) < 100);
+    ring_free(&ring);
+}
+
+#define STRESS_ITEMS 200000
+
+static spsc_ring_t stress_ring;
+static int stress_errors = 0;
+
+static void *consumer_thread(void *arg)
+{
+    (void)arg;
+    item_t item;
+    uint32_t expect = 0;
+    while (expect < STRESS_ITEMS) {
+        if (!spsc_ring_pop(&stress_ring, &item)) {
+            sched_yield();    // 单核机器上让生产者运行
+            continue;
+        }
+        if (!item_ok(&item, expect) && stress_errors++ < 5) {
+            fprintf(stderr, "第 %u 个元素错误: seq=%u\n", expect, item.seq);
+        }
+        expect++;
+    }
+    return NULL;
+}
+
+static void test_two_threads(void)
+{
+    CHECK_EQ(spsc_ring_init(&stress_ring, sizeof(item_t), 16, MALLOC_CAP_8BIT, MEM_TAG_NET), ESP_OK);
+
+    pthread_t consumer;
+    CHECK_EQ(pthread_create(&consumer, NULL, consumer_thread, NULL), 0);
+    for (uint32_t i = 0; i < STRESS_ITEMS; i++) {
+        item_t item = make_item(i);
+        while (!spsc_ring_push(&stress_ring, &item)) {
+            sched_yield();
+        }
+    }
+    pthread_join(consumer, NULL);
+
+    CHECK_EQ(stress_errors, 0);
+    CHECK_EQ(spsc_ring_count(&stress_ring), 0);
+    CHECK(stress_ring.high_water <= 16);
+    ring_free(&stress_ring);
+}
+
+int main(void)
+{
+    RUN_TEST(test_init_args);
+    RUN_TEST(test_fifo_full_empty);
+    RUN_TEST(test_counter_wraparound);
+    RUN_TEST(test_two_threads);
+    return HOST_TEST_EXIT_CODE();
+}
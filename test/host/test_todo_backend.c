@@ -0,0 +1,191 @@
+/**
+ * @file test_todo_backend.c
+ * @brief todo_backend：两个替身后端注入延迟和下线，请求按延迟 EWMA 选择后端，
+ *        明显更快（超过 TODO_BACKEND_SWITCH_MARGIN）才切换，后端无响应时同一次调用内
+ *        切到另一个后端，下线的后端退避结束后重新参与选择
+ *
+ * 直接包含 todo_backend.c 以便调用静态的 probe（探测任务在主机上不运行，由测试逐次驱动）。
+ * 请求经真实的 todo_client 发出，服务器为 host_http.c 的脚本化替身，时间为模拟时钟。
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "host_http.h"
+#include "host_pages.h"
+#include "todo_backend.c"
+
+#define ORIGIN_A    "http://10.0.0.2:5000"
+#define ORIGIN_B    "http://10.0.0.3:5000"
+#define LIST_TOTAL  10
+
+typedef struct {
+    uint32_t wait_ms;           // 注入的服务器延迟
+    int list_requests;
+    int complete_requests;
+    char body[8192];
+} backend_server_t;
+
+static backend_server_t servers[2];
+
+static void handler(const host_http_request_t *req, host_http_response_t *resp, void *ctx)
+{
+    backend_server_t *s = ctx;
+    resp->wait_ms = s->wait_ms;
+    resp->transfer_ms = 5;
+    if (req->method == HTTP_METHOD_POST && strstr(req->path, "/complete") != NULL) {
+        s->complete_requests++;
+        resp->status = 200;
+        return;
+    }
+    if (strncmp(req->path, "/api/todos?", 11) != 0) {
+        resp->status = 404;
+        return;
+    }
+    s->list_requests++;
+    resp->status = 200;
+    resp->headers[0][0] = "Content-Type";
+    resp->headers[0][1] = "application/json";
+    if (req->method != HTTP_METHOD_HEAD) {
+        resp->body = s->body;
+        resp->body_len = host_page_json(s->body, sizeof(s->body), 0, TODO_PAGE_SIZE, LIST_TOTAL);
+    }
+}
+
+static void get_page_ok(void)
+{
+    static todo_page_t page;
+    CHECK_EQ(todo_client_get_page(NULL, &page), ESP_OK);
+    CHECK_EQ(page.count, TODO_PAGE_SIZE);
+}
+
+static int active_backend(void)
+{
+    for (int i = 0; i < todo_backend_count(); i++) {
+        todo_backend_info_t info;
+        todo_backend_get_info(i, &info);
+        if (info.active) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void test_probe_finds_faster_backend(void)
+{
+    servers[0].wait_ms = 200;
+    servers[1].wait_ms = 40;
+
+    // B 还没有延迟样本：请求留在配置顺序的第一个后端
+    for (int i = 0; i < 3; i++) {
+        get_page_ok();
+    }
+    CHECK_EQ(servers[0].list_requests, 3);
+    CHECK_EQ(servers[1].list_requests, 0);
+    CHECK_EQ(active_backend(), 0);
+
+    // 探测 B 后它明显更快，下一次请求切过去
+    probe(1);
+    todo_backend_info_t info;
+    todo_backend_get_info(1, &info);
+    CHECK_EQ(info.samples, 1);
+    CHECK_EQ(info.ewma_ms, 45);
+    get_page_ok();
+    CHECK_EQ(servers[1].list_requests, 2);
+    CHECK_EQ(active_backend(), 1);
+}
+
+static void test_margin_prevents_flapping(void)
+{
+    // A 变得比 B 稍快，但没快出切换余量：留在 B
+    servers[0].wait_ms = 30;
+    for (int i = 0; i < 40; i++) {
+        probe(0);
+    }
+    todo_backend_info_t a;
+    todo_backend_info_t b;
+    todo_backend_get_info(0, &a);
+    todo_backend_get_info(1, &b);
+    CHECK(a.ewma_ms < b.ewma_ms);
+    CHECK(a.ewma_ms * 100 >= b.ewma_ms * (100 - TODO_BACKEND_SWITCH_MARGIN));
+
+    int a_requests = servers[0].list_requests;
+    for (int i = 0; i < 5; i++) {
+        get_page_ok();
+    }
+    CHECK_EQ(active_backend(), 1);
+    CHECK_EQ(servers[0].list_requests, a_requests);
+}
+
+static void test_failover_within_one_call(void)
+{
+    // B 下线：排队中的完成状态修改在同一次调用内改发到 A，不丢失
+    host_http_set_down(ORIGIN_B, true);
+    int64_t start = host_time_us;
+    CHECK_EQ(todo_client_set_completed("id-1", "list-1", true), ESP_OK);
+    CHECK_EQ(servers[0].complete_requests, 1);
+    CHECK_EQ(servers[1].complete_requests, 0);
+    CHECK_EQ(host_http_get_stats(ORIGIN_B)->refused, 1);
+    CHECK_EQ(active_backend(), 0);
+    // 失效长连接 1 ms + 连接 B 等满超时，之后在 A 上新建连接完成请求
+    CHECK_EQ((host_time_us - start) / 1000, 1 + 5000 + 3 + servers[0].wait_ms + 5);
+
+    todo_backend_info_t info;
+    todo_backend_get_info(1, &info);
+    CHECK(!info.healthy);
+    CHECK_EQ(info.failures, 1);
+    CHECK(backends[1].down_until_ms - host_time_us / 1000 >= BACKEND_DOWN_MIN_MS);
+    CHECK(backends[1].down_until_ms - host_time_us / 1000 <= BACKEND_DOWN_MIN_MS * 5 / 4);
+}
+
+static void test_recovers_after_backoff(void)
+{
+    // A 变慢，但 B 仍在退避期内：不尝试 B，也不探测它
+    servers[0].wait_ms = 300;
+    host_http_set_down(ORIGIN_B, false);
+    for (int i = 0; i < 10; i++) {
+        get_page_ok();
+    }
+    CHECK_EQ(active_backend(), 0);
+    CHECK_EQ(host_http_get_stats(ORIGIN_B)->refused, 1);
+    uint32_t b_requests = host_http_get_stats(ORIGIN_B)->requests;
+
+    // 退避结束：B 的延迟样本还在，明显比 A 快，下一次请求回到 B
+    host_time_us = (backends[1].down_until_ms + 1) * 1000;
+    todo_backend_info_t info;
+    todo_backend_get_info(1, &info);
+    CHECK(info.healthy);
+    get_page_ok();
+    CHECK_EQ(active_backend(), 1);
+    CHECK_EQ(host_http_get_stats(ORIGIN_B)->requests, b_requests + 1);
+
+    // 成功后连续失败计数清零，再次下线时从最短退避开始
+    CHECK_EQ(backends[1].failures_in_row, 0);
+}
+
+static void test_report(void)
+{
+    for (int i = 0; i < todo_backend_count(); i++) {
+        todo_backend_info_t info;
+        todo_backend_get_info(i, &info);
+        printf("   %s: %s, EWMA %lu ms, 请求 %lu 次, 无响应 %lu 次%s\n", info.url,
+               info.healthy ? "健康" : "下线", (unsigned long)info.ewma_ms, (unsigned long)info.requests,
+               (unsigned long)info.failures, info.active ? "（使用中）" : "");
+    }
+}
+
+int main(void)
+{
+    host_random_seed(1);
+    host_http_reset();
+    host_http_add_server(ORIGIN_A, 3, 3, handler, &servers[0]);
+    host_http_add_server(ORIGIN_B, 3, 3, handler, &servers[1]);
+    CHECK_EQ(todo_client_init(ORIGIN_A ", " ORIGIN_B "/"), ESP_OK);
+    CHECK_EQ(todo_backend_count(), 2);
+
+    RUN_TEST(test_probe_finds_faster_backend);
+    RUN_TEST(test_margin_prevents_flapping);
+    RUN_TEST(test_failover_within_one_call);
+    RUN_TEST(test_recovers_after_backoff);
+    RUN_TEST(test_report);
+    return HOST_TEST_EXIT_CODE();
+}
@@ -0,0 +1,237 @@
+/**
+ * @file test_todo_client.c
+ * @brief todo_client：列表页 JSON/CBOR 两种响应解析结果一致，CBOR 解析不分配内存，
+ *        以及两种编码的字节数、解析耗时和分配次数对比
+ *
+ * 直接包含 todo_client.c 以便对静态的 parse_page_json/parse_page_cbor 计时。
+ * HTTP 由 host_http.c 的脚本化服务器应答，cJSON 为 host_cjson.c（分配方式与 cJSON 1.7 相同）。
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "host_http.h"
+#include "host_pages.h"
+#include "todo_client.c"
+
+#define ORIGIN       "http://10.0.0.2:5000"
+#define LIST_TOTAL   25
+#define BENCH_ROUNDS 10000
+
+// 列表服务器：请求的 Accept 含 application/cbor 且 cbor_capable 时返回 CBOR
+typedef struct {
+    bool cbor_capable;
+    int total;
+    int list_requests;
+    bool last_was_cbor;
+    uint8_t body[HTTP_BUFFER_SIZE];
+} list_server_t;
+
+static list_server_t server;
+
+/**
+ * @brief 从请求路径中取出游标里的起始条目（游标为 skip=<n>&token=...，经过百分号编码）
+ */
+static int cursor_first(const char *path)
+{
+    const char *cursor = strstr(path, "cursor=skip%3D");
+    return cursor != NULL ? atoi(cursor + strlen("cursor=skip%3D")) : 0;
+}
+
+static void list_handler(const host_http_request_t *req, host_http_response_t *resp, void *ctx)
+{
+    list_server_t *s = ctx;
+    if (strncmp(req->path, "/api/todos?", 11) != 0) {
+        resp->status = 404;
+        return;
+    }
+    s->list_requests++;
+
+    int first = cursor_first(req->path);
+    int count = s->total - first < TODO_PAGE_SIZE ? s->total - first : TODO_PAGE_SIZE;
+    bool cbor = s->cbor_capable && req->accept != NULL && strstr(req->accept, "application/cbor") != NULL;
+    s->last_was_cbor = cbor;
+
+    resp->status = 200;
+    resp->headers[0][0] = "Content-Type";
+    resp->headers[0][1] = cbor ? "application/cbor" : "application/json";
+    resp->body = s->body;
+    resp->body_len = cbor ? host_page_cbor(s->body, sizeof(s->body), first, count, s->total)
+                          : host_page_json((char *)s->body, sizeof(s->body), first, count, s->total);
+    resp->wait_ms = 30;
+    resp->transfer_ms = 5;
+}
+
+static void start_server(bool cbor_capable, int total)
+{
+    host_http_reset();
+    memset(&server, 0, sizeof(server));
+    server.cbor_capable = cbor_capable;
+    server.total = total;
+    host_http_add_server(ORIGIN, 3, 3, list_handler, &server);
+    retry_policy_on_success(RETRY_ENDPOINT_LIST);
+}
+
+/**
+ * @brief 页中第 i 条与测试数据的第 first + i 条一致
+ */
+static void check_page(const todo_page_t *page, int first, int total)
+{
+    int expected = total - first < TODO_PAGE_SIZE ? total - first : TODO_PAGE_SIZE;
+    CHECK_EQ(page->count, expected);
+    CHECK(strcmp(page->default_listId, host_page_list_id()) == 0);
+    for (int i = 0; i < page->count; i++) {
+        host_item_t item;
+        host_page_item(first + i, &item);
+        CHECK(strcmp(page->items[i].id, item.id) == 0);
+        CHECK(strcmp(page->items[i].listId, item.list_id) == 0);
+        CHECK(strcmp(page->items[i].title, item.title) == 0);
+        CHECK_EQ(page->items[i].is_completed, item.completed);
+        CHECK(strcmp(page->items[i].importance, item.importance) == 0);
+        CHECK(strcmp(page->items[i].last_modified_date, item.modified) == 0);
+    }
+
+    char cursor[160] = "";
+    if (first + expected < total) {
+        host_page_cursor(first + expected, cursor, sizeof(cursor));
+    }
+    CHECK(strcmp(page->next_cursor, cursor) == 0);
+}
+
+/**
+ * @brief 按游标取完整个列表
+ * @return 取到的页数
+ */
+static int fetch_all(void)
+{
+    static todo_page_t page;
+    char cursor[TODO_CURSOR_MAX_LEN] = "";
+    int first = 0;
+    int pages = 0;
+    do {
+        CHECK_EQ(todo_client_get_page(cursor[0] ? cursor : NULL, &page), ESP_OK);
+        check_page(&page, first, server.total);
+        first += page.count;
+        strlcpy(cursor, page.next_cursor, sizeof(cursor));
+        pages++;
+    } while (cursor[0] != '\0' && pages < server.total);
+    CHECK_EQ(first, server.total);
+    return pages;
+}
+
+static void test_json_pages(void)
+{
+    start_server(false, LIST_TOTAL);
+    CHECK_EQ(fetch_all(), 3);
+    CHECK(!server.last_was_cbor);
+    CHECK_EQ(server.list_requests, 3);
+    // 三页都在同一条长连接上
+    CHECK_EQ(host_http_get_stats(ORIGIN)->connects, 1);
+}
+
+static void test_cbor_pages_match_json(void)
+{
+    start_server(true, LIST_TOTAL);
+    CHECK_EQ(fetch_all(), 3);
+    CHECK(server.last_was_cbor);
+}
+
+static void test_cbor_parse_allocates_nothing(void)
+{
+    static todo_page_t page;
+    json_arena_stats_t before;
+    json_arena_stats_t after;
+
+    start_server(true, LIST_TOTAL);
+    json_arena_get_stats(&before);
+    uint32_t internal_calls = host_heap_alloc_calls(false);
+    uint32_t psram_calls = host_heap_alloc_calls(true);
+    CHECK_EQ(todo_client_get_page(NULL, &page), ESP_OK);
+    json_arena_get_stats(&after);
+    CHECK(server.last_was_cbor);
+    CHECK_EQ(after.requests, before.requests);
+    CHECK_EQ(after.allocs, before.allocs);
+    CHECK_EQ(host_heap_alloc_calls(false), internal_calls);
+    CHECK_EQ(host_heap_alloc_calls(true), psram_calls);
+
+    // 同一页走 JSON 时 cJSON 每个值一个节点，键名和字符串值各一次分配
+    start_server(false, LIST_TOTAL);
+    json_arena_get_stats(&before);
+    CHECK_EQ(todo_client_get_page(NULL, &page), ESP_OK);
+    json_arena_get_stats(&after);
+    CHECK_EQ(after.requests, before.requests + 1);
+    // 根节点 + 3 个成员（节点、键名）+ 2 个字符串值；每条：节点 + 6 个成员 + 5 个字符串值
+    CHECK_EQ(after.allocs - before.allocs, 1 + 3 * 2 + 2 + TODO_PAGE_SIZE * (1 + 6 * 2 + 5));
+}
+
+static void test_truncated_cbor_fails(void)
+{
+    static todo_page_t page;
+    size_t len = host_page_cbor((uint8_t *)http_buffer, sizeof(http_buffer), 0, TODO_PAGE_SIZE, LIST_TOTAL);
+    CHECK(len > 0);
+    http_buffer_index = (int)len - 7;
+    memset(&page, 0, sizeof(page));
+    CHECK_EQ(parse_page_cbor(&page), ESP_FAIL);
+}
+
+/**
+ * @brief 同一页两种编码的字节数、解析耗时（本机）和分配
+ */
+static void test_page_size_parse_time_and_allocs(void)
+{
+    static todo_page_t page;
+    json_arena_stats_t before;
+    json_arena_stats_t after;
+
+    size_t json_len = host_page_json(http_buffer, sizeof(http_buffer), 0, TODO_PAGE_SIZE, LIST_TOTAL);
+    static uint8_t cbor[HTTP_BUFFER_SIZE];
+    size_t cbor_len = host_page_cbor(cbor, sizeof(cbor), 0, TODO_PAGE_SIZE, LIST_TOTAL);
+    CHECK(json_len > 0 && cbor_len > 0);
+    CHECK(cbor_len < json_len);
+
+    json_arena_get_stats(&before);
+    http_buffer_index = (int)json_len;
+    int64_t start = host_monotonic_us();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        memset(&page, 0, sizeof(page));
+        CHECK_EQ(parse_page_json(&page), ESP_OK);
+    }
+    int64_t json_us = host_monotonic_us() - start;
+    check_page(&page, 0, LIST_TOTAL);
+    json_arena_get_stats(&after);
+    uint32_t json_allocs = (after.allocs - before.allocs) / BENCH_ROUNDS;
+
+    memcpy(http_buffer, cbor, cbor_len);
+    http_buffer_index = (int)cbor_len;
+    json_arena_get_stats(&before);
+    uint32_t heap_calls = host_heap_alloc_calls(false) + host_heap_alloc_calls(true);
+    start = host_monotonic_us();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        memset(&page, 0, sizeof(page));
+        CHECK_EQ(parse_page_cbor(&page), ESP_OK);
+    }
+    int64_t cbor_us = host_monotonic_us() - start;
+    check_page(&page, 0, LIST_TOTAL);
+    json_arena_get_stats(&after);
+    CHECK_EQ(after.allocs, before.allocs);
+    CHECK_EQ(host_heap_alloc_calls(false) + host_heap_alloc_calls(true), heap_calls);
+
+    printf("   %d 条/页: JSON %zu 字节, CBOR %zu 字节 (%.1f%%)\n", TODO_PAGE_SIZE, json_len, cbor_len,
+           100.0 * cbor_len / json_len);
+    printf("   解析 (主机, %d 次平均): JSON %.2f us/页, CBOR %.2f us/页\n", BENCH_ROUNDS,
+           (double)json_us / BENCH_ROUNDS, (double)cbor_us / BENCH_ROUNDS);
+    printf("   分配: JSON %lu 次/页 (内存池峰值 %lu 字节，64 位主机节点 %zu 字节), CBOR 0 次\n",
+           (unsigned long)json_allocs, (unsigned long)after.peak_bytes, sizeof(cJSON));
+}
+
+int main(void)
+{
+    CHECK_EQ(todo_client_init(ORIGIN), ESP_OK);
+
+    RUN_TEST(test_json_pages);
+    RUN_TEST(test_cbor_pages_match_json);
+    RUN_TEST(test_cbor_parse_allocates_nothing);
+    RUN_TEST(test_truncated_cbor_fails);
+    RUN_TEST(test_page_size_parse_time_and_allocs);
+    return HOST_TEST_EXIT_CODE();
+}
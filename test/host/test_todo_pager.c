@@ -0,0 +1,406 @@
+/**
+ * @file test_todo_pager.c
+ * @brief todo_pager：对 10 000 条的替身服务器按游标分页，滚动预取、请求去重、远离可视区域的页被淘汰，
+ *        以及刷新、过期结果、失败重试和本地修改
+ *
+ * todo_net_fetch_page 由本文件实现为替身服务器：记下请求，经过设定的延迟后
+ * 生成一页数据块交给 todo_pager_on_fetched。时间用 host_time_us 推进，每帧 16 ms。
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "retry_policy.h"
+#include "todo_net.h"
+#include "todo_pager.h"
+#include "todo_store.h"
+
+#define FRAME_US     16000
+#define VIEW_ROWS    6          // 一屏可见的卡片数
+
+// ---------- 替身服务器 ----------
+
+typedef struct {
+    bool active;
+    int offset;
+    uint32_t tag;
+    int64_t due_us;
+} server_req_t;
+
+static server_req_t req;
+static int server_total = 10000;
+static int server_latency_ms = 120;
+static int server_requests = 0;
+static int server_edit = 0;         // 递增后返回的标题变化，模拟服务器端修改
+static int *fetch_counts = NULL;    // 每页被获取的次数
+
+// 游标对客户端不透明，带 '+' '/' '='，与 Graph 的 skiptoken 类似
+static void make_cursor(char *buf, size_t len, int offset)
+{
+    snprintf(buf, len, "eyJvZmZzZXQiOi+/%07d==", offset);
+}
+
+static int parse_cursor(const char *cursor)
+{
+    if (cursor == NULL) {
+        return 0;
+    }
+    const char *digits = strstr(cursor, "+/");
+    CHECK(digits != NULL);
+    return digits != NULL ? atoi(digits + 2) : 0;
+}
+
+esp_err_t todo_net_fetch_page(const char *cursor, uint32_t tag)
+{
+    if (req.active) {
+        return ESP_ERR_NO_MEM;
+    }
+    req.active = true;
+    req.offset = parse_cursor(cursor);
+    req.tag = tag;
+    req.due_us = host_time_us + (int64_t)server_latency_ms * 1000;
+    server_requests++;
+    fetch_counts[req.offset / TODO_PAGE_SIZE]++;
+    return ESP_OK;
+}
+
+static void fill_page(todo_page_t *page, int offset)
+{
+    memset(page, 0, sizeof(*page));
+    int count = server_total - offset;
+    page->count = count < TODO_PAGE_SIZE ? (count > 0 ? count : 0) : TODO_PAGE_SIZE;
+    for (int i = 0; i < page->count; i++) {
+        todo_item_t *item = &page->items[i];
+        snprintf(item->id, sizeof(item->id), "id-%d", offset + i);
+        snprintf(item->title, sizeof(item->title), "任务 %d v%d", offset + i, server_edit);
+        strcpy(item->listId, "list-1");
+    }
+    if (offset + page->count < server_total) {
+        make_cursor(page->next_cursor, sizeof(page->next_cursor), offset + page->count);
+    }
+}
+
+/**
+ * @brief 立即交付在途请求
+ */
+static bool server_deliver(esp_err_t err)
+{
+    if (!req.active) {
+        return false;
+    }
+    req.active = false;
+    todo_page_block_t *block = NULL;
+    if (err == ESP_OK) {
+        block = todo_store_block_new();
+        fill_page(&block->page, req.offset);
+    }
+    return todo_pager_on_fetched(req.tag, err, block);
+}
+
+static void server_reset(int total)
+{
+    free(fetch_counts);
+    server_total = total;
+    fetch_counts = calloc(total / TODO_PAGE_SIZE + 2, sizeof(int));
+    server_requests = 0;
+    req.active = false;
+}
+
+// ---------- 帧循环 ----------
+
+static size_t psram_peak = 0;
+
+static void run_frame(void)
+{
+    host_time_us += FRAME_US;
+    if (req.active && host_time_us >= req.due_us) {
+        server_deliver(ESP_OK);
+    }
+    todo_pager_process();
+    todo_store_notify();
+    if (host_heap_used(true) > psram_peak) {
+        psram_peak = host_heap_used(true);
+    }
+}
+
+static bool rows_visible(int first)
+{
+    int count = todo_pager_get_count();
+    for (int row = first; row < first + VIEW_ROWS && row < count; row++) {
+        const todo_item_t *item = todo_pager_get_item(row);
+        if (item == NULL) {
+            return false;
+        }
+        char want[32];
+        snprintf(want, sizeof(want), "id-%d", row);
+        if (strcmp(item->id, want) != 0) {
+            CHECK(strcmp(item->id, want) == 0);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 加载第一页（手动刷新）
+ */
+static void load_first_page(void)
+{
+    CHECK_EQ(todo_pager_refresh(true), ESP_OK);
+    CHECK(req.active);
+    while (req.active) {
+        run_frame();
+    }
+    todo_pager_set_viewport(0, VIEW_ROWS - 1);
+}
+
+// ---------- 测试 ----------
+
+static void test_scroll_10k_items(void)
+{
+    server_reset(10000);
+    load_first_page();
+    CHECK_EQ(todo_pager_get_count(), TODO_PAGE_SIZE);
+    CHECK(todo_pager_has_more());
+
+    // 每秒 30 行匀速滚动；可视行未到达时停下等待
+    const double rows_per_frame = 30.0 * FRAME_US / 1e6;
+    double pos = 0;
+    int64_t start_us = host_time_us;
+    int stalled_frames = 0;
+    uint32_t max_resident = 0;
+    uint32_t max_blocks = 0;
+    while (true) {
+        int first = (int)pos;
+        todo_pager_set_viewport(first, first + VIEW_ROWS - 1);
+        run_frame();
+
+        todo_pager_stats_t s;
+        todo_pager_get_stats(&s);
+        todo_store_stats_t ss;
+        todo_store_get_stats(&ss);
+        max_resident = s.resident_pages > max_resident ? s.resident_pages : max_resident;
+        max_blocks = ss.blocks_live > max_blocks ? ss.blocks_live : max_blocks;
+
+        if (!rows_visible(first)) {
+            stalled_frames++;
+            continue;
+        }
+        if (!todo_pager_has_more() && first + VIEW_ROWS >= todo_pager_get_count()) {
+            break;
+        }
+        pos += rows_per_frame;
+        if (host_time_us - start_us > 3600LL * 1000000) {
+            CHECK(!"滚动到末尾超时");
+            break;
+        }
+    }
+    double scroll_s = (host_time_us - start_us) / 1e6;
+
+    todo_pager_stats_t s;
+    todo_pager_get_stats(&s);
+    CHECK_EQ(todo_pager_get_count(), 10000);
+    CHECK(!todo_pager_has_more());
+    CHECK_EQ(s.known_pages, 1000);
+    // 向前滚动每页只获取一次，重复的预取请求被去重
+    CHECK_EQ(server_requests, 1000);
+    for (int i = 0; i < 1000; i++) {
+        if (fetch_counts[i] != 1) {
+            CHECK_EQ(fetch_counts[i], 1);
+            break;
+        }
+    }
+    CHECK(s.dedup_requests > 0);
+    // 常驻数据只有可视页及前后各 KEEP_DISTANCE 页
+    CHECK(max_resident <= 2 * TODO_PAGER_KEEP_DISTANCE + 1);
+    CHECK(max_blocks <= 2 * TODO_PAGER_KEEP_DISTANCE + 2);
+    CHECK(s.evictions >= 1000 - (2 * TODO_PAGER_KEEP_DISTANCE + 1));
+    // 请求延迟 120 ms 小于预取提前量（5 行 / 30 行每秒），匀速滚动不应等待
+    CHECK(stalled_frames < 10);
+
+    printf("   10000 条 / 1000 页：滚动到末尾 %.1f s（理想 %.1f s，等待 %d 帧），"
+           "常驻页最多 %u，页数据峰值 %u 字节，模拟PSRAM峰值 %u 字节\n",
+           scroll_s, (10000 - VIEW_ROWS) / 30.0, stalled_frames, max_resident,
+           (unsigned)s.peak_resident_bytes, (unsigned)psram_peak);
+
+    // 跳回顶部：被淘汰的页用保存的游标重新获取，内容正确
+    int before = server_requests;
+    todo_pager_set_viewport(0, VIEW_ROWS - 1);
+    for (int i = 0; i < 100 && !rows_visible(0); i++) {
+        run_frame();
+    }
+    CHECK(rows_visible(0));
+    CHECK_EQ(server_requests - before, 1);
+    CHECK_EQ(fetch_counts[0], 2);
+}
+
+static void test_reset_replaces_pages(void)
+{
+    server_reset(100);
+    load_first_page();
+    todo_pager_set_viewport(0, 9);
+    for (int i = 0; i < 50; i++) {
+        run_frame();
+    }
+    CHECK_EQ(todo_pager_get_count(), 20);
+
+    // 手动刷新：第一页到达前旧数据继续显示，到达后整体替换
+    CHECK_EQ(todo_pager_refresh(true), ESP_OK);
+    CHECK(todo_pager_is_resetting());
+    CHECK(req.active && req.offset == 0);
+    CHECK(todo_pager_get_item(12) != NULL);
+    CHECK(server_deliver(ESP_OK));
+    CHECK(!todo_pager_is_resetting());
+    CHECK_EQ(todo_pager_get_count(), TODO_PAGE_SIZE);
+    CHECK(todo_pager_get_item(12) == NULL);
+
+    // 旧页的数据块全部释放
+    todo_pager_stats_t s;
+    todo_pager_get_stats(&s);
+    todo_store_stats_t ss;
+    todo_store_get_stats(&ss);
+    CHECK_EQ(s.known_pages, 2);
+    CHECK_EQ(s.resident_pages, 1);
+    CHECK_EQ(ss.blocks_live, 1);
+}
+
+static void test_changed_page_truncates_following(void)
+{
+    server_reset(100);
+    load_first_page();
+    todo_pager_set_viewport(0, 9);
+    todo_pager_process();
+    server_deliver(ESP_OK);
+    todo_pager_set_viewport(10, 19);
+    todo_pager_process();
+    server_deliver(ESP_OK);
+    CHECK_EQ(todo_pager_get_count(), 30);
+
+    // 回到顶部，自动刷新时第一页少了一条：后继游标变化，后面的页全部作废
+    todo_pager_set_viewport(0, 5);
+    CHECK_EQ(todo_pager_refresh(false), ESP_OK);
+    todo_pager_process();
+    CHECK(req.active && req.offset == 0);
+    req.active = false;
+    todo_page_block_t *block = todo_store_block_new();
+    fill_page(&block->page, 0);
+    block->page.count = 9;
+    make_cursor(block->page.next_cursor, sizeof(block->page.next_cursor), 9);
+    CHECK(todo_pager_on_fetched(req.tag, ESP_OK, block));
+
+    todo_pager_stats_t s;
+    todo_pager_get_stats(&s);
+    CHECK_EQ(s.known_pages, 2);
+    CHECK_EQ(todo_pager_get_count(), 9);
+    CHECK(todo_pager_has_more());
+
+    // 下一页按新游标获取
+    todo_pager_set_viewport(0, 5);
+    todo_pager_process();
+    CHECK(req.active && req.offset == 9);
+    server_deliver(ESP_OK);
+    CHECK_EQ(todo_pager_get_count(), 19);
+    CHECK(strcmp(todo_pager_get_item(9)->id, "id-9") == 0);
+}
+
+static void test_failed_fetch_stays_pending(void)
+{
+    server_reset(50);
+    load_first_page();
+    todo_pager_set_viewport(0, 9);
+    todo_pager_process();
+    CHECK(req.active);
+
+    todo_pager_stats_t before;
+    todo_pager_get_stats(&before);
+    CHECK(!server_deliver(ESP_FAIL));
+    todo_pager_stats_t after;
+    todo_pager_get_stats(&after);
+    CHECK_EQ(after.fetch_failures, before.fetch_failures + 1);
+
+    // 退避期间不发请求，结束后重试同一页
+    retry_policy_on_failure(RETRY_ENDPOINT_LIST, false, 2000);
+    todo_pager_process();
+    CHECK(!req.active);
+    host_time_us += 3000 * 1000;
+    todo_pager_process();
+    CHECK(req.active);
+    CHECK_EQ(req.offset, 10);
+    server_deliver(ESP_OK);
+    retry_policy_on_success(RETRY_ENDPOINT_LIST);
+    CHECK_EQ(todo_pager_get_count(), 20);
+
+    // 已有列表时手动刷新失败：保留现有列表
+    CHECK_EQ(todo_pager_refresh(true), ESP_OK);
+    server_deliver(ESP_FAIL);
+    CHECK(!todo_pager_is_resetting());
+    CHECK_EQ(todo_pager_get_count(), 20);
+    CHECK(todo_pager_get_item(3) != NULL);
+}
+
+static void test_auto_refresh_keeps_old_rows(void)
+{
+    server_reset(30);
+    load_first_page();
+    server_edit = 1;
+    CHECK_EQ(todo_pager_refresh(false), ESP_OK);
+    CHECK(todo_pager_is_refreshing());
+
+    // 重新获取完成前旧数据继续显示
+    const todo_item_t *item = todo_pager_get_item(0);
+    CHECK(item != NULL && strstr(item->title, "v0") != NULL);
+    todo_pager_process();
+    server_deliver(ESP_OK);
+    CHECK(!todo_pager_is_refreshing());
+    item = todo_pager_get_item(0);
+    CHECK(item != NULL && strstr(item->title, "v1") != NULL);
+    server_edit = 0;
+}
+
+static void test_local_edits_and_snapshots(void)
+{
+    server_reset(30);
+    load_first_page();
+    const todo_item_t *snap_item = NULL;
+    todo_page_block_t *snap = todo_pager_snapshot(2, &snap_item);
+    CHECK(snap != NULL);
+
+    // 快照被持有时修改走写时复制，快照内容不变
+    todo_store_stats_t before;
+    todo_store_get_stats(&before);
+    todo_pager_set_completed(2, true);
+    todo_store_stats_t after;
+    todo_store_get_stats(&after);
+    CHECK_EQ(after.cow_copies, before.cow_copies + 1);
+    CHECK(!snap_item->is_completed);
+    CHECK(todo_pager_get_item(2)->is_completed);
+    todo_store_block_release(snap);
+
+    // 推送修改：在常驻页中原地更新，listId 为空时保留原值
+    todo_item_t upd = {0};
+    strcpy(upd.id, "id-4");
+    strcpy(upd.title, "改过的标题");
+    CHECK(todo_pager_apply_upsert(&upd));
+    CHECK(strcmp(todo_pager_get_item(4)->title, "改过的标题") == 0);
+    CHECK(strcmp(todo_pager_get_item(4)->listId, "list-1") == 0);
+    strcpy(upd.id, "id-9999");
+    CHECK(!todo_pager_apply_upsert(&upd));
+
+    // 推送删除：后续行前移
+    CHECK(todo_pager_apply_delete("id-5"));
+    CHECK_EQ(todo_pager_get_count(), TODO_PAGE_SIZE - 1);
+    CHECK(strcmp(todo_pager_get_item(5)->id, "id-6") == 0);
+    CHECK(!todo_pager_apply_delete("id-5"));
+}
+
+int main(void)
+{
+    RUN_TEST(test_scroll_10k_items);
+    RUN_TEST(test_reset_replaces_pages);
+    RUN_TEST(test_changed_page_truncates_following);
+    RUN_TEST(test_failed_fetch_stays_pending);
+    RUN_TEST(test_auto_refresh_keeps_old_rows);
+    RUN_TEST(test_local_edits_and_snapshots);
+    free(fetch_counts);
+    return HOST_TEST_EXIT_CODE();
+}
@@ -0,0 +1,360 @@
+/**
+ * @file test_todo_push.c
+ * @brief todo_push：SSE 流在任意位置分块时解析结果不变，事件增量应用到分页数据，
+ *        队列满时改为重新同步，断线重连带 Last-Event-ID，以及推送到界面收到变更的延迟
+ *
+ * 直接包含 todo_push.c 以便逐字节喂入 SSE 流。todo_pager/todo_store/todo_client 为真实模块，
+ * 推送连接由 host_http.c 的脚本化服务器应答；todo_net 的页请求、todo_refresh 和
+ * refresh_governor 的唤醒由本文件替代并记录。
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "host_http.h"
+#include "todo_net.h"
+#include "todo_store.h"
+#include "todo_push.c"
+
+#define ORIGIN          "http://10.0.0.2:5000"
+#define RESIDENT_ITEMS  TODO_PAGE_SIZE
+#define NET_DELAY_MS    40      // 替身：服务器发出事件到设备收到
+#define IDLE_PERIOD_MS  1000    // 空闲时界面循环最长睡眠（refresh_governor 空闲模式的刷新周期）
+#define EDITS           50
+
+// ---------- 替身 ----------
+
+static uint32_t refresh_requests = 0;   // TODO_REFRESH_BIT 的组合
+static int wakes = 0;
+static bool fetch_pending = false;
+static uint32_t fetch_tag = 0;
+
+esp_err_t todo_net_fetch_page(const char *cursor, uint32_t tag)
+{
+    (void)cursor;
+    fetch_pending = true;
+    fetch_tag = tag;
+    return ESP_OK;
+}
+
+void todo_refresh_request(todo_refresh_source_t source, bool reset)
+{
+    (void)reset;
+    refresh_requests |= TODO_REFRESH_BIT(source);
+}
+
+void refresh_governor_wake(void)
+{
+    wakes++;
+}
+
+static int notifications = 0;
+static int64_t last_notify_us = 0;
+
+static void on_store_change(const todo_store_change_t *change, void *ctx)
+{
+    (void)change;
+    (void)ctx;
+    notifications++;
+    last_notify_us = host_time_us;
+}
+
+/**
+ * @brief 加载一页常驻数据：id-0 .. id-9
+ */
+static void load_page(void)
+{
+    CHECK_EQ(todo_pager_refresh(true), ESP_OK);
+    todo_pager_process();
+    CHECK(fetch_pending);
+    fetch_pending = false;
+
+    todo_page_block_t *block = todo_store_block_new();
+    block->page.count = RESIDENT_ITEMS;
+    for (int i = 0; i < RESIDENT_ITEMS; i++) {
+        todo_item_t *item = &block->page.items[i];
+        snprintf(item->id, sizeof(item->id), "id-%d", i);
+        snprintf(item->title, sizeof(item->title), "任务 %d", i);
+        strcpy(item->listId, "list-1");
+    }
+    CHECK(todo_pager_on_fetched(fetch_tag, ESP_OK, block));
+    todo_store_notify();
+    CHECK_EQ(todo_pager_get_count(), RESIDENT_ITEMS);
+}
+
+/**
+ * @brief 清空解析状态、事件队列和记录
+ */
+static void reset_push(void)
+{
+    todo_push_event_t event;
+    while (xQueueReceive(event_queue, &event, 0) == pdTRUE) {
+    }
+    reset_parser();
+    last_event_id[0] = '\0';
+    retry_ms = PUSH_RETRY_MIN_MS;
+    refresh_requests = 0;
+    wakes = 0;
+}
+
+static void feed_str(const char *s)
+{
+    feed(s, (int)strlen(s));
+}
+
+// ---------- 测试 ----------
+
+static const char STREAM[] =
+    ": heartbeat\r\n"
+    "retry: 5000\r\n"
+    "id: 1760000000000\r\n"
+    "event: upsert\r\n"
+    "data: {\"id\":\"id-3\",\"title\":\"改过的标题\",\r\n"
+    "data: \"isCompleted\":true}\r\n"
+    "\r\n"
+    "event: delete\n"
+    "data: {\"id\":\"id-5\"}\n"
+    "\n"
+    "event: mystery\n"
+    "data: {}\n"
+    "\n"
+    "event: resync\n"
+    "data: {}\n"
+    "\n";
+
+static void check_stream_events(void)
+{
+    todo_push_event_t event;
+    CHECK(xQueueReceive(event_queue, &event, 0) == pdTRUE);
+    CHECK_EQ(event.type, TODO_PUSH_UPSERT);
+    CHECK(strcmp(event.item.id, "id-3") == 0);
+    CHECK(strcmp(event.item.title, "改过的标题") == 0);
+    CHECK(event.item.is_completed);
+    CHECK(event.server_time_ms == 1760000000000LL);
+
+    // id 字段一直有效到下一次设置
+    CHECK(xQueueReceive(event_queue, &event, 0) == pdTRUE);
+    CHECK_EQ(event.type, TODO_PUSH_DELETE);
+    CHECK(strcmp(event.item.id, "id-5") == 0);
+    CHECK(event.server_time_ms == 1760000000000LL);
+
+    // 未知事件被忽略
+    CHECK(xQueueReceive(event_queue, &event, 0) == pdTRUE);
+    CHECK_EQ(event.type, TODO_PUSH_RESYNC);
+    CHECK(xQueueReceive(event_queue, &event, 0) == pdFALSE);
+    CHECK_EQ(retry_ms, 5000);
+    CHECK_EQ(wakes, 3);
+}
+
+static void test_parse_split_anywhere(void)
+{
+    size_t len = strlen(STREAM);
+    for (size_t split = 0; split <= len; split++) {
+        reset_push();
+        feed(STREAM, (int)split);
+        feed(STREAM + split, (int)(len - split));
+        check_stream_events();
+    }
+
+    // 逐字节
+    reset_push();
+    for (size_t i = 0; i < len; i++) {
+        feed(STREAM + i, 1);
+    }
+    check_stream_events();
+}
+
+static void test_bad_events_dropped(void)
+{
+    todo_push_event_t event;
+    reset_push();
+
+    // JSON 损坏、缺少 id
+    feed_str("data: {not json\n\n");
+    feed_str("data: {\"title\":\"no id\"}\n\n");
+    // 超长的行整行丢弃：截断后的前半截本身是合法 JSON，也不能当成事件
+    char *long_line = malloc(PUSH_LINE_MAX + 64);
+    strcpy(long_line, "data: {\"id\":\"id-1\"}");
+    size_t head = strlen(long_line);
+    memset(long_line + head, ' ', PUSH_LINE_MAX);
+    strcpy(long_line + head + PUSH_LINE_MAX, "x\n\n");
+    feed_str(long_line);
+    free(long_line);
+    // 只有空行、只有注释
+    feed_str("\n\n: ping\n\n");
+    CHECK(xQueueReceive(event_queue, &event, 0) == pdFALSE);
+    CHECK_EQ(wakes, 0);
+
+    // 之后的正常事件不受影响
+    feed_str("data: {\"id\":\"id-2\"}\n\n");
+    CHECK(xQueueReceive(event_queue, &event, 0) == pdTRUE);
+    CHECK_EQ(event.type, TODO_PUSH_UPSERT);
+    CHECK(strcmp(event.item.id, "id-2") == 0);
+}
+
+static void test_apply_to_pages(void)
+{
+    reset_push();
+    load_page();
+    CHECK_EQ(todo_detail_cache_put("id-3", "旧正文"), ESP_OK);
+
+    feed_str(STREAM);
+    feed_str("event: upsert\ndata: {\"id\":\"id-9999\",\"title\":\"新条目\"}\n\n");
+    int before = notifications;
+    CHECK(todo_push_apply_pending());
+    CHECK(todo_store_notify());
+    CHECK_EQ(notifications, before + 1);
+
+    // 常驻条目原地更新（listId 保留），正文缓存作废
+    const todo_item_t *item = todo_pager_get_item(3);
+    CHECK(strcmp(item->title, "改过的标题") == 0);
+    CHECK(item->is_completed);
+    CHECK(strcmp(item->listId, "list-1") == 0);
+    CHECK(!todo_detail_cache_contains("id-3"));
+
+    // 删除后后面的行前移
+    CHECK_EQ(todo_pager_get_count(), RESIDENT_ITEMS - 1);
+    CHECK(strcmp(todo_pager_get_item(5)->id, "id-6") == 0);
+
+    // 不在常驻页中的新条目和 resync 只能重新获取
+    CHECK(refresh_requests & TODO_REFRESH_BIT(TODO_REFRESH_PUSH));
+    CHECK(refresh_requests & TODO_REFRESH_BIT(TODO_REFRESH_RECONNECT));
+    CHECK(!todo_push_apply_pending());
+}
+
+static void test_queue_full_resyncs(void)
+{
+    reset_push();
+    for (int i = 0; i < PUSH_QUEUE_LEN + 1; i++) {
+        feed_str("data: {\"id\":\"id-1\"}\n\n");
+    }
+    // 队列放不下的事件丢弃，改为整体重新同步；每个事件都唤醒界面循环
+    CHECK_EQ(uxQueueMessagesWaiting(event_queue), PUSH_QUEUE_LEN);
+    CHECK(refresh_requests & TODO_REFRESH_BIT(TODO_REFRESH_RECONNECT));
+    CHECK_EQ(wakes, PUSH_QUEUE_LEN + 1);
+    reset_push();
+}
+
+// 推送服务器：按顺序返回 responses 中的状态码，200 时带一个事件
+typedef struct {
+    int responses[4];
+    int served;
+    char last_event_id[24];
+    char body[256];
+} events_server_t;
+
+static events_server_t events_server;
+
+static void events_handler(const host_http_request_t *req, host_http_response_t *resp, void *ctx)
+{
+    events_server_t *s = ctx;
+    const char *id = host_http_request_header(req, "Last-Event-ID");
+    strlcpy(s->last_event_id, id != NULL ? id : "", sizeof(s->last_event_id));
+    CHECK(strcmp(req->path, PUSH_EVENTS_PATH) == 0);
+    CHECK(strcmp(host_http_request_header(req, "Accept"), "text/event-stream") == 0);
+
+    resp->status = s->responses[s->served++];
+    if (resp->status == 200) {
+        snprintf(s->body, sizeof(s->body), "id: %d\ndata: {\"id\":\"id-%d\"}\n\n: ping\n", 40 + s->served,
+                 s->served);
+        resp->body = s->body;
+        resp->body_len = strlen(s->body);
+    }
+    resp->wait_ms = 20;
+}
+
+static void test_reconnect_with_last_event_id(void)
+{
+    todo_push_event_t event;
+    reset_push();
+    host_http_reset();
+    memset(&events_server, 0, sizeof(events_server));
+    events_server.responses[0] = 200;
+    events_server.responses[1] = 200;
+    events_server.responses[2] = 404;
+    host_http_add_server(ORIGIN, 3, 3, events_handler, &events_server);
+
+    bool ever_connected = false;
+    CHECK_EQ(run_connection(&ever_connected), 200);
+    CHECK(ever_connected);
+    CHECK(!todo_push_is_connected());
+    CHECK(strcmp(events_server.last_event_id, "") == 0);
+    CHECK(xQueueReceive(event_queue, &event, 0) == pdTRUE);
+    CHECK(strcmp(event.item.id, "id-1") == 0);
+    // 第一次连接不需要补同步
+    CHECK_EQ(refresh_requests, 0);
+
+    // 重连：带上最后收到的事件ID，并安排一次重新同步弥补断线期间
+    CHECK_EQ(run_connection(&ever_connected), 200);
+    CHECK(strcmp(events_server.last_event_id, "41") == 0);
+    CHECK(refresh_requests & TODO_REFRESH_BIT(TODO_REFRESH_RECONNECT));
+    CHECK(xQueueReceive(event_queue, &event, 0) == pdTRUE);
+    CHECK(strcmp(event.item.id, "id-2") == 0);
+
+    // 后端不支持推送
+    CHECK_EQ(run_connection(&ever_connected), 404);
+    CHECK(xQueueReceive(event_queue, &event, 0) == pdFALSE);
+}
+
+/**
+ * @brief 服务器端修改到界面收到变更通知的延迟（模拟时钟）
+ *
+ * 界面循环空闲时最长睡 IDLE_PERIOD_MS；推送任务收到事件后唤醒它，
+ * 被唤醒的那一轮应用事件并通知界面。没有被唤醒的事件要等到下一个空闲周期。
+ */
+static void test_change_to_screen_latency(void)
+{
+    reset_push();
+    load_page();
+    host_random_seed(35);
+
+    int64_t total_us = 0;
+    int64_t max_us = 0;
+    int64_t t = host_time_us;
+    for (int i = 0; i < EDITS; i++) {
+        // 服务器端修改：时间随机分布
+        t += (int64_t)(esp_random() % 120000 + 1000) * 1000;
+        int64_t edit_us = t;
+        int row = (int)(esp_random() % RESIDENT_ITEMS);
+
+        host_time_us = edit_us + NET_DELAY_MS * 1000;
+        char chunk[160];
+        snprintf(chunk, sizeof(chunk), "event: upsert\ndata: {\"id\":\"id-%d\",\"title\":\"修改 %d\"}\n\n", row, i);
+        int woken = wakes;
+        feed_str(chunk);
+
+        // 界面循环：被唤醒则立即运行一轮，否则等到下一个空闲周期
+        if (wakes == woken) {
+            host_time_us = (host_time_us / (IDLE_PERIOD_MS * 1000) + 1) * IDLE_PERIOD_MS * 1000;
+        }
+        CHECK(todo_push_apply_pending());
+        CHECK(todo_store_notify());
+        CHECK(strstr(todo_pager_get_item(row)->title, "修改") != NULL);
+
+        int64_t latency = last_notify_us - edit_us;
+        total_us += latency;
+        if (latency > max_us) {
+            max_us = latency;
+        }
+    }
+
+    // 除了网络传输没有额外等待
+    CHECK_EQ(max_us, NET_DELAY_MS * 1000);
+    printf("   %d 次修改: 到界面收到变更平均 %.1f ms, 最大 %.1f ms（其中网络 %d ms 为替身设定值）\n", EDITS,
+           (double)total_us / EDITS / 1000, (double)max_us / 1000, NET_DELAY_MS);
+}
+
+int main(void)
+{
+    CHECK_EQ(todo_client_init(ORIGIN), ESP_OK);
+    CHECK_EQ(todo_push_start(), ESP_OK);
+    CHECK_EQ(todo_store_subscribe(on_store_change, NULL), ESP_OK);
+
+    RUN_TEST(test_parse_split_anywhere);
+    RUN_TEST(test_bad_events_dropped);
+    RUN_TEST(test_apply_to_pages);
+    RUN_TEST(test_queue_full_resyncs);
+    RUN_TEST(test_reconnect_with_last_event_id);
+    RUN_TEST(test_change_to_screen_latency);
+    return HOST_TEST_EXIT_CODE();
+}
@@ -0,0 +1,234 @@
+/**
+ * @file test_todo_refresh.c
+ * @brief todo_refresh：一串触发合并成一次获取，进行中到达的请求只产生一次后续刷新，
+ *        最小间隔、全部重新获取优先，以及多个线程同时触发时请求不丢失
+ *
+ * todo_pager 和 refresh_governor 由本文件替代：刷新“进行中”由测试控制。
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include "host_test.h"
+#include "freertos/FreeRTOS.h"
+#include "refresh_governor.h"
+#include "todo_pager.h"
+#include "todo_refresh.h"
+
+#define MS 1000LL
+
+static bool pager_refreshing = false;
+static int pager_refresh_calls = 0;
+static int pager_reset_calls = 0;
+static int wakes = 0;
+
+esp_err_t todo_pager_refresh(bool reset)
+{
+    pager_refresh_calls++;
+    pager_reset_calls += reset;
+    pager_refreshing = true;
+    return ESP_OK;
+}
+
+bool todo_pager_is_refreshing(void)
+{
+    return pager_refreshing;
+}
+
+void refresh_governor_wake(void)
+{
+    host_critical_enter();
+    wakes++;
+    host_critical_exit();
+}
+
+static void advance_ms(int64_t ms)
+{
+    host_time_us += ms * MS;
+}
+
+/**
+ * @brief 让上一次刷新完成并越过最小间隔
+ */
+static void settle(void)
+{
+    pager_refreshing = false;
+    advance_ms(TODO_REFRESH_MIN_INTERVAL_MS);
+    while (todo_refresh_run(NULL) != 0) {
+        pager_refreshing = false;
+        advance_ms(TODO_REFRESH_MIN_INTERVAL_MS);
+    }
+}
+
+static todo_refresh_stats_t stats(void)
+{
+    todo_refresh_stats_t s;
+    todo_refresh_get_stats(&s);
+    return s;
+}
+
+static void test_burst_coalesces_into_one_fetch(void)
+{
+    settle();
+    int calls = pager_refresh_calls;
+    todo_refresh_stats_t before = stats();
+    CHECK_EQ(todo_refresh_run(NULL), 0);
+    CHECK_EQ(todo_refresh_wait_ms(), UINT32_MAX);
+
+    // 定时、重连和两次推送几乎同时到达
+    todo_refresh_request(TODO_REFRESH_TIMER, false);
+    todo_refresh_request(TODO_REFRESH_RECONNECT, false);
+    todo_refresh_request(TODO_REFRESH_PUSH, false);
+    todo_refresh_request(TODO_REFRESH_PUSH, false);
+    CHECK_EQ(todo_refresh_wait_ms(), 0);
+
+    esp_err_t result = ESP_FAIL;
+    uint32_t sources = todo_refresh_run(&result);
+    CHECK_EQ(sources, TODO_REFRESH_BIT(TODO_REFRESH_TIMER) | TODO_REFRESH_BIT(TODO_REFRESH_RECONNECT) |
+                      TODO_REFRESH_BIT(TODO_REFRESH_PUSH));
+    CHECK_EQ(result, ESP_OK);
+    CHECK_EQ(pager_refresh_calls - calls, 1);
+    CHECK_EQ(todo_refresh_run(NULL), 0);
+
+    todo_refresh_stats_t s = stats();
+    CHECK_EQ(s.executed - before.executed, 1);
+    CHECK_EQ(s.coalesced - before.coalesced, 3);
+    CHECK_EQ(s.requested[TODO_REFRESH_PUSH] - before.requested[TODO_REFRESH_PUSH], 2);
+}
+
+static void test_trigger_during_inflight_runs_once_after(void)
+{
+    settle();
+    todo_refresh_request(TODO_REFRESH_TIMER, false);
+    CHECK(todo_refresh_run(NULL) != 0);
+    CHECK(pager_refreshing);
+    int calls = pager_refresh_calls;
+    todo_refresh_stats_t before = stats();
+
+    // 刷新进行中又来了多次触发：不执行，也不必定时醒来
+    advance_ms(TODO_REFRESH_MIN_INTERVAL_MS * 2);
+    for (int i = 0; i < 5; i++) {
+        todo_refresh_request(i % 2 ? TODO_REFRESH_PUSH : TODO_REFRESH_TIMER, false);
+        CHECK_EQ(todo_refresh_run(NULL), 0);
+        advance_ms(100);
+    }
+    CHECK_EQ(todo_refresh_wait_ms(), UINT32_MAX);
+    CHECK_EQ(pager_refresh_calls, calls);
+    CHECK_EQ(stats().deferred - before.deferred, 1);
+
+    // 完成后恰好一次后续刷新
+    pager_refreshing = false;
+    CHECK_EQ(todo_refresh_wait_ms(), 0);
+    CHECK(todo_refresh_run(NULL) != 0);
+    pager_refreshing = false;
+    advance_ms(TODO_REFRESH_MIN_INTERVAL_MS * 2);
+    CHECK_EQ(todo_refresh_run(NULL), 0);
+    CHECK_EQ(pager_refresh_calls - calls, 1);
+    CHECK_EQ(stats().coalesced - before.coalesced, 4);
+}
+
+static void test_min_interval(void)
+{
+    settle();
+    todo_refresh_request(TODO_REFRESH_TIMER, false);
+    CHECK(todo_refresh_run(NULL) != 0);
+    pager_refreshing = false;
+
+    advance_ms(500);
+    todo_refresh_request(TODO_REFRESH_PUSH, false);
+    CHECK_EQ(todo_refresh_wait_ms(), TODO_REFRESH_MIN_INTERVAL_MS - 500);
+    CHECK_EQ(todo_refresh_run(NULL), 0);
+    advance_ms(TODO_REFRESH_MIN_INTERVAL_MS - 501);
+    CHECK_EQ(todo_refresh_wait_ms(), 1);
+    CHECK_EQ(todo_refresh_run(NULL), 0);
+    advance_ms(1);
+    CHECK_EQ(todo_refresh_run(NULL), TODO_REFRESH_BIT(TODO_REFRESH_PUSH));
+}
+
+static void test_reset_not_blocked_by_inflight(void)
+{
+    settle();
+    todo_refresh_request(TODO_REFRESH_TIMER, false);
+    CHECK(todo_refresh_run(NULL) != 0);
+    advance_ms(TODO_REFRESH_MIN_INTERVAL_MS);
+    int resets = pager_reset_calls;
+
+    // 手动刷新替换进行中的常驻页刷新；同时到达的定时请求并入其中
+    todo_refresh_request(TODO_REFRESH_TIMER, false);
+    todo_refresh_request(TODO_REFRESH_MANUAL, true);
+    CHECK(pager_refreshing);
+    CHECK_EQ(todo_refresh_wait_ms(), 0);
+    CHECK_EQ(todo_refresh_run(NULL), TODO_REFRESH_BIT(TODO_REFRESH_TIMER) | TODO_REFRESH_BIT(TODO_REFRESH_MANUAL));
+    CHECK_EQ(pager_reset_calls - resets, 1);
+
+    // 无效来源被忽略
+    int before = wakes;
+    todo_refresh_request(TODO_REFRESH_SOURCE_COUNT, true);
+    CHECK_EQ(wakes, before);
+}
+
+#define THREADS 4
+#define REQUESTS_PER_THREAD 20000
+
+static atomic_int producers_done = 0;
+
+static void *trigger_thread(void *arg)
+{
+    todo_refresh_source_t source = (todo_refresh_source_t)(intptr_t)arg;
+    for (int i = 0; i < REQUESTS_PER_THREAD; i++) {
+        todo_refresh_request(source, false);
+        if (i % 64 == 0) {
+            sched_yield();    // 单核机器上让主循环穿插执行
+        }
+    }
+    atomic_fetch_add(&producers_done, 1);
+    return NULL;
+}
+
+static void test_concurrent_triggers(void)
+{
+    settle();
+    todo_refresh_stats_t before = stats();
+    int calls = pager_refresh_calls;
+    int wakes_before = wakes;
+
+    pthread_t threads[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        pthread_create(&threads[i], NULL, trigger_thread, (void *)(intptr_t)(TODO_REFRESH_TIMER + i % 3));
+    }
+    // 主循环一边执行，一边有请求到达；每次执行后刷新立即完成
+    while (atomic_load(&producers_done) < THREADS) {
+        advance_ms(TODO_REFRESH_MIN_INTERVAL_MS);
+        pager_refreshing = false;
+        todo_refresh_run(NULL);
+        sched_yield();
+    }
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    settle();
+
+    // 每个请求要么被执行，要么被合并，没有丢失
+    todo_refresh_stats_t s = stats();
+    uint32_t requested = 0;
+    for (int i = 0; i < TODO_REFRESH_SOURCE_COUNT; i++) {
+        requested += s.requested[i] - before.requested[i];
+    }
+    CHECK_EQ(requested, THREADS * REQUESTS_PER_THREAD);
+    CHECK_EQ((s.executed - before.executed) + (s.coalesced - before.coalesced), requested);
+    CHECK_EQ(pager_refresh_calls - calls, s.executed - before.executed);
+    CHECK_EQ(wakes - wakes_before, THREADS * REQUESTS_PER_THREAD);
+    printf("   %d 个请求合并为 %u 次刷新\n", THREADS * REQUESTS_PER_THREAD,
+           (unsigned)(s.executed - before.executed));
+}
+
+int main(void)
+{
+    host_time_us = 10 * 1000 * MS;
+    RUN_TEST(test_burst_coalesces_into_one_fetch);
+    RUN_TEST(test_trigger_during_inflight_runs_once_after);
+    RUN_TEST(test_min_interval);
+    RUN_TEST(test_reset_not_blocked_by_inflight);
+    RUN_TEST(test_concurrent_triggers);
+    return HOST_TEST_EXIT_CODE();
+}
@@ -0,0 +1,251 @@
+/**
+ * @file test_todo_store.c
+ * @brief todo_store：引用计数、写时复制，以及多个读线程与一个写线程并发时读不到改了一半的页
+ *
+ * 并发测试按固件中的用法：写线程（界面任务）持有各页的数据块，修改前取 todo_store_block_writable，
+ * 有时整页换成新块（新页到达）；读线程在锁内从写线程处取一个引用（相当于由界面任务交出快照），
+ * 之后不加锁读取，持有一段时间后再读一遍，两次都必须是同一版本、每条都完整。
+ * 写线程逐条改写并在中途让出，读到正在改写的块就会看到两个版本混在一起。
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include "host_test.h"
+#include "esp_heap_caps.h"
+#include "todo_store.h"
+
+#define SLOTS       4
+#define READERS     4
+#define WRITES      20000
+#define REPLACE_EVERY 16        // 每隔几次写换成新块
+
+static pthread_mutex_t slot_lock = PTHREAD_MUTEX_INITIALIZER;
+static todo_page_block_t *slots[SLOTS];
+static uint32_t slot_gen[SLOTS];
+static atomic_bool stop;
+
+static atomic_uint reads;
+static atomic_uint torn;            // 读到不完整或混合版本的页
+static atomic_uint changed;         // 持有期间快照被改动
+static atomic_uint went_back;       // 读到比之前更旧的版本
+
+static void fill_page(todo_page_t *page, int slot, uint32_t gen, bool yield)
+{
+    for (int i = 0; i < TODO_PAGE_SIZE; i++) {
+        todo_item_t *item = &page->items[i];
+        snprintf(item->id, sizeof(item->id), "p%d-%d", slot, i);
+        snprintf(item->title, sizeof(item->title), "第 %lu 版 第 %d 条", (unsigned long)gen, i);
+        item->is_completed = (gen & 1) != 0;
+        if (yield && i == TODO_PAGE_SIZE / 2) {
+            sched_yield();
+        }
+    }
+    page->count = TODO_PAGE_SIZE;
+    snprintf(page->next_cursor, sizeof(page->next_cursor), "p%d-g%lu", slot, (unsigned long)gen);
+}
+
+/**
+ * @brief 页的版本号，各条与游标不是同一版本时返回 0
+ */
+static uint32_t page_gen(const todo_page_t *page, int slot)
+{
+    unsigned long gen = 0;
+    if (page->count != TODO_PAGE_SIZE || sscanf(page->items[0].title, "第 %lu 版", &gen) != 1 || gen == 0) {
+        return 0;
+    }
+    char want[TODO_TITLE_MAX_LEN];
+    for (int i = 0; i < TODO_PAGE_SIZE; i++) {
+        const todo_item_t *item = &page->items[i];
+        snprintf(want, sizeof(want), "第 %lu 版 第 %d 条", gen, i);
+        if (strcmp(item->title, want) != 0 || item->is_completed != ((gen & 1) != 0)) {
+            return 0;
+        }
+        snprintf(want, sizeof(want), "p%d-%d", slot, i);
+        if (strcmp(item->id, want) != 0) {
+            return 0;
+        }
+    }
+    snprintf(want, sizeof(want), "p%d-g%lu", slot, gen);
+    if (strcmp(page->next_cursor, want) != 0) {
+        return 0;
+    }
+    return (uint32_t)gen;
+}
+
+static int refs(todo_page_block_t *block)
+{
+    return atomic_load(&block->refs);
+}
+
+static void test_refcount_single(void)
+{
+    todo_store_stats_t before, after;
+    todo_store_get_stats(&before);
+    size_t psram_before = host_heap_used(true);
+
+    todo_page_block_t *block = todo_store_block_new();
+    CHECK(block != NULL);
+    fill_page(&block->page, 0, 1, false);
+    CHECK_EQ(refs(block), 1);
+
+    // 只有自己持有：原地修改
+    CHECK(todo_store_block_writable(block) == block);
+
+    // 别处还持有：复制，调用者的引用转到新块，旧块内容不变
+    todo_page_block_t *snapshot = todo_store_block_retain(block);
+    CHECK_EQ(refs(block), 2);
+    todo_page_block_t *w = todo_store_block_writable(block);
+    CHECK(w != NULL && w != block);
+    CHECK_EQ(refs(block), 1);
+    CHECK_EQ(refs(w), 1);
+    fill_page(&w->page, 0, 2, false);
+    CHECK_EQ(page_gen(&snapshot->page, 0), 1);
+    CHECK_EQ(page_gen(&w->page, 0), 2);
+
+    todo_store_get_stats(&after);
+    CHECK_EQ(after.cow_copies - before.cow_copies, 1);
+    CHECK_EQ(after.blocks_live - before.blocks_live, 2);
+
+    // 最后一个引用释放时回收
+    todo_store_block_release(snapshot);
+    todo_store_block_release(w);
+    todo_store_block_release(NULL);
+    todo_store_get_stats(&after);
+    CHECK_EQ(after.blocks_live, before.blocks_live);
+    CHECK_EQ(host_heap_used(true), psram_before);
+}
+
+static void *reader_thread(void *arg)
+{
+    uint32_t rng = 0x9E3779B9u * (uint32_t)(uintptr_t)arg + 1;
+    uint32_t last_gen[SLOTS] = {0};
+
+    while (!atomic_load(&stop)) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        int k = (int)(rng % SLOTS);
+
+        pthread_mutex_lock(&slot_lock);
+        todo_page_block_t *block = todo_store_block_retain(slots[k]);
+        pthread_mutex_unlock(&slot_lock);
+
+        uint32_t gen = page_gen(&block->page, k);
+        if (gen == 0) {
+            atomic_fetch_add(&torn, 1);
+        } else if (gen < last_gen[k]) {
+            atomic_fetch_add(&went_back, 1);
+        }
+        last_gen[k] = gen > last_gen[k] ? gen : last_gen[k];
+
+        // 持有快照期间写线程继续改写，快照必须不变
+        for (int i = 0; i < 3; i++) {
+            sched_yield();
+        }
+        if (page_gen(&block->page, k) != gen) {
+            atomic_fetch_add(&changed, 1);
+        }
+        todo_store_block_release(block);
+        atomic_fetch_add(&reads, 1);
+    }
+    return NULL;
+}
+
+static void test_readers_and_writer(void)
+{
+    todo_store_stats_t before, after;
+    todo_store_get_stats(&before);
+    size_t psram_before = host_heap_used(true);
+
+    for (int k = 0; k < SLOTS; k++) {
+        slots[k] = todo_store_block_new();
+        slot_gen[k] = 1;
+        fill_page(&slots[k]->page, k, 1, false);
+    }
+
+    pthread_t readers[READERS];
+    for (int i = 0; i < READERS; i++) {
+        CHECK_EQ(pthread_create(&readers[i], NULL, reader_thread, (void *)(uintptr_t)i), 0);
+    }
+
+    uint32_t copies = 0;
+    uint32_t in_place = 0;
+    uint32_t replaced = 0;
+    uint32_t failures = 0;
+    for (int n = 0; n < WRITES; n++) {
+        int k = n % SLOTS;
+        pthread_mutex_lock(&slot_lock);
+        if (n % REPLACE_EVERY == REPLACE_EVERY - 1) {
+            // 新页到达：写好新块再换上，旧块由最后一个持有者回收
+            todo_page_block_t *fresh = todo_store_block_new();
+            if (fresh == NULL) {
+                failures++;
+            } else {
+                fill_page(&fresh->page, k, ++slot_gen[k], false);
+                todo_store_block_release(slots[k]);
+                slots[k] = fresh;
+                replaced++;
+            }
+        } else {
+            todo_page_block_t *old = slots[k];
+            todo_page_block_t *w = todo_store_block_writable(old);
+            if (w == NULL) {
+                failures++;
+            } else {
+                if (w == old) {
+                    in_place++;
+                } else {
+                    copies++;
+                }
+                fill_page(&w->page, k, ++slot_gen[k], true);
+                slots[k] = w;
+            }
+        }
+        pthread_mutex_unlock(&slot_lock);
+        if (n % 64 == 0) {
+            sched_yield();
+        }
+    }
+
+    atomic_store(&stop, true);
+    for (int i = 0; i < READERS; i++) {
+        pthread_join(readers[i], NULL);
+    }
+
+    CHECK_EQ(failures, 0);
+    CHECK_EQ(atomic_load(&torn), 0);
+    CHECK_EQ(atomic_load(&changed), 0);
+    CHECK_EQ(atomic_load(&went_back), 0);
+    CHECK(atomic_load(&reads) > 0);
+    // 读线程持有快照时写线程必须复制
+    CHECK(copies > 0);
+
+    todo_store_get_stats(&after);
+    CHECK_EQ(after.cow_copies - before.cow_copies, copies);
+
+    // 读线程都已释放：每页只剩写线程的一个引用，全部释放后块数和 PSRAM 回到原值
+    for (int k = 0; k < SLOTS; k++) {
+        CHECK_EQ(refs(slots[k]), 1);
+        CHECK_EQ(page_gen(&slots[k]->page, k), slot_gen[k]);
+        todo_store_block_release(slots[k]);
+        slots[k] = NULL;
+    }
+    todo_store_get_stats(&after);
+    CHECK_EQ(after.blocks_live, before.blocks_live);
+    CHECK(after.blocks_peak >= before.blocks_live + SLOTS);
+    CHECK_EQ(host_heap_used(true), psram_before);
+
+    printf("   读 %u 次，写 %d 次：复制 %lu，原地 %lu，换新块 %lu，峰值 %lu 块\n", atomic_load(&reads), WRITES,
+           (unsigned long)copies, (unsigned long)in_place, (unsigned long)replaced,
+           (unsigned long)after.blocks_peak);
+}
+
+int main(void)
+{
+    RUN_TEST(test_refcount_single);
+    RUN_TEST(test_readers_and_writer);
+    return HOST_TEST_EXIT_CODE();
+}
@@ -0,0 +1,152 @@
+/**
+ * @file test_todo_tls.c
+ * @brief todo_client 的 https 长连接：预热做一次完整握手，之后的请求复用连接；
+ *        服务器关闭连接后幂等请求用新连接重试并带上已保存的 TLS 会话，非幂等请求不重发
+ *
+ * 服务器为 host_http.c 的脚本化替身，握手耗时由测试设定（完整 FULL_MS、恢复 RESUMED_MS），
+ * 不做真实的 TLS 握手：这里验证的是客户端何时新建连接、何时携带会话以及统计是否正确，
+ * 打印的握手耗时只是替身设定值经统计后的结果，不是 mbedTLS 的实测数据。
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "host_http.h"
+#include "host_pages.h"
+#include "todo_client.h"
+
+#define ORIGIN       "https://todo.example.com"
+#define FULL_MS      400
+#define RESUMED_MS   120
+#define LIST_TOTAL   10
+#define DNS_MS       20
+
+typedef struct {
+    int list_requests;
+    int create_requests;
+    char body[8192];
+} tls_server_t;
+
+static tls_server_t server;
+
+static void handler(const host_http_request_t *req, host_http_response_t *resp, void *ctx)
+{
+    tls_server_t *s = ctx;
+    resp->wait_ms = 30;
+    resp->transfer_ms = 5;
+    if (req->method == HTTP_METHOD_POST && strcmp(req->path, "/api/todos") == 0) {
+        s->create_requests++;
+        resp->status = 201;
+        return;
+    }
+    if (strncmp(req->path, "/api/todos?", 11) != 0) {
+        resp->status = 404;
+        return;
+    }
+    s->list_requests++;
+    resp->status = 200;
+    resp->headers[0][0] = "Content-Type";
+    resp->headers[0][1] = "application/json";
+    if (req->method != HTTP_METHOD_HEAD) {
+        resp->body = s->body;
+        resp->body_len = host_page_json(s->body, sizeof(s->body), 0, TODO_PAGE_SIZE, LIST_TOTAL);
+    }
+}
+
+static void get_page_ok(void)
+{
+    static todo_page_t page;
+    CHECK_EQ(todo_client_get_page(NULL, &page), ESP_OK);
+    CHECK_EQ(page.count, TODO_PAGE_SIZE);
+}
+
+static void test_prewarm_then_reuse(void)
+{
+    todo_client_conn_stats_t stats;
+    CHECK_EQ(todo_client_prewarm(), ESP_OK);
+    todo_client_get_conn_stats(&stats);
+    CHECK_EQ(stats.handshakes_full, 1);
+    CHECK_EQ(stats.handshakes_offered, 0);
+    // DNS 在建连前单独解析，不计入握手
+    CHECK_EQ(stats.handshake_full_avg_ms, FULL_MS);
+
+    for (int i = 0; i < 5; i++) {
+        get_page_ok();
+    }
+    todo_client_get_conn_stats(&stats);
+    CHECK_EQ(stats.requests, 6);
+    CHECK_EQ(stats.connections_reused, 5);
+    CHECK_EQ(stats.handshakes_full, 1);
+    CHECK_EQ(host_http_get_stats(ORIGIN)->connects, 1);
+    CHECK_EQ(server.list_requests, 6);
+}
+
+static void test_dropped_connection_resumes_session(void)
+{
+    todo_client_conn_stats_t before;
+    todo_client_conn_stats_t after;
+    todo_client_get_conn_stats(&before);
+
+    // 服务器关闭空闲连接：复用时读到断开，列表请求幂等，换新连接重试并携带会话
+    host_http_drop_connections(ORIGIN);
+    int64_t start = host_time_us;
+    get_page_ok();
+    int64_t elapsed_ms = (host_time_us - start) / 1000;
+
+    todo_client_get_conn_stats(&after);
+    CHECK_EQ(after.requests - before.requests, 2);
+    CHECK_EQ(after.handshakes_full, before.handshakes_full);
+    CHECK_EQ(after.handshakes_offered, 1);
+    CHECK_EQ(after.handshake_offered_avg_ms, RESUMED_MS);
+    CHECK_EQ(after.handshake_last_ms, RESUMED_MS);
+    CHECK_EQ(host_http_get_stats(ORIGIN)->connects, 2);
+    CHECK_EQ(host_http_get_stats(ORIGIN)->resumed, 1);
+    // 失效连接 1 ms + 恢复握手 + 首字节 + 传输；重试在 perform 内进行，主机名沿用 lwIP 的DNS缓存
+    CHECK_EQ(elapsed_ms, 1 + RESUMED_MS + 30 + 5);
+
+    // 新连接随后照常复用
+    get_page_ok();
+    todo_client_get_conn_stats(&before);
+    CHECK_EQ(before.connections_reused, after.connections_reused + 1);
+}
+
+static void test_non_idempotent_not_resent(void)
+{
+    host_http_drop_connections(ORIGIN);
+    // 创建不是幂等请求：连接在请求发出后失效时无法知道服务器是否已处理，不自动重发
+    CHECK(todo_client_create("买牛奶", NULL) != ESP_OK);
+    CHECK_EQ(server.create_requests, 0);
+
+    todo_client_conn_stats_t stats;
+    todo_client_get_conn_stats(&stats);
+    uint32_t offered = stats.handshakes_offered;
+    get_page_ok();
+    todo_client_get_conn_stats(&stats);
+    CHECK_EQ(stats.handshakes_offered, offered + 1);
+    CHECK_EQ(host_http_get_stats(ORIGIN)->resumed, 2);
+}
+
+static void test_report_handshakes(void)
+{
+    todo_client_conn_stats_t stats;
+    todo_client_get_conn_stats(&stats);
+    printf("   替身设定: 完整握手 %d ms, 恢复握手 %d ms（非实测）\n", FULL_MS, RESUMED_MS);
+    printf("   %lu 次请求: 复用连接 %lu 次, 完整握手 %lu 次 (平均 %lu ms), 携带会话 %lu 次 (平均 %lu ms)\n",
+           (unsigned long)stats.requests, (unsigned long)stats.connections_reused,
+           (unsigned long)stats.handshakes_full, (unsigned long)stats.handshake_full_avg_ms,
+           (unsigned long)stats.handshakes_offered, (unsigned long)stats.handshake_offered_avg_ms);
+    CHECK_EQ(stats.handshakes_full + stats.handshakes_offered, host_http_get_stats(ORIGIN)->connects);
+}
+
+int main(void)
+{
+    host_http_reset();
+    host_http_add_server(ORIGIN, FULL_MS, RESUMED_MS, handler, &server);
+    host_http_set_dns_ms(DNS_MS);
+    CHECK_EQ(todo_client_init(ORIGIN), ESP_OK);
+
+    RUN_TEST(test_prewarm_then_reuse);
+    RUN_TEST(test_dropped_connection_resumes_session);
+    RUN_TEST(test_non_idempotent_not_resent);
+    RUN_TEST(test_report_handshakes);
+    return HOST_TEST_EXIT_CODE();
+}